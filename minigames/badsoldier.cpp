@@ -473,8 +473,10 @@ class BadSoldierGame {
         Quark::Vec3 size; // Half-size for AABB
         hMesh mesh;
         hMaterial material;
+        hRenderProxy proxy; // Retained, obstacles never move
     };
     std::vector<Obstacle> m_obstacles;
+    hRenderProxy m_groundProxy = 0;
 
     Player m_player;
     std::vector<Enemy> m_enemies;
@@ -610,6 +612,14 @@ public:
         m_camera.lookAt(Quark::Vec3(0.0f, 1.0f, 0.0f));
         m_rs->setActiveCamera(&m_camera);
 
+        // Static scenery is registered once as render proxies
+        RenderObject ground;
+        ground.mesh = m_planeMesh;
+        ground.material = m_matGround;
+        ground.worldMatrix = Quark::Mat4::Translation(Quark::Vec3(0,-0.1f,0));
+        ground.flags = RenderObjectFlags::STATIC | RenderObjectFlags::VISIBLE | RenderObjectFlags::CAST_SHADOW | RenderObjectFlags::RECEIVE_SHADOW;
+        m_groundProxy = m_rs->createRenderProxy(ground);
+
         resetGame();
     }
 
@@ -622,6 +632,7 @@ public:
         m_enemies.clear();
         m_projectiles.clear();
         m_pickups.clear();
+        for (const auto& o : m_obstacles) m_rs->destroyRenderProxy(o.proxy);
         m_obstacles.clear();
         
         // Create Map (Barriers)
@@ -632,6 +643,14 @@ public:
             o.size = size; // Half-Extents
             o.mesh = m_cubeMesh;
             o.material = m_matObstacle;
+
+            RenderObject ro;
+            ro.mesh = o.mesh;
+            ro.material = o.material;
+            ro.worldMatrix = Quark::Mat4::Translation(o.position) * Quark::Mat4::Scaling(o.size * 2.0f); // o.size is half-extent, box mesh is unit size
+            ro.flags = RenderObjectFlags::STATIC | RenderObjectFlags::VISIBLE | RenderObjectFlags::CAST_SHADOW | RenderObjectFlags::RECEIVE_SHADOW;
+            o.proxy = m_rs->createRenderProxy(ro);
+
             m_obstacles.push_back(o);
         };
         
@@ -1160,13 +1179,8 @@ public:
     void render() {
         RenderObjectFlags noCull = RenderObjectFlags::VISIBLE | RenderObjectFlags::CAST_SHADOW | RenderObjectFlags::RECEIVE_SHADOW;
 
-        // Render Ground
+        // Ground and obstacles are render proxies (see init / resetGame)
         RenderObject ro;
-        ro.mesh = m_planeMesh;
-        ro.material = m_matGround;
-        ro.worldMatrix = Quark::Mat4::Translation(Quark::Vec3(0,-0.1f,0));
-        ro.flags = noCull; 
-        m_rs->submit(ro);
 
         // Render Enemies
         for (const auto& e : m_enemies) {
@@ -1220,18 +1234,6 @@ public:
             ro.flags = noCull;
             m_rs->submit(ro);
         }
-
-        // Render Obstacles
-        for (const auto& o : m_obstacles) {
-            ro.mesh = o.mesh;
-            ro.material = o.material;
-            ro.worldMatrix = Quark::Mat4::Translation(o.position) * Quark::Mat4::Scaling(o.size * 2.0f); // Scaling is full size, o.size is half-extent? Check logic.
-            // CreateBoxMesh(1,1,1) -> Bounds -0.5 to 0.5. Size 1.
-            // If o.size is half-extent (e.g., 2,2,2), full size is 4. So Scale(4).
-            // o.size * 2.0f.
-            ro.flags = noCull;
-            m_rs->submit(ro);
-        }
     }
 
     void renderUI() {
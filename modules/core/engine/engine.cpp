@@ -10,19 +10,33 @@ Engine::Engine()
     , m_runningPlatform(RunningPlatform::NONE)
     , m_renderingBackend(RenderingBackend::NONE)
     , m_pWindow(nullptr)
+    , m_pProfiler(new Quark::Profiler())
     , m_pModuleManager(new ModuleManager())
+    , m_pJobSystem(new JobSystem())
     , m_pRenderSystem(nullptr)
     , m_pRHI(nullptr)
+    , m_isRenderThreadEnabled(false)
+    , m_pRenderThread(nullptr)
+    , m_isFrameCaptureEnabled(false)
+    , m_pFrameCapture(nullptr)
 #ifdef _WIN32
     , m_isWindowsDefaultCPPConsoleActive(true)
 #endif
 {
+    Quark::setModuleProfiler(m_pProfiler, "engine");
 }
 
 Engine::~Engine()
 {
     delete m_pModuleManager;
     m_pModuleManager = nullptr;
+
+    delete m_pJobSystem;
+    m_pJobSystem = nullptr;
+
+    Quark::setModuleProfiler(nullptr, "engine");
+    delete m_pProfiler;
+    m_pProfiler = nullptr;
 }
 
 void Engine::engineInit(
@@ -53,6 +67,8 @@ void Engine::engineInit(
         engineShutdown();
         return;
     }
+    m_pRenderSystem->setJobSystem(m_pJobSystem);
+    m_pRenderSystem->setProfiler(m_pProfiler);
 
     if (m_renderingBackend == RenderingBackend::RS_D3D11)
     {
@@ -63,6 +79,49 @@ void Engine::engineInit(
             engineShutdown();
             return;
         }
+        if (m_pModuleManager->fnSetProfiler_D3D11)
+            m_pModuleManager->fnSetProfiler_D3D11(m_pProfiler);
+    }
+    else if (m_renderingBackend == RenderingBackend::NONE)
+    {
+        // Headless: full render pipeline, no GPU
+        m_pRHI = m_pModuleManager->fnCreateRenderBackend_Null
+            ? m_pModuleManager->fnCreateRenderBackend_Null()
+            : nullptr;
+        if (!m_pRHI)
+        {
+            std::cerr << "Null backend creation failed!\n";
+            engineShutdown();
+            return;
+        }
+    }
+    else if (m_renderingBackend == RenderingBackend::RS_SOFTWARE)
+    {
+        m_pRHI = m_pModuleManager->fnCreateRenderBackend_Software
+            ? m_pModuleManager->fnCreateRenderBackend_Software()
+            : nullptr;
+        if (!m_pRHI)
+        {
+            std::cerr << "Software backend creation failed!\n";
+            engineShutdown();
+            return;
+        }
+        // Binning and tile jobs go to the engine workers instead of private threads
+        m_pModuleManager->fnSetJobSystem_Software(m_pRHI, m_pJobSystem);
+        if (m_pModuleManager->fnSetProfiler_Software)
+            m_pModuleManager->fnSetProfiler_Software(m_pProfiler);
+    }
+
+    // The render system talks to the render thread, which owns the backend from here on
+    if (m_pRHI && m_isRenderThreadEnabled)
+    {
+        m_pRenderThread = new RenderThread(m_pRHI);
+        m_pRenderThread->start();
+    }
+
+    if (m_pRHI && m_isFrameCaptureEnabled)
+    {
+        m_pFrameCapture = new FrameCapture(m_pRenderThread ? static_cast<RHI*>(m_pRenderThread) : m_pRHI);
     }
 
     if (m_engineMode == EngineMode::WITH_EDITOR)
@@ -92,11 +151,14 @@ void Engine::engineInit(
         );
 #endif
 
-        //m_pRenderSystem->renderSystemInit(
-        //    m_pRHI,
-        //    m_pWindow->getWindowHandler(),
-        //    m_pWindow->getWindowInstance()
-        //);
+        if (m_pRHI)
+        {
+            RHI* rhi = m_pRHI;
+            if (m_pRenderThread) rhi = m_pRenderThread;
+            if (m_pFrameCapture) rhi = m_pFrameCapture;
+
+            m_pRenderSystem->init(rhi, m_pWindow->getWindowHandler());
+        }
 
         m_isRunning = true;
         engineRun();
@@ -107,11 +169,20 @@ void Engine::engineRun()
 {
     while (m_isRunning)
     {
+        QUARK_PROFILE_FRAME("Frame");
+
         if (m_pWindow)
+        {
+            QUARK_PROFILE_ZONE("Window::pollMessages");
             m_pWindow->pollMessages();
+        }
 
-        if (m_pRenderSystem)
-            //m_pRenderSystem->renderFrame();
+        // With the render thread enabled this only builds and queues the packet
+        if (m_pRenderSystem && m_pRHI && m_pRenderSystem->getActiveCamera())
+        {
+            m_pRenderSystem->renderFrame();
+            m_pRenderSystem->endFrame();
+        }
 
 #ifdef _WIN32
         Sleep(16);
@@ -133,13 +204,34 @@ void Engine::engineShutdown()
 
     if (m_pRenderSystem)
     {
+        m_pRenderSystem->shutdown();
         m_pModuleManager->fnDestroyRenderSystem(m_pRenderSystem);
         m_pRenderSystem = nullptr;
     }
 
+    // Closes a capture still in progress
+    if (m_pFrameCapture)
+    {
+        delete m_pFrameCapture;
+        m_pFrameCapture = nullptr;
+    }
+
+    // Drains the queued commands before the backend goes away
+    if (m_pRenderThread)
+    {
+        m_pRenderThread->stop();
+        delete m_pRenderThread;
+        m_pRenderThread = nullptr;
+    }
+
     if (m_pRHI)
     {
-        m_pModuleManager->fnDestroyRenderBackend_D3D11(m_pRHI);
+        if (m_renderingBackend == RenderingBackend::NONE)
+            m_pModuleManager->fnDestroyRenderBackend_Null(m_pRHI);
+        else if (m_renderingBackend == RenderingBackend::RS_SOFTWARE)
+            m_pModuleManager->fnDestroyRenderBackend_Software(m_pRHI);
+        else
+            m_pModuleManager->fnDestroyRenderBackend_D3D11(m_pRHI);
         m_pRHI = nullptr;
     }
 
@@ -159,6 +251,63 @@ void Engine::onWindowEvent(UINT, WPARAM, LPARAM)
 }
 #endif
 
+void Engine::setRenderThreadEnabled(bool enabled)
+{
+    m_isRenderThreadEnabled = enabled;
+}
+
+bool Engine::isRenderThreadEnabled() const
+{
+    return m_isRenderThreadEnabled;
+}
+
+RenderThreadStats Engine::getRenderThreadStats() const
+{
+    if (!m_pRenderThread) return RenderThreadStats{};
+    return m_pRenderThread->getStats();
+}
+
+void Engine::setFrameCaptureEnabled(bool enabled)
+{
+    m_isFrameCaptureEnabled = enabled;
+}
+
+bool Engine::isFrameCaptureEnabled() const
+{
+    return m_isFrameCaptureEnabled;
+}
+
+bool Engine::beginFrameCapture(const char* filename, UINT32 frameCount)
+{
+    if (!m_pFrameCapture)
+    {
+        std::cerr << "Frame capture is not enabled!\n";
+        return false;
+    }
+    return m_pFrameCapture->beginCapture(filename, frameCount);
+}
+
+void Engine::endFrameCapture()
+{
+    if (m_pFrameCapture)
+        m_pFrameCapture->endCapture();
+}
+
+bool Engine::isFrameCaptureActive() const
+{
+    return m_pFrameCapture && m_pFrameCapture->isCapturing();
+}
+
+JobSystemAPI* Engine::getJobSystem()
+{
+    return m_pJobSystem;
+}
+
+Quark::Profiler* Engine::getProfiler()
+{
+    return m_pProfiler;
+}
+
 void Engine::onWindowClose()
 {
 #ifdef _WIN32
@@ -12,8 +12,12 @@
 #include "engineapi.h"
 #include "modulemanager/modulemanager.h"
 #include "window/window.h"
+#include "renderthread/renderthread.h"
+#include "framecapture/framecapture.h"
+#include "jobsystem/jobsystem.h"
 #include "enginetypes.h"
 #include "../../graphics/rendersystem/rendersystemapi.h"
+#include "../../headeronly/profiler.h"
 
 class Engine : public EngineAPI
 {
@@ -29,6 +33,19 @@ public:
 
     void engineShutdown() override;
 
+    void setRenderThreadEnabled(bool enabled) override;
+    bool isRenderThreadEnabled() const override;
+    RenderThreadStats getRenderThreadStats() const override;
+
+    void setFrameCaptureEnabled(bool enabled) override;
+    bool isFrameCaptureEnabled() const override;
+    bool beginFrameCapture(const char* filename, UINT32 frameCount) override;
+    void endFrameCapture() override;
+    bool isFrameCaptureActive() const override;
+
+    JobSystemAPI* getJobSystem() override;
+    Quark::Profiler* getProfiler() override;
+
 private:
     void engineRun();
 
@@ -48,10 +65,20 @@ private:
     RenderingBackend m_renderingBackend;
 
     Window* m_pWindow;
+    Quark::Profiler* m_pProfiler;
     ModuleManager* m_pModuleManager;
+    JobSystem* m_pJobSystem;
 
     RenderSystemAPI* m_pRenderSystem;
     RHI* m_pRHI;
+
+    // Optional, wraps m_pRHI when enabled
+    bool m_isRenderThreadEnabled;
+    RenderThread* m_pRenderThread;
+
+    // Optional, in front of the render thread (or backend) so it records on the game thread
+    bool m_isFrameCaptureEnabled;
+    FrameCapture* m_pFrameCapture;
 };
 
 // C API
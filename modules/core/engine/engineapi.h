@@ -1,12 +1,38 @@
 #pragma once
 
 #include "enginetypes.h"
+#include "jobsystem/jobsystemapi.h"
 #include "../../graphics/rendersystem/rstypes.h"
 
+namespace Quark { class Profiler; }
+
 class EngineAPI
 {
 public:
 	virtual ~EngineAPI() = default;
 	virtual void engineInit(EngineMode engineMode, RunningPlatform runningPlatform, RenderingBackend renderingBackend) = 0;
 	virtual void engineShutdown() = 0;
+
+	// Runs the render backend on its own thread, fed frame packets through a queue.
+	// Takes effect on the next engineInit.
+	virtual void setRenderThreadEnabled(bool enabled) = 0;
+	virtual bool isRenderThreadEnabled() const = 0;
+	virtual RenderThreadStats getRenderThreadStats() const = 0;
+
+	// Puts a recorder in front of the backend so frames can be captured for framereplay.
+	// Takes effect on the next engineInit, the recorder keeps a CPU copy of every mesh.
+	virtual void setFrameCaptureEnabled(bool enabled) = 0;
+	virtual bool isFrameCaptureEnabled() const = 0;
+
+	// Writes the next frameCount frames (0 = until endFrameCapture) to filename
+	virtual bool beginFrameCapture(const char* filename, UINT32 frameCount) = 0;
+	virtual void endFrameCapture() = 0;
+	virtual bool isFrameCaptureActive() const = 0;
+
+	// Shared worker pool, valid for the lifetime of the engine
+	virtual JobSystemAPI* getJobSystem() = 0;
+
+	// Shared by the engine, render system and backends. Start and stop recording with
+	// beginCapture/endCapture, then writeChromeTrace. Valid for the lifetime of the engine.
+	virtual Quark::Profiler* getProfiler() = 0;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../../headeronly/globaltypes.h"
+
 // Engine init mode
 enum class EngineMode
 {
@@ -25,5 +27,18 @@ enum class RenderingBackend
 	RS_VULKAN,
 	RS_OPENGL,
 	RS_METAL,
+	RS_SOFTWARE,	// CPU rasterizer, no GPU needed
 	NONE
+};
+
+// Render thread statistics (times in milliseconds)
+struct RenderThreadStats
+{
+	UINT32 queuedFrames;	// Packets waiting for the render thread
+	UINT32 framesExecuted;
+	UINT32 producerStalls;	// Times the game thread blocked on a full command queue
+	float stallTime;		// Total time the game thread spent blocked
+	float queueLatency;		// Last packet, from submission to the render thread picking it up
+	float executeTime;		// Last packet, backend executeFrame
+	float presentTime;		// Last endFrame
 };
\ No newline at end of file
@@ -0,0 +1,850 @@
+#include "framecapture.h"
+#include "../../../headeronly/profiler.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+static float millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static UINT32 paddedSize(UINT32 size)
+{
+    return (size + 7u) & ~7u;
+}
+
+static CaptureFileHeader makeFileHeader()
+{
+    CaptureFileHeader header = {};
+    header.magic = FRAME_CAPTURE_MAGIC;
+    header.version = FRAME_CAPTURE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.materialSize = sizeof(MaterialData);
+    header.drawCommandSize = sizeof(DrawCommand);
+    header.shadowViewSize = sizeof(ShadowView);
+    header.instanceSize = sizeof(PerInstanceData);
+    header.lightSize = sizeof(GPULightData);
+    header.constantsSize = sizeof(FrameConstants);
+    header.skySize = sizeof(SkySettings);
+    return header;
+}
+
+// Payload bytes that follow a CaptureFrameRecord
+static UINT64 framePayloadSize(const CaptureFrameRecord& frame)
+{
+    return static_cast<UINT64>(frame.drawCommandCount + frame.shadowDrawCommandCount) * sizeof(DrawCommand) +
+           static_cast<UINT64>(frame.shadowViewCount) * sizeof(ShadowView) +
+           static_cast<UINT64>(frame.instanceDataCount + frame.shadowInstanceDataCount) * sizeof(PerInstanceData) +
+           static_cast<UINT64>(frame.materialCount) * (sizeof(MaterialData) + sizeof(hMaterial)) +
+           static_cast<UINT64>(frame.lightCount) * sizeof(GPULightData) +
+           static_cast<UINT64>(frame.lightClusterCount) * sizeof(LightClusterRange) +
+           static_cast<UINT64>(frame.clusterLightIndexCount) * sizeof(UINT32);
+}
+
+// ==================== CONSTRUCTOR ====================
+FrameCapture::FrameCapture(RHI* backend)
+    : m_pBackend(backend)
+    , m_width(0)
+    , m_height(0)
+    , m_framesRequested(0)
+    , m_framesCaptured(0)
+    , m_bytesWritten(0)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    endCapture();
+}
+
+// ==================== CAPTURE ====================
+bool FrameCapture::beginCapture(const char* filename, UINT32 frameCount)
+{
+    if (!filename || isCapturing()) return false;
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        std::cerr << "[FrameCapture] ERROR: Cannot open " << filename << " for writing.\n";
+        return false;
+    }
+
+    m_framesRequested = frameCount;
+    m_framesCaptured = 0;
+    m_bytesWritten = 0;
+
+    CaptureFileHeader header = makeFileHeader();
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_bytesWritten += sizeof(header);
+
+    writeSnapshot();
+
+    std::cout << "[FrameCapture] Capturing to " << filename << "\n";
+    return true;
+}
+
+void FrameCapture::endCapture()
+{
+    if (!isCapturing()) return;
+
+    // Patch the frame count, a reader seeing 0 knows the file was not closed properly
+    CaptureFileHeader header = makeFileHeader();
+    header.frameCount = m_framesCaptured;
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    bool failed = m_file.fail();
+    m_file.close();
+
+    if (failed)
+    {
+        std::cerr << "[FrameCapture] ERROR: Write failed, the capture is incomplete.\n";
+        return;
+    }
+
+    std::cout << "[FrameCapture] Captured " << m_framesCaptured << " frames ("
+              << m_bytesWritten / 1024 << " KB).\n";
+}
+
+void FrameCapture::beginRecord(CaptureRecordType type, UINT32 size)
+{
+    CaptureRecordHeader header = { type, size };
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_bytesWritten += sizeof(header);
+}
+
+void FrameCapture::writeBytes(const void* data, UINT32 size)
+{
+    if (size == 0) return;
+    m_file.write(static_cast<const char*>(data), size);
+    m_bytesWritten += size;
+}
+
+void FrameCapture::endRecord(UINT32 size)
+{
+    static const char zeros[8] = {};
+    UINT32 padding = paddedSize(size) - size;
+    writeBytes(zeros, padding);
+}
+
+void FrameCapture::writeMesh(CaptureRecordType type, hMesh handle, const MeshData& meshData, bool isDynamic)
+{
+    CaptureMeshRecord record = {};
+    record.handle = handle;
+    record.isDynamic = isDynamic ? 1 : 0;
+    record.vertexCount = meshData.vertexCount;
+    record.indexCount = meshData.indices ? meshData.indexCount : 0;
+    record.hasIndices = meshData.indices ? 1 : 0;
+    record.boundingBox = meshData.boundingBox;
+
+    UINT32 vertexBytes = record.vertexCount * sizeof(Vertex);
+    UINT32 indexBytes = record.indexCount * sizeof(UINT32);
+    UINT32 size = sizeof(record) + vertexBytes + indexBytes;
+
+    beginRecord(type, size);
+    writeBytes(&record, sizeof(record));
+    writeBytes(meshData.vertices, vertexBytes);
+    writeBytes(meshData.indices, indexBytes);
+    endRecord(size);
+}
+
+void FrameCapture::writeSnapshot()
+{
+    // Textures first, materials bind them
+    for (const auto& [handle, path] : m_textures)
+    {
+        CaptureHandleRecord record = { handle, static_cast<UINT32>(path.size()) };
+        UINT32 size = sizeof(record) + record.value;
+        beginRecord(CaptureRecordType::LOAD_TEXTURE, size);
+        writeBytes(&record, sizeof(record));
+        writeBytes(path.data(), record.value);
+        endRecord(size);
+    }
+
+    for (const auto& [handle, mesh] : m_meshes)
+    {
+        MeshData meshData;
+        meshData.vertices = const_cast<Vertex*>(mesh.vertices.data());
+        meshData.vertexCount = static_cast<UINT32>(mesh.vertices.size());
+        meshData.indices = mesh.indices.empty() ? nullptr : const_cast<UINT32*>(mesh.indices.data());
+        meshData.indexCount = static_cast<UINT32>(mesh.indices.size());
+        meshData.boundingBox = mesh.boundingBox;
+        writeMesh(CaptureRecordType::CREATE_MESH, handle, meshData, mesh.isDynamic);
+    }
+
+    for (const auto& [handle, material] : m_materials)
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        UINT32 size = sizeof(record) + sizeof(MaterialData);
+        beginRecord(CaptureRecordType::CREATE_MATERIAL, size);
+        writeBytes(&record, sizeof(record));
+        writeBytes(&material.data, sizeof(MaterialData));
+        endRecord(size);
+
+        for (UINT32 slot = 0; slot < 6; ++slot)
+        {
+            if (material.textures[slot] == 0) continue;
+            CaptureBindRecord bind = { handle, material.textures[slot], slot, 0 };
+            beginRecord(CaptureRecordType::BIND_TEXTURE, sizeof(bind));
+            writeBytes(&bind, sizeof(bind));
+        }
+    }
+
+    if (m_width > 0 && m_height > 0)
+    {
+        CaptureResizeRecord resize = { m_width, m_height };
+        beginRecord(CaptureRecordType::RESIZE, sizeof(resize));
+        writeBytes(&resize, sizeof(resize));
+    }
+}
+
+void FrameCapture::writeFrame(const FramePacket& packet)
+{
+    QUARK_PROFILE_ZONE("FrameCapture::writeFrame");
+
+    CaptureFrameRecord frame = {};
+    frame.constants = packet.constants;
+    memcpy(frame.clearColor, packet.clearColor, sizeof(frame.clearColor));
+    frame.skySettings = packet.skySettings;
+    frame.viewportWidth = packet.viewportWidth;
+    frame.viewportHeight = packet.viewportHeight;
+    frame.drawCommandCount = packet.drawCommandCount;
+    frame.shadowDrawCommandCount = packet.shadowDrawCommandCount;
+    frame.shadowViewCount = packet.shadowViewCount;
+    frame.instanceDataCount = packet.instanceDataCount;
+    frame.shadowInstanceDataCount = packet.shadowInstanceDataCount;
+    frame.materialCount = packet.materialCount;
+    frame.lightCount = packet.lightCount;
+    frame.lightClusterCount = packet.lightClusterCount;
+    frame.clusterLightIndexCount = packet.clusterLightIndexCount;
+
+    UINT32 size = static_cast<UINT32>(sizeof(frame) + framePayloadSize(frame));
+    beginRecord(CaptureRecordType::EXECUTE_FRAME, size);
+    writeBytes(&frame, sizeof(frame));
+    writeBytes(packet.drawCommands, packet.drawCommandCount * sizeof(DrawCommand));
+    writeBytes(packet.shadowDrawCommands, packet.shadowDrawCommandCount * sizeof(DrawCommand));
+    writeBytes(packet.shadowViews, packet.shadowViewCount * sizeof(ShadowView));
+    writeBytes(packet.instanceData, packet.instanceDataCount * sizeof(PerInstanceData));
+    writeBytes(packet.shadowInstanceData, packet.shadowInstanceDataCount * sizeof(PerInstanceData));
+    writeBytes(packet.materials, packet.materialCount * sizeof(MaterialData));
+    writeBytes(packet.materialHandles, packet.materialCount * sizeof(hMaterial));
+    writeBytes(packet.lights, packet.lightCount * sizeof(GPULightData));
+    writeBytes(packet.lightClusters, packet.lightClusterCount * sizeof(LightClusterRange));
+    writeBytes(packet.clusterLightIndices, packet.clusterLightIndexCount * sizeof(UINT32));
+    endRecord(size);
+}
+
+// ==================== LIFECYCLE (RHI) ====================
+void FrameCapture::init(qWndh windowHandle)
+{
+    m_pBackend->init(windowHandle);
+}
+
+void FrameCapture::shutdown()
+{
+    endCapture();
+    m_pBackend->shutdown();
+
+    m_meshes.clear();
+    m_materials.clear();
+    m_textures.clear();
+}
+
+// ==================== GPU MESH BUFFERS ====================
+hMesh FrameCapture::createMeshBuffer(const MeshData& meshData, bool isDynamic)
+{
+    hMesh handle = m_pBackend->createMeshBuffer(meshData, isDynamic);
+    if (handle == 0) return 0;
+
+    TrackedMesh& mesh = m_meshes[handle];
+    mesh.vertices.assign(meshData.vertices, meshData.vertices + meshData.vertexCount);
+    if (meshData.indices)
+        mesh.indices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+    mesh.boundingBox = meshData.boundingBox;
+    mesh.isDynamic = isDynamic;
+
+    if (isCapturing())
+        writeMesh(CaptureRecordType::CREATE_MESH, handle, meshData, isDynamic);
+    return handle;
+}
+
+void FrameCapture::destroyMeshBuffer(hMesh handle)
+{
+    m_pBackend->destroyMeshBuffer(handle);
+    if (m_meshes.erase(handle) == 0) return;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        beginRecord(CaptureRecordType::DESTROY_MESH, sizeof(record));
+        writeBytes(&record, sizeof(record));
+    }
+}
+
+bool FrameCapture::updateMeshBuffer(hMesh handle, const MeshData& meshData)
+{
+    if (!m_pBackend->updateMeshBuffer(handle, meshData)) return false;
+
+    auto it = m_meshes.find(handle);
+    if (it == m_meshes.end()) return true;
+
+    TrackedMesh& mesh = it->second;
+    mesh.vertices.assign(meshData.vertices, meshData.vertices + meshData.vertexCount);
+    if (meshData.indices)
+        mesh.indices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+    mesh.boundingBox = meshData.boundingBox;
+
+    if (isCapturing())
+        writeMesh(CaptureRecordType::UPDATE_MESH, handle, meshData, mesh.isDynamic);
+    return true;
+}
+
+// ==================== GPU MATERIAL BUFFERS ====================
+hMaterial FrameCapture::createMaterialBuffer(const MaterialData& materialData)
+{
+    hMaterial handle = m_pBackend->createMaterialBuffer(materialData);
+    if (handle == 0) return 0;
+
+    TrackedMaterial& material = m_materials[handle];
+    material = {};
+    material.data = materialData;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        UINT32 size = sizeof(record) + sizeof(MaterialData);
+        beginRecord(CaptureRecordType::CREATE_MATERIAL, size);
+        writeBytes(&record, sizeof(record));
+        writeBytes(&materialData, sizeof(MaterialData));
+        endRecord(size);
+    }
+    return handle;
+}
+
+void FrameCapture::destroyMaterialBuffer(hMaterial handle)
+{
+    m_pBackend->destroyMaterialBuffer(handle);
+    if (m_materials.erase(handle) == 0) return;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        beginRecord(CaptureRecordType::DESTROY_MATERIAL, sizeof(record));
+        writeBytes(&record, sizeof(record));
+    }
+}
+
+bool FrameCapture::updateMaterialBuffer(hMaterial handle, const MaterialData& materialData)
+{
+    if (!m_pBackend->updateMaterialBuffer(handle, materialData)) return false;
+
+    auto it = m_materials.find(handle);
+    if (it == m_materials.end()) return true;
+    it->second.data = materialData;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        UINT32 size = sizeof(record) + sizeof(MaterialData);
+        beginRecord(CaptureRecordType::UPDATE_MATERIAL, size);
+        writeBytes(&record, sizeof(record));
+        writeBytes(&materialData, sizeof(MaterialData));
+        endRecord(size);
+    }
+    return true;
+}
+
+// ==================== TEXTURES ====================
+hTexture FrameCapture::loadTexture(const char* filename)
+{
+    hTexture handle = m_pBackend->loadTexture(filename);
+    if (handle == 0 || !filename) return handle;
+
+    // Only the path is kept, the replaying machine needs the same files
+    std::string& path = m_textures[handle];
+    path = filename;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, static_cast<UINT32>(path.size()) };
+        UINT32 size = sizeof(record) + record.value;
+        beginRecord(CaptureRecordType::LOAD_TEXTURE, size);
+        writeBytes(&record, sizeof(record));
+        writeBytes(path.data(), record.value);
+        endRecord(size);
+    }
+    return handle;
+}
+
+void FrameCapture::destroyTexture(hTexture handle)
+{
+    m_pBackend->destroyTexture(handle);
+    if (m_textures.erase(handle) == 0) return;
+
+    if (isCapturing())
+    {
+        CaptureHandleRecord record = { handle, 0 };
+        beginRecord(CaptureRecordType::DESTROY_TEXTURE, sizeof(record));
+        writeBytes(&record, sizeof(record));
+    }
+}
+
+bool FrameCapture::bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot)
+{
+    if (!m_pBackend->bindTextureToMaterial(material, texture, slot)) return false;
+
+    auto it = m_materials.find(material);
+    if (it != m_materials.end() && slot < 6)
+        it->second.textures[slot] = texture;
+
+    if (isCapturing())
+    {
+        CaptureBindRecord record = { material, texture, slot, 0 };
+        beginRecord(CaptureRecordType::BIND_TEXTURE, sizeof(record));
+        writeBytes(&record, sizeof(record));
+    }
+    return true;
+}
+
+// ==================== FRAME EXECUTION ====================
+void FrameCapture::executeFrame(const FramePacket& packet)
+{
+    // Written before the backend sees the packet, the memory is valid for the whole call
+    if (isCapturing())
+        writeFrame(packet);
+
+    m_pBackend->executeFrame(packet);
+}
+
+void FrameCapture::endFrame()
+{
+    m_pBackend->endFrame();
+
+    if (!isCapturing()) return;
+
+    beginRecord(CaptureRecordType::END_FRAME, 0);
+    m_framesCaptured++;
+    if (m_framesRequested > 0 && m_framesCaptured >= m_framesRequested)
+        endCapture();
+}
+
+UINT64 FrameCapture::getCompletedFrameFence() const
+{
+    return m_pBackend->getCompletedFrameFence();
+}
+
+void FrameCapture::waitForFrameFence(UINT64 fence)
+{
+    m_pBackend->waitForFrameFence(fence);
+}
+
+// ==================== WINDOW EVENTS ====================
+void FrameCapture::onResize(UINT32 width, UINT32 height)
+{
+    m_pBackend->onResize(width, height);
+    m_width = width;
+    m_height = height;
+
+    if (isCapturing())
+    {
+        CaptureResizeRecord record = { width, height };
+        beginRecord(CaptureRecordType::RESIZE, sizeof(record));
+        writeBytes(&record, sizeof(record));
+    }
+}
+
+// ==================== DEBUG ====================
+void* FrameCapture::getDevice() const
+{
+    return m_pBackend->getDevice();
+}
+
+void* FrameCapture::getContext() const
+{
+    return m_pBackend->getContext();
+}
+
+// ==================== FRAME REPLAYER ====================
+FrameReplayer::FrameReplayer()
+    : m_frameCount(0)
+    , m_width(0)
+    , m_height(0)
+{
+}
+
+bool FrameReplayer::load(const char* filename)
+{
+    m_data.clear();
+    m_frameCount = 0;
+    m_width = 0;
+    m_height = 0;
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        std::cerr << "[FrameReplayer] ERROR: Cannot open " << (filename ? filename : "(null)") << ".\n";
+        return false;
+    }
+
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0);
+    m_data.resize(static_cast<size_t>(fileSize));
+    if (fileSize < static_cast<std::streamsize>(sizeof(CaptureFileHeader)) ||
+        !file.read(reinterpret_cast<char*>(m_data.data()), fileSize))
+    {
+        std::cerr << "[FrameReplayer] ERROR: " << filename << " is not a capture.\n";
+        m_data.clear();
+        return false;
+    }
+
+    CaptureFileHeader header;
+    memcpy(&header, m_data.data(), sizeof(header));
+    CaptureFileHeader expected = makeFileHeader();
+    expected.frameCount = header.frameCount;
+    if (memcmp(&header, &expected, sizeof(header)) != 0)
+    {
+        std::cerr << "[FrameReplayer] ERROR: " << filename << " was captured by a build with a different format.\n";
+        m_data.clear();
+        return false;
+    }
+
+    // Validate the record chain once, replay() can then walk it without checks
+    size_t offset = sizeof(CaptureFileHeader);
+    while (offset + sizeof(CaptureRecordHeader) <= m_data.size())
+    {
+        CaptureRecordHeader record;
+        memcpy(&record, m_data.data() + offset, sizeof(record));
+        const UINT8* payload = m_data.data() + offset + sizeof(record);
+        size_t next = offset + sizeof(record) + paddedSize(record.size);
+        if (next > m_data.size()) break;
+
+        bool valid = true;
+        switch (record.type)
+        {
+        case CaptureRecordType::CREATE_MESH:
+        case CaptureRecordType::UPDATE_MESH:
+        {
+            CaptureMeshRecord mesh;
+            valid = record.size >= sizeof(mesh);
+            if (!valid) break;
+            memcpy(&mesh, payload, sizeof(mesh));
+            valid = record.size == sizeof(mesh) + static_cast<UINT64>(mesh.vertexCount) * sizeof(Vertex) +
+                                   static_cast<UINT64>(mesh.indexCount) * sizeof(UINT32);
+            break;
+        }
+        case CaptureRecordType::CREATE_MATERIAL:
+        case CaptureRecordType::UPDATE_MATERIAL:
+            valid = record.size == sizeof(CaptureHandleRecord) + sizeof(MaterialData);
+            break;
+        case CaptureRecordType::DESTROY_MESH:
+        case CaptureRecordType::DESTROY_MATERIAL:
+        case CaptureRecordType::DESTROY_TEXTURE:
+            valid = record.size == sizeof(CaptureHandleRecord);
+            break;
+        case CaptureRecordType::LOAD_TEXTURE:
+        {
+            CaptureHandleRecord texture;
+            valid = record.size >= sizeof(texture);
+            if (!valid) break;
+            memcpy(&texture, payload, sizeof(texture));
+            valid = record.size == sizeof(texture) + texture.value;
+            break;
+        }
+        case CaptureRecordType::BIND_TEXTURE:
+            valid = record.size == sizeof(CaptureBindRecord);
+            break;
+        case CaptureRecordType::RESIZE:
+        {
+            valid = record.size == sizeof(CaptureResizeRecord);
+            if (!valid || m_width > 0) break;
+            CaptureResizeRecord resize;
+            memcpy(&resize, payload, sizeof(resize));
+            m_width = resize.width;
+            m_height = resize.height;
+            break;
+        }
+        case CaptureRecordType::EXECUTE_FRAME:
+        {
+            CaptureFrameRecord frame;
+            valid = record.size >= sizeof(frame);
+            if (!valid) break;
+            memcpy(&frame, payload, sizeof(frame));
+            valid = record.size == sizeof(frame) + framePayloadSize(frame);
+            if (valid && m_width == 0)
+            {
+                m_width = frame.viewportWidth;
+                m_height = frame.viewportHeight;
+            }
+            break;
+        }
+        case CaptureRecordType::END_FRAME:
+            valid = record.size == 0;
+            if (valid) m_frameCount++;
+            break;
+        default:
+            valid = false;
+            break;
+        }
+
+        if (!valid) break;
+        offset = next;
+    }
+
+    // A capture cut short (crash, full disk) still replays up to its last complete record
+    if (offset != m_data.size())
+    {
+        std::cerr << "[FrameReplayer] WARNING: " << filename << " is truncated or corrupt after "
+                  << m_frameCount << " frames.\n";
+        m_data.resize(offset);
+    }
+
+    if (header.frameCount != 0 && header.frameCount != m_frameCount)
+    {
+        std::cerr << "[FrameReplayer] WARNING: Header lists " << header.frameCount << " frames, found "
+                  << m_frameCount << ".\n";
+    }
+
+    return true;
+}
+
+UINT32 FrameReplayer::remap(const std::unordered_map<UINT32, UINT32>& handles, UINT32 handle) const
+{
+    auto it = handles.find(handle);
+    return it != handles.end() ? it->second : 0;
+}
+
+bool FrameReplayer::replay(RHI* rhi)
+{
+    if (!rhi || m_data.empty()) return false;
+
+    m_meshes.clear();
+    m_materials.clear();
+    m_textures.clear();
+    m_timings.clear();
+    m_timings.reserve(m_frameCount);
+
+    // Handles are rewritten in place, a working copy keeps the capture replayable
+    std::vector<UINT8> data = m_data;
+    UINT64 fence = rhi->getCompletedFrameFence();
+    ReplayFrameTiming timing = {};
+    auto frameStart = std::chrono::steady_clock::now();
+    QUARK_PROFILE_FRAME("Frame");
+
+    size_t offset = sizeof(CaptureFileHeader);
+    while (offset < data.size())
+    {
+        CaptureRecordHeader record;
+        memcpy(&record, data.data() + offset, sizeof(record));
+        UINT8* payload = data.data() + offset + sizeof(record);
+        offset += sizeof(record) + paddedSize(record.size);
+
+        switch (record.type)
+        {
+        case CaptureRecordType::CREATE_MESH:
+        case CaptureRecordType::UPDATE_MESH:
+        {
+            CaptureMeshRecord mesh;
+            memcpy(&mesh, payload, sizeof(mesh));
+
+            MeshData meshData;
+            meshData.vertices = reinterpret_cast<Vertex*>(payload + sizeof(mesh));
+            meshData.vertexCount = mesh.vertexCount;
+            meshData.indices = mesh.hasIndices ? reinterpret_cast<UINT32*>(meshData.vertices + mesh.vertexCount) : nullptr;
+            meshData.indexCount = mesh.indexCount;
+            meshData.boundingBox = mesh.boundingBox;
+
+            if (record.type == CaptureRecordType::CREATE_MESH)
+                m_meshes[mesh.handle] = rhi->createMeshBuffer(meshData, mesh.isDynamic != 0);
+            else
+                rhi->updateMeshBuffer(remap(m_meshes, mesh.handle), meshData);
+            break;
+        }
+        case CaptureRecordType::DESTROY_MESH:
+        {
+            CaptureHandleRecord handle;
+            memcpy(&handle, payload, sizeof(handle));
+            rhi->destroyMeshBuffer(remap(m_meshes, handle.handle));
+            m_meshes.erase(handle.handle);
+            break;
+        }
+        case CaptureRecordType::CREATE_MATERIAL:
+        case CaptureRecordType::UPDATE_MATERIAL:
+        {
+            CaptureHandleRecord handle;
+            MaterialData material;
+            memcpy(&handle, payload, sizeof(handle));
+            memcpy(&material, payload + sizeof(handle), sizeof(material));
+
+            if (record.type == CaptureRecordType::CREATE_MATERIAL)
+                m_materials[handle.handle] = rhi->createMaterialBuffer(material);
+            else
+                rhi->updateMaterialBuffer(remap(m_materials, handle.handle), material);
+            break;
+        }
+        case CaptureRecordType::DESTROY_MATERIAL:
+        {
+            CaptureHandleRecord handle;
+            memcpy(&handle, payload, sizeof(handle));
+            rhi->destroyMaterialBuffer(remap(m_materials, handle.handle));
+            m_materials.erase(handle.handle);
+            break;
+        }
+        case CaptureRecordType::LOAD_TEXTURE:
+        {
+            CaptureHandleRecord handle;
+            memcpy(&handle, payload, sizeof(handle));
+            std::string path(reinterpret_cast<const char*>(payload + sizeof(handle)), handle.value);
+            m_textures[handle.handle] = rhi->loadTexture(path.c_str());
+            break;
+        }
+        case CaptureRecordType::DESTROY_TEXTURE:
+        {
+            CaptureHandleRecord handle;
+            memcpy(&handle, payload, sizeof(handle));
+            rhi->destroyTexture(remap(m_textures, handle.handle));
+            m_textures.erase(handle.handle);
+            break;
+        }
+        case CaptureRecordType::BIND_TEXTURE:
+        {
+            CaptureBindRecord bind;
+            memcpy(&bind, payload, sizeof(bind));
+            rhi->bindTextureToMaterial(remap(m_materials, bind.material), remap(m_textures, bind.texture), bind.slot);
+            break;
+        }
+        case CaptureRecordType::RESIZE:
+        {
+            CaptureResizeRecord resize;
+            memcpy(&resize, payload, sizeof(resize));
+            rhi->onResize(resize.width, resize.height);
+            break;
+        }
+        case CaptureRecordType::EXECUTE_FRAME:
+        {
+            CaptureFrameRecord frame;
+            memcpy(&frame, payload, sizeof(frame));
+            UINT8* cursor = payload + sizeof(frame);
+
+            FramePacket packet = {};
+            packet.frameFence = ++fence;
+            packet.constants = frame.constants;
+            memcpy(packet.clearColor, frame.clearColor, sizeof(packet.clearColor));
+            packet.skySettings = frame.skySettings;
+            packet.viewportWidth = frame.viewportWidth;
+            packet.viewportHeight = frame.viewportHeight;
+
+            packet.drawCommands = reinterpret_cast<DrawCommand*>(cursor);
+            packet.drawCommandCount = frame.drawCommandCount;
+            cursor += frame.drawCommandCount * sizeof(DrawCommand);
+            packet.shadowDrawCommands = reinterpret_cast<DrawCommand*>(cursor);
+            packet.shadowDrawCommandCount = frame.shadowDrawCommandCount;
+            cursor += frame.shadowDrawCommandCount * sizeof(DrawCommand);
+            packet.shadowViews = reinterpret_cast<ShadowView*>(cursor);
+            packet.shadowViewCount = frame.shadowViewCount;
+            cursor += frame.shadowViewCount * sizeof(ShadowView);
+            packet.instanceData = reinterpret_cast<PerInstanceData*>(cursor);
+            packet.instanceDataCount = frame.instanceDataCount;
+            cursor += frame.instanceDataCount * sizeof(PerInstanceData);
+            packet.shadowInstanceData = reinterpret_cast<PerInstanceData*>(cursor);
+            packet.shadowInstanceDataCount = frame.shadowInstanceDataCount;
+            cursor += frame.shadowInstanceDataCount * sizeof(PerInstanceData);
+            packet.materials = reinterpret_cast<MaterialData*>(cursor);
+            cursor += frame.materialCount * sizeof(MaterialData);
+            packet.materialHandles = reinterpret_cast<hMaterial*>(cursor);
+            packet.materialCount = frame.materialCount;
+            cursor += frame.materialCount * sizeof(hMaterial);
+            packet.lights = reinterpret_cast<GPULightData*>(cursor);
+            packet.lightCount = frame.lightCount;
+            cursor += frame.lightCount * sizeof(GPULightData);
+            packet.lightClusters = reinterpret_cast<LightClusterRange*>(cursor);
+            packet.lightClusterCount = frame.lightClusterCount;
+            cursor += frame.lightClusterCount * sizeof(LightClusterRange);
+            packet.clusterLightIndices = reinterpret_cast<UINT32*>(cursor);
+            packet.clusterLightIndexCount = frame.clusterLightIndexCount;
+
+            for (UINT32 i = 0; i < packet.drawCommandCount; ++i)
+            {
+                packet.drawCommands[i].mesh = remap(m_meshes, packet.drawCommands[i].mesh);
+                packet.drawCommands[i].material = remap(m_materials, packet.drawCommands[i].material);
+            }
+            for (UINT32 i = 0; i < packet.shadowDrawCommandCount; ++i)
+            {
+                packet.shadowDrawCommands[i].mesh = remap(m_meshes, packet.shadowDrawCommands[i].mesh);
+                packet.shadowDrawCommands[i].material = remap(m_materials, packet.shadowDrawCommands[i].material);
+            }
+            for (UINT32 i = 0; i < packet.materialCount; ++i)
+            {
+                packet.materialHandles[i] = remap(m_materials, packet.materialHandles[i]);
+            }
+
+            timing.drawCalls = packet.drawCommandCount;
+            timing.instances = packet.instanceDataCount;
+
+            // The working copy outlives the replay, packets never need to wait on their fence
+            QUARK_PROFILE_ZONE("FrameReplayer::executeFrame");
+            auto start = std::chrono::steady_clock::now();
+            rhi->executeFrame(packet);
+            timing.executeTime = millisecondsSince(start);
+            break;
+        }
+        case CaptureRecordType::END_FRAME:
+        {
+            {
+                QUARK_PROFILE_ZONE("FrameReplayer::endFrame");
+                auto start = std::chrono::steady_clock::now();
+                rhi->endFrame();
+                timing.endFrameTime = millisecondsSince(start);
+            }
+            timing.frameTime = millisecondsSince(frameStart);
+            m_timings.push_back(timing);
+
+            timing = {};
+            frameStart = std::chrono::steady_clock::now();
+            QUARK_PROFILE_FRAME("Frame");
+            break;
+        }
+        }
+    }
+
+    rhi->waitForFrameFence(fence);
+
+    for (const auto& [captured, handle] : m_meshes) rhi->destroyMeshBuffer(handle);
+    for (const auto& [captured, handle] : m_materials) rhi->destroyMaterialBuffer(handle);
+    for (const auto& [captured, handle] : m_textures) rhi->destroyTexture(handle);
+    m_meshes.clear();
+    m_materials.clear();
+    m_textures.clear();
+
+    return true;
+}
+
+ReplayStats FrameReplayer::getStats() const
+{
+    ReplayStats stats = {};
+    stats.frames = static_cast<UINT32>(m_timings.size());
+    if (stats.frames == 0) return stats;
+
+    std::vector<float> frameTimes(stats.frames);
+    stats.minFrameTime = m_timings[0].frameTime;
+    for (UINT32 i = 0; i < stats.frames; ++i)
+    {
+        float frameTime = m_timings[i].frameTime;
+        frameTimes[i] = frameTime;
+        stats.totalTime += frameTime;
+        stats.minFrameTime = std::min(stats.minFrameTime, frameTime);
+        if (frameTime > stats.maxFrameTime)
+        {
+            stats.maxFrameTime = frameTime;
+            stats.slowestFrame = i;
+        }
+    }
+    stats.avgFrameTime = stats.totalTime / static_cast<float>(stats.frames);
+
+    // Nearest rank
+    UINT32 rank = (stats.frames * 95 + 99) / 100;
+    std::nth_element(frameTimes.begin(), frameTimes.begin() + (rank - 1), frameTimes.end());
+    stats.p95FrameTime = frameTimes[rank - 1];
+    return stats;
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+
+#include "../../../headeronly/globaltypes.h"
+#include "../../../graphics/rendersystem/rhi.h"
+
+// ==================== CAPTURE FILE FORMAT ====================
+// A capture is a header followed by records, each a CaptureRecordHeader and
+// `size` bytes of payload (padded to 8 bytes). Structs are stored raw, so a
+// capture only replays in a build with the same struct layouts; the header
+// keeps their sizes to reject anything else.
+constexpr UINT32 FRAME_CAPTURE_MAGIC = 0x50434651;   // "QFCP"
+constexpr UINT32 FRAME_CAPTURE_VERSION = 2;   // 2: light clusters
+
+enum class CaptureRecordType : UINT32
+{
+    CREATE_MESH = 1,      // CaptureMeshRecord, vertices, indices
+    UPDATE_MESH,          // CaptureMeshRecord, vertices, indices
+    DESTROY_MESH,         // CaptureHandleRecord
+    CREATE_MATERIAL,      // CaptureHandleRecord, MaterialData
+    UPDATE_MATERIAL,      // CaptureHandleRecord, MaterialData
+    DESTROY_MATERIAL,     // CaptureHandleRecord
+    LOAD_TEXTURE,         // CaptureHandleRecord (value = path length), path
+    DESTROY_TEXTURE,      // CaptureHandleRecord
+    BIND_TEXTURE,         // CaptureBindRecord
+    RESIZE,               // CaptureResizeRecord
+    EXECUTE_FRAME,        // CaptureFrameRecord, then the packet arrays in field order
+    END_FRAME             // No payload
+};
+
+struct CaptureFileHeader
+{
+    UINT32 magic;
+    UINT32 version;
+    UINT32 vertexSize;
+    UINT32 materialSize;
+    UINT32 drawCommandSize;
+    UINT32 shadowViewSize;
+    UINT32 instanceSize;
+    UINT32 lightSize;
+    UINT32 constantsSize;
+    UINT32 skySize;
+    UINT32 frameCount;    // Written when the capture ends, 0 if it was cut short
+    UINT32 _pad;
+};
+
+struct CaptureRecordHeader
+{
+    CaptureRecordType type;
+    UINT32 size;
+};
+
+struct CaptureHandleRecord
+{
+    UINT32 handle;
+    UINT32 value;
+};
+
+struct CaptureMeshRecord
+{
+    hMesh handle;
+    UINT32 isDynamic;
+    UINT32 vertexCount;
+    UINT32 indexCount;
+    UINT32 hasIndices;    // Updates may leave the index buffer alone
+    UINT32 _pad;
+    Quark::AABB boundingBox;
+};
+
+struct CaptureBindRecord
+{
+    hMaterial material;
+    hTexture texture;
+    UINT32 slot;
+    UINT32 _pad;
+};
+
+struct CaptureResizeRecord
+{
+    UINT32 width;
+    UINT32 height;
+};
+
+struct CaptureFrameRecord
+{
+    FrameConstants constants;
+    float clearColor[4];
+    SkySettings skySettings;
+    UINT32 viewportWidth;
+    UINT32 viewportHeight;
+    UINT32 drawCommandCount;
+    UINT32 shadowDrawCommandCount;
+    UINT32 shadowViewCount;
+    UINT32 instanceDataCount;
+    UINT32 shadowInstanceDataCount;
+    UINT32 materialCount;
+    UINT32 lightCount;
+    UINT32 lightClusterCount;
+    UINT32 clusterLightIndexCount;
+};
+
+// ==================== FRAME CAPTURE ====================
+// RHI that forwards every call to a backend and, while a capture is running,
+// serializes the calls to a file: resource creation and updates, resizes and
+// every FramePacket with its arrays.
+//
+// Live resources are tracked from the moment the wrapper is installed (mesh
+// data is kept in CPU memory), so a capture can start at any frame: it opens
+// with a snapshot of the resources alive at that point. Handles are stored as
+// the backend returned them and remapped on replay.
+class FrameCapture : public RHI
+{
+private:
+    struct TrackedMesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<UINT32> indices;
+        Quark::AABB boundingBox;
+        bool isDynamic;
+    };
+
+    struct TrackedMaterial
+    {
+        MaterialData data;
+        hTexture textures[6];
+    };
+
+    RHI* m_pBackend;
+
+    std::unordered_map<hMesh, TrackedMesh> m_meshes;
+    std::unordered_map<hMaterial, TrackedMaterial> m_materials;
+    std::unordered_map<hTexture, std::string> m_textures;
+    UINT32 m_width;
+    UINT32 m_height;
+
+    std::ofstream m_file;
+    UINT32 m_framesRequested;   // 0 = until endCapture()
+    UINT32 m_framesCaptured;
+    UINT64 m_bytesWritten;
+
+    // A record is beginRecord(), writeBytes() adding up to size, endRecord()
+    void beginRecord(CaptureRecordType type, UINT32 size);
+    void writeBytes(const void* data, UINT32 size);
+    void endRecord(UINT32 size);
+    void writeMesh(CaptureRecordType type, hMesh handle, const MeshData& meshData, bool isDynamic);
+    void writeSnapshot();
+    void writeFrame(const FramePacket& packet);
+
+public:
+    explicit FrameCapture(RHI* backend);
+    ~FrameCapture() override;
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Starts writing to filename, frameCount frames (0 = until endCapture())
+    bool beginCapture(const char* filename, UINT32 frameCount);
+    void endCapture();
+    bool isCapturing() const { return m_file.is_open(); }
+    UINT32 getCapturedFrameCount() const { return m_framesCaptured; }
+    UINT64 getCapturedBytes() const { return m_bytesWritten; }
+
+    // ==================== RHI INTERFACE ====================
+    void init(qWndh windowHandle) override;
+    void shutdown() override;
+
+    hMesh createMeshBuffer(const MeshData& meshData, bool isDynamic) override;
+    void destroyMeshBuffer(hMesh handle) override;
+    bool updateMeshBuffer(hMesh handle, const MeshData& meshData) override;
+
+    hMaterial createMaterialBuffer(const MaterialData& materialData) override;
+    void destroyMaterialBuffer(hMaterial handle) override;
+    bool updateMaterialBuffer(hMaterial handle, const MaterialData& materialData) override;
+
+    hTexture loadTexture(const char* filename) override;
+    void destroyTexture(hTexture handle) override;
+    bool bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot) override;
+
+    void executeFrame(const FramePacket& packet) override;
+    void endFrame() override;
+    UINT64 getCompletedFrameFence() const override;
+    void waitForFrameFence(UINT64 fence) override;
+
+    void onResize(UINT32 width, UINT32 height) override;
+
+    void* getDevice() const override;
+    void* getContext() const override;
+};
+
+// ==================== FRAME REPLAYER ====================
+struct ReplayFrameTiming
+{
+    float executeTime;    // Backend executeFrame
+    float endFrameTime;   // Backend endFrame
+    float frameTime;      // From the previous endFrame, includes the frame's resource calls
+    UINT32 drawCalls;
+    UINT32 instances;
+};
+
+struct ReplayStats
+{
+    UINT32 frames;
+    float totalTime;
+    float minFrameTime;
+    float avgFrameTime;
+    float p95FrameTime;
+    float maxFrameTime;
+    UINT32 slowestFrame;
+};
+
+// Feeds a capture into any RHI as fast as the backend takes it. Packets point
+// straight into a copy of the loaded file, handles are remapped to the ones the
+// backend returns, and fences are renumbered after the backend's current fence.
+class FrameReplayer
+{
+private:
+    std::vector<UINT8> m_data;
+    UINT32 m_frameCount;
+    UINT32 m_width;
+    UINT32 m_height;
+
+    std::unordered_map<UINT32, hMesh> m_meshes;
+    std::unordered_map<UINT32, hMaterial> m_materials;
+    std::unordered_map<UINT32, hTexture> m_textures;
+    std::vector<ReplayFrameTiming> m_timings;
+
+    UINT32 remap(const std::unordered_map<UINT32, UINT32>& handles, UINT32 handle) const;
+
+public:
+    FrameReplayer();
+
+    bool load(const char* filename);
+
+    // The backend must be initialized. Resources the capture created are destroyed at the end.
+    bool replay(RHI* rhi);
+
+    UINT32 getFrameCount() const { return m_frameCount; }
+    UINT32 getWidth() const { return m_width; }     // First resize in the capture
+    UINT32 getHeight() const { return m_height; }
+    const std::vector<ReplayFrameTiming>& getFrameTimings() const { return m_timings; }
+    ReplayStats getStats() const;
+};
@@ -0,0 +1,290 @@
+#include "jobsystem.h"
+#include "../../../headeronly/profiler.h"
+#include <algorithm>
+
+constexpr UINT32 JOB_QUEUE_INITIAL_SIZE = 256;
+constexpr UINT32 JOB_IDLE_SPINS = 64;
+
+// Which system and deque the current thread belongs to, outside threads use deque 0
+static thread_local const JobSystem* t_pJobSystem = nullptr;
+static thread_local UINT32 t_queueIndex = 0;
+
+// ==================== CONSTRUCTOR ====================
+JobSystem::JobSystem(UINT32 threadCount)
+    : m_queueCount(0)
+    , m_heldCount(0)
+    , m_epoch(0)
+    , m_quit(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    m_queueCount = (std::max)(threadCount, 1u);
+
+    m_queues = std::make_unique<WorkQueue[]>(m_queueCount);
+    for (UINT32 i = 0; i < m_queueCount; ++i)
+    {
+        m_queues[i].ring.resize(JOB_QUEUE_INITIAL_SIZE);
+    }
+
+    m_workers.reserve(m_queueCount - 1);
+    for (UINT32 i = 1; i < m_queueCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    m_quit = true;
+    wake(true);
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+UINT32 JobSystem::getThreadCount() const
+{
+    return m_queueCount;
+}
+
+UINT32 JobSystem::currentQueue() const
+{
+    return t_pJobSystem == this ? t_queueIndex : 0;
+}
+
+// ==================== SUBMISSION ====================
+void JobSystem::run(const JobDecl& decl, JobCounter* counter, const JobCounter* dependency)
+{
+    if (decl.count == 0) return;
+
+    Job job = {};
+    job.function = decl.function;
+    job.context = decl.context;
+    job.begin = 0;
+    job.end = decl.count;
+    job.minChunk = decl.minChunk > 0 ? decl.minChunk : 1;
+    job.counter = counter;
+
+    if (counter)
+    {
+        counter->pending.fetch_add(1);
+    }
+
+    if (dependency && !dependency->isDone())
+    {
+        // Publish the held count before re-checking the dependency: either we see it
+        // done here, or the thread finishing it sees a held job and releases it
+        std::lock_guard<std::mutex> lock(m_heldMutex);
+        m_heldCount.fetch_add(1);
+        if (dependency->pending.load() != 0)
+        {
+            m_heldJobs.push_back({ job, dependency });
+            return;
+        }
+        m_heldCount.fetch_sub(1);
+    }
+
+    pushJob(currentQueue(), job);
+}
+
+void JobSystem::wait(const JobCounter* counter)
+{
+    if (!counter) return;
+
+    const UINT32 queueIndex = currentQueue();
+    UINT32 spins = 0;
+
+    while (!counter->isDone())
+    {
+        UINT32 epoch = m_epoch.load();
+
+        Job job;
+        if (findJob(queueIndex, job))
+        {
+            executeJob(job, queueIndex);
+            spins = 0;
+            continue;
+        }
+
+        if (counter->isDone()) break;
+
+        // The last slices are running elsewhere, sleep until something changes
+        if (++spins < JOB_IDLE_SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        m_epoch.wait(epoch);
+    }
+}
+
+// ==================== WORKERS ====================
+void JobSystem::workerLoop(UINT32 queueIndex)
+{
+    t_pJobSystem = this;
+    t_queueIndex = queueIndex;
+    QUARK_PROFILE_THREAD("Job Worker");
+
+    UINT32 spins = 0;
+    while (!m_quit.load(std::memory_order_relaxed))
+    {
+        UINT32 epoch = m_epoch.load();
+
+        Job job;
+        if (findJob(queueIndex, job))
+        {
+            executeJob(job, queueIndex);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < JOB_IDLE_SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        m_epoch.wait(epoch);
+    }
+}
+
+void JobSystem::executeJob(Job& job, UINT32 queueIndex)
+{
+    // Lazy binary splitting: hand out the upper half while our own deque is empty
+    if (!m_workers.empty())
+    {
+        while (job.end - job.begin > job.minChunk && m_queues[queueIndex].size.load(std::memory_order_relaxed) == 0)
+        {
+            Job upper = job;
+            upper.begin = job.begin + (job.end - job.begin) / 2;
+            job.end = upper.begin;
+
+            if (job.counter)
+            {
+                job.counter->pending.fetch_add(1);
+            }
+            pushJob(queueIndex, upper);
+        }
+    }
+
+    {
+        QUARK_PROFILE_ZONE("Job");
+        job.function(job.context, job.begin, job.end);
+    }
+    finishJob(job.counter, queueIndex);
+}
+
+void JobSystem::finishJob(JobCounter* counter, UINT32 queueIndex)
+{
+    if (!counter || counter->pending.fetch_sub(1) != 1) return;
+
+    if (m_heldCount.load() > 0)
+    {
+        releaseHeldJobs(queueIndex);
+    }
+
+    // Waiters sleep on the epoch too
+    wake(true);
+}
+
+void JobSystem::releaseHeldJobs(UINT32 queueIndex)
+{
+    std::lock_guard<std::mutex> lock(m_heldMutex);
+
+    for (size_t i = 0; i < m_heldJobs.size();)
+    {
+        if (m_heldJobs[i].dependency->isDone())
+        {
+            pushJob(queueIndex, m_heldJobs[i].job);
+            m_heldJobs[i] = m_heldJobs.back();
+            m_heldJobs.pop_back();
+            m_heldCount.fetch_sub(1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void JobSystem::wake(bool all)
+{
+    m_epoch.fetch_add(1);
+    if (all)
+        m_epoch.notify_all();
+    else
+        m_epoch.notify_one();
+}
+
+// ==================== DEQUES ====================
+void JobSystem::pushJob(UINT32 queueIndex, const Job& job)
+{
+    WorkQueue& queue = m_queues[queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        UINT32 size = queue.size.load(std::memory_order_relaxed);
+        UINT32 capacity = static_cast<UINT32>(queue.ring.size());
+        if (size == capacity)
+        {
+            // Unroll the ring into a buffer twice as large
+            std::vector<Job> grown(capacity * 2);
+            for (UINT32 i = 0; i < size; ++i)
+            {
+                grown[i] = queue.ring[(queue.head + i) % capacity];
+            }
+            queue.ring.swap(grown);
+            queue.head = 0;
+            capacity *= 2;
+        }
+
+        queue.ring[(queue.head + size) % capacity] = job;
+        queue.size.store(size + 1, std::memory_order_relaxed);
+    }
+    wake(false);
+}
+
+bool JobSystem::popJob(UINT32 queueIndex, Job& job)
+{
+    WorkQueue& queue = m_queues[queueIndex];
+    if (queue.size.load(std::memory_order_relaxed) == 0) return false;
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    UINT32 size = queue.size.load(std::memory_order_relaxed);
+    if (size == 0) return false;
+
+    // Owner side: newest job
+    const UINT32 capacity = static_cast<UINT32>(queue.ring.size());
+    job = queue.ring[(queue.head + size - 1) % capacity];
+    queue.size.store(size - 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::stealJob(UINT32 thiefIndex, Job& job)
+{
+    for (UINT32 i = 1; i < m_queueCount; ++i)
+    {
+        WorkQueue& queue = m_queues[(thiefIndex + i) % m_queueCount];
+        if (queue.size.load(std::memory_order_relaxed) == 0) continue;
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        UINT32 size = queue.size.load(std::memory_order_relaxed);
+        if (size == 0) continue;
+
+        // Thief side: oldest job
+        const UINT32 capacity = static_cast<UINT32>(queue.ring.size());
+        job = queue.ring[queue.head];
+        queue.head = (queue.head + 1) % capacity;
+        queue.size.store(size - 1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::findJob(UINT32 queueIndex, Job& job)
+{
+    return popJob(queueIndex, job) || stealJob(queueIndex, job);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "jobsystemapi.h"
+
+// ==================== JOB SYSTEM ====================
+// Work-stealing job system.
+//
+// Every worker owns a deque: it pushes and pops at the back (newest first,
+// cache-warm) while idle threads steal from the front (oldest, usually the
+// biggest slices). Threads outside the pool share deque 0. Ranges use lazy
+// binary splitting: a thread keeps halving its slice and offering the upper
+// half only while its own deque is empty, so chunk sizes adapt to how busy
+// the other threads are instead of being fixed up front.
+//
+// Idle threads sleep on an epoch counter that is bumped by every push and
+// by every counter reaching zero.
+class JobSystem : public JobSystemAPI
+{
+private:
+    struct Job
+    {
+        JobFunction function;
+        void* context;
+        UINT32 begin;
+        UINT32 end;
+        UINT32 minChunk;
+        JobCounter* counter;
+    };
+
+    struct HeldJob
+    {
+        Job job;
+        const JobCounter* dependency;
+    };
+
+    // Ring buffer deque, guarded by its own lock (contention is limited to steals)
+    struct alignas(64) WorkQueue
+    {
+        std::mutex mutex;
+        std::vector<Job> ring;
+        UINT32 head = 0;
+        std::atomic<UINT32> size{ 0 };
+    };
+
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<WorkQueue[]> m_queues;   // [0] shared by outside threads, [i] for worker i
+    UINT32 m_queueCount;
+
+    // Jobs waiting for a dependency
+    std::mutex m_heldMutex;
+    std::vector<HeldJob> m_heldJobs;
+    std::atomic<UINT32> m_heldCount;
+
+    std::atomic<UINT32> m_epoch;
+    std::atomic<bool> m_quit;
+
+    UINT32 currentQueue() const;
+    void workerLoop(UINT32 queueIndex);
+
+    void pushJob(UINT32 queueIndex, const Job& job);
+    bool popJob(UINT32 queueIndex, Job& job);
+    bool stealJob(UINT32 thiefIndex, Job& job);
+    bool findJob(UINT32 queueIndex, Job& job);
+    void executeJob(Job& job, UINT32 queueIndex);
+    void finishJob(JobCounter* counter, UINT32 queueIndex);
+    void releaseHeldJobs(UINT32 queueIndex);
+    void wake(bool all);
+
+public:
+    // threadCount includes the waiting thread, 0 = one per hardware thread
+    explicit JobSystem(UINT32 threadCount = 0);
+    ~JobSystem() override;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    UINT32 getThreadCount() const override;
+    void run(const JobDecl& job, JobCounter* counter, const JobCounter* dependency = nullptr) override;
+    void wait(const JobCounter* counter) override;
+};
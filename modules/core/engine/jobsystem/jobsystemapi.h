@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+#include "../../../headeronly/globaltypes.h"
+
+// ==================== JOB TYPES ====================
+// A job runs function(context, begin, end) over a slice of [0, count)
+using JobFunction = void (*)(void* context, UINT32 begin, UINT32 end);
+
+struct JobDecl
+{
+    JobFunction function;
+    void* context;
+    UINT32 count;       // Index range [0, count)
+    UINT32 minChunk;    // Slices are split in halves while larger than this and other threads run dry
+};
+
+// Jobs still outstanding. Start at zero, pass to run() and wait() on it.
+struct JobCounter
+{
+    std::atomic<UINT32> pending{ 0 };
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// ==================== JOB SYSTEM API ====================
+// Shared worker pool owned by the engine. Subsystems submit jobs instead of
+// spawning their own threads. A thread that waits on a counter runs queued
+// jobs until the counter is done, so jobs may themselves submit and wait.
+class JobSystemAPI
+{
+public:
+    virtual ~JobSystemAPI() = default;
+
+    // Worker threads plus the thread calling wait()
+    virtual UINT32 getThreadCount() const = 0;
+
+    // Queues a job. counter (optional) stays non-zero until every slice has run.
+    // With a dependency, the job is held back until that counter is done.
+    virtual void run(const JobDecl& job, JobCounter* counter, const JobCounter* dependency = nullptr) = 0;
+
+    // Executes queued jobs on the calling thread until counter is done
+    virtual void wait(const JobCounter* counter) = 0;
+
+    // Runs fn(begin, end) over [0, count) and returns when every slice is done
+    template <typename Fn>
+    void parallelFor(UINT32 count, UINT32 minChunk, Fn&& fn)
+    {
+        using Function = std::remove_reference_t<Fn>;
+
+        JobDecl job = {};
+        job.function = &invokeRange<Function>;
+        job.context = const_cast<void*>(static_cast<const void*>(&fn));
+        job.count = count;
+        job.minChunk = minChunk > 0 ? minChunk : 1;
+
+        JobCounter counter;
+        run(job, &counter);
+        wait(&counter);
+    }
+
+private:
+    template <typename Fn>
+    static void invokeRange(void* context, UINT32 begin, UINT32 end)
+    {
+        (*static_cast<Fn*>(context))(begin, end);
+    }
+};
@@ -9,6 +9,17 @@ ModuleManager::ModuleManager()
     , m_rsD3D11BackendModule(nullptr)
     , fnCreateRenderBackend_D3D11(nullptr)
     , fnDestroyRenderBackend_D3D11(nullptr)
+    , fnSetProfiler_D3D11(nullptr)
+
+    , m_rsNullBackendModule(nullptr)
+    , fnCreateRenderBackend_Null(nullptr)
+    , fnDestroyRenderBackend_Null(nullptr)
+
+    , m_rsSoftwareBackendModule(nullptr)
+    , fnCreateRenderBackend_Software(nullptr)
+    , fnDestroyRenderBackend_Software(nullptr)
+    , fnSetJobSystem_Software(nullptr)
+    , fnSetProfiler_Software(nullptr)
 {
 }
 
@@ -57,8 +68,71 @@ bool ModuleManager::loadModules()
         return false;
     }
 
+    fnSetProfiler_D3D11 =
+        reinterpret_cast<t_fnSetProfiler>(
+            GetProcAddress(m_rsD3D11BackendModule, "setRenderBackendProfiler"));
+
+    // Null backend (headless), optional
+    m_rsNullBackendModule = LoadLibraryA("modules/rsnull.dll");
+    if (m_rsNullBackendModule)
+    {
+        fnCreateRenderBackend_Null =
+            reinterpret_cast<t_fnCreateRenderBackend_Null>(
+                GetProcAddress(m_rsNullBackendModule, "createRenderBackend"));
+
+        fnDestroyRenderBackend_Null =
+            reinterpret_cast<t_fnDestroyRenderBackend_Null>(
+                GetProcAddress(m_rsNullBackendModule, "destroyRenderBackend"));
+
+        if (!fnCreateRenderBackend_Null || !fnDestroyRenderBackend_Null)
+        {
+            std::cout << "rsnull.dll function load failed!\n";
+            FreeLibrary(m_rsNullBackendModule);
+            m_rsNullBackendModule = nullptr;
+            fnCreateRenderBackend_Null = nullptr;
+            fnDestroyRenderBackend_Null = nullptr;
+        }
+    }
+
+    // Software backend (CPU rasterizer), optional
+    m_rsSoftwareBackendModule = LoadLibraryA("modules/rssoftware.dll");
+    if (m_rsSoftwareBackendModule)
+    {
+        fnCreateRenderBackend_Software =
+            reinterpret_cast<t_fnCreateRenderBackend_Software>(
+                GetProcAddress(m_rsSoftwareBackendModule, "createRenderBackend"));
+
+        fnDestroyRenderBackend_Software =
+            reinterpret_cast<t_fnDestroyRenderBackend_Software>(
+                GetProcAddress(m_rsSoftwareBackendModule, "destroyRenderBackend"));
+
+        fnSetJobSystem_Software =
+            reinterpret_cast<t_fnSetJobSystem_Software>(
+                GetProcAddress(m_rsSoftwareBackendModule, "setRenderBackendJobSystem"));
+
+        if (!fnCreateRenderBackend_Software || !fnDestroyRenderBackend_Software || !fnSetJobSystem_Software)
+        {
+            std::cout << "rssoftware.dll function load failed!\n";
+            FreeLibrary(m_rsSoftwareBackendModule);
+            m_rsSoftwareBackendModule = nullptr;
+            fnCreateRenderBackend_Software = nullptr;
+            fnDestroyRenderBackend_Software = nullptr;
+            fnSetJobSystem_Software = nullptr;
+        }
+        else
+        {
+            fnSetProfiler_Software =
+                reinterpret_cast<t_fnSetProfiler>(
+                    GetProcAddress(m_rsSoftwareBackendModule, "setRenderBackendProfiler"));
+        }
+    }
+
     std::cout << "rendersystem.dll loaded.\n";
     std::cout << "rsd3d11.dll loaded.\n";
+    if (m_rsNullBackendModule)
+        std::cout << "rsnull.dll loaded.\n";
+    if (m_rsSoftwareBackendModule)
+        std::cout << "rssoftware.dll loaded.\n";
     return true;
 #endif
 }
@@ -85,6 +159,29 @@ void ModuleManager::unloadModules()
 
     fnCreateRenderBackend_D3D11 = nullptr;
     fnDestroyRenderBackend_D3D11 = nullptr;
+    fnSetProfiler_D3D11 = nullptr;
+
+    // Null backend
+    if (m_rsNullBackendModule)
+    {
+        FreeLibrary(m_rsNullBackendModule);
+        m_rsNullBackendModule = nullptr;
+    }
+
+    fnCreateRenderBackend_Null = nullptr;
+    fnDestroyRenderBackend_Null = nullptr;
+
+    // Software backend
+    if (m_rsSoftwareBackendModule)
+    {
+        FreeLibrary(m_rsSoftwareBackendModule);
+        m_rsSoftwareBackendModule = nullptr;
+    }
+
+    fnCreateRenderBackend_Software = nullptr;
+    fnDestroyRenderBackend_Software = nullptr;
+    fnSetJobSystem_Software = nullptr;
+    fnSetProfiler_Software = nullptr;
 #endif
 }
 
@@ -6,6 +6,9 @@
 
 #include "../../../graphics/rendersystem/rendersystemapi.h"
 
+class JobSystemAPI;
+namespace Quark { class Profiler; }
+
 class ModuleManager
 {
 private:
@@ -23,6 +26,18 @@ private:
 	typedef RHI* (*t_fnCreateRenderBackend_D3D11)();
 	typedef void  (*t_fnDestroyRenderBackend_D3D11)(RHI*);
 
+	// Backends export setRenderBackendProfiler optionally
+	typedef void  (*t_fnSetProfiler)(Quark::Profiler*);
+
+	QMODULE m_rsNullBackendModule;
+	typedef RHI* (*t_fnCreateRenderBackend_Null)();
+	typedef void  (*t_fnDestroyRenderBackend_Null)(RHI*);
+
+	QMODULE m_rsSoftwareBackendModule;
+	typedef RHI* (*t_fnCreateRenderBackend_Software)();
+	typedef void  (*t_fnDestroyRenderBackend_Software)(RHI*);
+	typedef void  (*t_fnSetJobSystem_Software)(RHI*, JobSystemAPI*);
+
 public:
 	ModuleManager();
 	~ModuleManager();
@@ -35,4 +50,13 @@ public:
 
 	t_fnCreateRenderBackend_D3D11 fnCreateRenderBackend_D3D11;
 	t_fnDestroyRenderBackend_D3D11 fnDestroyRenderBackend_D3D11;
+	t_fnSetProfiler fnSetProfiler_D3D11;
+
+	t_fnCreateRenderBackend_Null fnCreateRenderBackend_Null;
+	t_fnDestroyRenderBackend_Null fnDestroyRenderBackend_Null;
+
+	t_fnCreateRenderBackend_Software fnCreateRenderBackend_Software;
+	t_fnDestroyRenderBackend_Software fnDestroyRenderBackend_Software;
+	t_fnSetJobSystem_Software fnSetJobSystem_Software;
+	t_fnSetProfiler fnSetProfiler_Software;
 };
\ No newline at end of file
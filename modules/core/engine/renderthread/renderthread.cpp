@@ -0,0 +1,456 @@
+#include "renderthread.h"
+#include "../../../headeronly/profiler.h"
+#include <iostream>
+
+static float millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ==================== CONSTRUCTOR ====================
+RenderThread::RenderThread(RHI* backend)
+    : m_pBackend(backend)
+    , m_invokesIssued(0)
+    , m_invokesCompleted(0)
+    , m_meshHandles(RENDER_HANDLE_CAPACITY)
+    , m_materialHandles(RENDER_HANDLE_CAPACITY)
+    , m_textureHandles(RENDER_HANDLE_CAPACITY)
+    , m_inlineCommand()
+    , m_completedFrameFence(0)
+    , m_queuedFrames(0)
+    , m_framesExecuted(0)
+    , m_producerStalls(0)
+    , m_stallTime(0.0f)
+    , m_queueLatency(0.0f)
+    , m_executeTime(0.0f)
+    , m_presentTime(0.0f)
+{
+}
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+// ==================== LIFECYCLE ====================
+void RenderThread::start()
+{
+    if (isRunning() || !m_pBackend) return;
+
+    m_completedFrameFence = m_pBackend->getCompletedFrameFence();
+    m_thread = std::thread(&RenderThread::threadLoop, this);
+}
+
+void RenderThread::stop()
+{
+    if (!isRunning()) return;
+
+    beginCommand(RenderCommandType::QUIT);
+    submitCommand();
+    m_thread.join();
+}
+
+RenderThreadStats RenderThread::getStats() const
+{
+    RenderThreadStats stats = {};
+    stats.queuedFrames = m_queuedFrames.load();
+    stats.framesExecuted = m_framesExecuted.load();
+    stats.producerStalls = m_producerStalls.load();
+    stats.stallTime = m_stallTime.load();
+    stats.queueLatency = m_queueLatency.load();
+    stats.executeTime = m_executeTime.load();
+    stats.presentTime = m_presentTime.load();
+    return stats;
+}
+
+// ==================== COMMAND QUEUE ====================
+RenderCommand& RenderThread::beginCommand(RenderCommandType type)
+{
+    if (!isRunning())
+    {
+        m_inlineCommand.type = type;
+        return m_inlineCommand;
+    }
+
+    // Back-pressure: the game thread waits here when the render thread falls behind
+    if (m_queue.full())
+    {
+        QUARK_PROFILE_ZONE("RenderThread::stall");
+        auto start = std::chrono::steady_clock::now();
+        m_queue.waitForSpace();
+        m_producerStalls++;
+        m_stallTime += millisecondsSince(start);
+    }
+
+    RenderCommand& command = m_queue.back();
+    command.type = type;
+    command.enqueueTime = std::chrono::steady_clock::now();
+    return command;
+}
+
+// Runs the command right away when the thread is not running
+void RenderThread::submitCommand()
+{
+    if (!isRunning())
+    {
+        executeCommand(m_inlineCommand);
+        return;
+    }
+    m_queue.push();
+}
+
+void RenderThread::invokeOnThread(void (*function)(void*), void* context)
+{
+    if (!isRunning())
+    {
+        function(context);
+        return;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::INVOKE);
+    command.function = function;
+    command.context = context;
+    UINT64 ticket = ++m_invokesIssued;
+    submitCommand();
+
+    UINT64 completed = m_invokesCompleted.load(std::memory_order_acquire);
+    while (completed < ticket)
+    {
+        m_invokesCompleted.wait(completed, std::memory_order_acquire);
+        completed = m_invokesCompleted.load(std::memory_order_acquire);
+    }
+}
+
+void RenderThread::threadLoop()
+{
+    QUARK_PROFILE_THREAD("Render Thread");
+
+    for (;;)
+    {
+        m_queue.waitForItem();
+
+        // The slot stays owned by this thread until pop(), packets are read in place
+        RenderCommand& command = m_queue.front();
+        if (command.type == RenderCommandType::QUIT)
+        {
+            m_queue.pop();
+            return;
+        }
+
+        executeCommand(command);
+        m_queue.pop();
+    }
+}
+
+void RenderThread::executeCommand(RenderCommand& command)
+{
+    switch (command.type)
+    {
+    case RenderCommandType::EXECUTE_FRAME:
+    {
+        m_queueLatency = millisecondsSince(command.enqueueTime);
+
+        QUARK_PROFILE_ZONE("RenderThread::executeFrame");
+        auto start = std::chrono::steady_clock::now();
+        resolvePacket(command.packet);
+        m_pBackend->executeFrame(command.packet);
+        m_pBackend->waitForFrameFence(command.packet.frameFence);
+        m_executeTime = millisecondsSince(start);
+
+        m_queuedFrames--;
+        m_framesExecuted++;
+        m_completedFrameFence.store(command.packet.frameFence, std::memory_order_release);
+        m_completedFrameFence.notify_all();
+        break;
+    }
+    case RenderCommandType::END_FRAME:
+    {
+        QUARK_PROFILE_ZONE("RenderThread::endFrame");
+        auto start = std::chrono::steady_clock::now();
+        m_pBackend->endFrame();
+        m_presentTime = millisecondsSince(start);
+        break;
+    }
+    case RenderCommandType::RESIZE:
+        m_pBackend->onResize(command.width, command.height);
+        break;
+    case RenderCommandType::CREATE_MESH:
+        m_meshHandles.bind(command.handle, m_pBackend->createMeshBuffer(command.upload->meshData, command.isDynamic));
+        delete command.upload;
+        break;
+    case RenderCommandType::UPDATE_MESH:
+        m_pBackend->updateMeshBuffer(m_meshHandles.resolve(command.handle), command.upload->meshData);
+        delete command.upload;
+        break;
+    case RenderCommandType::DESTROY_MESH:
+        m_pBackend->destroyMeshBuffer(m_meshHandles.resolve(command.handle));
+        m_meshHandles.bind(command.handle, 0);
+        break;
+    case RenderCommandType::CREATE_MATERIAL:
+        m_materialHandles.bind(command.handle, m_pBackend->createMaterialBuffer(command.material));
+        break;
+    case RenderCommandType::UPDATE_MATERIAL:
+        m_pBackend->updateMaterialBuffer(m_materialHandles.resolve(command.handle), command.material);
+        break;
+    case RenderCommandType::DESTROY_MATERIAL:
+        m_pBackend->destroyMaterialBuffer(m_materialHandles.resolve(command.handle));
+        m_materialHandles.bind(command.handle, 0);
+        break;
+    case RenderCommandType::LOAD_TEXTURE:
+        m_textureHandles.bind(command.handle, m_pBackend->loadTexture(command.upload->filename.c_str()));
+        delete command.upload;
+        break;
+    case RenderCommandType::BIND_TEXTURE:
+        m_pBackend->bindTextureToMaterial(m_materialHandles.resolve(command.handle),
+                                          m_textureHandles.resolve(command.texture), command.slot);
+        break;
+    case RenderCommandType::DESTROY_TEXTURE:
+        m_pBackend->destroyTexture(m_textureHandles.resolve(command.handle));
+        m_textureHandles.bind(command.handle, 0);
+        break;
+    case RenderCommandType::INVOKE:
+        command.function(command.context);
+        m_invokesCompleted.fetch_add(1, std::memory_order_release);
+        m_invokesCompleted.notify_all();
+        break;
+    case RenderCommandType::QUIT:
+        break;
+    }
+}
+
+// ==================== LIFECYCLE (RHI) ====================
+void RenderThread::init(qWndh windowHandle)
+{
+    invoke([&] { m_pBackend->init(windowHandle); });
+}
+
+void RenderThread::shutdown()
+{
+    invoke([&] { m_pBackend->shutdown(); });
+}
+
+// ==================== RESOURCE HANDLES ====================
+// Backend handles in the packet become valid right before the backend reads it.
+// The packet memory stays untouched by the game thread until its frame fence completes.
+void RenderThread::resolvePacket(const FramePacket& packet) const
+{
+    for (UINT32 i = 0; i < packet.drawCommandCount; ++i)
+    {
+        packet.drawCommands[i].mesh = m_meshHandles.resolve(packet.drawCommands[i].mesh);
+        packet.drawCommands[i].material = m_materialHandles.resolve(packet.drawCommands[i].material);
+    }
+    for (UINT32 i = 0; i < packet.shadowDrawCommandCount; ++i)
+    {
+        packet.shadowDrawCommands[i].mesh = m_meshHandles.resolve(packet.shadowDrawCommands[i].mesh);
+        packet.shadowDrawCommands[i].material = m_materialHandles.resolve(packet.shadowDrawCommands[i].material);
+    }
+}
+
+static RenderUpload* createMeshUpload(const MeshData& meshData)
+{
+    RenderUpload* upload = new RenderUpload();
+    if (meshData.vertices)
+        upload->vertices.assign(meshData.vertices, meshData.vertices + meshData.vertexCount);
+    if (meshData.indices)
+        upload->indices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+
+    upload->meshData = meshData;
+    upload->meshData.vertices = meshData.vertices ? upload->vertices.data() : nullptr;
+    upload->meshData.indices = meshData.indices ? upload->indices.data() : nullptr;
+    return upload;
+}
+
+// ==================== GPU MESH BUFFERS ====================
+hMesh RenderThread::createMeshBuffer(const MeshData& meshData, bool isDynamic)
+{
+    hMesh handle = m_meshHandles.reserve();
+    if (handle == 0)
+    {
+        std::cerr << "[RenderThread] ERROR: Mesh handle table is full.\n";
+        return 0;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::CREATE_MESH);
+    command.handle = handle;
+    command.isDynamic = isDynamic;
+    command.upload = createMeshUpload(meshData);
+    submitCommand();
+    return handle;
+}
+
+void RenderThread::destroyMeshBuffer(hMesh handle)
+{
+    if (!m_meshHandles.isLive(handle)) return;
+
+    RenderCommand& command = beginCommand(RenderCommandType::DESTROY_MESH);
+    command.handle = handle;
+    submitCommand();
+    m_meshHandles.release(handle);
+}
+
+bool RenderThread::updateMeshBuffer(hMesh handle, const MeshData& meshData)
+{
+    if (!m_meshHandles.isLive(handle)) return false;
+
+    RenderCommand& command = beginCommand(RenderCommandType::UPDATE_MESH);
+    command.handle = handle;
+    command.upload = createMeshUpload(meshData);
+    submitCommand();
+    return true;
+}
+
+// ==================== GPU MATERIAL BUFFERS ====================
+hMaterial RenderThread::createMaterialBuffer(const MaterialData& materialData)
+{
+    hMaterial handle = m_materialHandles.reserve();
+    if (handle == 0)
+    {
+        std::cerr << "[RenderThread] ERROR: Material handle table is full.\n";
+        return 0;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::CREATE_MATERIAL);
+    command.handle = handle;
+    command.material = materialData;
+    submitCommand();
+    return handle;
+}
+
+void RenderThread::destroyMaterialBuffer(hMaterial handle)
+{
+    if (!m_materialHandles.isLive(handle)) return;
+
+    RenderCommand& command = beginCommand(RenderCommandType::DESTROY_MATERIAL);
+    command.handle = handle;
+    submitCommand();
+    m_materialHandles.release(handle);
+}
+
+bool RenderThread::updateMaterialBuffer(hMaterial handle, const MaterialData& materialData)
+{
+    if (!m_materialHandles.isLive(handle)) return false;
+
+    RenderCommand& command = beginCommand(RenderCommandType::UPDATE_MATERIAL);
+    command.handle = handle;
+    command.material = materialData;
+    submitCommand();
+    return true;
+}
+
+// ==================== TEXTURES ====================
+hTexture RenderThread::loadTexture(const char* filename)
+{
+    if (!filename) return 0;
+
+    hTexture handle = m_textureHandles.reserve();
+    if (handle == 0)
+    {
+        std::cerr << "[RenderThread] ERROR: Texture handle table is full.\n";
+        return 0;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::LOAD_TEXTURE);
+    command.handle = handle;
+    command.upload = new RenderUpload();
+    command.upload->filename = filename;
+    submitCommand();
+    return handle;
+}
+
+void RenderThread::destroyTexture(hTexture handle)
+{
+    if (!m_textureHandles.isLive(handle)) return;
+
+    RenderCommand& command = beginCommand(RenderCommandType::DESTROY_TEXTURE);
+    command.handle = handle;
+    submitCommand();
+    m_textureHandles.release(handle);
+}
+
+bool RenderThread::bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot)
+{
+    if (!m_materialHandles.isLive(material) || !m_textureHandles.isLive(texture)) return false;
+
+    RenderCommand& command = beginCommand(RenderCommandType::BIND_TEXTURE);
+    command.handle = material;
+    command.texture = texture;
+    command.slot = slot;
+    submitCommand();
+    return true;
+}
+
+// ==================== FRAME EXECUTION ====================
+void RenderThread::executeFrame(const FramePacket& packet)
+{
+    if (!isRunning())
+    {
+        resolvePacket(packet);
+        m_pBackend->executeFrame(packet);
+        return;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::EXECUTE_FRAME);
+    command.packet = packet;
+    m_queuedFrames++;
+    submitCommand();
+}
+
+void RenderThread::endFrame()
+{
+    if (!isRunning())
+    {
+        m_pBackend->endFrame();
+        return;
+    }
+
+    beginCommand(RenderCommandType::END_FRAME);
+    submitCommand();
+}
+
+UINT64 RenderThread::getCompletedFrameFence() const
+{
+    if (!isRunning()) return m_pBackend->getCompletedFrameFence();
+    return m_completedFrameFence.load(std::memory_order_acquire);
+}
+
+void RenderThread::waitForFrameFence(UINT64 fence)
+{
+    if (!isRunning())
+    {
+        m_pBackend->waitForFrameFence(fence);
+        return;
+    }
+
+    UINT64 completed = m_completedFrameFence.load(std::memory_order_acquire);
+    while (completed < fence)
+    {
+        m_completedFrameFence.wait(completed, std::memory_order_acquire);
+        completed = m_completedFrameFence.load(std::memory_order_acquire);
+    }
+}
+
+// ==================== WINDOW EVENTS ====================
+void RenderThread::onResize(UINT32 width, UINT32 height)
+{
+    if (!isRunning())
+    {
+        m_pBackend->onResize(width, height);
+        return;
+    }
+
+    RenderCommand& command = beginCommand(RenderCommandType::RESIZE);
+    command.width = width;
+    command.height = height;
+    submitCommand();
+}
+
+// ==================== DEBUG ====================
+void* RenderThread::getDevice() const
+{
+    return m_pBackend->getDevice();
+}
+
+void* RenderThread::getContext() const
+{
+    return m_pBackend->getContext();
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <vector>
+#include <string>
+
+#include "../../../headeronly/globaltypes.h"
+#include "../../../headeronly/spscqueue.h"
+#include "../../../graphics/rendersystem/rhi.h"
+#include "../enginetypes.h"
+
+// ==================== RENDER COMMANDS ====================
+enum class RenderCommandType : UINT32
+{
+    EXECUTE_FRAME,
+    END_FRAME,
+    RESIZE,
+    CREATE_MESH,
+    UPDATE_MESH,
+    DESTROY_MESH,
+    CREATE_MATERIAL,
+    UPDATE_MATERIAL,
+    DESTROY_MATERIAL,
+    LOAD_TEXTURE,
+    BIND_TEXTURE,
+    DESTROY_TEXTURE,
+    INVOKE,          // Blocking call, the game thread waits for it to finish
+    QUIT
+};
+
+// Caller data copied for a create or update that runs later, freed by the render thread
+struct RenderUpload
+{
+    std::vector<Vertex> vertices;
+    std::vector<UINT32> indices;
+    MeshData meshData;           // Points into vertices and indices
+    std::string filename;
+};
+
+struct RenderCommand
+{
+    RenderCommandType type;
+    UINT32 handle;
+    UINT32 width;
+    UINT32 height;
+    UINT32 texture;              // BIND_TEXTURE
+    UINT32 slot;                 // BIND_TEXTURE
+    bool isDynamic;              // CREATE_MESH
+    MaterialData material;       // CREATE_MATERIAL, UPDATE_MATERIAL
+    RenderUpload* upload;        // Mesh and texture payloads
+    void (*function)(void* context);
+    void* context;
+    std::chrono::steady_clock::time_point enqueueTime;
+    FramePacket packet;
+};
+
+constexpr UINT32 RENDER_COMMAND_QUEUE_SIZE = 64;
+constexpr UINT32 RENDER_HANDLE_CAPACITY = 1u << 16;    // Per resource type
+
+// ==================== RENDER HANDLES ====================
+// Handles given out on the game thread and bound to the backend's handles on the
+// render thread. A handle is its table index + 1, so 0 stays the null handle.
+// An index is recycled as soon as its destroy is queued: commands run in order,
+// so the destroy always reaches the backend before a later create reuses the index.
+class RenderHandleTable
+{
+private:
+    std::vector<UINT32> m_backendHandles;   // Render thread
+    std::vector<UINT8> m_live;              // Game thread
+    std::vector<UINT32> m_freeIndices;      // Game thread
+    UINT32 m_nextIndex;
+
+public:
+    explicit RenderHandleTable(UINT32 capacity)
+        : m_backendHandles(capacity, 0)
+        , m_live(capacity, 0)
+        , m_nextIndex(0)
+    {
+        m_freeIndices.reserve(capacity);
+    }
+
+    // Game thread, 0 when the table is full
+    UINT32 reserve()
+    {
+        UINT32 index;
+        if (!m_freeIndices.empty())
+        {
+            index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+        }
+        else if (m_nextIndex < m_live.size())
+        {
+            index = m_nextIndex++;
+        }
+        else
+        {
+            return 0;
+        }
+        m_live[index] = 1;
+        return index + 1;
+    }
+
+    // Game thread, false for the null handle or one already released
+    bool release(UINT32 handle)
+    {
+        if (!isLive(handle)) return false;
+        m_live[handle - 1] = 0;
+        m_freeIndices.push_back(handle - 1);
+        return true;
+    }
+
+    bool isLive(UINT32 handle) const { return handle != 0 && handle <= m_live.size() && m_live[handle - 1] != 0; }
+
+    // Render thread
+    void bind(UINT32 handle, UINT32 backendHandle) { m_backendHandles[handle - 1] = backendHandle; }
+    UINT32 resolve(UINT32 handle) const { return handle != 0 && handle <= m_backendHandles.size() ? m_backendHandles[handle - 1] : 0; }
+};
+
+// ==================== RENDER THREAD ====================
+// RHI that runs the real backend on a dedicated thread.
+//
+// The game thread pushes frame packets and resource calls into a bounded SPSC
+// queue and the render thread executes them in order, so game logic and render
+// submission overlap instead of adding up. Packet memory is released through
+// the frame fences (RenderSystem keeps it alive until the fence completes).
+// Resource calls never wait for the render thread: creation returns a handle
+// reserved on the game thread and queues the backend call with a copy of the
+// source data, the render thread binds the backend's handle to it. Handles in
+// frame packets are translated in place before the backend sees them. Updates
+// return false only for a handle that is not live; backend failures are
+// reported by the backend. init() and shutdown() still block.
+class RenderThread : public RHI
+{
+private:
+    RHI* m_pBackend;
+    std::thread m_thread;
+
+    // Game thread -> render thread
+    Quark::SPSCQueue<RenderCommand, RENDER_COMMAND_QUEUE_SIZE> m_queue;
+    UINT64 m_invokesIssued;                  // Game thread only
+
+    // Render thread -> game thread
+    std::atomic<UINT64> m_invokesCompleted;
+
+    // Reserved on the game thread, bound on the render thread
+    RenderHandleTable m_meshHandles;
+    RenderHandleTable m_materialHandles;
+    RenderHandleTable m_textureHandles;
+
+    // Stands in for the queue slot while the thread is not running
+    RenderCommand m_inlineCommand;
+    std::atomic<UINT64> m_completedFrameFence;
+
+    // Stats, written by whichever thread measures them
+    std::atomic<UINT32> m_queuedFrames;
+    std::atomic<UINT32> m_framesExecuted;
+    std::atomic<UINT32> m_producerStalls;
+    std::atomic<float> m_stallTime;
+    std::atomic<float> m_queueLatency;
+    std::atomic<float> m_executeTime;
+    std::atomic<float> m_presentTime;
+
+    void threadLoop();
+    void executeCommand(RenderCommand& command);
+    void resolvePacket(const FramePacket& packet) const;
+
+    RenderCommand& beginCommand(RenderCommandType type);
+    void submitCommand();
+    void invokeOnThread(void (*function)(void*), void* context);
+
+    template <typename Fn>
+    static void invokeFunction(void* context)
+    {
+        (*static_cast<Fn*>(context))();
+    }
+
+    // Runs fn on the render thread and waits for it, inline if the thread is not running
+    template <typename Fn>
+    void invoke(Fn&& fn)
+    {
+        using Function = std::remove_reference_t<Fn>;
+        invokeOnThread(&invokeFunction<Function>, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+public:
+    explicit RenderThread(RHI* backend);
+    ~RenderThread() override;
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    void start();
+    void stop();     // Drains the queue, then joins the thread
+    bool isRunning() const { return m_thread.joinable(); }
+
+    RenderThreadStats getStats() const;
+
+    // ==================== RHI INTERFACE ====================
+    void init(qWndh windowHandle) override;
+    void shutdown() override;
+
+    hMesh createMeshBuffer(const MeshData& meshData, bool isDynamic) override;
+    void destroyMeshBuffer(hMesh handle) override;
+    bool updateMeshBuffer(hMesh handle, const MeshData& meshData) override;
+
+    hMaterial createMaterialBuffer(const MaterialData& materialData) override;
+    void destroyMaterialBuffer(hMaterial handle) override;
+    bool updateMaterialBuffer(hMaterial handle, const MaterialData& materialData) override;
+
+    hTexture loadTexture(const char* filename) override;
+    void destroyTexture(hTexture handle) override;
+    bool bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot) override;
+
+    void executeFrame(const FramePacket& packet) override;
+    void endFrame() override;
+    UINT64 getCompletedFrameFence() const override;
+    void waitForFrameFence(UINT64 fence) override;
+
+    void onResize(UINT32 width, UINT32 height) override;
+
+    // Backend objects, only safe to use from the render thread
+    void* getDevice() const override;
+    void* getContext() const override;
+};
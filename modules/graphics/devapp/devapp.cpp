@@ -14,6 +14,7 @@
 #include "../rendersystem/rhi.h"
 #include "../rendersystem/sky.h"
 #include "../../headeronly/globaltypes.h"
+#include "../../headeronly/profiler.h"
 #include "../../tools/modelloader.h"
 
 // ImGui includes
@@ -34,6 +35,7 @@ typedef void (*DestroyRenderSystemFn)(RenderSystemAPI*);
 // DLL function types for RHI factory
 typedef RHI* (*CreateRenderBackendFn)();
 typedef void (*DestroyRenderBackendFn)(RHI*);
+typedef void (*SetRenderBackendProfilerFn)(Quark::Profiler*);
 
 // Forward declare ImGui Win32 message handler
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -278,6 +280,10 @@ private:
     CreateRenderBackendFn m_pfnCreateRenderBackend;
     DestroyRenderBackendFn m_pfnDestroyRenderBackend;
 
+    // Shared by devapp, the render system and the backend
+    Quark::Profiler m_profiler;
+    UINT32 m_traceFramesLeft = 0;
+
     // Editor structs
     struct EditorMesh
     {
@@ -313,13 +319,14 @@ private:
         bool castsShadows;      // Casts shadows (even if not visible)
         bool receivesShadows;   // Receives shadows from lights
         bool frustumCull;       // Participates in frustum culling
+        bool occluder;          // Rasterized into the CPU occlusion buffer
         
         bool animate;
         float animationSpeed;
 
         SceneObject()
             : position(0, 0, 0), rotation(0, 0, 0), scale(1, 1, 1)
-            , active(true), visible(true), castsShadows(true), receivesShadows(true), frustumCull(true)
+            , active(true), visible(true), castsShadows(true), receivesShadows(true), frustumCull(true), occluder(false)
             , animate(false), animationSpeed(1.0f)
             , meshIndex(-1), materialIndex(-1) {}
     };
@@ -331,6 +338,18 @@ private:
     std::vector<MaterialResource> m_materials;
     std::vector<SceneObject> m_sceneObjects;
 
+    // Render proxy per scene object slot, with the state it was last updated from.
+    // Kept outside SceneObject so undo/redo snapshots never copy proxy handles.
+    struct SceneProxy
+    {
+        hRenderProxy handle = 0;
+        hMesh mesh = 0;
+        hMaterial material = 0;
+        RenderObjectFlags flags = RenderObjectFlags::NONE;
+        Quark::Vec3 position, rotation, scale;
+    };
+    std::vector<SceneProxy> m_sceneProxies;
+
     int m_selectedObject = -1;
     int m_selectedMaterial = -1;
     int m_selectedMesh = -1;
@@ -523,6 +542,16 @@ public:
             return false;
         }
 
+        Quark::setModuleProfiler(&m_profiler, "devapp");
+        QUARK_PROFILE_THREAD("Main Thread");
+        m_pRenderSystem->setProfiler(&m_profiler);
+        SetRenderBackendProfilerFn pfnSetRenderBackendProfiler =
+            (SetRenderBackendProfilerFn)GetProcAddress(m_hRHIDLL, "setRenderBackendProfiler");
+        if (pfnSetRenderBackendProfiler)
+        {
+            pfnSetRenderBackendProfiler(&m_profiler);
+        }
+
         // Initialize with new API
         m_pRenderSystem->init(m_pRHI, static_cast<qWndh>(m_pWindow->getHandle()));
         // m_pRenderSystem->setAmbientLight(Quark::Color(0.0f, 0.0f, 0.0f));
@@ -1226,8 +1255,57 @@ public:
             ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
             ImGui::Text("Objects Rendered: %d", stats.objectsRendered);
             ImGui::Text("Objects Culled: %d", stats.objectsCulled);
+            ImGui::Text("Render Proxies: %d (%d updated)", stats.proxyCount, stats.proxiesUpdated);
+            ImGui::Text("Objects Occluded: %d (%d occluders, %d tris)", stats.objectsOccluded, stats.occluderCount, stats.occluderTriangles);
             ImGui::Text("Draw Calls: %d", stats.drawCalls);
             ImGui::Text("Triangles: %d", stats.trianglesRendered);
+            ImGui::Text("Shadow Views: %d (%d draws, %d instances)", stats.shadowViews, stats.shadowMapDrawCalls, stats.shadowInstances);
+            ImGui::Text("Frames In Flight: %d (%d fence waits)", stats.framesInFlight, stats.fenceWaits);
+            ImGui::Text("AABBs Tested: %d (%d early outs, %d shadow)", stats.aabbsTested, stats.cullEarlyOuts, stats.shadowAABBsTested);
+            ImGui::Text("Instances Written: %d (%d merged into batches)", stats.instancesWritten, stats.batchesMerged);
+            ImGui::Text("Visible Lights: %d (%d culled, %d over budget)", stats.lightsVisible, stats.lightsCulled, stats.lightsOverBudget);
+            ImGui::Text("Shadow Cache: %d cached, %d static only", stats.shadowViewsCached, stats.shadowViewsStaticCached);
+            ImGui::Text("Cascades Updated: %d of %d", stats.cascadesUpdated, DIRECTIONAL_CASCADE_COUNT);
+            ImGui::Text("Shadow Atlas: %d lights, %d new tiles, %.0f%% used", stats.localShadowLights, stats.shadowTilesAllocated, stats.shadowAtlasUsage * 100.0f);
+            ImGui::Text("Clustered Lights: %d (%d list entries, %d max per cluster)", stats.lightsClustered, stats.clusterLightRefs, stats.maxClusterLights);
+            ImGui::Separator();
+            ImGui::Text("CPU: %.2f ms  Frame: %.2f ms  (%d frame window)", stats.cpuTime, stats.frameTime, stats.windowFrames);
+            if (ImGui::BeginTable("StageTimes", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Stage (ms)");
+                ImGui::TableSetupColumn("Last");
+                ImGui::TableSetupColumn("Avg");
+                ImGui::TableSetupColumn("P95");
+                ImGui::TableSetupColumn("Max");
+                ImGui::TableHeadersRow();
+
+                auto timingRow = [](const char* name, float last, const RenderTimingSummary& window)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(name);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", last);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", window.avg);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", window.p95);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", window.max);
+                };
+                for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+                {
+                    timingRow(getRenderStageName(static_cast<RenderStage>(s)), stats.stageTime[s], stats.stageTimeWindow[s]);
+                }
+                timingRow("CPU total", stats.cpuTime, stats.cpuTimeWindow);
+                timingRow("Frame", stats.frameTime, stats.frameTimeWindow);
+                ImGui::EndTable();
+            }
+            ImGui::Separator();
+            if (m_traceFramesLeft > 0)
+            {
+                ImGui::Text("Recording trace... %d frames left", m_traceFramesLeft);
+            }
+            else if (ImGui::Button("Capture Trace (300 frames)"))
+            {
+                m_profiler.beginCapture();
+                m_traceFramesLeft = 300;
+            }
             ImGui::End();
         }
 
@@ -1389,6 +1467,9 @@ public:
                 ImGui::Checkbox("Receive Shadows", &obj.receivesShadows);
                 if (ImGui::IsItemHovered()) ImGui::SetTooltip("Object receives shadows from lights");
 
+                ImGui::Checkbox("Occluder", &obj.occluder);
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Object hides other objects in CPU occlusion culling (use for large, simple meshes)");
+
                 
                 ImGui::Separator();
                 
@@ -1990,6 +2071,8 @@ public:
     {
         while (m_pWindow && m_pWindow->isRunning())
         {
+            QUARK_PROFILE_FRAME("Frame");
+
             float currentTime = static_cast<float>(std::chrono::duration<double>(
                 std::chrono::high_resolution_clock::now().time_since_epoch()).count());
             float deltaTime = currentTime - m_lastFrameTime;
@@ -1997,11 +2080,14 @@ public:
             m_time += deltaTime;
             deltaTime = (std::min)(deltaTime, 0.1f);
 
-            updateCamera(deltaTime);
-            updateScene(deltaTime);
-            submitLights();
+            {
+                QUARK_PROFILE_ZONE("DevApp::update");
+                updateCamera(deltaTime);
+                updateScene(deltaTime);
+                submitLights();
 
-            m_pWindow->pollMessages();
+                m_pWindow->pollMessages();
+            }
 
             m_pRenderSystem->setTime(m_time);
             m_pRenderSystem->setDeltaTime(deltaTime);
@@ -2009,10 +2095,22 @@ public:
             m_pRenderSystem->renderFrame();
 
             // Render ImGui overlay
-            renderImGui();
-            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+            {
+                QUARK_PROFILE_ZONE("DevApp::renderImGui");
+                renderImGui();
+                ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+            }
 
             m_pRenderSystem->endFrame();
+
+            if (m_traceFramesLeft > 0 && --m_traceFramesLeft == 0)
+            {
+                m_profiler.endCapture();
+                if (m_profiler.writeChromeTrace("quark_trace.json"))
+                {
+                    std::cout << "Trace written to quark_trace.json (open in ui.perfetto.dev)\n";
+                }
+            }
         }
     }
 
@@ -2187,21 +2285,38 @@ public:
         m_camera.setEulerAngles(eulerAngles);
     }
 
+    static bool sameVec3(const Quark::Vec3& a, const Quark::Vec3& b)
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    void destroySceneProxy(SceneProxy& proxy)
+    {
+        if (proxy.handle)
+            m_pRenderSystem->destroyRenderProxy(proxy.handle);
+        proxy = SceneProxy();
+    }
+
     void updateScene(float dt)
     {
-        // New API: No need to clearRenderQueue, submit does it automatically per frame
+        // Scene objects are retained render proxies: only objects whose
+        // transform, resources or flags changed are sent to the render system
+        m_sceneProxies.resize((std::max)(m_sceneProxies.size(), m_sceneObjects.size()));
 
-        for (auto& obj : m_sceneObjects)
+        for (size_t i = 0; i < m_sceneObjects.size(); ++i)
         {
-            // Skip if not active (completely ignored by render system)
-            if (!obj.active)
-                continue;
-                
-            // Skip if no valid mesh/material
-            if (obj.meshIndex < 0 || obj.materialIndex < 0)
-                continue;
-            if (obj.meshIndex >= (int)m_meshes.size() || obj.materialIndex >= (int)m_materials.size())
+            SceneObject& obj = m_sceneObjects[i];
+            SceneProxy& proxy = m_sceneProxies[i];
+
+            // Inactive objects are completely ignored by the render system
+            bool valid = obj.active &&
+                         obj.meshIndex >= 0 && obj.meshIndex < (int)m_meshes.size() &&
+                         obj.materialIndex >= 0 && obj.materialIndex < (int)m_materials.size();
+            if (!valid)
+            {
+                destroySceneProxy(proxy);
                 continue;
+            }
 
             if (obj.animate)
             {
@@ -2209,6 +2324,30 @@ public:
                 if (obj.rotation.y > 360.0f) obj.rotation.y -= 360.0f;
             }
 
+            // Build flags from SceneObject properties
+            RenderObjectFlags flags = RenderObjectFlags::NONE;
+            if (obj.visible)
+                flags |= RenderObjectFlags::VISIBLE;
+            if (obj.frustumCull)
+                flags |= RenderObjectFlags::FRUSTUM_CULL;
+            if (obj.castsShadows)
+                flags |= RenderObjectFlags::CAST_SHADOW;
+            if (obj.receivesShadows)
+                flags |= RenderObjectFlags::RECEIVE_SHADOW;
+            if (obj.occluder)
+                flags |= RenderObjectFlags::OCCLUDER;
+
+            hMesh mesh = m_meshes[obj.meshIndex].handle;
+            hMaterial material = m_materials[obj.materialIndex].handle;
+
+            bool transformChanged = !sameVec3(proxy.position, obj.position) ||
+                                    !sameVec3(proxy.rotation, obj.rotation) ||
+                                    !sameVec3(proxy.scale, obj.scale);
+            bool objectChanged = proxy.mesh != mesh || proxy.material != material || proxy.flags != flags;
+
+            if (proxy.handle && !transformChanged && !objectChanged)
+                continue;
+
             // Build transform
             Quark::Mat4 translation = Quark::Mat4::Translation(obj.position);
             Quark::Mat4 rotation = Quark::Mat4::RotationX(Quark::Radians(obj.rotation.x)) *
@@ -2217,48 +2356,44 @@ public:
             Quark::Mat4 scale = Quark::Mat4::Scaling(obj.scale);
             Quark::Mat4 worldMatrix = translation * rotation * scale;
 
-            // Calculate world bounds from local mesh bounds
-            const Quark::AABB& localBounds = m_meshes[obj.meshIndex].boundingBox;
-            Quark::Vec3 halfExtent = (localBounds.maxBounds - localBounds.minBounds) * 0.5f;
-            Quark::Vec3 scaledExtent = Quark::Vec3(
-                halfExtent.x * obj.scale.x,
-                halfExtent.y * obj.scale.y,
-                halfExtent.z * obj.scale.z
-            );
-            Quark::AABB worldBounds;
-            worldBounds.minBounds = obj.position - scaledExtent;
-            worldBounds.maxBounds = obj.position + scaledExtent;
-
-
-            // New API: submit(RenderObject) with flags based on SceneObject settings
+            // World bounds are derived from the mesh bounds by the render system
             RenderObject renderObj;
-            renderObj.mesh = m_meshes[obj.meshIndex].handle;
-            renderObj.material = m_materials[obj.materialIndex].handle;
+            renderObj.mesh = mesh;
+            renderObj.material = material;
             renderObj.worldMatrix = worldMatrix;
-            renderObj.worldAABB = worldBounds;
-            
-            // Build flags from SceneObject properties
-            renderObj.flags = RenderObjectFlags::NONE;
-            if (obj.visible)
-                renderObj.flags |= RenderObjectFlags::VISIBLE;
-            if (obj.frustumCull)
-                renderObj.flags |= RenderObjectFlags::FRUSTUM_CULL;
-            if (obj.castsShadows)
-                renderObj.flags |= RenderObjectFlags::CAST_SHADOW;
-            if (obj.receivesShadows)
-                renderObj.flags |= RenderObjectFlags::RECEIVE_SHADOW;
-            
-            m_pRenderSystem->submit(renderObj);
-
+            renderObj.flags = flags;
 
+            if (!proxy.handle)
+                proxy.handle = m_pRenderSystem->createRenderProxy(renderObj);
+            else if (objectChanged)
+                m_pRenderSystem->updateRenderProxy(proxy.handle, renderObj);
+            else
+                m_pRenderSystem->updateProxyTransform(proxy.handle, worldMatrix);
+
+            proxy.mesh = mesh;
+            proxy.material = material;
+            proxy.flags = flags;
+            proxy.position = obj.position;
+            proxy.rotation = obj.rotation;
+            proxy.scale = obj.scale;
         }
 
+        // Objects were removed (delete, undo, scene clear)
+        while (m_sceneProxies.size() > m_sceneObjects.size())
+        {
+            destroySceneProxy(m_sceneProxies.back());
+            m_sceneProxies.pop_back();
+        }
     }
 
     void shutdown()
     {
         if (m_pRenderSystem)
         {
+            for (auto& proxy : m_sceneProxies)
+                destroySceneProxy(proxy);
+            m_sceneProxies.clear();
+
             for (auto& mesh : m_meshes)
                 m_pRenderSystem->destroyMesh(mesh.handle);
             m_meshes.clear();
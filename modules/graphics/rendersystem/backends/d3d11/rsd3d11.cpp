@@ -4,6 +4,7 @@
 #include "rsd3d11_shaders.h"
 #include "rsd3d11_pipeline.h"
 #include "rsd3d11_math_converter.h"
+#include "../../../../headeronly/profiler.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
@@ -22,15 +23,18 @@ RSD3D11::RSD3D11()
     , m_pShaderManager(nullptr)
     , m_pPipelineManager(nullptr)
     , m_pMemoryManager(nullptr)
-    , m_NextMeshHandle(1)
-    , m_NextMaterialHandle(1)
-    , m_NextTextureHandle(1)
     , m_pFrameConstantBuffer(nullptr)
     , m_pMaterialConstantBuffer(nullptr)
     , m_pInstanceBuffer(nullptr)
     , m_InstanceBufferSize(0)
     , m_pLightBuffer(nullptr)
     , m_pLightBufferSRV(nullptr)
+    , m_LightBufferCapacity(0)
+    , m_pLightClusterBuffer(nullptr)
+    , m_pLightClusterSRV(nullptr)
+    , m_pClusterLightIndexBuffer(nullptr)
+    , m_pClusterLightIndexSRV(nullptr)
+    , m_ClusterLightIndexCapacity(0)
     , m_pDefaultSampler(nullptr)
 {
     std::cout << "[RSD3D11] Created.\n";
@@ -100,7 +104,8 @@ void RSD3D11::init(qWndh windowHandle)
     device->CreateSamplerState(&samplerDesc, &m_pDefaultSampler);
 
     // Create light structured buffer for dynamic lighting
-    createLightBuffer();
+    createLightBuffer(64);
+    createClusterBuffers(4096);
 
     if (!m_pDevice->createShadowAtlas(static_cast<UINT32>(DIRECTIONAL_SHADOW_ATLAS_SIZE)))
     {
@@ -129,29 +134,29 @@ void RSD3D11::shutdown()
     std::cout << "[RSD3D11] Shutting down...\n";
 
     // Release mesh buffers
-    for (auto& pair : m_MeshBuffers)
+    for (auto& buffer : m_MeshBuffers)
     {
-        if (pair.second.pVertexBuffer) pair.second.pVertexBuffer->Release();
-        if (pair.second.pIndexBuffer) pair.second.pIndexBuffer->Release();
+        if (buffer.pVertexBuffer) buffer.pVertexBuffer->Release();
+        if (buffer.pIndexBuffer) buffer.pIndexBuffer->Release();
     }
     m_MeshBuffers.clear();
 
     // Release material buffers
-    for (auto& pair : m_MaterialBuffers)
+    for (auto& buffer : m_MaterialBuffers)
     {
-        if (pair.second.pConstantBuffer) pair.second.pConstantBuffer->Release();
+        if (buffer.pConstantBuffer) buffer.pConstantBuffer->Release();
         for (int i = 0; i < 6; ++i)
         {
-            if (pair.second.textures[i]) pair.second.textures[i]->Release();
+            if (buffer.textures[i]) buffer.textures[i]->Release();
         }
     }
     m_MaterialBuffers.clear();
 
     // Release textures
-    for (auto& pair : m_Textures)
+    for (auto& tex : m_Textures)
     {
-        if (pair.second.pTexture) pair.second.pTexture->Release();
-        if (pair.second.pSRV) pair.second.pSRV->Release();
+        if (tex.pTexture) tex.pTexture->Release();
+        if (tex.pSRV) tex.pSRV->Release();
     }
     m_Textures.clear();
 
@@ -160,6 +165,14 @@ void RSD3D11::shutdown()
     if (m_pInstanceBuffer) { m_pInstanceBuffer->Release(); m_pInstanceBuffer = nullptr; }
     if (m_pLightBuffer) { m_pLightBuffer->Release(); m_pLightBuffer = nullptr; }
     if (m_pLightBufferSRV) { m_pLightBufferSRV->Release(); m_pLightBufferSRV = nullptr; }
+    if (m_pLightClusterBuffer) { m_pLightClusterBuffer->Release(); m_pLightClusterBuffer = nullptr; }
+    if (m_pLightClusterSRV) { m_pLightClusterSRV->Release(); m_pLightClusterSRV = nullptr; }
+    if (m_pClusterLightIndexBuffer) { m_pClusterLightIndexBuffer->Release(); m_pClusterLightIndexBuffer = nullptr; }
+    if (m_pClusterLightIndexSRV) { m_pClusterLightIndexSRV->Release(); m_pClusterLightIndexSRV = nullptr; }
+    m_LightBufferCapacity = 0;
+    m_ClusterLightIndexCapacity = 0;
+    m_ShadowTiles.clear();
+    m_NextShadowTiles.clear();
     if (m_pDefaultSampler) { m_pDefaultSampler->Release(); m_pDefaultSampler = nullptr; }
     if (m_pSkyVertexBuffer) { m_pSkyVertexBuffer->Release(); m_pSkyVertexBuffer = nullptr; }
     if (m_pSkyIndexBuffer) { m_pSkyIndexBuffer->Release(); m_pSkyIndexBuffer = nullptr; }
@@ -229,50 +242,55 @@ hMesh RSD3D11::createMeshBuffer(const MeshData& meshData, bool isDynamic)
         }
     }
 
-    hMesh handle = m_NextMeshHandle++;
-    m_MeshBuffers[handle] = buffer;
+    hMesh handle = m_MeshBuffers.insert(buffer);
+    if (handle == 0)
+    {
+        buffer.pVertexBuffer->Release();
+        if (buffer.pIndexBuffer) buffer.pIndexBuffer->Release();
+        std::cerr << "[RSD3D11] ERROR: Mesh buffer storage is full.\n";
+    }
     return handle;
 }
 
 void RSD3D11::destroyMeshBuffer(hMesh handle)
 {
-    auto it = m_MeshBuffers.find(handle);
-    if (it == m_MeshBuffers.end()) return;
+    const D3D11MeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer) return;
 
-    if (it->second.pVertexBuffer) it->second.pVertexBuffer->Release();
-    if (it->second.pIndexBuffer) it->second.pIndexBuffer->Release();
-    m_MeshBuffers.erase(it);
+    if (buffer->pVertexBuffer) buffer->pVertexBuffer->Release();
+    if (buffer->pIndexBuffer) buffer->pIndexBuffer->Release();
+    m_MeshBuffers.remove(handle);
 }
 
 bool RSD3D11::updateMeshBuffer(hMesh handle, const MeshData& meshData)
 {
-    auto it = m_MeshBuffers.find(handle);
-    if (it == m_MeshBuffers.end() || !it->second.isDynamic) return false;
+    D3D11MeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer || !buffer->isDynamic) return false;
 
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
     // Update vertex buffer
     D3D11_MAPPED_SUBRESOURCE mapped;
-    HRESULT hr = context->Map(it->second.pVertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    HRESULT hr = context->Map(buffer->pVertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr))
     {
         memcpy(mapped.pData, meshData.vertices, meshData.vertexCount * sizeof(Vertex));
-        context->Unmap(it->second.pVertexBuffer, 0);
+        context->Unmap(buffer->pVertexBuffer, 0);
     }
 
     // Update index buffer if present
-    if (it->second.pIndexBuffer && meshData.indices)
+    if (buffer->pIndexBuffer && meshData.indices)
     {
-        hr = context->Map(it->second.pIndexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+        hr = context->Map(buffer->pIndexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
         if (SUCCEEDED(hr))
         {
             memcpy(mapped.pData, meshData.indices, meshData.indexCount * sizeof(UINT32));
-            context->Unmap(it->second.pIndexBuffer, 0);
+            context->Unmap(buffer->pIndexBuffer, 0);
         }
     }
 
-    it->second.vertexCount = meshData.vertexCount;
-    it->second.indexCount = meshData.indexCount;
+    buffer->vertexCount = meshData.vertexCount;
+    buffer->indexCount = meshData.indexCount;
     return true;
 }
 
@@ -304,35 +322,39 @@ hMaterial RSD3D11::createMaterialBuffer(const MaterialData& materialData)
         return 0;
     }
 
-    hMaterial handle = m_NextMaterialHandle++;
-    m_MaterialBuffers[handle] = buffer;
+    hMaterial handle = m_MaterialBuffers.insert(buffer);
+    if (handle == 0)
+    {
+        buffer.pConstantBuffer->Release();
+        std::cerr << "[RSD3D11] ERROR: Material buffer storage is full.\n";
+    }
     return handle;
 }
 
 void RSD3D11::destroyMaterialBuffer(hMaterial handle)
 {
-    auto it = m_MaterialBuffers.find(handle);
-    if (it == m_MaterialBuffers.end()) return;
+    const D3D11MaterialBuffer* buffer = m_MaterialBuffers.get(handle);
+    if (!buffer) return;
 
-    if (it->second.pConstantBuffer) it->second.pConstantBuffer->Release();
+    if (buffer->pConstantBuffer) buffer->pConstantBuffer->Release();
     // Note: textures are shared, don't release here
-    m_MaterialBuffers.erase(it);
+    m_MaterialBuffers.remove(handle);
 }
 
 bool RSD3D11::updateMaterialBuffer(hMaterial handle, const MaterialData& materialData)
 {
-    auto it = m_MaterialBuffers.find(handle);
-    if (it == m_MaterialBuffers.end()) return false;
+    D3D11MaterialBuffer* buffer = m_MaterialBuffers.get(handle);
+    if (!buffer) return false;
 
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
     D3D11_MAPPED_SUBRESOURCE mapped;
-    HRESULT hr = context->Map(it->second.pConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    HRESULT hr = context->Map(buffer->pConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr))
     {
         memcpy(mapped.pData, &materialData, sizeof(MaterialData));
-        context->Unmap(it->second.pConstantBuffer, 0);
-        it->second.data = materialData;
+        context->Unmap(buffer->pConstantBuffer, 0);
+        buffer->data = materialData;
         return true;
     }
     return false;
@@ -411,8 +433,14 @@ hTexture RSD3D11::loadTexture(const char* filename)
     // Free image data
     stbi_image_free(imageData);
 
-    hTexture handle = m_NextTextureHandle++;
-    m_Textures[handle] = tex;
+    hTexture handle = m_Textures.insert(tex);
+    if (handle == 0)
+    {
+        tex.pSRV->Release();
+        tex.pTexture->Release();
+        std::cerr << "[RSD3D11] ERROR: Texture storage is full.\n";
+        return 0;
+    }
     
     std::cout << "[RSD3D11] Loaded texture: " << filename << " (" << width << "x" << height << ") with Mipmaps.\n";
     return handle;
@@ -420,318 +448,234 @@ hTexture RSD3D11::loadTexture(const char* filename)
 
 void RSD3D11::destroyTexture(hTexture handle)
 {
-    auto it = m_Textures.find(handle);
-    if (it == m_Textures.end()) return;
+    const D3D11Texture* tex = m_Textures.get(handle);
+    if (!tex) return;
 
-    if (it->second.pTexture) it->second.pTexture->Release();
-    if (it->second.pSRV) it->second.pSRV->Release();
-    m_Textures.erase(it);
+    if (tex->pTexture) tex->pTexture->Release();
+    if (tex->pSRV) tex->pSRV->Release();
+    m_Textures.remove(handle);
 }
 
 bool RSD3D11::bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot)
 {
     if (slot >= 6) return false;
 
-    auto matIt = m_MaterialBuffers.find(material);
-    if (matIt == m_MaterialBuffers.end()) return false;
+    D3D11MaterialBuffer* matBuffer = m_MaterialBuffers.get(material);
+    if (!matBuffer) return false;
 
-    auto texIt = m_Textures.find(texture);
-    if (texIt == m_Textures.end()) return false;
+    const D3D11Texture* tex = m_Textures.get(texture);
+    if (!tex) return false;
 
-    matIt->second.textures[slot] = texIt->second.pSRV;
+    matBuffer->textures[slot] = tex->pSRV;
     return true;
 }
 
-// ==================== SHADOW PASS ====================
-void RSD3D11::renderShadowPass(const FramePacket& packet)
+// ==================== SHADOW INSTANCES ====================
+void RSD3D11::uploadShadowInstanceData(const FramePacket& packet)
 {
-    if (!m_pDevice || packet.shadowDrawCommandCount == 0 || packet.lightCount == 0) return;
+    if (!m_pDevice || packet.shadowInstanceDataCount == 0) return;
 
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
-    // 1. Find shadow casting directional light
-    const GPULightData* pShadowLight = nullptr;
-    for (UINT32 i = 0; i < packet.lightCount; ++i)
+    size_t requiredSize = packet.shadowInstanceDataCount * sizeof(PerInstanceData);
+    resizeInstanceBufferIfNeeded(requiredSize);
+    
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr = context->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (SUCCEEDED(hr))
     {
-        if ((packet.lights[i].flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && 
-            packet.lights[i].type == static_cast<UINT32>(LightType::DIRECTIONAL))
+        PerInstanceData* dest = static_cast<PerInstanceData*>(mapped.pData);
+        for (UINT32 i = 0; i < packet.shadowInstanceDataCount; ++i)
         {
-            pShadowLight = &packet.lights[i];
-            break;
+            dest[i] = convertInstanceData(packet.shadowInstanceData[i]);
         }
+        context->Unmap(m_pInstanceBuffer, 0);
     }
+}
 
-    if (!pShadowLight) return;
+// Draws a range of one shadow view's commands, the viewport must already be set
+void RSD3D11::drawShadowView(const FramePacket& packet, const ShadowView& view, UINT32 commandStart, UINT32 commandCount)
+{
+    if (commandCount == 0) return;
 
-    // 2. Setup Shadow Pipeline
-    m_pDevice->setShadowRenderTarget();
-    m_pDevice->clearShadowAtlas();
-    
-    m_pShaderManager->bindShadowPipeline();
-    m_pPipelineManager->setShadowRasterizer();
+    ID3D11DeviceContext* context = m_pDevice->getContext();
 
-    // 3. Upload shadow instance data (shared for all cascades)
-    if (packet.shadowInstanceDataCount > 0)
-    {
-        size_t requiredSize = packet.shadowInstanceDataCount * sizeof(PerInstanceData);
-        resizeInstanceBufferIfNeeded(requiredSize);
-        
-        D3D11_MAPPED_SUBRESOURCE mapped;
-        HRESULT hr = context->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
-        if (SUCCEEDED(hr))
-        {
-            PerInstanceData* dest = static_cast<PerInstanceData*>(mapped.pData);
-            for (UINT32 i = 0; i < packet.shadowInstanceDataCount; ++i)
-            {
-                dest[i] = convertInstanceData(packet.shadowInstanceData[i]);
-            }
-            context->Unmap(m_pInstanceBuffer, 0);
-        }
-    }
+    // Matrix comes as [-1, 1] from csm.h / lighting.h, convert to [0, 1] and transpose for D3D
+    FrameConstants shadowConstants = convertFrameConstants(packet.constants);
+    shadowConstants.viewProjection = convertShadowProjectionMatrix(view.viewProjection);
+    
+    m_pPipelineManager->updateFrameConstants(shadowConstants);
+    m_pPipelineManager->bindFrameConstants();
 
-    // D3D11 Z correction is now handled directly in computeCascadeMatrix (csm.h)
-    // No manual correction needed here.
+    hMesh lastMesh = 0;
+    UINT instanceStride = sizeof(PerInstanceData);
 
-    // 4. Render each cascade
-    for (UINT32 cascade = 0; cascade < DIRECTIONAL_CASCADE_COUNT; ++cascade)
+    for (UINT32 i = commandStart; i < commandStart + commandCount; ++i)
     {
-        // Set cascade viewport
-        m_pDevice->setCascadeViewport(cascade);
-
-        // Setup constants for this cascade
-        // Matrix comes as [-1, 1] from csm.h, convert to [0, 1] and transpose for D3D
-        FrameConstants shadowConstants = convertFrameConstants(packet.constants);
-        shadowConstants.viewProjection = convertShadowProjectionMatrix(pShadowLight->cascadeMatrices[cascade]);
+        const DrawCommand& cmd = packet.shadowDrawCommands[i];
         
-        m_pPipelineManager->updateFrameConstants(shadowConstants);
-        m_pPipelineManager->bindFrameConstants();
+        const D3D11MeshBuffer* meshBuffer = m_MeshBuffers.get(cmd.mesh);
+        if (!meshBuffer) continue;
 
-        // Draw all shadow geometry
-        hMesh lastMesh = 0;
-        UINT instanceStride = sizeof(PerInstanceData);
-
-        for (UINT32 i = 0; i < packet.shadowDrawCommandCount; ++i)
+        if (cmd.mesh != lastMesh)
         {
-            const DrawCommand& cmd = packet.shadowDrawCommands[i];
-            
-            auto meshIt = m_MeshBuffers.find(cmd.mesh);
-            if (meshIt == m_MeshBuffers.end()) continue;
-
-            if (cmd.mesh != lastMesh)
-            {
-                ID3D11Buffer* buffers[2] = { meshIt->second.pVertexBuffer, m_pInstanceBuffer };
-                UINT strides[2] = { meshIt->second.vertexStride, instanceStride };
-                UINT offsets[2] = { 0, 0 };
-                context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
-                context->IASetIndexBuffer(meshIt->second.pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
-                lastMesh = cmd.mesh;
-            }
-
-            context->DrawIndexedInstanced(meshIt->second.indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
+            ID3D11Buffer* buffers[2] = { meshBuffer->pVertexBuffer, m_pInstanceBuffer };
+            UINT strides[2] = { meshBuffer->vertexStride, instanceStride };
+            UINT offsets[2] = { 0, 0 };
+            context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+            context->IASetIndexBuffer(meshBuffer->pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+            lastMesh = cmd.mesh;
         }
+
+        context->DrawIndexedInstanced(meshBuffer->indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
     }
 }
 
-// ==================== SPOT SHADOW PASS ====================
-void RSD3D11::renderSpotShadowPass(const FramePacket& packet)
+// ==================== SHADOW PASS ====================
+void RSD3D11::renderShadowPass(const FramePacket& packet)
 {
-    if (!m_pDevice || packet.shadowDrawCommandCount == 0 || packet.lightCount == 0) return;
+    QUARK_PROFILE_ZONE("RSD3D11::renderShadowPass");
 
-    ID3D11DeviceContext* context = m_pDevice->getContext();
+    if (!m_pDevice || packet.lightCount == 0) return;
 
-    // Count spot lights that need shadow rendering
-    UINT32 spotShadowCount = 0;
+    // 1. Find shadow casting directional light
+    const GPULightData* pShadowLight = nullptr;
     for (UINT32 i = 0; i < packet.lightCount; ++i)
     {
-        if ((packet.lights[i].flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) &&
-            packet.lights[i].type == static_cast<UINT32>(LightType::SPOT) &&
-            packet.lights[i].shadowIndex >= 0)
+        if ((packet.lights[i].flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && 
+            packet.lights[i].type == static_cast<UINT32>(LightType::DIRECTIONAL))
         {
-            spotShadowCount++;
+            pShadowLight = &packet.lights[i];
+            break;
         }
     }
 
-    if (spotShadowCount == 0) return;
+    if (!pShadowLight) return;
 
-    // Local shadow atlas already cleared in executeFrame before all local shadow passes
-    m_pDevice->setLocalShadowRenderTarget();
-    
-    // Use shadow pipeline (depth-only shader)
-    m_pShaderManager->bindShadowPipeline();
-    m_pPipelineManager->setShadowRasterizer();
+    // 2. Render the cascades that changed
+    // D3D11 Z correction is now handled directly in computeCascadeMatrix (csm.h)
+    // No manual correction needed here.
+    renderShadowViews(packet, false);
+}
 
-    // Upload shadow instance data (shared for all lights)
-    if (packet.shadowInstanceDataCount > 0)
-    {
-        size_t requiredSize = packet.shadowInstanceDataCount * sizeof(PerInstanceData);
-        resizeInstanceBufferIfNeeded(requiredSize);
-        
-        D3D11_MAPPED_SUBRESOURCE mapped;
-        HRESULT hr = context->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
-        if (SUCCEEDED(hr))
-        {
-            PerInstanceData* dest = static_cast<PerInstanceData*>(mapped.pData);
-            for (UINT32 i = 0; i < packet.shadowInstanceDataCount; ++i)
-            {
-                dest[i] = convertInstanceData(packet.shadowInstanceData[i]);
-            }
-            context->Unmap(m_pInstanceBuffer, 0);
-        }
-    }
+// ==================== LOCAL SHADOW PASS ====================
+// Spot lights and point light cube faces, one atlas tile per view
+void RSD3D11::renderLocalShadowPass(const FramePacket& packet)
+{
+    QUARK_PROFILE_ZONE("RSD3D11::renderLocalShadowPass");
+
+    if (!m_pDevice) return;
 
-    // Render shadow map for each spot light
-    for (UINT32 lightIdx = 0; lightIdx < packet.lightCount; ++lightIdx)
+    bool hasLocalViews = false;
+    for (UINT32 v = 0; v < packet.shadowViewCount && !hasLocalViews; ++v)
     {
-        const GPULightData& light = packet.lights[lightIdx];
-        
-        // Skip non-shadow-casting and non-spot lights
-        if (!(light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) ||
-            light.type != static_cast<UINT32>(LightType::SPOT) ||
-            light.shadowIndex < 0)
-        {
-            continue;
-        }
+        hasLocalViews = packet.shadowViews[v].type != ShadowViewType::CASCADE;
+    }
 
-        // Set viewport for this spot light's atlas slot
-        m_pDevice->setLocalShadowSlotViewport(static_cast<UINT32>(light.shadowIndex));
+    if (!hasLocalViews) return;
 
-        // Setup constants with spot light's shadow matrix
-        // Convert to D3D11 format (RH column-major -> LH row-major)
-        FrameConstants shadowConstants = convertFrameConstants(packet.constants);
-        shadowConstants.viewProjection = convertShadowProjectionMatrix(light.spotShadowMatrix);
-        
-        m_pPipelineManager->updateFrameConstants(shadowConstants);
-        m_pPipelineManager->bindFrameConstants();
+    renderShadowViews(packet, true);
+}
 
-        // Draw all shadow geometry
-        hMesh lastMesh = 0;
-        UINT instanceStride = sizeof(PerInstanceData);
+// ==================== SHADOW TILES ====================
+// Replaces the depth of the current viewport with the static cache's (t0) or with 1
+void RSD3D11::fillShadowTile(bool fromCache)
+{
+    ID3D11DeviceContext* context = m_pDevice->getContext();
 
-        for (UINT32 cmdIdx = 0; cmdIdx < packet.shadowDrawCommandCount; ++cmdIdx)
-        {
-            const DrawCommand& cmd = packet.shadowDrawCommands[cmdIdx];
-            
-            auto meshIt = m_MeshBuffers.find(cmd.mesh);
-            if (meshIt == m_MeshBuffers.end()) continue;
+    if (fromCache)
+        m_pShaderManager->bindShadowCacheCopyPipeline();
+    else
+        m_pShaderManager->bindShadowCacheClearPipeline();
+    m_pPipelineManager->setShadowCacheDepthStencilState();
+    m_pPipelineManager->setRasterizerState(CullMode::NONE);
 
-            if (cmd.mesh != lastMesh)
-            {
-                ID3D11Buffer* buffers[2] = { meshIt->second.pVertexBuffer, m_pInstanceBuffer };
-                UINT strides[2] = { meshIt->second.vertexStride, instanceStride };
-                UINT offsets[2] = { 0, 0 };
-                context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
-                context->IASetIndexBuffer(meshIt->second.pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
-                lastMesh = cmd.mesh;
-            }
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->Draw(3, 0);
 
-            context->DrawIndexedInstanced(meshIt->second.indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
-        }
-    }
+    // Back to depth-only caster drawing
+    m_pShaderManager->bindShadowPipeline();
+    m_pPipelineManager->setDefaultDepthStencilState();
+    m_pPipelineManager->setShadowRasterizer();
 }
 
-// ==================== POINT SHADOW PASS (CUBE MAP) ====================
-void RSD3D11::renderPointShadowPass(const FramePacket& packet)
+// The cascade or the local views, in two steps: static layers that changed are drawn
+// into the cache atlas, then every tile that changed is rebuilt from its cached static
+// layer plus the dynamic casters. Tiles still holding the view's version are kept.
+void RSD3D11::renderShadowViews(const FramePacket& packet, bool localViews)
 {
-    if (!m_pDevice || packet.shadowDrawCommandCount == 0 || packet.lightCount == 0) return;
-
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
-    // Count point lights that need shadow rendering
-    UINT32 pointShadowCount = 0;
-    for (UINT32 i = 0; i < packet.lightCount; ++i)
+    auto isPassView = [&](const ShadowView& view)
     {
-        if ((packet.lights[i].flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) &&
-            packet.lights[i].type == static_cast<UINT32>(LightType::POINT) &&
-            packet.lights[i].shadowIndex >= 0)
-        {
-            pointShadowCount++;
-        }
-    }
-
-    if (pointShadowCount == 0) return;
+        return (view.type != ShadowViewType::CASCADE) == localViews;
+    };
+    auto setTileViewport = [&](const ShadowView& view)
+    {
+        if (localViews)
+            m_pDevice->setLocalShadowTileViewport(view.atlasRect);
+        else
+            m_pDevice->setCascadeViewport(view.slot);
+    };
+    auto findHeldTile = [&](const ShadowView& view) -> const D3D11ShadowTile*
+    {
+        return m_ShadowTiles.find(getShadowTileKey(view.type, view.slot, view.atlasRect));
+    };
 
-    // Local shadow atlas should already be set from spot light pass
-    // If no spot lights rendered, we need to set it here
-    m_pDevice->setLocalShadowRenderTarget();
-    
-    // Use shadow pipeline (depth-only shader)
     m_pShaderManager->bindShadowPipeline();
+    m_pPipelineManager->setDefaultDepthStencilState();
     m_pPipelineManager->setShadowRasterizer();
 
-    // Upload shadow instance data (shared for all lights)
-    if (packet.shadowInstanceDataCount > 0)
+    // 1. Static layers
+    bool cacheBound = false;
+    for (UINT32 v = 0; v < packet.shadowViewCount; ++v)
     {
-        size_t requiredSize = packet.shadowInstanceDataCount * sizeof(PerInstanceData);
-        resizeInstanceBufferIfNeeded(requiredSize);
-        
-        D3D11_MAPPED_SUBRESOURCE mapped;
-        HRESULT hr = context->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
-        if (SUCCEEDED(hr))
-        {
-            PerInstanceData* dest = static_cast<PerInstanceData*>(mapped.pData);
-            for (UINT32 i = 0; i < packet.shadowInstanceDataCount; ++i)
-            {
-                dest[i] = convertInstanceData(packet.shadowInstanceData[i]);
-            }
-            context->Unmap(m_pInstanceBuffer, 0);
-        }
-    }
+        const ShadowView& view = packet.shadowViews[v];
+        if (!isPassView(view) || view.staticCommandCount == 0) continue;
 
-    // Render shadow map for each point light (6 faces each)
-    for (UINT32 lightIdx = 0; lightIdx < packet.lightCount; ++lightIdx)
-    {
-        const GPULightData& light = packet.lights[lightIdx];
-        
-        // Skip non-shadow-casting and non-point lights
-        if (!(light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) ||
-            light.type != static_cast<UINT32>(LightType::POINT) ||
-            light.shadowIndex < 0)
+        const D3D11ShadowTile* held = findHeldTile(view);
+        if (view.staticCacheVersion != 0 && held && held->staticVersion == view.staticCacheVersion) continue;
+
+        if (!cacheBound)
         {
-            continue;
+            if (localViews)
+                m_pDevice->setLocalShadowCacheRenderTarget();
+            else
+                m_pDevice->setShadowCacheRenderTarget();
+            cacheBound = true;
         }
 
-        // Render all 6 cube faces
-        for (UINT32 faceIdx = 0; faceIdx < POINT_SHADOW_FACE_COUNT; ++faceIdx)
-        {
-            // Calculate slot index for this face
-            // shadowIndex is the base slot, add faceIdx for each face
-            UINT32 slotIndex = static_cast<UINT32>(light.shadowIndex) + faceIdx;
-            
-            // Set viewport for this face's atlas slot
-            m_pDevice->setLocalShadowSlotViewport(slotIndex);
+        setTileViewport(view);
+        fillShadowTile(false);
+        drawShadowView(packet, view, view.commandStart, view.staticCommandCount);
+    }
 
-            // Setup constants with this face's shadow matrix
-            FrameConstants shadowConstants = convertFrameConstants(packet.constants);
-            shadowConstants.viewProjection = convertShadowProjectionMatrix(light.pointShadowMatrices[faceIdx]);
-            
-            m_pPipelineManager->updateFrameConstants(shadowConstants);
-            m_pPipelineManager->bindFrameConstants();
+    // 2. Live tiles, the cache is read through t0
+    if (localViews)
+        m_pDevice->setLocalShadowRenderTarget();
+    else
+        m_pDevice->setShadowRenderTarget();
 
-            // Draw all shadow geometry
-            hMesh lastMesh = 0;
-            UINT instanceStride = sizeof(PerInstanceData);
+    ID3D11ShaderResourceView* cacheSRV = localViews ? m_pDevice->getLocalShadowCacheSRV() : m_pDevice->getShadowCacheSRV();
+    context->PSSetShaderResources(0, 1, &cacheSRV);
 
-            for (UINT32 cmdIdx = 0; cmdIdx < packet.shadowDrawCommandCount; ++cmdIdx)
-            {
-                const DrawCommand& cmd = packet.shadowDrawCommands[cmdIdx];
-                
-                auto meshIt = m_MeshBuffers.find(cmd.mesh);
-                if (meshIt == m_MeshBuffers.end()) continue;
+    for (UINT32 v = 0; v < packet.shadowViewCount; ++v)
+    {
+        const ShadowView& view = packet.shadowViews[v];
+        if (!isPassView(view)) continue;
 
-                if (cmd.mesh != lastMesh)
-                {
-                    ID3D11Buffer* buffers[2] = { meshIt->second.pVertexBuffer, m_pInstanceBuffer };
-                    UINT strides[2] = { meshIt->second.vertexStride, instanceStride };
-                    UINT offsets[2] = { 0, 0 };
-                    context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
-                    context->IASetIndexBuffer(meshIt->second.pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
-                    lastMesh = cmd.mesh;
-                }
+        const D3D11ShadowTile* held = findHeldTile(view);
+        if (D3D11ShadowTile* next = m_NextShadowTiles.insert(getShadowTileKey(view.type, view.slot, view.atlasRect)))
+            *next = { view.cacheVersion, view.staticCacheVersion };
+        if (view.cacheVersion != 0 && held && held->version == view.cacheVersion) continue;
 
-                context->DrawIndexedInstanced(meshIt->second.indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
-            }
-        }
+        setTileViewport(view);
+        fillShadowTile(view.staticCommandCount > 0);
+        drawShadowView(packet, view, view.commandStart + view.staticCommandCount, view.commandCount - view.staticCommandCount);
     }
+
+    ID3D11ShaderResourceView* nullSRV = nullptr;
+    context->PSSetShaderResources(0, 1, &nullSRV);
 }
 
 // ==================== RENDER SKY ====================
@@ -779,7 +723,13 @@ void RSD3D11::renderSky(const FramePacket& packet)
 // ==================== FRAME EXECUTION ====================
 void RSD3D11::executeFrame(const FramePacket& packet)
 {
-    if (!m_pDevice) return;
+    QUARK_PROFILE_ZONE("RSD3D11::executeFrame");
+
+    if (!m_pDevice)
+    {
+        m_CompletedFrameFence = packet.frameFence;
+        return;
+    }
 
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
@@ -814,16 +764,19 @@ void RSD3D11::executeFrame(const FramePacket& packet)
 
     // Upload light data
     uploadLightData(packet);
+    uploadLightClusters(packet);
 
     // 1. Shadow Passes
-    renderShadowPass(packet);       // Directional CSM
+    // Every view draws a range of the same shadow instance buffer
+    uploadShadowInstanceData(packet);
     
-    // Clear local shadow atlas once before spot and point passes
-    m_pDevice->setLocalShadowRenderTarget();
-    m_pDevice->clearLocalShadowAtlas();
+    // Atlases are not cleared, every view fills its own tile unless it still holds it
+    m_NextShadowTiles.clear();
     
-    renderSpotShadowPass(packet);   // Spot light shadows
-    renderPointShadowPass(packet);  // Point light cube map shadows
+    renderShadowPass(packet);       // Directional CSM
+    renderLocalShadowPass(packet);  // Spot lights and point light cube faces
+    
+    m_ShadowTiles.swap(m_NextShadowTiles);
 
     // 2. Main Pass
     // Restore Main Render Target & Viewport
@@ -847,22 +800,40 @@ void RSD3D11::executeFrame(const FramePacket& packet)
     uploadInstanceData(packet);
 
     // Execute draw commands
-    executeDrawCommands(packet);
+    {
+        QUARK_PROFILE_ZONE("RSD3D11::executeDrawCommands");
+        executeDrawCommands(packet);
+    }
 
     // 3. Sky Pass (render after main geometry, at far plane)
     renderSky(packet);
 
+    // Everything the GPU needs was copied out of the packet above
+    m_CompletedFrameFence = packet.frameFence;
+
     // Note: present() called separately by RenderSystem
 }
 
 void RSD3D11::endFrame()
 {
+    QUARK_PROFILE_ZONE("RSD3D11::present");
+
     if (m_pDevice)
     {
         m_pDevice->present();
     }
 }
 
+UINT64 RSD3D11::getCompletedFrameFence() const
+{
+    return m_CompletedFrameFence;
+}
+
+void RSD3D11::waitForFrameFence(UINT64 /*fence*/)
+{
+    // executeFrame() is synchronous, every submitted fence is already complete
+}
+
 void RSD3D11::uploadFrameConstants(const FramePacket& packet)
 {
     ID3D11DeviceContext* context = m_pDevice->getContext();
@@ -941,33 +912,33 @@ void RSD3D11::executeDrawCommands(const FramePacket& packet)
         const DrawCommand& cmd = packet.drawCommands[i];
 
         // Find mesh buffer
-        auto meshIt = m_MeshBuffers.find(cmd.mesh);
-        if (meshIt == m_MeshBuffers.end()) continue;
+        const D3D11MeshBuffer* meshBuffer = m_MeshBuffers.get(cmd.mesh);
+        if (!meshBuffer) continue;
 
         // Find material buffer
-        auto matIt = m_MaterialBuffers.find(cmd.material);
-        if (matIt == m_MaterialBuffers.end()) continue;
+        const D3D11MaterialBuffer* matBuffer = m_MaterialBuffers.get(cmd.material);
+        if (!matBuffer) continue;
 
         // Bind mesh only if changed
         if (cmd.mesh != lastMesh)
         {
-            ID3D11Buffer* buffers[2] = { meshIt->second.pVertexBuffer, m_pInstanceBuffer };
-            UINT strides[2] = { meshIt->second.vertexStride, instanceStride };
+            ID3D11Buffer* buffers[2] = { meshBuffer->pVertexBuffer, m_pInstanceBuffer };
+            UINT strides[2] = { meshBuffer->vertexStride, instanceStride };
             UINT offsets[2] = { 0, 0 };
             context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
-            context->IASetIndexBuffer(meshIt->second.pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+            context->IASetIndexBuffer(meshBuffer->pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
             lastMesh = cmd.mesh;
         }
 
         // Bind material only if changed
         if (cmd.material != lastMaterial)
         {
-            context->VSSetConstantBuffers(1, 1, &matIt->second.pConstantBuffer);
-            context->PSSetConstantBuffers(1, 1, &matIt->second.pConstantBuffer);
-            context->PSSetShaderResources(0, 6, matIt->second.textures);
+            context->VSSetConstantBuffers(1, 1, &matBuffer->pConstantBuffer);
+            context->PSSetConstantBuffers(1, 1, &matBuffer->pConstantBuffer);
+            context->PSSetShaderResources(0, 6, matBuffer->textures);
             
             // Set cull mode from material
-            CullMode cullMode = static_cast<CullMode>(matIt->second.data.cullMode);
+            CullMode cullMode = static_cast<CullMode>(matBuffer->data.cullMode);
             if (cullMode != lastCullMode)
             {
                 m_pPipelineManager->setRasterizerState(cullMode);
@@ -978,7 +949,7 @@ void RSD3D11::executeDrawCommands(const FramePacket& packet)
         }
 
         // Draw instanced - use StartInstanceLocation for instance buffer offset
-        context->DrawIndexedInstanced(meshIt->second.indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
+        context->DrawIndexedInstanced(meshBuffer->indexCount, cmd.instanceCount, 0, 0, cmd.instanceStart);
     }
 }
 
@@ -1036,51 +1007,90 @@ void* RSD3D11::getContext() const
 }
 
 // ==================== LIGHT BUFFER ====================
-bool RSD3D11::createLightBuffer()
+// Dynamic structured buffer with an SRV over all of it, replaces what buffer and srv held
+bool RSD3D11::createStructuredBuffer(UINT32 stride, UINT32 count, ID3D11Buffer** buffer, ID3D11ShaderResourceView** srv)
 {
     if (!m_pDevice) return false;
+    if (*buffer) { (*buffer)->Release(); *buffer = nullptr; }
+    if (*srv) { (*srv)->Release(); *srv = nullptr; }
 
     ID3D11Device* device = m_pDevice->getDevice();
 
-    // Create structured buffer for lights
     D3D11_BUFFER_DESC bufferDesc = {};
-    bufferDesc.ByteWidth = MAX_LIGHTS * sizeof(GPULightData);
+    bufferDesc.ByteWidth = stride * count;
     bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
     bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
     bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-    bufferDesc.StructureByteStride = sizeof(GPULightData);
+    bufferDesc.StructureByteStride = stride;
 
-    HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, &m_pLightBuffer);
+    HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, buffer);
     if (FAILED(hr))
     {
-        std::cerr << "[RSD3D11] ERROR: Failed to create light buffer.\\n";
         return false;
     }
 
-    // Create SRV for the light buffer
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Format = DXGI_FORMAT_UNKNOWN;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
     srvDesc.Buffer.FirstElement = 0;
-    srvDesc.Buffer.NumElements = MAX_LIGHTS;
+    srvDesc.Buffer.NumElements = count;
 
-    hr = device->CreateShaderResourceView(m_pLightBuffer, &srvDesc, &m_pLightBufferSRV);
+    hr = device->CreateShaderResourceView(*buffer, &srvDesc, srv);
     if (FAILED(hr))
     {
-        std::cerr << "[RSD3D11] ERROR: Failed to create light buffer SRV.\\n";
+        (*buffer)->Release();
+        *buffer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool RSD3D11::createLightBuffer(UINT32 capacity)
+{
+    if (!createStructuredBuffer(sizeof(GPULightData), capacity, &m_pLightBuffer, &m_pLightBufferSRV))
+    {
+        std::cerr << "[RSD3D11] ERROR: Failed to create light buffer.\n";
+        m_LightBufferCapacity = 0;
+        return false;
+    }
+
+    m_LightBufferCapacity = capacity;
+    return true;
+}
+
+bool RSD3D11::createClusterBuffers(UINT32 indexCapacity)
+{
+    if (!m_pLightClusterBuffer &&
+        !createStructuredBuffer(sizeof(LightClusterRange), LIGHT_CLUSTER_COUNT, &m_pLightClusterBuffer, &m_pLightClusterSRV))
+    {
+        std::cerr << "[RSD3D11] ERROR: Failed to create light cluster buffer.\n";
         return false;
     }
 
-    std::cout << "[RSD3D11] Light buffer created (max " << MAX_LIGHTS << " lights).\n";
+    if (!createStructuredBuffer(sizeof(UINT32), indexCapacity, &m_pClusterLightIndexBuffer, &m_pClusterLightIndexSRV))
+    {
+        std::cerr << "[RSD3D11] ERROR: Failed to create cluster light index buffer.\n";
+        m_ClusterLightIndexCapacity = 0;
+        return false;
+    }
+
+    m_ClusterLightIndexCapacity = indexCapacity;
     return true;
 }
 
 void RSD3D11::uploadLightData(const FramePacket& packet)
 {
-    if (!m_pDevice || !m_pLightBuffer) return;
+    if (!m_pDevice) return;
     if (packet.lightCount == 0) return;
 
+    // Double the capacity to avoid frequent reallocations
+    if (packet.lightCount > m_LightBufferCapacity &&
+        !createLightBuffer((std::max)(packet.lightCount, m_LightBufferCapacity * 2)))
+    {
+        return;
+    }
+
     ID3D11DeviceContext* context = m_pDevice->getContext();
 
     // Create Local Copy of Lights with D3D11 conversions
@@ -1092,8 +1102,6 @@ void RSD3D11::uploadLightData(const FramePacket& packet)
         // D3D11 Z correction is now handled directly in computeCascadeMatrix (csm.h)
 
         UINT32 dirShadowCount = 0;
-        UINT32 spotShadowCount = 0;
-        UINT32 pointShadowCount = 0;
         for (UINT32 i = 0; i < packet.lightCount; ++i)
         {
             // 1. Convert to D3D11 format
@@ -1132,21 +1140,10 @@ void RSD3D11::uploadLightData(const FramePacket& packet)
                         keepShadow = true;
                     }
                 }
-                else if (light.type == static_cast<UINT32>(LightType::SPOT))
+                else
                 {
-                    if (spotShadowCount < MAX_SPOT_SHADOW_LIGHTS)
-                    {
-                        spotShadowCount++;
-                        keepShadow = true;
-                    }
-                }
-                else if (light.type == static_cast<UINT32>(LightType::POINT))
-                {
-                    if (pointShadowCount < MAX_POINT_SHADOW_LIGHTS)
-                    {
-                        pointShadowCount++;
-                        keepShadow = true;
-                    }
+                    // Spot and point lights only have shadows when they got atlas tiles
+                    keepShadow = light.shadowIndex >= 0;
                 }
 
                 if (!keepShadow)
@@ -1171,6 +1168,41 @@ void RSD3D11::uploadLightData(const FramePacket& packet)
     context->PSSetShaderResources(6, 1, &m_pLightBufferSRV);
 }
 
+void RSD3D11::uploadLightClusters(const FramePacket& packet)
+{
+    if (!m_pDevice || !m_pLightClusterBuffer) return;
+
+    ID3D11DeviceContext* context = m_pDevice->getContext();
+
+    if (packet.clusterLightIndexCount > m_ClusterLightIndexCapacity &&
+        !createClusterBuffers((std::max)(packet.clusterLightIndexCount, m_ClusterLightIndexCapacity * 2)))
+    {
+        return;
+    }
+
+    // A packet without clusters leaves only the directional lights
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(context->Map(m_pLightClusterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+    {
+        if (packet.lightClusterCount == LIGHT_CLUSTER_COUNT)
+            memcpy(mapped.pData, packet.lightClusters, LIGHT_CLUSTER_COUNT * sizeof(LightClusterRange));
+        else
+            memset(mapped.pData, 0, LIGHT_CLUSTER_COUNT * sizeof(LightClusterRange));
+        context->Unmap(m_pLightClusterBuffer, 0);
+    }
+
+    if (packet.clusterLightIndexCount > 0 &&
+        SUCCEEDED(context->Map(m_pClusterLightIndexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+    {
+        memcpy(mapped.pData, packet.clusterLightIndices, packet.clusterLightIndexCount * sizeof(UINT32));
+        context->Unmap(m_pClusterLightIndexBuffer, 0);
+    }
+
+    // t7: cluster ranges, t8: light indices
+    ID3D11ShaderResourceView* clusterSRVs[2] = { m_pLightClusterSRV, m_pClusterLightIndexSRV };
+    context->PSSetShaderResources(7, 2, clusterSRVs);
+}
+
 // ==================== SKY SPHERE ====================
 bool RSD3D11::createSkySphere()
 {
@@ -1298,3 +1330,8 @@ void destroyRenderBackend(RHI* rhi)
         delete rhi;
     }
 }
+
+void setRenderBackendProfiler(Quark::Profiler* profiler)
+{
+    Quark::setModuleProfiler(profiler, "rsd3d11");
+}
@@ -22,11 +22,14 @@
 #include "../../framepacket.h"
 #include "../../../../headeronly/globaltypes.h"
 #include "../../../../headeronly/mathematics.h"
+#include "../../../../headeronly/slotmap.h"
 #include "rsd3d11_device.h"
 #include "rsd3d11_memory.h"
 #include "rsd3d11_shaders.h"
 #include "rsd3d11_pipeline.h"
 
+namespace Quark { class Profiler; }
+
 // ==================== GPU MESH BUFFER ====================
 struct D3D11MeshBuffer
 {
@@ -53,6 +56,14 @@ struct D3D11Texture
     ID3D11ShaderResourceView* pSRV;
 };
 
+// ==================== SHADOW TILE ====================
+// Versions a shadow tile holds, see ShadowView
+struct D3D11ShadowTile
+{
+    UINT64 version;
+    UINT64 staticVersion;
+};
+
 // ==================== RSD3D11 BACKEND ====================
 class RSD3D11 : public RHI
 {
@@ -64,13 +75,9 @@ private:
     std::unique_ptr<RSD3D11MemoryManager> m_pMemoryManager;
     
     // GPU Resources
-    std::unordered_map<hMesh, D3D11MeshBuffer> m_MeshBuffers;
-    std::unordered_map<hMaterial, D3D11MaterialBuffer> m_MaterialBuffers;
-    std::unordered_map<hTexture, D3D11Texture> m_Textures;
-    
-    hMesh m_NextMeshHandle;
-    hMaterial m_NextMaterialHandle;
-    hTexture m_NextTextureHandle;
+    Quark::SlotMap<D3D11MeshBuffer> m_MeshBuffers;
+    Quark::SlotMap<D3D11MaterialBuffer> m_MaterialBuffers;
+    Quark::SlotMap<D3D11Texture> m_Textures;
     
     // Frame execution buffers
     ID3D11Buffer* m_pFrameConstantBuffer;
@@ -78,9 +85,17 @@ private:
     ID3D11Buffer* m_pInstanceBuffer;
     size_t m_InstanceBufferSize;
     
-    // Light structured buffer
+    // Light structured buffer, grows with the packet's light count
     ID3D11Buffer* m_pLightBuffer;
     ID3D11ShaderResourceView* m_pLightBufferSRV;
+    UINT32 m_LightBufferCapacity;
+    
+    // Light clusters: one range per cluster and the light index lists they point into
+    ID3D11Buffer* m_pLightClusterBuffer;
+    ID3D11ShaderResourceView* m_pLightClusterSRV;
+    ID3D11Buffer* m_pClusterLightIndexBuffer;
+    ID3D11ShaderResourceView* m_pClusterLightIndexSRV;
+    UINT32 m_ClusterLightIndexCapacity;
     
     // Sampler
     ID3D11SamplerState* m_pDefaultSampler;
@@ -90,6 +105,13 @@ private:
     ID3D11Buffer* m_pSkyIndexBuffer = nullptr;
     UINT32 m_SkyIndexCount = 0;
     
+    // Packets are fully copied into GPU buffers inside executeFrame()
+    UINT64 m_CompletedFrameFence = 0;
+    
+    // Shadow tiles drawn by the previous packet and the current one, by getShadowTileKey
+    ShadowTileMap<D3D11ShadowTile> m_ShadowTiles;
+    ShadowTileMap<D3D11ShadowTile> m_NextShadowTiles;
+    
 public:
     RSD3D11();
     ~RSD3D11() override;
@@ -120,6 +142,8 @@ public:
     // Frame Execution
     void executeFrame(const FramePacket& packet) override;
     void endFrame() override;
+    UINT64 getCompletedFrameFence() const override;
+    void waitForFrameFence(UINT64 fence) override;
 
     void onResize(UINT32 width, UINT32 height) override;
 
@@ -131,15 +155,21 @@ private:
     void uploadFrameConstants(const FramePacket& packet);
     void uploadInstanceData(const FramePacket& packet);
     void uploadLightData(const FramePacket& packet);
+    void uploadLightClusters(const FramePacket& packet);
     void executeDrawCommands(const FramePacket& packet);
+    void uploadShadowInstanceData(const FramePacket& packet);
+    void drawShadowView(const FramePacket& packet, const ShadowView& view, UINT32 commandStart, UINT32 commandCount);
+    void fillShadowTile(bool fromCache);
+    void renderShadowViews(const FramePacket& packet, bool localViews);
     void renderShadowPass(const FramePacket& packet);       // Directional CSM
-    void renderSpotShadowPass(const FramePacket& packet);   // Spot light shadows
-    void renderPointShadowPass(const FramePacket& packet);  // Point light cube map shadows
+    void renderLocalShadowPass(const FramePacket& packet);  // Spot lights and point light cube faces
     void renderSky(const FramePacket& packet);              // Sky
     
     bool createInstanceBuffer(size_t size);
     bool resizeInstanceBufferIfNeeded(size_t requiredSize);
-    bool createLightBuffer();
+    bool createStructuredBuffer(UINT32 stride, UINT32 count, ID3D11Buffer** buffer, ID3D11ShaderResourceView** srv);
+    bool createLightBuffer(UINT32 capacity);
+    bool createClusterBuffers(UINT32 indexCapacity);
     bool createSkySphere();
 };
 
@@ -147,4 +177,7 @@ private:
 extern "C" {
     RSD3D11_API RHI* createRenderBackend();
     RSD3D11_API void destroyRenderBackend(RHI* rhi);
+
+    // Records the backend's CPU-side zones into a shared profiler
+    RSD3D11_API void setRenderBackendProfiler(Quark::Profiler* profiler);
 }
\ No newline at end of file
@@ -66,6 +66,14 @@ void RSD3D11Device::shutdown()
     if (m_pLocalShadowAtlasDSV) { m_pLocalShadowAtlasDSV->Release(); m_pLocalShadowAtlasDSV = nullptr; }
     if (m_pLocalShadowAtlasTexture) { m_pLocalShadowAtlasTexture->Release(); m_pLocalShadowAtlasTexture = nullptr; }
 
+    // Shadow Cache cleanup
+    if (m_pShadowCacheSRV) { m_pShadowCacheSRV->Release(); m_pShadowCacheSRV = nullptr; }
+    if (m_pShadowCacheDSV) { m_pShadowCacheDSV->Release(); m_pShadowCacheDSV = nullptr; }
+    if (m_pShadowCacheTexture) { m_pShadowCacheTexture->Release(); m_pShadowCacheTexture = nullptr; }
+    if (m_pLocalShadowCacheSRV) { m_pLocalShadowCacheSRV->Release(); m_pLocalShadowCacheSRV = nullptr; }
+    if (m_pLocalShadowCacheDSV) { m_pLocalShadowCacheDSV->Release(); m_pLocalShadowCacheDSV = nullptr; }
+    if (m_pLocalShadowCacheTexture) { m_pLocalShadowCacheTexture->Release(); m_pLocalShadowCacheTexture = nullptr; }
+
     std::cout << "[RSD3D11Device] Shutdown complete.\n";
 }
 
@@ -396,6 +404,13 @@ bool RSD3D11Device::createShadowAtlas(UINT32 size)
     m_ShadowViewport.MinDepth = 0.0f;
     m_ShadowViewport.MaxDepth = 1.0f;
 
+    // 5. Static layer cache
+    if (!createShadowCache(size, &m_pShadowCacheTexture, &m_pShadowCacheDSV, &m_pShadowCacheSRV))
+    {
+        std::cerr << "[RSD3D11Device] Failed to create Shadow Cache.\n";
+        return false;
+    }
+
     std::cout << "[RSD3D11Device] Shadow Atlas created (" << size << "x" << size << ").\n";
     return true;
 }
@@ -445,6 +460,16 @@ void RSD3D11Device::clearShadowAtlas()
     }
 }
 
+void RSD3D11Device::setShadowCacheRenderTarget()
+{
+    if (m_pContext && m_pShadowCacheDSV)
+    {
+        ID3D11RenderTargetView* nullRTV = nullptr;
+        m_pContext->OMSetRenderTargets(0, &nullRTV, m_pShadowCacheDSV);
+        m_pContext->RSSetViewports(1, &m_ShadowViewport);
+    }
+}
+
 // ==================== LOCAL SHADOW ATLAS (SPOT/POINT) ====================
 bool RSD3D11Device::createLocalShadowAtlas(UINT32 size)
 {
@@ -508,7 +533,14 @@ bool RSD3D11Device::createLocalShadowAtlas(UINT32 size)
     m_LocalShadowViewport.MinDepth = 0.0f;
     m_LocalShadowViewport.MaxDepth = 1.0f;
 
-    std::cout << "[RSD3D11Device] Local Shadow Atlas created (" << size << "x" << size << ", 8x8 grid).\n";
+    // 5. Static layer cache
+    if (!createShadowCache(size, &m_pLocalShadowCacheTexture, &m_pLocalShadowCacheDSV, &m_pLocalShadowCacheSRV))
+    {
+        std::cerr << "[RSD3D11Device] Failed to create Local Shadow Cache.\n";
+        return false;
+    }
+
+    std::cout << "[RSD3D11Device] Local Shadow Atlas created (" << size << "x" << size << ").\n";
     return true;
 }
 
@@ -522,26 +554,22 @@ void RSD3D11Device::setLocalShadowRenderTarget()
     }
 }
 
-void RSD3D11Device::setLocalShadowSlotViewport(UINT32 slotIndex)
+void RSD3D11Device::setLocalShadowTileViewport(const Quark::Vec4& atlasRect)
 {
-    if (!m_pContext || slotIndex >= 64) return;
+    if (!m_pContext || atlasRect.z <= 0.0f || atlasRect.w <= 0.0f) return;
     
-    // 8x8 grid layout
-    constexpr UINT32 GRID_SIZE = 8;
-    float slotSize = static_cast<float>(m_LocalShadowSize) / static_cast<float>(GRID_SIZE);
+    // Tiles come from the render system's quadtree, in UV space of the atlas
+    const float atlasSize = static_cast<float>(m_LocalShadowSize);
     
-    UINT32 col = slotIndex % GRID_SIZE;
-    UINT32 row = slotIndex / GRID_SIZE;
+    D3D11_VIEWPORT tileViewport = {};
+    tileViewport.TopLeftX = atlasRect.x * atlasSize;
+    tileViewport.TopLeftY = atlasRect.y * atlasSize;
+    tileViewport.Width = atlasRect.z * atlasSize;
+    tileViewport.Height = atlasRect.w * atlasSize;
+    tileViewport.MinDepth = 0.0f;
+    tileViewport.MaxDepth = 1.0f;
     
-    D3D11_VIEWPORT slotViewport = {};
-    slotViewport.TopLeftX = static_cast<float>(col) * slotSize;
-    slotViewport.TopLeftY = static_cast<float>(row) * slotSize;
-    slotViewport.Width = slotSize;
-    slotViewport.Height = slotSize;
-    slotViewport.MinDepth = 0.0f;
-    slotViewport.MaxDepth = 1.0f;
-    
-    m_pContext->RSSetViewports(1, &slotViewport);
+    m_pContext->RSSetViewports(1, &tileViewport);
 }
 
 void RSD3D11Device::clearLocalShadowAtlas()
@@ -551,3 +579,52 @@ void RSD3D11Device::clearLocalShadowAtlas()
         m_pContext->ClearDepthStencilView(m_pLocalShadowAtlasDSV, D3D11_CLEAR_DEPTH, 1.0f, 0);
     }
 }
+
+void RSD3D11Device::setLocalShadowCacheRenderTarget()
+{
+    if (m_pContext && m_pLocalShadowCacheDSV)
+    {
+        ID3D11RenderTargetView* nullRTV = nullptr;
+        m_pContext->OMSetRenderTargets(0, &nullRTV, m_pLocalShadowCacheDSV);
+        m_pContext->RSSetViewports(1, &m_LocalShadowViewport);
+    }
+}
+
+// ==================== SHADOW CACHE ====================
+// Depth texture holding the static casters of every cached shadow tile
+bool RSD3D11Device::createShadowCache(UINT32 size, ID3D11Texture2D** outTexture, ID3D11DepthStencilView** outDSV, ID3D11ShaderResourceView** outSRV)
+{
+    D3D11_TEXTURE2D_DESC texDesc = {};
+    texDesc.Width = size;
+    texDesc.Height = size;
+    texDesc.MipLevels = 1;
+    texDesc.ArraySize = 1;
+    texDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.SampleDesc.Quality = 0;
+    texDesc.Usage = D3D11_USAGE_DEFAULT;
+    texDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+    texDesc.CPUAccessFlags = 0;
+    texDesc.MiscFlags = 0;
+
+    if (FAILED(m_pDevice->CreateTexture2D(&texDesc, nullptr, outTexture))) return false;
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+    dsvDesc.Texture2D.MipSlice = 0;
+
+    if (FAILED(m_pDevice->CreateDepthStencilView(*outTexture, &dsvDesc, outDSV))) return false;
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    if (FAILED(m_pDevice->CreateShaderResourceView(*outTexture, &srvDesc, outSRV))) return false;
+
+    // Cleared once, a tile is only read after its static layer was drawn
+    m_pContext->ClearDepthStencilView(*outDSV, D3D11_CLEAR_DEPTH, 1.0f, 0);
+    return true;
+}
@@ -4,6 +4,7 @@
 #include <dxgi.h>
 #include <Windows.h>
 #include "../../../../headeronly/globaltypes.h"
+#include "../../../../headeronly/mathematics.h"
 
 // ==================== D3D11 DEVICE MANAGEMENT ====================
 class RSD3D11Device
@@ -34,12 +35,21 @@ private:
     ID3D11ShaderResourceView* m_pLocalShadowAtlasSRV = nullptr;
     D3D11_VIEWPORT m_LocalShadowViewport = {};
     UINT32 m_LocalShadowSize = 0;
+    
+    // Static layer caches, same size as their atlas so tiles line up
+    ID3D11Texture2D* m_pShadowCacheTexture = nullptr;
+    ID3D11DepthStencilView* m_pShadowCacheDSV = nullptr;
+    ID3D11ShaderResourceView* m_pShadowCacheSRV = nullptr;
+    ID3D11Texture2D* m_pLocalShadowCacheTexture = nullptr;
+    ID3D11DepthStencilView* m_pLocalShadowCacheDSV = nullptr;
+    ID3D11ShaderResourceView* m_pLocalShadowCacheSRV = nullptr;
 
 private:
     bool createDevice(HWND hwnd);
     bool createSwapChain(HWND hwnd);
     bool createRenderTargets();
     bool createDepthStencil();
+    bool createShadowCache(UINT32 size, ID3D11Texture2D** outTexture, ID3D11DepthStencilView** outDSV, ID3D11ShaderResourceView** outSRV);
 
 public:
     RSD3D11Device() = default;
@@ -60,12 +70,14 @@ public:
     void setShadowRenderTarget();
     void setCascadeViewport(UINT32 cascadeIndex);
     void clearShadowAtlas();
+    void setShadowCacheRenderTarget();
     
-    // Local Light Shadow Atlas (8x8 grid for spot/point)
+    // Local Light Shadow Atlas (quadtree tiles for spot/point)
     bool createLocalShadowAtlas(UINT32 size);
     void setLocalShadowRenderTarget();
-    void setLocalShadowSlotViewport(UINT32 slotIndex);  // slotIndex 0-63
+    void setLocalShadowTileViewport(const Quark::Vec4& atlasRect);  // UV offset (xy) and scale (zw)
     void clearLocalShadowAtlas();
+    void setLocalShadowCacheRenderTarget();
 
     // Getters
     ID3D11Device* getDevice() const { return m_pDevice; }
@@ -79,4 +91,6 @@ public:
 
     ID3D11ShaderResourceView* getShadowAtlasSRV() const { return m_pShadowAtlasSRV; }
     ID3D11ShaderResourceView* getLocalShadowAtlasSRV() const { return m_pLocalShadowAtlasSRV; }
+    ID3D11ShaderResourceView* getShadowCacheSRV() const { return m_pShadowCacheSRV; }
+    ID3D11ShaderResourceView* getLocalShadowCacheSRV() const { return m_pLocalShadowCacheSRV; }
 };
\ No newline at end of file
@@ -71,6 +71,7 @@ void RSD3D11PipelineManager::shutdown()
     if (m_pOpaqueBlend) { m_pOpaqueBlend->Release(); m_pOpaqueBlend = nullptr; }
     
     if (m_pSkyDepthStencil) { m_pSkyDepthStencil->Release(); m_pSkyDepthStencil = nullptr; }
+    if (m_pShadowCacheDepthStencil) { m_pShadowCacheDepthStencil->Release(); m_pShadowCacheDepthStencil = nullptr; }
     if (m_pDefaultDepthStencil) { m_pDefaultDepthStencil->Release(); m_pDefaultDepthStencil = nullptr; }
     
     if (m_pCullNoneRasterizer) { m_pCullNoneRasterizer->Release(); m_pCullNoneRasterizer = nullptr; }
@@ -164,6 +165,18 @@ bool RSD3D11PipelineManager::createDepthStencilStates()
         return false;
     }
 
+    // Shadow cache depth stencil: the pixel shader's depth replaces the tile
+    dsDesc.DepthEnable = TRUE;
+    dsDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+    dsDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+
+    hr = m_pDevice->CreateDepthStencilState(&dsDesc, &m_pShadowCacheDepthStencil);
+    if (FAILED(hr))
+    {
+        std::cerr << "[RSD3D11PipelineManager] Failed to create shadow cache depth stencil.\n";
+        return false;
+    }
+
     std::cout << "[RSD3D11PipelineManager] Depth stencil states created.\n";
     return true;
 }
@@ -417,6 +430,18 @@ void RSD3D11PipelineManager::setSkyDepthStencilState()
     }
 }
 
+void RSD3D11PipelineManager::setShadowCacheDepthStencilState()
+{
+    if (m_pContext && m_pShadowCacheDepthStencil)
+    {
+        if (m_pCurrentDepthStencilState != m_pShadowCacheDepthStencil)
+        {
+            m_pContext->OMSetDepthStencilState(m_pShadowCacheDepthStencil, 0);
+            m_pCurrentDepthStencilState = m_pShadowCacheDepthStencil;
+        }
+    }
+}
+
 void RSD3D11PipelineManager::updateSkyConstants(const SkySettings& settings, float time)
 {
     if (!m_pContext || !m_pSkyConstantBuffer) return;
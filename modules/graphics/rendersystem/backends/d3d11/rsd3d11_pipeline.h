@@ -32,6 +32,7 @@ private:
     // Depth stencil states
     ID3D11DepthStencilState* m_pDefaultDepthStencil = nullptr;
     ID3D11DepthStencilState* m_pSkyDepthStencil = nullptr; // Depth test LESS_EQUAL, write OFF
+    ID3D11DepthStencilState* m_pShadowCacheDepthStencil = nullptr; // Depth test ALWAYS, write ON (tile copy/clear)
     
     // Blend states
     ID3D11BlendState* m_pOpaqueBlend = nullptr;
@@ -72,6 +73,7 @@ public:
     void setShadowRasterizer();
     void setDefaultDepthStencilState();
     void setSkyDepthStencilState();
+    void setShadowCacheDepthStencilState();
     void setOpaqueBlendState();
     void setAlphaBlendState();
     void bindSamplers();
@@ -2,6 +2,7 @@
 #include "shaders/rsd3d11_main_ps.h"
 #include "shaders/rsd3d11_main_vs.h"
 #include "shaders/rsd3d11_shadow_vs.h"
+#include "shaders/rsd3d11_shadowcache.h"
 #include "shaders/rsd3d11_sky_vs.h"
 #include "shaders/rsd3d11_sky_ps.h"
 #include "../../lighting.h"
@@ -35,6 +36,12 @@ bool RSD3D11ShaderManager::initialize(ID3D11Device* device, ID3D11DeviceContext*
         return false;
     }
 
+    if (!createShadowCacheShaders())
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to create Shadow Cache shaders.\n";
+        return false;
+    }
+
     if (!createSkyShaders())
     {
         std::cerr << "[RSD3D11ShaderManager] Failed to create Sky shaders.\n";
@@ -53,6 +60,9 @@ void RSD3D11ShaderManager::shutdown()
     if (m_pPBRPixelShader) { m_pPBRPixelShader->Release(); m_pPBRPixelShader = nullptr; }
     if (m_pPBRVertexShader) { m_pPBRVertexShader->Release(); m_pPBRVertexShader = nullptr; }
     if (m_pShadowVertexShader) { m_pShadowVertexShader->Release(); m_pShadowVertexShader = nullptr; }
+    if (m_pShadowCacheVertexShader) { m_pShadowCacheVertexShader->Release(); m_pShadowCacheVertexShader = nullptr; }
+    if (m_pShadowCacheCopyPixelShader) { m_pShadowCacheCopyPixelShader->Release(); m_pShadowCacheCopyPixelShader = nullptr; }
+    if (m_pShadowCacheClearPixelShader) { m_pShadowCacheClearPixelShader->Release(); m_pShadowCacheClearPixelShader = nullptr; }
     if (m_pSkyVertexShader) { m_pSkyVertexShader->Release(); m_pSkyVertexShader = nullptr; }
     if (m_pSkyPixelShader) { m_pSkyPixelShader->Release(); m_pSkyPixelShader = nullptr; }
     
@@ -163,9 +173,7 @@ bool RSD3D11ShaderManager::createPBRShaders()
     }
 
     // Prepare macros from lighting.h
-    std::string maxLightsStr = std::to_string(MAX_LIGHTS);
     std::string cascadeCountStr = std::to_string(DIRECTIONAL_CASCADE_COUNT);
-    std::string shadowGridSizeStr = std::to_string(LOCAL_SHADOW_GRID_SIZE);
     
     std::string typeNoneStr = std::to_string(static_cast<int>(LightType::NONE));
     std::string typeDirStr = std::to_string(static_cast<int>(LightType::DIRECTIONAL));
@@ -176,9 +184,7 @@ bool RSD3D11ShaderManager::createPBRShaders()
     std::string flagShadowStr = std::to_string(static_cast<int>(LightFlags::LIGHT_CAST_SHADOWS));
 
     D3D_SHADER_MACRO defines[] = {
-        { "MAX_LIGHTS", maxLightsStr.c_str() },
         { "DIRECTIONAL_CASCADE_COUNT", cascadeCountStr.c_str() },
-        { "LOCAL_SHADOW_GRID_SIZE", shadowGridSizeStr.c_str() },
         { "LIGHT_TYPE_NONE", typeNoneStr.c_str() },
         { "LIGHT_TYPE_DIRECTIONAL", typeDirStr.c_str() },
         { "LIGHT_TYPE_POINT", typePointStr.c_str() },
@@ -271,6 +277,103 @@ void RSD3D11ShaderManager::bindShadowPipeline()
     }
 }
 
+// ==================== SHADOW CACHE SHADER IMPL ====================
+bool RSD3D11ShaderManager::createShadowCacheShaders()
+{
+    ID3DBlob* vsBlob = nullptr;
+    ID3DBlob* copyBlob = nullptr;
+    ID3DBlob* clearBlob = nullptr;
+
+    // Compile Shadow Cache shaders (one source, three entry points)
+    if (!compileShaderFromSource(g_ShadowCacheShaderSource, "VSMain", "vs_5_0", &vsBlob))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to compile Shadow Cache vertex shader.\n";
+        return false;
+    }
+
+    HRESULT hr = m_pDevice->CreateVertexShader(
+        vsBlob->GetBufferPointer(),
+        vsBlob->GetBufferSize(),
+        nullptr,
+        &m_pShadowCacheVertexShader
+    );
+
+    vsBlob->Release();
+
+    if (FAILED(hr))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to create Shadow Cache vertex shader.\n";
+        return false;
+    }
+
+    if (!compileShaderFromSource(g_ShadowCacheShaderSource, "CopyPS", "ps_5_0", &copyBlob))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to compile Shadow Cache copy pixel shader.\n";
+        return false;
+    }
+
+    hr = m_pDevice->CreatePixelShader(
+        copyBlob->GetBufferPointer(),
+        copyBlob->GetBufferSize(),
+        nullptr,
+        &m_pShadowCacheCopyPixelShader
+    );
+
+    copyBlob->Release();
+
+    if (FAILED(hr))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to create Shadow Cache copy pixel shader.\n";
+        return false;
+    }
+
+    if (!compileShaderFromSource(g_ShadowCacheShaderSource, "ClearPS", "ps_5_0", &clearBlob))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to compile Shadow Cache clear pixel shader.\n";
+        return false;
+    }
+
+    hr = m_pDevice->CreatePixelShader(
+        clearBlob->GetBufferPointer(),
+        clearBlob->GetBufferSize(),
+        nullptr,
+        &m_pShadowCacheClearPixelShader
+    );
+
+    clearBlob->Release();
+
+    if (FAILED(hr))
+    {
+        std::cerr << "[RSD3D11ShaderManager] Failed to create Shadow Cache clear pixel shader.\n";
+        return false;
+    }
+
+    std::cout << "[RSD3D11ShaderManager] Shadow Cache shaders created successfully.\n";
+    return true;
+}
+
+void RSD3D11ShaderManager::bindShadowCacheCopyPipeline()
+{
+    if (m_pContext)
+    {
+        m_pContext->VSSetShader(m_pShadowCacheVertexShader, nullptr, 0);
+        m_pContext->PSSetShader(m_pShadowCacheCopyPixelShader, nullptr, 0);
+        
+        // Fullscreen triangle from SV_VertexID
+        m_pContext->IASetInputLayout(nullptr);
+    }
+}
+
+void RSD3D11ShaderManager::bindShadowCacheClearPipeline()
+{
+    if (m_pContext)
+    {
+        m_pContext->VSSetShader(m_pShadowCacheVertexShader, nullptr, 0);
+        m_pContext->PSSetShader(m_pShadowCacheClearPixelShader, nullptr, 0);
+        m_pContext->IASetInputLayout(nullptr);
+    }
+}
+
 // ==================== SKY SHADER IMPL ====================
 bool RSD3D11ShaderManager::createSkyShaders()
 {
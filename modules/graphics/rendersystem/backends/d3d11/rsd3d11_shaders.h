@@ -20,6 +20,11 @@ private:
     // Shadow Pipeline
     ID3D11VertexShader* m_pShadowVertexShader = nullptr;
 
+    // Shadow Cache Pipeline (tile copy/clear)
+    ID3D11VertexShader* m_pShadowCacheVertexShader = nullptr;
+    ID3D11PixelShader* m_pShadowCacheCopyPixelShader = nullptr;
+    ID3D11PixelShader* m_pShadowCacheClearPixelShader = nullptr;
+
     // Sky Pipeline
     ID3D11VertexShader* m_pSkyVertexShader = nullptr;
     ID3D11PixelShader* m_pSkyPixelShader = nullptr;
@@ -28,6 +33,7 @@ private:
         const char* target, ID3DBlob** outBlob, const D3D_SHADER_MACRO* defines = nullptr);
     bool createPBRShaders();
     bool createShadowShaders();
+    bool createShadowCacheShaders();
     bool createSkyShaders();
 
 public:
@@ -39,6 +45,8 @@ public:
     
     void bindPBRPipeline();
     void bindShadowPipeline();
+    void bindShadowCacheCopyPipeline();     // Static cache SRV goes to t0
+    void bindShadowCacheClearPipeline();
     void bindSkyPipeline();
     
     // Getters
@@ -6,10 +6,6 @@
 // Part 1A: Constants, Structs, Resources
 static const char* g_PBRPixelShaderSource_Part1A = R"(
 // ==================== CONSTANTS ====================
-#ifndef MAX_LIGHTS
-#define MAX_LIGHTS 64
-#endif
-
 #ifndef PI
 #define PI 3.14159265359
 #endif
@@ -18,10 +14,6 @@ static const char* g_PBRPixelShaderSource_Part1A = R"(
 #define DIRECTIONAL_CASCADE_COUNT 4
 #endif
 
-#ifndef LOCAL_SHADOW_GRID_SIZE
-#define LOCAL_SHADOW_GRID_SIZE 8
-#endif
-
 #ifndef POINT_SHADOW_FACE_COUNT
 #define POINT_SHADOW_FACE_COUNT 6
 #endif
@@ -55,6 +47,7 @@ static const char* g_PBRPixelShaderSource_Part1A = R"(
 #define OBJFLAG_CAST_SHADOW    0x08
 #define OBJFLAG_RECEIVE_SHADOW 0x10
 #define OBJFLAG_FRUSTUM_CULL   0x20
+#define OBJFLAG_OCCLUDER       0x40
 
 // Material flags
 #define MATFLAG_ALBEDO_MAP    0x01
@@ -82,7 +75,7 @@ struct GPULight
     uint flags;
     
     float3 attenuation;
-    int shadowMapIndex;
+    int shadowMapIndex;  // -1 = no shadow
     
     // CSM data
     float4 cascadeSplits;
@@ -93,6 +86,9 @@ struct GPULight
     
     // Point light cube face shadow matrices
     matrix pointShadowMatrices[POINT_SHADOW_FACE_COUNT];
+    
+    // Local shadow atlas tiles: UV offset (xy) and scale (zw), spot lights use the first
+    float4 shadowRects[POINT_SHADOW_FACE_COUNT];
 };
 
 // ==================== FRAME CONSTANTS ====================
@@ -113,6 +109,17 @@ cbuffer FrameConstants : register(b0)
     uint g_ActiveLightCount;
     uint g_ShadowAtlasSize;
     uint g_LocalShadowAtlasSize;  // Spot/Point shadow atlas size
+    
+    // Light clusters (see lightclusters.h)
+    uint g_ClusterGridX;
+    uint g_ClusterGridY;
+    uint g_ClusterGridZ;
+    uint g_DirectionalLightCount; // Directional lights lead g_Lights and are not clustered
+    
+    float g_ClusterDepthScale;    // Slice = log(view depth) * scale + bias
+    float g_ClusterDepthBias;
+    float g_ClusterTileScaleX;    // Tile = pixel * scale
+    float g_ClusterTileScaleY;
 };
 
 // ==================== MATERIAL CONSTANTS ====================
@@ -148,6 +155,16 @@ cbuffer MaterialConstants : register(b1)
 // ==================== RESOURCES ====================
 StructuredBuffer<GPULight> g_Lights : register(t6);
 
+// Per cluster range of g_ClusterLightIndices
+struct LightCluster
+{
+    uint offset;
+    uint count;
+};
+
+StructuredBuffer<LightCluster> g_LightClusters : register(t7);
+StructuredBuffer<uint> g_ClusterLightIndices : register(t8);
+
 Texture2D g_AlbedoTexture : register(t0);
 Texture2D g_NormalTexture : register(t1);
 Texture2D g_MetallicTexture : register(t2);
@@ -557,42 +574,17 @@ float CalculateShadow(float4 shadowPos, float3 N, float3 L, float softness, floa
 
 // Part 2A: Spot/Point Shadow Functions
 static const char* g_PBRPixelShaderSource_Part2A = R"(
-// ==================== SPOT LIGHT SHADOW CALCULATION ====================
-float CalculateSpotShadow(float3 worldPos, GPULight light, float3 N, float3 L)
+// ==================== LOCAL SHADOW ATLAS SAMPLING ====================
+// tileUV is in [0, 1] over the light's tile, rect is its atlas tile (UV offset xy, scale zw).
+// The PCF footprint is kept inside the tile so no neighbouring tile bleeds in.
+float SampleLocalShadow(float2 tileUV, float4 rect, float currentDepth, uint quality)
 {
-    // Transform to light space
-    float4 shadowPos = mul(float4(worldPos, 1.0), light.spotShadowMatrix);
-    
-    // Perspective divide
-    float3 projCoords = shadowPos.xyz / shadowPos.w;
-    
-    // Transform from [-1, 1] to [0, 1]
-    projCoords.x = projCoords.x * 0.5 + 0.5;
-    projCoords.y = -projCoords.y * 0.5 + 0.5;
-    
-    // Check if out of frustum
-    if (projCoords.z > 1.0 || projCoords.z < 0.0 ||
-        projCoords.x < 0.0 || projCoords.x > 1.0 || 
-        projCoords.y < 0.0 || projCoords.y > 1.0)
-        return 1.0;
-    
-    // Calculate atlas UV (grid, slot index in shadowMapIndex)
-    float gridSize = float(LOCAL_SHADOW_GRID_SIZE);
-    float slotSize = 1.0 / gridSize;
-    float col = float(light.shadowMapIndex % LOCAL_SHADOW_GRID_SIZE);
-    float row = float(light.shadowMapIndex / LOCAL_SHADOW_GRID_SIZE);
-    float2 atlasOffset = float2(col, row) * slotSize;
-    float2 atlasUV = projCoords.xy * slotSize + atlasOffset;
-    
-    // Bias to prevent shadow acne
-    float NdotL = saturate(dot(N, L));
-    float bias = max(0.001 * (1.0 - NdotL), 0.0005);
-    float currentDepth = projCoords.z - bias;
+    float2 texelSize = 1.0 / (float)g_LocalShadowAtlasSize;
+    float kernelRadius = quality <= 1 ? 0.0 : (quality == 2 ? 1.0 : 2.0);
+    float2 padding = (kernelRadius + 0.5) * texelSize;
+    float2 atlasUV = clamp(tileUV * rect.zw + rect.xy, rect.xy + padding, rect.xy + rect.zw - padding);
     
-    // PCF filtering based on shadow quality
     float shadow = 0.0;
-    float2 texelSize = 1.0 / (float)g_LocalShadowAtlasSize;
-    uint quality = light.shadowQuality;
     
     if (quality <= 1)
     {
@@ -629,6 +621,33 @@ float CalculateSpotShadow(float3 worldPos, GPULight light, float3 N, float3 L)
     return shadow;
 }
 
+// ==================== SPOT LIGHT SHADOW CALCULATION ====================
+float CalculateSpotShadow(float3 worldPos, GPULight light, float3 N, float3 L)
+{
+    // Transform to light space
+    float4 shadowPos = mul(float4(worldPos, 1.0), light.spotShadowMatrix);
+    
+    // Perspective divide
+    float3 projCoords = shadowPos.xyz / shadowPos.w;
+    
+    // Transform from [-1, 1] to [0, 1]
+    projCoords.x = projCoords.x * 0.5 + 0.5;
+    projCoords.y = -projCoords.y * 0.5 + 0.5;
+    
+    // Check if out of frustum
+    if (projCoords.z > 1.0 || projCoords.z < 0.0 ||
+        projCoords.x < 0.0 || projCoords.x > 1.0 || 
+        projCoords.y < 0.0 || projCoords.y > 1.0)
+        return 1.0;
+    
+    // Bias to prevent shadow acne
+    float NdotL = saturate(dot(N, L));
+    float bias = max(0.001 * (1.0 - NdotL), 0.0005);
+    float currentDepth = projCoords.z - bias;
+    
+    return SampleLocalShadow(projCoords.xy, light.shadowRects[0], currentDepth, light.shadowQuality);
+}
+
 // ==================== POINT LIGHT SHADOW CALCULATION (CUBE MAP) ====================
 // Select which cube face the fragment falls on based on light-to-fragment direction
 uint SelectCubeFace(float3 lightToFrag)
@@ -667,69 +686,29 @@ float CalculatePointShadow(float3 worldPos, GPULight light, float3 N, float3 L)
         projCoords.y < 0.0 || projCoords.y > 1.0)
         return 1.0;
     
-    // Calculate atlas slot: base slot + face index
-    uint slotIndex = light.shadowMapIndex + faceIndex;
-    
-    // Calculate atlas UV (8x8 grid) with edge padding to prevent bleeding
-    float gridSize = float(LOCAL_SHADOW_GRID_SIZE);
-    float slotSize = 1.0 / gridSize;
-    float col = float(slotIndex % LOCAL_SHADOW_GRID_SIZE);
-    float row = float(slotIndex / LOCAL_SHADOW_GRID_SIZE);
-    float2 atlasOffset = float2(col, row) * slotSize;
-    
-    // Add edge padding: shrink UV range slightly to avoid sampling adjacent slots
-    float edgePadding = 0.5 / (float)g_LocalShadowAtlasSize;  // Half texel padding
-    float2 clampedUV = clamp(projCoords.xy, edgePadding, 1.0 - edgePadding);
-    float2 atlasUV = clampedUV * slotSize + atlasOffset;
-    
     // Bias to prevent shadow acne
     float NdotL = saturate(dot(N, L));
     float bias = max(0.002 * (1.0 - NdotL), 0.001);
     float currentDepth = projCoords.z - bias;
     
-    // PCF filtering based on shadow quality
-    float shadow = 0.0;
-    float2 texelSize = 1.0 / (float)g_LocalShadowAtlasSize;
-    uint quality = light.shadowQuality;
-    
-    if (quality <= 1)
-    {
-        // Hard shadows - single sample
-        shadow = g_LocalShadowAtlas.SampleCmpLevelZero(g_ShadowSampler, atlasUV, currentDepth);
-    }
-    else if (quality == 2)
-    {
-        // Medium shadows - 3x3 PCF
-        for (int x = -1; x <= 1; ++x)
-        {
-            for (int y = -1; y <= 1; ++y)
-            {
-                float2 offset = float2(x, y) * texelSize;
-                shadow += g_LocalShadowAtlas.SampleCmpLevelZero(g_ShadowSampler, atlasUV + offset, currentDepth);
-            }
-        }
-        shadow /= 9.0;
-    }
-    else
-    {
-        // Soft shadows - 5x5 PCF
-        for (int x = -2; x <= 2; ++x)
-        {
-            for (int y = -2; y <= 2; ++y)
-            {
-                float2 offset = float2(x, y) * texelSize;
-                shadow += g_LocalShadowAtlas.SampleCmpLevelZero(g_ShadowSampler, atlasUV + offset, currentDepth);
-            }
-        }
-        shadow /= 25.0;
-    }
-    
-    return shadow;
+    // Every face has its own tile
+    return SampleLocalShadow(projCoords.xy, light.shadowRects[faceIndex], currentDepth, light.shadowQuality);
 }
 )";
 
 // Part 2B: Main Pixel Shader
 static const char* g_PBRPixelShaderSource_Part2B = R"(
+// ==================== LIGHT CLUSTERS ====================
+// Same mapping as getLightClusterIndex() in framepacket.h
+uint GetLightClusterIndex(float2 pixel, float viewDepth)
+{
+    uint x = min((uint)(pixel.x * g_ClusterTileScaleX), g_ClusterGridX - 1);
+    uint y = min((uint)(pixel.y * g_ClusterTileScaleY), g_ClusterGridY - 1);
+    float slice = log(max(viewDepth, 1e-6)) * g_ClusterDepthScale + g_ClusterDepthBias;
+    uint z = min((uint)max(slice, 0.0), g_ClusterGridZ - 1);
+    return (z * g_ClusterGridY + y) * g_ClusterGridX + x;
+}
+
 // ==================== PIXEL SHADER MAIN ======================================
 float4 main(PS_INPUT input) : SV_TARGET
 {
@@ -784,9 +763,15 @@ float4 main(PS_INPUT input) : SV_TARGET
     // ==================== LIGHTING LOOP ====================
     float3 Lo = float3(0.0, 0.0, 0.0);
     
-    uint lightCount = min(g_ActiveLightCount, MAX_LIGHTS);
-    for (uint i = 0; i < lightCount; i++)
+    // Directional lights, then the point and spot lights of this pixel's cluster
+    float pixelViewDepth = -mul(float4(input.worldPos, 1.0), g_View).z;
+    LightCluster cluster = g_LightClusters[GetLightClusterIndex(input.position.xy, pixelViewDepth)];
+    
+    uint directionalCount = min(g_DirectionalLightCount, g_ActiveLightCount);
+    uint lightCount = directionalCount + cluster.count;
+    for (uint n = 0; n < lightCount; n++)
     {
+        uint i = n < directionalCount ? n : g_ClusterLightIndices[cluster.offset + n - directionalCount];
         GPULight light = g_Lights[i];
         
         // Skip disabled lights
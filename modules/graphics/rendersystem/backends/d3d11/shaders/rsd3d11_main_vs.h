@@ -22,6 +22,16 @@ cbuffer FrameConstants : register(b0)
     uint g_ActiveLightCount;
     uint g_ShadowAtlasSize;
     uint g_LocalShadowAtlasSize;
+    
+    uint g_ClusterGridX;
+    uint g_ClusterGridY;
+    uint g_ClusterGridZ;
+    uint g_DirectionalLightCount;
+    
+    float g_ClusterDepthScale;
+    float g_ClusterDepthBias;
+    float g_ClusterTileScaleX;
+    float g_ClusterTileScaleY;
 };
 
 // ==================== VERTEX INPUT ====================
@@ -67,8 +77,8 @@ VS_OUTPUT main(VS_INPUT input)
     output.worldPos = worldPos.xyz;
     
     // Transform normal to world space using inverse transpose
-    // For correct lighting: N' = (M^-1)^T * N
-    output.normal = normalize(mul((float3x3)worldInvTranspose, input.normal));
+    // For correct lighting: N' = (M^-1)^T * N, uploaded like the world matrix (row vector form)
+    output.normal = normalize(mul(input.normal, (float3x3)worldInvTranspose));
     
     // Transform tangent and bitangent to world space
     // Tangent/bitangent use regular world matrix (they follow surface, not normals)
@@ -0,0 +1,27 @@
+// ==================== rsd3d11_shadowcache.h ====================
+// Shadow Cache Shaders - Fill one shadow tile (viewport) from the static cache atlas or clear it
+#pragma once
+
+static const char* g_ShadowCacheShaderSource = R"(
+// Same size as the atlas being written, so a pixel reads the texel it covers
+Texture2D<float> g_StaticShadowCache : register(t0);
+
+// ==================== VERTEX SHADER ====================
+// Fullscreen triangle, the viewport cuts it down to the tile
+float4 VSMain(uint vertexId : SV_VertexID) : SV_POSITION
+{
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+// ==================== PIXEL SHADERS ====================
+float CopyPS(float4 position : SV_POSITION) : SV_Depth
+{
+    return g_StaticShadowCache.Load(int3(position.xy, 0));
+}
+
+float ClearPS(float4 position : SV_POSITION) : SV_Depth
+{
+    return 1.0;
+}
+)";
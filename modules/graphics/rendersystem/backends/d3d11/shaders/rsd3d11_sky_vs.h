@@ -21,6 +21,16 @@ cbuffer FrameConstants : register(b0)
     uint g_ActiveLightCount;
     uint g_ShadowAtlasSize;
     uint g_LocalShadowAtlasSize;
+    
+    uint g_ClusterGridX;
+    uint g_ClusterGridY;
+    uint g_ClusterGridZ;
+    uint g_DirectionalLightCount;
+    
+    float g_ClusterDepthScale;
+    float g_ClusterDepthBias;
+    float g_ClusterTileScaleX;
+    float g_ClusterTileScaleY;
 };
 
 // ==================== VERTEX INPUT ====================
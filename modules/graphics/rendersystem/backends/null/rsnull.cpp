@@ -0,0 +1,306 @@
+#include "rsnull.h"
+#include <iostream>
+#include <cstring>
+
+constexpr UINT64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr UINT64 FNV_PRIME = 1099511628211ull;
+
+static UINT64 hashBytes(UINT64 hash, const void* data, size_t size)
+{
+    const UINT8* bytes = static_cast<const UINT8*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// ==================== CONSTRUCTOR / DESTRUCTOR ====================
+RSNull::RSNull()
+    : m_ChecksumEnabled(false)
+    , m_Initialized(false)
+    , m_Width(0)
+    , m_Height(0)
+    , m_CompletedFrameFence(0)
+{
+    memset(&m_Stats, 0, sizeof(NullRHIStats));
+    std::cout << "[RSNull] Created.\n";
+}
+
+RSNull::~RSNull()
+{
+    shutdown();
+}
+
+// ==================== INITIALIZATION ====================
+void RSNull::init(qWndh)
+{
+    // No device and no window needed, the handle is ignored
+    memset(&m_Stats, 0, sizeof(NullRHIStats));
+    m_CompletedFrameFence = 0;
+    m_Initialized = true;
+    std::cout << "[RSNull] Initialized (headless).\n";
+}
+
+void RSNull::shutdown()
+{
+    if (!m_Initialized) return;
+
+    m_MeshBuffers.clear();
+    m_MaterialBuffers.clear();
+    m_Textures.clear();
+    m_Stats.meshCount = 0;
+    m_Stats.materialCount = 0;
+    m_Stats.textureCount = 0;
+    m_Stats.meshBytes = 0;
+    m_Initialized = false;
+
+    std::cout << "[RSNull] Shutdown complete.\n";
+}
+
+// ==================== GPU MESH BUFFERS ====================
+hMesh RSNull::createMeshBuffer(const MeshData& meshData, bool isDynamic)
+{
+    if (!meshData.vertices || meshData.vertexCount == 0)
+    {
+        std::cerr << "[RSNull] ERROR: Invalid mesh data.\n";
+        return 0;
+    }
+
+    NullMeshBuffer buffer = {};
+    buffer.vertexCount = meshData.vertexCount;
+    buffer.indexCount = meshData.indices ? meshData.indexCount : 0;
+    buffer.bytes = static_cast<UINT64>(buffer.vertexCount) * sizeof(Vertex) + static_cast<UINT64>(buffer.indexCount) * sizeof(UINT32);
+    buffer.isDynamic = isDynamic;
+
+    hMesh handle = m_MeshBuffers.insert(buffer);
+    if (handle == 0) return 0;
+
+    m_Stats.meshCount++;
+    m_Stats.meshBytes += buffer.bytes;
+    return handle;
+}
+
+void RSNull::destroyMeshBuffer(hMesh handle)
+{
+    NullMeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer) return;
+
+    m_Stats.meshCount--;
+    m_Stats.meshBytes -= buffer->bytes;
+    m_MeshBuffers.remove(handle);
+}
+
+bool RSNull::updateMeshBuffer(hMesh handle, const MeshData& meshData)
+{
+    // Same rules as a GPU backend: only dynamic buffers, no growth past the original size
+    NullMeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer || !buffer->isDynamic || !meshData.vertices) return false;
+
+    UINT64 bytes = static_cast<UINT64>(meshData.vertexCount) * sizeof(Vertex) +
+                   static_cast<UINT64>(meshData.indices ? meshData.indexCount : 0) * sizeof(UINT32);
+    if (bytes > buffer->bytes) return false;
+
+    buffer->vertexCount = meshData.vertexCount;
+    if (meshData.indices) buffer->indexCount = meshData.indexCount;
+    m_Stats.totalUploadBytes += bytes;
+    return true;
+}
+
+// ==================== GPU MATERIAL BUFFERS ====================
+hMaterial RSNull::createMaterialBuffer(const MaterialData& materialData)
+{
+    NullMaterialBuffer buffer = {};
+    buffer.data = materialData;
+
+    hMaterial handle = m_MaterialBuffers.insert(buffer);
+    if (handle == 0) return 0;
+
+    m_Stats.materialCount++;
+    return handle;
+}
+
+void RSNull::destroyMaterialBuffer(hMaterial handle)
+{
+    if (m_MaterialBuffers.remove(handle))
+    {
+        m_Stats.materialCount--;
+    }
+}
+
+bool RSNull::updateMaterialBuffer(hMaterial handle, const MaterialData& materialData)
+{
+    NullMaterialBuffer* buffer = m_MaterialBuffers.get(handle);
+    if (!buffer) return false;
+
+    buffer->data = materialData;
+    m_Stats.totalUploadBytes += sizeof(MaterialData);
+    return true;
+}
+
+// ==================== TEXTURES ====================
+hTexture RSNull::loadTexture(const char* filename)
+{
+    if (!filename) return 0;
+
+    NullTexture texture = {};
+    texture.pathHash = hashBytes(FNV_OFFSET_BASIS, filename, strlen(filename));
+
+    hTexture handle = m_Textures.insert(texture);
+    if (handle == 0) return 0;
+
+    m_Stats.textureCount++;
+    return handle;
+}
+
+void RSNull::destroyTexture(hTexture handle)
+{
+    if (m_Textures.remove(handle))
+    {
+        m_Stats.textureCount--;
+    }
+}
+
+bool RSNull::bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot)
+{
+    if (slot >= 6) return false;
+
+    NullMaterialBuffer* buffer = m_MaterialBuffers.get(material);
+    if (!buffer || !m_Textures.contains(texture)) return false;
+
+    buffer->textures[slot] = texture;
+    return true;
+}
+
+// ==================== FRAME EXECUTION ====================
+void RSNull::countDrawCommands(const DrawCommand* commands, UINT32 commandCount, UINT32 instanceCount,
+                               UINT32& drawCalls, UINT32& instances, UINT64& triangles)
+{
+    for (UINT32 i = 0; i < commandCount; ++i)
+    {
+        const DrawCommand& cmd = commands[i];
+        const NullMeshBuffer* mesh = m_MeshBuffers.get(cmd.mesh);
+
+        // A GPU backend would skip these (or fault), count them so tests can assert zero
+        if (!mesh || cmd.instanceCount == 0 || cmd.instanceStart + cmd.instanceCount > instanceCount)
+        {
+            m_Stats.invalidDraws++;
+            continue;
+        }
+
+        UINT32 primitiveVertices = mesh->indexCount > 0 ? mesh->indexCount : mesh->vertexCount;
+        drawCalls++;
+        instances += cmd.instanceCount;
+        triangles += static_cast<UINT64>(primitiveVertices / 3) * cmd.instanceCount;
+    }
+}
+
+UINT64 RSNull::hashPacket(const FramePacket& packet) const
+{
+    UINT64 hash = FNV_OFFSET_BASIS;
+    hash = hashBytes(hash, &packet.constants, sizeof(FrameConstants));
+    hash = hashBytes(hash, packet.clearColor, sizeof(packet.clearColor));
+    hash = hashBytes(hash, packet.drawCommands, sizeof(DrawCommand) * packet.drawCommandCount);
+    hash = hashBytes(hash, packet.instanceData, sizeof(PerInstanceData) * packet.instanceDataCount);
+    hash = hashBytes(hash, packet.shadowViews, sizeof(ShadowView) * packet.shadowViewCount);
+    hash = hashBytes(hash, packet.shadowDrawCommands, sizeof(DrawCommand) * packet.shadowDrawCommandCount);
+    hash = hashBytes(hash, packet.shadowInstanceData, sizeof(PerInstanceData) * packet.shadowInstanceDataCount);
+    hash = hashBytes(hash, packet.materials, sizeof(MaterialData) * packet.materialCount);
+    hash = hashBytes(hash, packet.materialHandles, sizeof(hMaterial) * packet.materialCount);
+    hash = hashBytes(hash, packet.lights, sizeof(GPULightData) * packet.lightCount);
+    hash = hashBytes(hash, packet.lightClusters, sizeof(LightClusterRange) * packet.lightClusterCount);
+    hash = hashBytes(hash, packet.clusterLightIndices, sizeof(UINT32) * packet.clusterLightIndexCount);
+    hash = hashBytes(hash, &packet.skySettings, sizeof(SkySettings));
+    return hash;
+}
+
+void RSNull::executeFrame(const FramePacket& packet)
+{
+    m_Stats.drawCalls = 0;
+    m_Stats.instances = 0;
+    m_Stats.triangles = 0;
+    m_Stats.shadowDrawCalls = 0;
+    m_Stats.shadowInstances = 0;
+    m_Stats.shadowTriangles = 0;
+    m_Stats.invalidDraws = 0;
+
+    countDrawCommands(packet.drawCommands, packet.drawCommandCount, packet.instanceDataCount,
+                      m_Stats.drawCalls, m_Stats.instances, m_Stats.triangles);
+
+    // Shadow commands are only drawn through their views
+    for (UINT32 i = 0; i < packet.shadowViewCount; ++i)
+    {
+        const ShadowView& view = packet.shadowViews[i];
+        if (view.commandStart + view.commandCount > packet.shadowDrawCommandCount)
+        {
+            m_Stats.invalidDraws++;
+            continue;
+        }
+        countDrawCommands(packet.shadowDrawCommands + view.commandStart, view.commandCount, packet.shadowInstanceDataCount,
+                          m_Stats.shadowDrawCalls, m_Stats.shadowInstances, m_Stats.shadowTriangles);
+    }
+
+    m_Stats.shadowViews = packet.shadowViewCount;
+    m_Stats.lights = packet.lightCount;
+    m_Stats.materials = packet.materialCount;
+    m_Stats.uploadBytes = sizeof(FrameConstants) +
+        static_cast<UINT64>(packet.instanceDataCount + packet.shadowInstanceDataCount) * sizeof(PerInstanceData) +
+        static_cast<UINT64>(packet.lightCount) * sizeof(GPULightData) +
+        static_cast<UINT64>(packet.lightClusterCount) * sizeof(LightClusterRange) +
+        static_cast<UINT64>(packet.clusterLightIndexCount) * sizeof(UINT32) +
+        static_cast<UINT64>(packet.materialCount) * sizeof(MaterialData);
+    m_Stats.checksum = m_ChecksumEnabled ? hashPacket(packet) : 0;
+
+    m_Stats.framesExecuted++;
+    m_Stats.totalDrawCalls += m_Stats.drawCalls + m_Stats.shadowDrawCalls;
+    m_Stats.totalTriangles += m_Stats.triangles + m_Stats.shadowTriangles;
+    m_Stats.totalUploadBytes += m_Stats.uploadBytes;
+
+    m_CompletedFrameFence = packet.frameFence;
+}
+
+void RSNull::endFrame()
+{
+    m_Stats.framesPresented++;
+}
+
+UINT64 RSNull::getCompletedFrameFence() const
+{
+    return m_CompletedFrameFence;
+}
+
+void RSNull::waitForFrameFence(UINT64 /*fence*/)
+{
+    // executeFrame() is synchronous, every submitted fence is already complete
+}
+
+void RSNull::onResize(UINT32 width, UINT32 height)
+{
+    m_Width = width;
+    m_Height = height;
+}
+
+void* RSNull::getDevice() const
+{
+    return nullptr;
+}
+
+void* RSNull::getContext() const
+{
+    return nullptr;
+}
+
+// ==================== C API ====================
+RHI* createRenderBackend()
+{
+    return new RSNull();
+}
+
+void destroyRenderBackend(RHI* rhi)
+{
+    if (rhi)
+    {
+        delete rhi;
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef _WIN32
+#ifdef RSNULL_EXPORTS
+#define RSNULL_API __declspec(dllexport)
+#else
+#define RSNULL_API __declspec(dllimport)
+#endif
+#else
+#define RSNULL_API
+#endif
+
+#include "../../rhi.h"
+#include "../../rstypes.h"
+#include "../../meshdata.h"
+#include "../../material.h"
+#include "../../framepacket.h"
+#include "../../../../headeronly/globaltypes.h"
+#include "../../../../headeronly/slotmap.h"
+
+// ==================== NULL MESH BUFFER ====================
+struct NullMeshBuffer
+{
+    UINT32 vertexCount;
+    UINT32 indexCount;
+    UINT64 bytes;
+    bool isDynamic;
+};
+
+// ==================== NULL MATERIAL BUFFER ====================
+struct NullMaterialBuffer
+{
+    MaterialData data;
+    hTexture textures[6];
+};
+
+// ==================== NULL TEXTURE ====================
+struct NullTexture
+{
+    UINT64 pathHash;    // Nothing is loaded, the path only identifies the texture
+};
+
+// ==================== NULL BACKEND STATISTICS ====================
+struct NullRHIStats
+{
+    // Live resources
+    UINT32 meshCount;
+    UINT32 materialCount;
+    UINT32 textureCount;
+    UINT64 meshBytes;            // Vertex + index bytes held by live meshes
+
+    // Last frame
+    UINT32 drawCalls;
+    UINT32 instances;
+    UINT64 triangles;
+    UINT32 shadowViews;
+    UINT32 shadowDrawCalls;
+    UINT32 shadowInstances;
+    UINT64 shadowTriangles;
+    UINT32 lights;
+    UINT32 materials;
+    UINT64 uploadBytes;          // Instance, light and material data the packet would upload
+    UINT32 invalidDraws;         // Commands referencing a stale handle or an out of range instance slice
+    UINT64 checksum;             // FNV-1a of the packet contents, 0 when checksums are off
+
+    // Totals since init
+    UINT64 framesExecuted;
+    UINT64 framesPresented;
+    UINT64 totalDrawCalls;
+    UINT64 totalTriangles;
+    UINT64 totalUploadBytes;
+};
+
+// ==================== RSNULL BACKEND ====================
+// Headless RHI: does no rendering, only CPU-side bookkeeping.
+// Handles behave like a real backend's (stale handles are rejected), every
+// packet is validated against them and counted, and with checksums on the
+// packet contents are hashed so runs can be compared bit for bit.
+class RSNull : public RHI
+{
+private:
+    Quark::SlotMap<NullMeshBuffer> m_MeshBuffers;
+    Quark::SlotMap<NullMaterialBuffer> m_MaterialBuffers;
+    Quark::SlotMap<NullTexture> m_Textures;
+
+    NullRHIStats m_Stats;
+    bool m_ChecksumEnabled;
+    bool m_Initialized;
+    UINT32 m_Width;
+    UINT32 m_Height;
+    UINT64 m_CompletedFrameFence;
+
+    void countDrawCommands(const DrawCommand* commands, UINT32 commandCount, UINT32 instanceCount,
+                           UINT32& drawCalls, UINT32& instances, UINT64& triangles);
+    UINT64 hashPacket(const FramePacket& packet) const;
+
+public:
+    RSNull();
+    ~RSNull() override;
+
+    RSNull(const RSNull&) = delete;
+    RSNull& operator=(const RSNull&) = delete;
+
+    // ==================== RHI INTERFACE ====================
+    void init(qWndh windowHandle) override;
+    void shutdown() override;
+
+    hMesh createMeshBuffer(const MeshData& meshData, bool isDynamic) override;
+    void destroyMeshBuffer(hMesh handle) override;
+    bool updateMeshBuffer(hMesh handle, const MeshData& meshData) override;
+
+    hMaterial createMaterialBuffer(const MaterialData& materialData) override;
+    void destroyMaterialBuffer(hMaterial handle) override;
+    bool updateMaterialBuffer(hMaterial handle, const MaterialData& materialData) override;
+
+    hTexture loadTexture(const char* filename) override;
+    void destroyTexture(hTexture handle) override;
+    bool bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot) override;
+
+    void executeFrame(const FramePacket& packet) override;
+    void endFrame() override;
+    UINT64 getCompletedFrameFence() const override;
+    void waitForFrameFence(UINT64 fence) override;
+
+    void onResize(UINT32 width, UINT32 height) override;
+
+    void* getDevice() const override;
+    void* getContext() const override;
+
+    // ==================== NULL BACKEND ====================
+    void setChecksumEnabled(bool enabled) { m_ChecksumEnabled = enabled; }
+    bool isChecksumEnabled() const { return m_ChecksumEnabled; }
+    const NullRHIStats& getStats() const { return m_Stats; }
+    UINT32 getWidth() const { return m_Width; }
+    UINT32 getHeight() const { return m_Height; }
+};
+
+// ==================== C API (DLL BOUNDARY) ====================
+extern "C" {
+    RSNULL_API RHI* createRenderBackend();
+    RSNULL_API void destroyRenderBackend(RHI* rhi);
+}
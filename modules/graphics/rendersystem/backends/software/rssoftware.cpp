@@ -0,0 +1,1410 @@
+#include "rssoftware.h"
+#include "../../renderobject.h"
+#include "../../../../headeronly/profiler.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <emmintrin.h>
+
+constexpr float SOFTWARE_PI = 3.14159265359f;
+constexpr UINT32 GAMMA_LUT_SIZE = 4096;
+constexpr UINT32 SKY_GRADIENT_STEPS = 512;
+
+// Shadow rasterizer bias, the D3D11 shadow state uses DepthBias 1000 and SlopeScaledDepthBias 1.5
+constexpr float SHADOW_CONSTANT_BIAS = 1000.0f / 16777216.0f;
+constexpr float SHADOW_SLOPE_BIAS = 1.5f;
+
+constexpr UINT64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr UINT64 FNV_PRIME = 1099511628211ull;
+
+static UINT64 hashBytes(UINT64 hash, const void* data, size_t size)
+{
+    const UINT8* bytes = static_cast<const UINT8*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static double elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// ==================== PASS STATE ====================
+struct SoftwareRasterTarget
+{
+    float* depth;
+    UINT32* color;      // nullptr for depth-only (shadow) passes
+    UINT32 width;
+    UINT32 height;
+    UINT32 stride;
+    UINT32 tilesX;
+    UINT32 tilesY;
+};
+
+struct SoftwareShadeContext
+{
+    const GPULightData* lights;
+    UINT32 lightCount;
+
+    // Light clusters, nullptr shades every light at every pixel
+    const LightClusterRange* clusters;
+    const UINT32* clusterLightIndices;
+    UINT32 directionalLightCount;
+    FrameConstants clusterConstants;    // Tile scales match the render target
+
+    Quark::Vec3 cameraPosition;
+    Quark::Mat4 view;
+    Quark::Vec3 ambient;
+
+    // Directional CSM, only the first shadowed directional light gets shadows (as on D3D11)
+    const GPULightData* shadowLight;
+    const float* shadowMaps[DIRECTIONAL_CASCADE_COUNT];
+    UINT32 shadowMapSize;
+    UINT32 shadowMapStride;
+};
+
+// ==================== SHADING ====================
+// CPU port of the parts of rsd3d11_main_ps.h the software backend renders
+
+static float saturate(float x)
+{
+    return std::clamp(x, 0.0f, 1.0f);
+}
+
+static float smoothstep(float edge0, float edge1, float x)
+{
+    float t = saturate((x - edge0) / (edge1 - edge0));
+    return t * t * (3.0f - 2.0f * t);
+}
+
+static Quark::Vec3 lerp(const Quark::Vec3& a, const Quark::Vec3& b, float t)
+{
+    return a + (b - a) * t;
+}
+
+static float distributionGGX(float NdotH, float roughness)
+{
+    float a = roughness * roughness;
+    float a2 = a * a;
+    float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+    denom = SOFTWARE_PI * denom * denom;
+    return a2 / (std::max)(denom, 0.0001f);
+}
+
+static float geometrySmithCorrelated(float NdotV, float NdotL, float roughness)
+{
+    float a2 = roughness * roughness * roughness * roughness;
+    float GGXV = NdotL * std::sqrt(NdotV * NdotV * (1.0f - a2) + a2);
+    float GGXL = NdotV * std::sqrt(NdotL * NdotL * (1.0f - a2) + a2);
+    return 0.5f / (std::max)(GGXV + GGXL, 0.0001f);
+}
+
+static Quark::Vec3 fresnelSchlickRoughness(float cosTheta, const Quark::Vec3& F0, float roughness)
+{
+    float f = 1.0f - saturate(cosTheta);
+    float f5 = f * f * f * f * f;
+    float g = 1.0f - roughness;
+    return Quark::Vec3(
+        F0.x + ((std::max)(g, F0.x) - F0.x) * f5,
+        F0.y + ((std::max)(g, F0.y) - F0.y) * f5,
+        F0.z + ((std::max)(g, F0.z) - F0.z) * f5);
+}
+
+static float calculateAttenuation(float dist, float range, const Quark::Vec3& atten)
+{
+    float attenuation = 1.0f / (atten.x + atten.y * dist + atten.z * dist * dist);
+    float falloff = saturate(1.0f - dist / range);
+    return attenuation * falloff * falloff;
+}
+
+// Sky gradient standing in for an environment map
+static Quark::Vec3 approximateEnvironment(const Quark::Vec3& R, float roughness)
+{
+    const Quark::Vec3 zenithColor(0.2f, 0.4f, 0.8f);
+    const Quark::Vec3 horizonColor(0.7f, 0.75f, 0.85f);
+    const Quark::Vec3 groundColor(0.25f, 0.22f, 0.18f);
+    const Quark::Vec3 averageColor(0.5f, 0.52f, 0.55f);
+
+    float upFactor = R.Normalized().y * 0.5f + 0.5f;
+    float skyBlend = smoothstep(0.0f, 1.0f, upFactor);
+    float groundBlend = smoothstep(0.5f, 0.0f, upFactor);
+
+    Quark::Vec3 color = lerp(horizonColor, zenithColor, skyBlend * skyBlend);
+    color = lerp(color, groundColor, groundBlend);
+    return lerp(color, averageColor, roughness * 0.6f);
+}
+
+static Quark::Vec3 calculateIBL(const Quark::Vec3& N, const Quark::Vec3& V, const Quark::Vec3& albedo,
+                                const Quark::Vec3& F0, float roughness, float metallic, float ao)
+{
+    float NdotV = (std::max)(N.Dot(V), 0.0f);
+    Quark::Vec3 F = fresnelSchlickRoughness(NdotV, F0, roughness);
+    Quark::Vec3 kD = (Quark::Vec3(1.0f, 1.0f, 1.0f) - F) * (1.0f - metallic);
+
+    Quark::Vec3 irradiance = approximateEnvironment(N, 1.0f) * 0.5f;
+    Quark::Vec3 diffuse = kD * albedo * irradiance;
+
+    // Split-sum BRDF approximation (Karis)
+    Quark::Vec3 R = N * (2.0f * N.Dot(V)) - V;
+    float r0 = roughness * -1.0f + 1.0f;
+    float r1 = roughness * -0.0275f + 0.0425f;
+    float r2 = roughness * -0.572f + 1.04f;
+    float r3 = roughness * 0.022f - 0.04f;
+    float a004 = (std::min)(r0 * r0, std::exp2(-9.28f * NdotV)) * r0 + r1;
+    float scale = -1.04f * a004 + r2;
+    float bias = 1.04f * a004 + r3;
+    Quark::Vec3 specular = approximateEnvironment(R, roughness) * (F * scale + Quark::Vec3(bias, bias, bias));
+
+    return (diffuse + specular) * ao;
+}
+
+static float sampleCascadeShadow(const SoftwareShadeContext& ctx, const Quark::Vec3& worldPos, UINT32 cascade,
+                                 const Quark::Vec3& N, const Quark::Vec3& L)
+{
+    const float* map = ctx.shadowMaps[cascade];
+    if (!map) return 1.0f;
+
+    // Normal offset, larger for the wider cascades
+    Quark::Vec3 offsetPos = worldPos + N * (0.02f * (cascade + 1));
+    Quark::Vec4 shadowPos = ctx.shadowLight->cascadeMatrices[cascade] * Quark::Vec4(offsetPos, 1.0f);
+    if (shadowPos.w <= 0.0f) return 1.0f;
+
+    float u = shadowPos.x / shadowPos.w * 0.5f + 0.5f;
+    float v = -shadowPos.y / shadowPos.w * 0.5f + 0.5f;
+    float z = shadowPos.z / shadowPos.w * 0.5f + 0.5f;
+    if (z > 1.0f || u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) return 1.0f;
+
+    float NdotL = saturate(N.Dot(L));
+    float currentDepth = z - (0.0005f * (1.0f - NdotL) + 0.0001f * (cascade + 1));
+
+    // Nearest-texel PCF: 1x1, 3x3 or 5x5 by shadow quality
+    const int size = static_cast<int>(ctx.shadowMapSize);
+    const int radius = ctx.shadowLight->shadowQuality <= 1 ? 0 : (ctx.shadowLight->shadowQuality == 2 ? 1 : 2);
+    const int cx = (std::min)(static_cast<int>(u * size), size - 1);
+    const int cy = (std::min)(static_cast<int>(v * size), size - 1);
+
+    float lit = 0.0f;
+    for (int y = -radius; y <= radius; ++y)
+    {
+        int sy = std::clamp(cy + y, 0, size - 1);
+        const float* row = map + static_cast<size_t>(sy) * ctx.shadowMapStride;
+        for (int x = -radius; x <= radius; ++x)
+        {
+            int sx = std::clamp(cx + x, 0, size - 1);
+            lit += currentDepth <= row[sx] ? 1.0f : 0.0f;
+        }
+    }
+    float taps = static_cast<float>((2 * radius + 1) * (2 * radius + 1));
+    return lit / taps;
+}
+
+static float calculateCSMShadow(const SoftwareShadeContext& ctx, const Quark::Vec3& worldPos,
+                                const Quark::Vec3& N, const Quark::Vec3& L)
+{
+    const Quark::Vec4& splits = ctx.shadowLight->cascadeSplits;
+    const float cascadeSplits[5] = { 0.0f, splits.x, splits.y, splits.z, splits.w };
+
+    Quark::Vec4 viewPos = ctx.view * Quark::Vec4(worldPos, 1.0f);
+    float depth = std::fabs(viewPos.z);
+
+    UINT32 cascade = depth < splits.x ? 0 : (depth < splits.y ? 1 : (depth < splits.z ? 2 : 3));
+    float shadow = sampleCascadeShadow(ctx, worldPos, cascade, N, L);
+
+    // Blend into the next cascade over the last 10% of this one
+    if (cascade < DIRECTIONAL_CASCADE_COUNT - 1)
+    {
+        float range = cascadeSplits[cascade + 1] - cascadeSplits[cascade];
+        float blendStart = cascadeSplits[cascade + 1] - range * 0.1f;
+        if (depth > blendStart)
+        {
+            float t = saturate((depth - blendStart) / (range * 0.1f));
+            float nextShadow = sampleCascadeShadow(ctx, worldPos, cascade + 1, N, L);
+            shadow = shadow + (nextShadow - shadow) * t;
+        }
+    }
+    return shadow;
+}
+
+// Tone mapped [0, 1] to 8-bit gamma 2.2
+static UINT32 encodeChannel(float value)
+{
+    static const auto s_GammaLUT = []
+    {
+        std::vector<UINT8> lut(GAMMA_LUT_SIZE);
+        for (UINT32 i = 0; i < GAMMA_LUT_SIZE; ++i)
+        {
+            float linear = static_cast<float>(i) / (GAMMA_LUT_SIZE - 1);
+            lut[i] = static_cast<UINT8>(std::pow(linear, 1.0f / 2.2f) * 255.0f + 0.5f);
+        }
+        return lut;
+    }();
+
+    return s_GammaLUT[static_cast<UINT32>(saturate(value) * (GAMMA_LUT_SIZE - 1) + 0.5f)];
+}
+
+static UINT32 packColor(const Quark::Vec3& color)
+{
+    return encodeChannel(color.x) | (encodeChannel(color.y) << 8) | (encodeChannel(color.z) << 16) | 0xFF000000u;
+}
+
+// Fitted ACES, as at the end of the main pixel shader
+static Quark::Vec3 tonemapACES(const Quark::Vec3& x)
+{
+    auto curve = [](float v)
+    {
+        v = (std::max)(v, 0.0f);
+        return saturate((v * (2.51f * v + 0.03f)) / (v * (2.43f * v + 0.59f) + 0.14f));
+    };
+    return Quark::Vec3(curve(x.x), curve(x.y), curve(x.z));
+}
+
+static Quark::Vec3 shadePixel(const SoftwareShadeContext& ctx, const MaterialData& material, float pixelX, float pixelY,
+                              const Quark::Vec3& worldPos, const Quark::Vec3& normal, UINT32 objectFlags)
+{
+    const Quark::Vec3 albedo(material.albedo.r, material.albedo.g, material.albedo.b);
+    const float metallic = material.metallic;
+    const float roughness = material.roughness;
+
+    Quark::Vec3 N = normal.Normalized();
+    Quark::Vec3 V = (ctx.cameraPosition - worldPos).Normalized();
+    Quark::Vec3 F0 = lerp(Quark::Vec3(0.04f, 0.04f, 0.04f), albedo, metallic);
+    float NdotV = N.Dot(V);
+
+    const bool receiveShadows = (objectFlags & static_cast<UINT32>(RenderObjectFlags::RECEIVE_SHADOW)) != 0;
+
+    // Directional lights, then the point and spot lights of the pixel's cluster
+    UINT32 lightCount = ctx.lightCount;
+    UINT32 directionalCount = lightCount;
+    const UINT32* clusterLights = nullptr;
+    if (ctx.clusters)
+    {
+        float viewDepth = -(ctx.view * Quark::Vec4(worldPos, 1.0f)).z;
+        const LightClusterRange& cluster = ctx.clusters[getLightClusterIndex(ctx.clusterConstants, pixelX, pixelY, viewDepth)];
+        directionalCount = ctx.directionalLightCount;
+        clusterLights = ctx.clusterLightIndices + cluster.offset;
+        lightCount = directionalCount + cluster.count;
+    }
+
+    Quark::Vec3 Lo(0.0f, 0.0f, 0.0f);
+    for (UINT32 n = 0; n < lightCount; ++n)
+    {
+        const GPULightData& light = ctx.lights[n < directionalCount ? n : clusterLights[n - directionalCount]];
+        if (!(light.flags & static_cast<UINT32>(LightFlags::LIGHT_ENABLED))) continue;
+
+        Quark::Vec3 L;
+        Quark::Vec3 radiance = light.color * light.intensity;
+
+        if (light.type == static_cast<UINT32>(LightType::DIRECTIONAL))
+        {
+            L = (light.direction * -1.0f).Normalized();
+            if (&light == ctx.shadowLight && receiveShadows)
+            {
+                radiance *= calculateCSMShadow(ctx, worldPos, N, L);
+            }
+        }
+        else
+        {
+            Quark::Vec3 toLight = light.position - worldPos;
+            float distance = toLight.Length();
+            if (distance >= light.range || distance <= 0.0f) continue;
+            L = toLight * (1.0f / distance);
+
+            float attenuation = calculateAttenuation(distance, light.range, light.attenuation);
+            if (light.type == static_cast<UINT32>(LightType::SPOT))
+            {
+                float theta = L.Dot((light.direction * -1.0f).Normalized());
+                float epsilon = light.spotAngles.x - light.spotAngles.y;
+                attenuation *= saturate((theta - light.spotAngles.y) / epsilon);
+            }
+            radiance *= attenuation;
+        }
+
+        float NdotL = N.Dot(L);
+        if (NdotL <= 0.0f) continue;
+
+        // Isotropic GGX with a height-correlated visibility term
+        Quark::Vec3 H = (V + L).Normalized();
+        float D = distributionGGX((std::max)(N.Dot(H), 0.0f), roughness);
+        float G = geometrySmithCorrelated(NdotV, NdotL, roughness);
+        Quark::Vec3 F = fresnelSchlickRoughness((std::max)(H.Dot(V), 0.0f), F0, roughness);
+
+        Quark::Vec3 kD = (Quark::Vec3(1.0f, 1.0f, 1.0f) - F) * (1.0f - metallic);
+        Quark::Vec3 specular = F * (D * G);
+        Lo += (kD * albedo * (1.0f / SOFTWARE_PI) + specular) * radiance * NdotL;
+    }
+
+    Quark::Vec3 ambient = calculateIBL(N, V, albedo, F0, roughness, metallic, material.ao);
+    ambient += ctx.ambient * albedo * (material.ao * 0.1f);
+
+    Quark::Vec3 emissive(material.emissive.r, material.emissive.g, material.emissive.b);
+    return tonemapACES(ambient + Lo + emissive * material.emissiveStrength);
+}
+
+// ==================== TRIANGLE SETUP ====================
+static ClipVertex lerpVertex(const ClipVertex& a, const ClipVertex& b, float t)
+{
+    ClipVertex result;
+    result.position = a.position + (b.position - a.position) * t;
+    result.worldPos = lerp(a.worldPos, b.worldPos, t);
+    result.normal = lerp(a.normal, b.normal, t);
+    return result;
+}
+
+static void setupTriangle(BinTask& task, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                          UINT32 width, UINT32 height, CullMode cullMode, bool depthOnly,
+                          const MaterialData* material, UINT32 objectFlags)
+{
+    const ClipVertex* verts[3] = { &v0, &v1, &v2 };
+    float sx[3], sy[3], sz[3], invW[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const Quark::Vec4& p = verts[i]->position;
+        invW[i] = 1.0f / p.w;
+        sx[i] = (p.x * invW[i] * 0.5f + 0.5f) * width;
+        sy[i] = (0.5f - p.y * invW[i] * 0.5f) * height;
+        sz[i] = p.z * invW[i] * 0.5f + 0.5f;
+    }
+
+    // Counter-clockwise in NDC is front facing (FrontCounterClockwise on D3D11), negative here with y down
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    bool frontFacing = area < 0.0f;
+    if (cullMode == CullMode::BACK && !frontFacing) return;
+    if (cullMode == CullMode::FRONT && frontFacing) return;
+
+    // Rasterize with positive area
+    int order[3] = { 0, 1, 2 };
+    if (area < 0.0f)
+    {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+    if (!(area > 0.0f)) return;     // Degenerate or NaN
+
+    float minX = (std::min)({ sx[0], sx[1], sx[2] });
+    float maxX = (std::max)({ sx[0], sx[1], sx[2] });
+    float minY = (std::min)({ sy[0], sy[1], sy[2] });
+    float maxY = (std::max)({ sy[0], sy[1], sy[2] });
+
+    RasterTriangle tri;
+    tri.minX = static_cast<int>(std::floor(std::clamp(minX, 0.0f, static_cast<float>(width - 1))));
+    tri.maxX = static_cast<int>(std::floor(std::clamp(maxX, 0.0f, static_cast<float>(width - 1))));
+    tri.minY = static_cast<int>(std::floor(std::clamp(minY, 0.0f, static_cast<float>(height - 1))));
+    tri.maxY = static_cast<int>(std::floor(std::clamp(maxY, 0.0f, static_cast<float>(height - 1))));
+    if (maxX < 0.0f || maxY < 0.0f || minX > width || minY > height) return;
+
+    float x[3], y[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        x[i] = sx[order[i]];
+        y[i] = sy[order[i]];
+    }
+
+    tri.topLeftEdges = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        // Edge opposite vertex i, from a to b. Shared edges get exactly negated coefficients, so
+        // neighbours agree on every pixel and the top-left rule settles pixels on the edge.
+        int a = (i + 1) % 3;
+        int b = (i + 2) % 3;
+        tri.edgeA[i] = y[a] - y[b];
+        tri.edgeB[i] = x[b] - x[a];
+        tri.edgeC[i] = x[a] * y[b] - y[a] * x[b];
+
+        if (tri.edgeA[i] > 0.0f || (tri.edgeA[i] == 0.0f && tri.edgeB[i] > 0.0f))
+        {
+            tri.topLeftEdges |= 1u << i;
+        }
+    }
+
+    float z[3] = { sz[order[0]], sz[order[1]], sz[order[2]] };
+    if (depthOnly)
+    {
+        // Slope-scaled bias like the D3D11 shadow rasterizer state
+        float dzdx = (tri.edgeA[0] * z[0] + tri.edgeA[1] * z[1] + tri.edgeA[2] * z[2]) / area;
+        float dzdy = (tri.edgeB[0] * z[0] + tri.edgeB[1] * z[1] + tri.edgeB[2] * z[2]) / area;
+        float bias = SHADOW_CONSTANT_BIAS + SHADOW_SLOPE_BIAS * (std::max)(std::fabs(dzdx), std::fabs(dzdy));
+        for (float& depth : z) depth += bias;
+    }
+
+    const float invArea = 1.0f / area;
+    for (int i = 0; i < 3; ++i)
+    {
+        tri.depth[i] = z[i] * invArea;
+        tri.invW[i] = invW[order[i]];
+        if (!depthOnly)
+        {
+            tri.worldPos[i] = verts[order[i]]->worldPos;
+            tri.normal[i] = verts[order[i]]->normal;
+        }
+    }
+    tri.material = material;
+    tri.objectFlags = objectFlags;
+
+    const UINT32 index = static_cast<UINT32>(task.triangles.size());
+    task.triangles.push_back(tri);
+    task.trianglesOut++;
+
+    const UINT32 tilesX = (width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    for (int ty = tri.minY / static_cast<int>(SOFTWARE_TILE_SIZE); ty <= tri.maxY / static_cast<int>(SOFTWARE_TILE_SIZE); ++ty)
+    {
+        for (int tx = tri.minX / static_cast<int>(SOFTWARE_TILE_SIZE); tx <= tri.maxX / static_cast<int>(SOFTWARE_TILE_SIZE); ++tx)
+        {
+            task.bins[ty * tilesX + tx].push_back(index);
+        }
+    }
+}
+
+// Clips against the near plane (z >= -w), trivially rejects triangles outside a side plane
+static void clipTriangle(BinTask& task, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                         UINT32 width, UINT32 height, CullMode cullMode, bool depthOnly,
+                         const MaterialData* material, UINT32 objectFlags)
+{
+    const Quark::Vec4& p0 = v0.position;
+    const Quark::Vec4& p1 = v1.position;
+    const Quark::Vec4& p2 = v2.position;
+
+    if ((p0.x > p0.w && p1.x > p1.w && p2.x > p2.w) || (p0.x < -p0.w && p1.x < -p1.w && p2.x < -p2.w)) return;
+    if ((p0.y > p0.w && p1.y > p1.w && p2.y > p2.w) || (p0.y < -p0.w && p1.y < -p1.w && p2.y < -p2.w)) return;
+    if (p0.z > p0.w && p1.z > p1.w && p2.z > p2.w) return;
+
+    const float d[3] = { p0.z + p0.w, p1.z + p1.w, p2.z + p2.w };
+    if (d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f)
+    {
+        setupTriangle(task, v0, v1, v2, width, height, cullMode, depthOnly, material, objectFlags);
+        return;
+    }
+    if (d[0] < 0.0f && d[1] < 0.0f && d[2] < 0.0f) return;
+
+    // Sutherland-Hodgman against one plane, at most a quad comes out
+    const ClipVertex* in[3] = { &v0, &v1, &v2 };
+    ClipVertex out[4];
+    int outCount = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int j = (i + 1) % 3;
+        if (d[i] >= 0.0f) out[outCount++] = *in[i];
+        if ((d[i] >= 0.0f) != (d[j] >= 0.0f))
+        {
+            out[outCount++] = lerpVertex(*in[i], *in[j], d[i] / (d[i] - d[j]));
+        }
+    }
+
+    for (int i = 1; i + 1 < outCount; ++i)
+    {
+        setupTriangle(task, out[0], out[i], out[i + 1], width, height, cullMode, depthOnly, material, objectFlags);
+    }
+}
+
+// ==================== RASTERIZATION ====================
+static UINT64 rasterizeTriangle(const RasterTriangle& tri, const SoftwareRasterTarget& target,
+                                const SoftwareShadeContext* shade, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+    const int minX = (std::max)(tri.minX, tileMinX) & ~3;
+    const int maxX = (std::min)(tri.maxX, tileMaxX);
+    const int minY = (std::max)(tri.minY, tileMinY);
+    const int maxY = (std::min)(tri.maxY, tileMaxY);
+    if (minX > maxX || minY > maxY) return 0;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 laneCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    __m128 edgeA[3], topLeft[3], depth[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        edgeA[i] = _mm_set1_ps(tri.edgeA[i]);
+        topLeft[i] = _mm_castsi128_ps(_mm_set1_epi32((tri.topLeftEdges & (1u << i)) ? -1 : 0));
+        depth[i] = _mm_set1_ps(tri.depth[i]);
+    }
+
+    const bool depthOnly = target.color == nullptr;
+    const bool blend = !depthOnly && (tri.material->flags & static_cast<UINT32>(MaterialFlags::ALPHA_BLEND)) != 0;
+    UINT64 shaded = 0;
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const float py = static_cast<float>(y) + 0.5f;
+        __m128 rowC[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            rowC[i] = _mm_set1_ps(tri.edgeB[i] * py + tri.edgeC[i]);
+        }
+
+        float* depthRow = target.depth + static_cast<size_t>(y) * target.stride;
+        UINT32* colorRow = depthOnly ? nullptr : target.color + static_cast<size_t>(y) * target.stride;
+
+        for (int x = minX; x <= maxX; x += 4)
+        {
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneCenters);
+
+            __m128 e[3];
+            __m128 covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int i = 0; i < 3; ++i)
+            {
+                e[i] = _mm_add_ps(_mm_mul_ps(edgeA[i], px), rowC[i]);
+                __m128 inside = _mm_or_ps(_mm_cmpgt_ps(e[i], zero), _mm_and_ps(_mm_cmpeq_ps(e[i], zero), topLeft[i]));
+                covered = _mm_and_ps(covered, inside);
+            }
+            if (_mm_movemask_ps(covered) == 0) continue;
+
+            __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e[0], depth[0]), _mm_mul_ps(e[1], depth[1])), _mm_mul_ps(e[2], depth[2]));
+            __m128 stored = _mm_loadu_ps(depthRow + x);
+            __m128 pass = _mm_and_ps(covered, _mm_cmplt_ps(z, stored));
+            int mask = _mm_movemask_ps(pass);
+            if (mask == 0) continue;
+
+            if (depthOnly)
+            {
+                _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, stored)));
+                continue;
+            }
+
+            alignas(16) float e0[4], e1[4], e2[4], zs[4];
+            _mm_store_ps(e0, e[0]);
+            _mm_store_ps(e1, e[1]);
+            _mm_store_ps(e2, e[2]);
+            _mm_store_ps(zs, z);
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                if (!(mask & (1 << lane))) continue;
+
+                // Perspective-correct weights
+                float l0 = e0[lane] * tri.invW[0];
+                float l1 = e1[lane] * tri.invW[1];
+                float l2 = e2[lane] * tri.invW[2];
+                float invSum = 1.0f / (l0 + l1 + l2);
+                l0 *= invSum;
+                l1 *= invSum;
+                l2 *= invSum;
+
+                Quark::Vec3 worldPos = tri.worldPos[0] * l0 + tri.worldPos[1] * l1 + tri.worldPos[2] * l2;
+                Quark::Vec3 normal = tri.normal[0] * l0 + tri.normal[1] * l1 + tri.normal[2] * l2;
+                Quark::Vec3 color = shadePixel(*shade, *tri.material, x + lane + 0.5f, y + 0.5f, worldPos, normal, tri.objectFlags);
+                shaded++;
+
+                UINT32& dst = colorRow[x + lane];
+                if (blend)
+                {
+                    // Alpha cutout, then src-alpha over the target without a depth write
+                    float alpha = tri.material->albedo.a;
+                    if (alpha < tri.material->alphaCutoff) continue;
+
+                    UINT32 src = packColor(color);
+                    UINT32 a = static_cast<UINT32>(saturate(alpha) * 255.0f + 0.5f);
+                    UINT32 result = 0xFF000000u;
+                    for (UINT32 shift = 0; shift < 24; shift += 8)
+                    {
+                        UINT32 s = (src >> shift) & 0xFF;
+                        UINT32 d = (dst >> shift) & 0xFF;
+                        result |= ((s * a + d * (255 - a) + 127) / 255) << shift;
+                    }
+                    dst = result;
+                }
+                else
+                {
+                    dst = packColor(color);
+                    depthRow[x + lane] = zs[lane];
+                }
+            }
+        }
+    }
+    return shaded;
+}
+
+// ==================== CONSTRUCTOR / DESTRUCTOR ====================
+RSSoftware::RSSoftware()
+    : m_Width(0)
+    , m_Height(0)
+    , m_Stride(0)
+    , m_TilesX(0)
+    , m_TilesY(0)
+    , m_ShadowMapValid{}
+    , m_ShadowMapVersions{}
+    , m_StaticShadowMapVersions{}
+    , m_ShadowMapSize(SOFTWARE_DEFAULT_SHADOW_MAP_SIZE)
+    , m_ShadowMapStride(0)
+    , m_ShadowsEnabled(true)
+    , m_SkyEnabled(true)
+    , m_ClusteredLighting(true)
+    , m_BinTaskCount(0)
+    , m_Initialized(false)
+    , m_CompletedFrameFence(0)
+{
+    memset(&m_Stats, 0, sizeof(SoftwareRHIStats));
+    std::cout << "[RSSoftware] Created.\n";
+}
+
+RSSoftware::~RSSoftware()
+{
+    shutdown();
+}
+
+// ==================== INITIALIZATION ====================
+void RSSoftware::init(qWndh)
+{
+    // Renders into memory, the window handle is ignored
+    memset(&m_Stats, 0, sizeof(SoftwareRHIStats));
+    m_CompletedFrameFence = 0;
+
+    if (m_Width == 0 || m_Height == 0)
+    {
+        resizeTargets(SOFTWARE_DEFAULT_WIDTH, SOFTWARE_DEFAULT_HEIGHT);
+    }
+
+    m_Initialized = true;
+    std::cout << "[RSSoftware] Initialized (" << m_Width << "x" << m_Height << ", "
+              << m_TaskPool.getThreadCount() << " threads).\n";
+}
+
+void RSSoftware::shutdown()
+{
+    if (!m_Initialized) return;
+
+    m_MeshBuffers.clear();
+    m_MaterialBuffers.clear();
+    m_Textures.clear();
+    m_Stats.meshCount = 0;
+    m_Stats.materialCount = 0;
+    m_Stats.textureCount = 0;
+    m_Stats.meshBytes = 0;
+
+    m_BinTasks.clear();
+    m_DrawInstances.clear();
+    for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
+    {
+        m_ShadowMaps[i].clear();
+        m_ShadowMaps[i].shrink_to_fit();
+        m_StaticShadowMaps[i].clear();
+        m_StaticShadowMaps[i].shrink_to_fit();
+        m_ShadowMapValid[i] = false;
+        m_ShadowMapVersions[i] = 0;
+        m_StaticShadowMapVersions[i] = 0;
+    }
+    m_Initialized = false;
+
+    std::cout << "[RSSoftware] Shutdown complete.\n";
+}
+
+void RSSoftware::resizeTargets(UINT32 width, UINT32 height)
+{
+    if (width == 0 || height == 0) return;
+
+    m_Width = width;
+    m_Height = height;
+    m_TilesX = (width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    m_TilesY = (height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    m_Stride = m_TilesX * SOFTWARE_TILE_SIZE;
+
+    const size_t pixels = static_cast<size_t>(m_Stride) * m_TilesY * SOFTWARE_TILE_SIZE;
+    m_ColorBuffer.assign(pixels, 0xFF000000u);
+    m_DepthBuffer.assign(pixels, 1.0f);
+    m_TilePixels.assign(static_cast<size_t>(m_TilesX) * m_TilesY, 0);
+}
+
+void RSSoftware::setShadowMapSize(UINT32 size)
+{
+    m_ShadowMapSize = (std::max)(size, SOFTWARE_TILE_SIZE);
+    for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
+    {
+        m_ShadowMaps[i].clear();
+        m_StaticShadowMaps[i].clear();
+        m_ShadowMapValid[i] = false;
+        m_ShadowMapVersions[i] = 0;
+        m_StaticShadowMapVersions[i] = 0;
+    }
+}
+
+// ==================== MESH BUFFERS ====================
+hMesh RSSoftware::createMeshBuffer(const MeshData& meshData, bool isDynamic)
+{
+    if (!meshData.vertices || meshData.vertexCount == 0)
+    {
+        std::cerr << "[RSSoftware] ERROR: Invalid mesh data.\n";
+        return 0;
+    }
+
+    SoftwareMeshBuffer buffer;
+    buffer.vertices.assign(meshData.vertices, meshData.vertices + meshData.vertexCount);
+    if (meshData.indices && meshData.indexCount > 0)
+    {
+        buffer.indices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+    }
+    buffer.bytes = static_cast<UINT64>(buffer.vertices.size()) * sizeof(Vertex) + static_cast<UINT64>(buffer.indices.size()) * sizeof(UINT32);
+    buffer.isDynamic = isDynamic;
+
+    const UINT64 bytes = buffer.bytes;
+    hMesh handle = m_MeshBuffers.insert(std::move(buffer));
+    if (handle == 0) return 0;
+
+    m_Stats.meshCount++;
+    m_Stats.meshBytes += bytes;
+    return handle;
+}
+
+void RSSoftware::destroyMeshBuffer(hMesh handle)
+{
+    SoftwareMeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer) return;
+
+    m_Stats.meshCount--;
+    m_Stats.meshBytes -= buffer->bytes;
+    m_MeshBuffers.remove(handle);
+}
+
+bool RSSoftware::updateMeshBuffer(hMesh handle, const MeshData& meshData)
+{
+    // Same rules as a GPU backend: only dynamic buffers, no growth past the original size
+    SoftwareMeshBuffer* buffer = m_MeshBuffers.get(handle);
+    if (!buffer || !buffer->isDynamic || !meshData.vertices) return false;
+
+    UINT64 bytes = static_cast<UINT64>(meshData.vertexCount) * sizeof(Vertex) +
+                   static_cast<UINT64>(meshData.indices ? meshData.indexCount : 0) * sizeof(UINT32);
+    if (bytes > buffer->bytes) return false;
+
+    buffer->vertices.assign(meshData.vertices, meshData.vertices + meshData.vertexCount);
+    if (meshData.indices)
+    {
+        buffer->indices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+    }
+    return true;
+}
+
+// ==================== MATERIAL BUFFERS ====================
+hMaterial RSSoftware::createMaterialBuffer(const MaterialData& materialData)
+{
+    SoftwareMaterialBuffer buffer = {};
+    buffer.data = materialData;
+
+    hMaterial handle = m_MaterialBuffers.insert(buffer);
+    if (handle == 0) return 0;
+
+    m_Stats.materialCount++;
+    return handle;
+}
+
+void RSSoftware::destroyMaterialBuffer(hMaterial handle)
+{
+    if (m_MaterialBuffers.remove(handle))
+    {
+        m_Stats.materialCount--;
+    }
+}
+
+bool RSSoftware::updateMaterialBuffer(hMaterial handle, const MaterialData& materialData)
+{
+    SoftwareMaterialBuffer* buffer = m_MaterialBuffers.get(handle);
+    if (!buffer) return false;
+
+    buffer->data = materialData;
+    return true;
+}
+
+// ==================== TEXTURES ====================
+hTexture RSSoftware::loadTexture(const char* filename)
+{
+    if (!filename) return 0;
+
+    SoftwareTexture texture = {};
+    texture.pathHash = hashBytes(FNV_OFFSET_BASIS, filename, strlen(filename));
+
+    hTexture handle = m_Textures.insert(texture);
+    if (handle == 0) return 0;
+
+    m_Stats.textureCount++;
+    return handle;
+}
+
+void RSSoftware::destroyTexture(hTexture handle)
+{
+    if (m_Textures.remove(handle))
+    {
+        m_Stats.textureCount--;
+    }
+}
+
+bool RSSoftware::bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot)
+{
+    if (slot >= 6) return false;
+
+    SoftwareMaterialBuffer* buffer = m_MaterialBuffers.get(material);
+    if (!buffer || !m_Textures.contains(texture)) return false;
+
+    buffer->textures[slot] = texture;
+    return true;
+}
+
+// ==================== PASSES ====================
+void RSSoftware::clearTargets(const FramePacket& packet)
+{
+    QUARK_PROFILE_ZONE("RSSoftware::clearTargets");
+
+    const UINT32 clear = packColor(Quark::Vec3(packet.clearColor[0], packet.clearColor[1], packet.clearColor[2]));
+    const SkySettings& sky = packet.skySettings;
+
+    // Horizon to zenith gradient (the sky shader's path without sun, clouds and night sky),
+    // tone mapped with the sky's ACES fit and looked up by the ray's up component
+    UINT32 skyColors[SKY_GRADIENT_STEPS];
+    for (UINT32 i = 0; i < SKY_GRADIENT_STEPS; ++i)
+    {
+        auto curve = [](float v)
+        {
+            v = (std::max)(v, 0.0f);
+            return saturate((v * (v + 0.0245786f) - 0.000090537f) / (v * (0.983729f * v + 0.4329510f) + 0.238081f));
+        };
+        Quark::Vec3 color = lerp(sky.horizonColor, sky.zenithColor, static_cast<float>(i) / (SKY_GRADIENT_STEPS - 1));
+        skyColors[i] = packColor(Quark::Vec3(curve(color.x), curve(color.y), curve(color.z)));
+    }
+    const Quark::Mat4& invProjection = packet.constants.invProjection;
+    const Quark::Mat4& invView = packet.constants.invView;
+
+    m_TaskPool.run(m_TilesY, [&](UINT32 tileRow)
+    {
+        const UINT32 yEnd = (std::min)((tileRow + 1) * SOFTWARE_TILE_SIZE, m_Height);
+        for (UINT32 y = tileRow * SOFTWARE_TILE_SIZE; y < yEnd; ++y)
+        {
+            float* depthRow = m_DepthBuffer.data() + static_cast<size_t>(y) * m_Stride;
+            UINT32* colorRow = m_ColorBuffer.data() + static_cast<size_t>(y) * m_Stride;
+            std::fill(depthRow, depthRow + m_Stride, 1.0f);
+
+            if (!m_SkyEnabled)
+            {
+                std::fill(colorRow, colorRow + m_Stride, clear);
+                continue;
+            }
+
+            // Far plane w is the same for every pixel, so the unnormalized view ray is linear in x
+            const float ndcY = 1.0f - 2.0f * (static_cast<float>(y) + 0.5f) / m_Height;
+            const float ndcStep = 2.0f / m_Width;
+            Quark::Vec4 rowStart = invProjection * Quark::Vec4(ndcStep * 0.5f - 1.0f, ndcY, 1.0f, 1.0f);
+            Quark::Vec4 rowNext = invProjection * Quark::Vec4(ndcStep * 1.5f - 1.0f, ndcY, 1.0f, 1.0f);
+            const float sign = rowStart.w < 0.0f ? -1.0f : 1.0f;
+            const Quark::Vec3 rayStart = invView.TransformDirection(Quark::Vec3(rowStart.x, rowStart.y, rowStart.z) * sign);
+            const Quark::Vec3 rayStep = invView.TransformDirection(Quark::Vec3(rowNext.x - rowStart.x, rowNext.y - rowStart.y, rowNext.z - rowStart.z) * sign);
+
+            for (UINT32 x = 0; x < m_Width; ++x)
+            {
+                Quark::Vec3 ray = rayStart + rayStep * static_cast<float>(x);
+                float up = saturate(ray.y / ray.Length());
+                colorRow[x] = skyColors[static_cast<UINT32>(up * (SKY_GRADIENT_STEPS - 1) + 0.5f)];
+            }
+        }
+    });
+}
+
+void RSSoftware::binTriangles(const DrawCommand* commands, UINT32 commandCount,
+                              const PerInstanceData* instances, UINT32 instanceCount,
+                              const Quark::Mat4& viewProjection, const SoftwareRasterTarget& target)
+{
+    QUARK_PROFILE_ZONE("RSSoftware::binTriangles");
+
+    static const MaterialData s_DefaultMaterial = {};
+    const bool depthOnly = target.color == nullptr;
+
+    m_DrawInstances.clear();
+    for (UINT32 i = 0; i < commandCount; ++i)
+    {
+        const DrawCommand& cmd = commands[i];
+        if (!m_MeshBuffers.contains(cmd.mesh) || cmd.instanceCount == 0 || cmd.instanceStart + cmd.instanceCount > instanceCount)
+        {
+            m_Stats.invalidDraws++;
+            continue;
+        }
+
+        if (!depthOnly)
+        {
+            m_Stats.drawCalls++;
+            m_Stats.instances += cmd.instanceCount;
+        }
+        for (UINT32 j = 0; j < cmd.instanceCount; ++j)
+        {
+            m_DrawInstances.push_back({ i, cmd.instanceStart + j });
+        }
+    }
+
+    const UINT32 tileCount = target.tilesX * target.tilesY;
+    UINT32 chunkSize = 0;
+    m_BinTaskCount = m_TaskPool.chunkCount(static_cast<UINT32>(m_DrawInstances.size()), SOFTWARE_GEOMETRY_CHUNK_SIZE, 1, chunkSize);
+    if (m_BinTasks.size() < m_BinTaskCount)
+    {
+        m_BinTasks.resize(m_BinTaskCount);
+    }
+
+    m_TaskPool.run(m_BinTaskCount, [&](UINT32 chunk)
+    {
+        BinTask& task = m_BinTasks[chunk];
+        task.triangles.clear();
+        if (task.bins.size() < tileCount) task.bins.resize(tileCount);
+        for (UINT32 t = 0; t < tileCount; ++t) task.bins[t].clear();
+        task.trianglesIn = 0;
+        task.trianglesOut = 0;
+
+        const UINT32 begin = chunk * chunkSize;
+        const UINT32 end = (std::min)(begin + chunkSize, static_cast<UINT32>(m_DrawInstances.size()));
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            const DrawCommand& cmd = commands[m_DrawInstances[i].command];
+            const PerInstanceData& instance = instances[m_DrawInstances[i].instance];
+            const SoftwareMeshBuffer* mesh = m_MeshBuffers.get(cmd.mesh);
+
+            const SoftwareMaterialBuffer* materialBuffer = m_MaterialBuffers.get(cmd.material);
+            const MaterialData* material = materialBuffer ? &materialBuffer->data : &s_DefaultMaterial;
+
+            // Shadow passes cull back faces regardless of material, like the D3D11 shadow state
+            CullMode cullMode = depthOnly ? CullMode::BACK : static_cast<CullMode>(material->cullMode);
+            UINT32 objectFlags = static_cast<UINT32>(instance.customData.x);
+
+            // Vertex stage
+            const Quark::Mat4 worldViewProjection = viewProjection * instance.worldMatrix;
+            const UINT32 vertexCount = static_cast<UINT32>(mesh->vertices.size());
+            task.vertices.resize(vertexCount);
+            for (UINT32 v = 0; v < vertexCount; ++v)
+            {
+                const Vertex& vertex = mesh->vertices[v];
+                ClipVertex& out = task.vertices[v];
+                out.position = worldViewProjection * Quark::Vec4(vertex.position, 1.0f);
+                if (!depthOnly)
+                {
+                    out.worldPos = instance.worldMatrix.TransformPoint(vertex.position);
+                    out.normal = instance.worldInvTranspose.TransformDirection(vertex.normal);
+                }
+            }
+
+            // Primitive stage
+            const bool indexed = !mesh->indices.empty();
+            const UINT32 primitiveVertices = indexed ? static_cast<UINT32>(mesh->indices.size()) : vertexCount;
+            for (UINT32 p = 0; p + 2 < primitiveVertices; p += 3)
+            {
+                UINT32 i0 = indexed ? mesh->indices[p] : p;
+                UINT32 i1 = indexed ? mesh->indices[p + 1] : p + 1;
+                UINT32 i2 = indexed ? mesh->indices[p + 2] : p + 2;
+                task.trianglesIn++;
+                if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) continue;
+
+                clipTriangle(task, task.vertices[i0], task.vertices[i1], task.vertices[i2],
+                             target.width, target.height, cullMode, depthOnly, material, objectFlags);
+            }
+        }
+    });
+}
+
+void RSSoftware::rasterizeTiles(const SoftwareRasterTarget& target, const SoftwareShadeContext* shade)
+{
+    QUARK_PROFILE_ZONE("RSSoftware::rasterizeTiles");
+
+    const UINT32 tileCount = target.tilesX * target.tilesY;
+    if (m_TilePixels.size() < tileCount)
+    {
+        m_TilePixels.resize(tileCount);
+    }
+
+    m_TaskPool.run(tileCount, [&](UINT32 tile)
+    {
+        const int tileMinX = static_cast<int>((tile % target.tilesX) * SOFTWARE_TILE_SIZE);
+        const int tileMinY = static_cast<int>((tile / target.tilesX) * SOFTWARE_TILE_SIZE);
+        const int tileMaxX = (std::min)(tileMinX + static_cast<int>(SOFTWARE_TILE_SIZE), static_cast<int>(target.width)) - 1;
+        const int tileMaxY = (std::min)(tileMinY + static_cast<int>(SOFTWARE_TILE_SIZE), static_cast<int>(target.height)) - 1;
+
+        // Tasks in submission order keep blending and equal-depth results deterministic
+        UINT64 pixels = 0;
+        for (UINT32 t = 0; t < m_BinTaskCount; ++t)
+        {
+            const BinTask& task = m_BinTasks[t];
+            for (UINT32 index : task.bins[tile])
+            {
+                pixels += rasterizeTriangle(task.triangles[index], target, shade, tileMinX, tileMinY, tileMaxX, tileMaxY);
+            }
+        }
+        m_TilePixels[tile] = pixels;
+    });
+}
+
+void RSSoftware::renderShadowCascades(const FramePacket& packet)
+{
+    QUARK_PROFILE_ZONE("RSSoftware::renderShadowCascades");
+
+    for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
+    {
+        m_ShadowMapValid[i] = false;
+    }
+
+    const UINT32 tiles = (m_ShadowMapSize + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    m_ShadowMapStride = tiles * SOFTWARE_TILE_SIZE;
+
+    for (UINT32 v = 0; v < packet.shadowViewCount; ++v)
+    {
+        const ShadowView& view = packet.shadowViews[v];
+        if (view.type != ShadowViewType::CASCADE || view.slot >= DIRECTIONAL_CASCADE_COUNT) continue;
+        if (view.commandStart + view.commandCount > packet.shadowDrawCommandCount ||
+            view.staticCommandCount > view.commandCount)
+        {
+            m_Stats.invalidDraws++;
+            continue;
+        }
+
+        // Maps are only ever written by their cascade, so a held version is still in them
+        const UINT32 slot = view.slot;
+        m_ShadowMapValid[slot] = true;
+        if (view.cacheVersion != 0 && m_ShadowMapVersions[slot] == view.cacheVersion)
+        {
+            m_Stats.shadowViewsCached++;
+            continue;
+        }
+
+        std::vector<float>& map = m_ShadowMaps[slot];
+        std::vector<float>& staticMap = m_StaticShadowMaps[slot];
+        if (view.staticCommandCount > 0)
+        {
+            if (view.staticCacheVersion == 0 || m_StaticShadowMapVersions[slot] != view.staticCacheVersion)
+            {
+                staticMap.assign(static_cast<size_t>(m_ShadowMapStride) * m_ShadowMapStride, 1.0f);
+                renderShadowDepth(packet, view, view.commandStart, view.staticCommandCount, staticMap);
+            }
+            map = staticMap;
+        }
+        else
+        {
+            map.assign(static_cast<size_t>(m_ShadowMapStride) * m_ShadowMapStride, 1.0f);
+        }
+        renderShadowDepth(packet, view, view.commandStart + view.staticCommandCount, view.commandCount - view.staticCommandCount, map);
+
+        m_ShadowMapVersions[slot] = view.cacheVersion;
+        m_StaticShadowMapVersions[slot] = view.staticCacheVersion;
+        m_Stats.shadowViews++;
+    }
+}
+
+void RSSoftware::renderShadowDepth(const FramePacket& packet, const ShadowView& view, UINT32 commandStart, UINT32 commandCount, std::vector<float>& map)
+{
+    if (commandCount == 0) return;
+
+    const UINT32 tiles = m_ShadowMapStride / SOFTWARE_TILE_SIZE;
+
+    SoftwareRasterTarget target = {};
+    target.depth = map.data();
+    target.color = nullptr;
+    target.width = m_ShadowMapSize;
+    target.height = m_ShadowMapSize;
+    target.stride = m_ShadowMapStride;
+    target.tilesX = tiles;
+    target.tilesY = tiles;
+
+    binTriangles(packet.shadowDrawCommands + commandStart, commandCount,
+                 packet.shadowInstanceData, packet.shadowInstanceDataCount, view.viewProjection, target);
+    rasterizeTiles(target, nullptr);
+
+    for (UINT32 t = 0; t < m_BinTaskCount; ++t)
+    {
+        m_Stats.shadowTriangles += m_BinTasks[t].trianglesIn;
+    }
+}
+
+// ==================== FRAME EXECUTION ====================
+void RSSoftware::executeFrame(const FramePacket& packet)
+{
+    QUARK_PROFILE_ZONE("RSSoftware::executeFrame");
+
+    auto frameStart = std::chrono::high_resolution_clock::now();
+
+    m_Stats.drawCalls = 0;
+    m_Stats.instances = 0;
+    m_Stats.triangles = 0;
+    m_Stats.trianglesRasterized = 0;
+    m_Stats.shadowTriangles = 0;
+    m_Stats.shadowViews = 0;
+    m_Stats.shadowViewsCached = 0;
+    m_Stats.binEntries = 0;
+    m_Stats.pixelsShaded = 0;
+    m_Stats.invalidDraws = 0;
+
+    // The packet viewport wins over the last onResize()
+    UINT32 width = packet.viewportWidth > 0 ? packet.viewportWidth : m_Width;
+    UINT32 height = packet.viewportHeight > 0 ? packet.viewportHeight : m_Height;
+    if (width != m_Width || height != m_Height || m_ColorBuffer.empty())
+    {
+        resizeTargets(width > 0 ? width : SOFTWARE_DEFAULT_WIDTH, height > 0 ? height : SOFTWARE_DEFAULT_HEIGHT);
+    }
+
+    // ---- Shadow cascades ----
+    SoftwareShadeContext shade = {};
+    shade.lights = packet.lights;
+    shade.lightCount = packet.lightCount;
+    shade.cameraPosition = packet.constants.cameraPosition;
+    shade.view = packet.constants.view;
+    shade.ambient = Quark::Vec3(packet.constants.ambientLight.r, packet.constants.ambientLight.g, packet.constants.ambientLight.b);
+
+    // Packets without a full cluster grid fall back to every light
+    const FrameConstants& constants = packet.constants;
+    if (m_ClusteredLighting && packet.lightClusterCount == LIGHT_CLUSTER_COUNT &&
+        constants.clusterGridX * constants.clusterGridY * constants.clusterGridZ == LIGHT_CLUSTER_COUNT &&
+        constants.directionalLightCount <= packet.lightCount)
+    {
+        shade.clusters = packet.lightClusters;
+        shade.clusterLightIndices = packet.clusterLightIndices;
+        shade.directionalLightCount = constants.directionalLightCount;
+        shade.clusterConstants = constants;
+        shade.clusterConstants.clusterTileScaleX = static_cast<float>(constants.clusterGridX) / m_Width;
+        shade.clusterConstants.clusterTileScaleY = static_cast<float>(constants.clusterGridY) / m_Height;
+    }
+
+    for (UINT32 i = 0; i < packet.lightCount && m_ShadowsEnabled; ++i)
+    {
+        const GPULightData& light = packet.lights[i];
+        const UINT32 required = static_cast<UINT32>(LightFlags::LIGHT_ENABLED) | static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS);
+        if (light.type == static_cast<UINT32>(LightType::DIRECTIONAL) && (light.flags & required) == required)
+        {
+            shade.shadowLight = &light;
+            break;
+        }
+    }
+
+    auto passStart = std::chrono::high_resolution_clock::now();
+    if (shade.shadowLight)
+    {
+        renderShadowCascades(packet);
+        for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
+        {
+            shade.shadowMaps[i] = m_ShadowMapValid[i] ? m_ShadowMaps[i].data() : nullptr;
+        }
+        shade.shadowMapSize = m_ShadowMapSize;
+        shade.shadowMapStride = m_ShadowMapStride;
+    }
+    m_Stats.shadowMs = elapsedMs(passStart);
+
+    // ---- Main pass ----
+    SoftwareRasterTarget target = {};
+    target.depth = m_DepthBuffer.data();
+    target.color = m_ColorBuffer.data();
+    target.width = m_Width;
+    target.height = m_Height;
+    target.stride = m_Stride;
+    target.tilesX = m_TilesX;
+    target.tilesY = m_TilesY;
+
+    passStart = std::chrono::high_resolution_clock::now();
+    clearTargets(packet);
+    binTriangles(packet.drawCommands, packet.drawCommandCount, packet.instanceData, packet.instanceDataCount,
+                 packet.constants.viewProjection, target);
+    m_Stats.geometryMs = elapsedMs(passStart);
+
+    for (UINT32 t = 0; t < m_BinTaskCount; ++t)
+    {
+        const BinTask& task = m_BinTasks[t];
+        m_Stats.triangles += task.trianglesIn;
+        m_Stats.trianglesRasterized += task.trianglesOut;
+        for (UINT32 tile = 0; tile < m_TilesX * m_TilesY; ++tile)
+        {
+            m_Stats.binEntries += task.bins[tile].size();
+        }
+    }
+
+    passStart = std::chrono::high_resolution_clock::now();
+    rasterizeTiles(target, &shade);
+    m_Stats.rasterMs = elapsedMs(passStart);
+
+    for (UINT32 tile = 0; tile < m_TilesX * m_TilesY; ++tile)
+    {
+        m_Stats.pixelsShaded += m_TilePixels[tile];
+    }
+
+    m_Stats.frameMs = elapsedMs(frameStart);
+    m_Stats.trianglesPerSecond = m_Stats.frameMs > 0.0
+        ? static_cast<double>(m_Stats.triangles + m_Stats.shadowTriangles) * 1000.0 / m_Stats.frameMs
+        : 0.0;
+
+    m_Stats.framesExecuted++;
+    m_Stats.totalTriangles += m_Stats.triangles + m_Stats.shadowTriangles;
+    m_Stats.totalFrameMs += m_Stats.frameMs;
+
+    m_CompletedFrameFence = packet.frameFence;
+}
+
+void RSSoftware::endFrame()
+{
+    m_Stats.framesPresented++;
+}
+
+UINT64 RSSoftware::getCompletedFrameFence() const
+{
+    return m_CompletedFrameFence;
+}
+
+void RSSoftware::waitForFrameFence(UINT64 /*fence*/)
+{
+    // executeFrame() is synchronous, every submitted fence is already complete
+}
+
+void RSSoftware::onResize(UINT32 width, UINT32 height)
+{
+    resizeTargets(width, height);
+}
+
+void* RSSoftware::getDevice() const
+{
+    return nullptr;
+}
+
+void* RSSoftware::getContext() const
+{
+    return nullptr;
+}
+
+// ==================== IMAGE OUTPUT ====================
+void RSSoftware::readPixels(UINT8* outPixels) const
+{
+    if (!outPixels) return;
+
+    for (UINT32 y = 0; y < m_Height; ++y)
+    {
+        memcpy(outPixels + static_cast<size_t>(y) * m_Width * 4,
+               m_ColorBuffer.data() + static_cast<size_t>(y) * m_Stride,
+               static_cast<size_t>(m_Width) * 4);
+    }
+}
+
+static UINT32 crc32(UINT32 crc, const UINT8* data, size_t size)
+{
+    static const auto s_Table = []
+    {
+        std::vector<UINT32> table(256);
+        for (UINT32 i = 0; i < 256; ++i)
+        {
+            UINT32 c = i;
+            for (int k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = s_Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void appendBigEndian(std::vector<UINT8>& out, UINT32 value)
+{
+    out.push_back(static_cast<UINT8>(value >> 24));
+    out.push_back(static_cast<UINT8>(value >> 16));
+    out.push_back(static_cast<UINT8>(value >> 8));
+    out.push_back(static_cast<UINT8>(value));
+}
+
+static void appendChunk(std::vector<UINT8>& out, const char* type, const std::vector<UINT8>& data)
+{
+    appendBigEndian(out, static_cast<UINT32>(data.size()));
+    size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBigEndian(out, crc32(0, out.data() + typeOffset, data.size() + 4));
+}
+
+bool RSSoftware::writePNG(const char* filename) const
+{
+    if (!filename || m_Width == 0 || m_Height == 0)
+    {
+        std::cerr << "[RSSoftware] ERROR: Nothing to write.\n";
+        return false;
+    }
+
+    // Filter byte 0 + RGBA8 per row
+    const size_t rowBytes = static_cast<size_t>(m_Width) * 4 + 1;
+    std::vector<UINT8> raw(rowBytes * m_Height);
+    for (UINT32 y = 0; y < m_Height; ++y)
+    {
+        raw[y * rowBytes] = 0;
+        memcpy(&raw[y * rowBytes + 1], m_ColorBuffer.data() + static_cast<size_t>(y) * m_Stride, rowBytes - 1);
+    }
+
+    // zlib stream of stored (uncompressed) deflate blocks, no compressor needed
+    std::vector<UINT8> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+
+    size_t offset = 0;
+    do
+    {
+        UINT32 blockSize = static_cast<UINT32>((std::min)(raw.size() - offset, static_cast<size_t>(65535)));
+        bool last = offset + blockSize == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<UINT8>(blockSize));
+        zlib.push_back(static_cast<UINT8>(blockSize >> 8));
+        zlib.push_back(static_cast<UINT8>(~blockSize));
+        zlib.push_back(static_cast<UINT8>(~blockSize >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    UINT32 adlerA = 1;
+    UINT32 adlerB = 0;
+    for (UINT8 byte : raw)
+    {
+        adlerA = (adlerA + byte) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+    }
+    appendBigEndian(zlib, (adlerB << 16) | adlerA);
+
+    std::vector<UINT8> header;
+    appendBigEndian(header, m_Width);
+    appendBigEndian(header, m_Height);
+    header.push_back(8);    // Bit depth
+    header.push_back(6);    // RGBA
+    header.push_back(0);    // Deflate
+    header.push_back(0);    // Adaptive filtering
+    header.push_back(0);    // No interlace
+
+    const UINT8 signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    std::vector<UINT8> png(signature, signature + 8);
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", zlib);
+    appendChunk(png, "IEND", {});
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "[RSSoftware] ERROR: Cannot open " << filename << " for writing.\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    return static_cast<bool>(file);
+}
+
+// ==================== C API ====================
+RHI* createRenderBackend()
+{
+    return new RSSoftware();
+}
+
+void destroyRenderBackend(RHI* rhi)
+{
+    if (rhi)
+    {
+        delete rhi;
+    }
+}
+
+void setRenderBackendJobSystem(RHI* rhi, JobSystemAPI* jobSystem)
+{
+    if (rhi)
+    {
+        static_cast<RSSoftware*>(rhi)->setJobSystem(jobSystem);
+    }
+}
+
+void setRenderBackendProfiler(Quark::Profiler* profiler)
+{
+    Quark::setModuleProfiler(profiler, "rssoftware");
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#ifdef _WIN32
+#ifdef RSSOFTWARE_EXPORTS
+#define RSSOFTWARE_API __declspec(dllexport)
+#else
+#define RSSOFTWARE_API __declspec(dllimport)
+#endif
+#else
+#define RSSOFTWARE_API
+#endif
+
+#include <vector>
+
+#include "../../rhi.h"
+#include "../../rstypes.h"
+#include "../../meshdata.h"
+#include "../../material.h"
+#include "../../lighting.h"
+#include "../../framepacket.h"
+#include "../../taskpool.h"
+#include "../../../../headeronly/globaltypes.h"
+#include "../../../../headeronly/slotmap.h"
+#include "../../../../core/engine/jobsystem/jobsystemapi.h"
+
+namespace Quark { class Profiler; }
+
+// ==================== SOFTWARE RASTERIZER CONSTANTS ====================
+constexpr UINT32 SOFTWARE_TILE_SIZE = 64;                  // Pixels per bin side, a multiple of 4 (SIMD width)
+constexpr UINT32 SOFTWARE_DEFAULT_WIDTH = 1280;
+constexpr UINT32 SOFTWARE_DEFAULT_HEIGHT = 720;
+constexpr UINT32 SOFTWARE_DEFAULT_SHADOW_MAP_SIZE = 1024;  // Per cascade
+constexpr UINT32 SOFTWARE_GEOMETRY_CHUNK_SIZE = 16;        // Instances per geometry task (minimum)
+
+// ==================== SOFTWARE MESH BUFFER ====================
+struct SoftwareMeshBuffer
+{
+    std::vector<Vertex> vertices;
+    std::vector<UINT32> indices;   // Empty for non-indexed meshes
+    UINT64 bytes;                  // Size at creation, updates may not grow past it
+    bool isDynamic;
+};
+
+// ==================== SOFTWARE MATERIAL BUFFER ====================
+struct SoftwareMaterialBuffer
+{
+    MaterialData data;
+    hTexture textures[6];
+};
+
+// ==================== SOFTWARE TEXTURE ====================
+struct SoftwareTexture
+{
+    UINT64 pathHash;    // Images are not decoded, materials shade with their constant values
+};
+
+// ==================== CLIP VERTEX ====================
+struct ClipVertex
+{
+    Quark::Vec4 position;       // Clip space
+    Quark::Vec3 worldPos;
+    Quark::Vec3 normal;
+};
+
+// ==================== RASTER TRIANGLE ====================
+// Screen-space triangle after clipping, culling and setup. Edge i is the edge
+// opposite vertex i, E_i(x, y) = A*x + B*y + C is positive inside and equals
+// twice the area times the screen-space weight of vertex i.
+struct RasterTriangle
+{
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    float depth[3];             // Vertex depth in [0, 1] divided by twice the area
+    float invW[3];
+    Quark::Vec3 worldPos[3];
+    Quark::Vec3 normal[3];
+    int minX, minY, maxX, maxY; // Pixel bounds, clamped to the target
+    const MaterialData* material;
+    UINT32 topLeftEdges;        // Bit i set when edge i owns pixels exactly on it (top-left rule)
+    UINT32 objectFlags;         // RenderObjectFlags from the instance custom data
+};
+
+// ==================== BIN TASK ====================
+// Output of one geometry task: its triangles and, per tile, the indices of the
+// triangles touching that tile. Tiles walk the tasks in order, so draw order
+// is kept no matter how the tasks were scheduled.
+struct BinTask
+{
+    std::vector<ClipVertex> vertices;       // Current instance, transformed
+    std::vector<RasterTriangle> triangles;
+    std::vector<std::vector<UINT32>> bins;
+    UINT64 trianglesIn;
+    UINT64 trianglesOut;
+};
+
+// Pass target and shading inputs, defined in rssoftware.cpp
+struct SoftwareRasterTarget;
+struct SoftwareShadeContext;
+
+// ==================== SOFTWARE BACKEND STATISTICS ====================
+struct SoftwareRHIStats
+{
+    // Live resources
+    UINT32 meshCount;
+    UINT32 materialCount;
+    UINT32 textureCount;
+    UINT64 meshBytes;
+
+    // Last frame
+    UINT32 drawCalls;
+    UINT32 instances;
+    UINT64 triangles;             // Main pass triangles submitted
+    UINT64 trianglesRasterized;   // Main pass triangles left after clipping and culling
+    UINT64 shadowTriangles;       // Cascade triangles submitted
+    UINT32 shadowViews;           // Cascades rendered
+    UINT32 shadowViewsCached;     // Cascades kept from an earlier frame, see ShadowView
+    UINT64 binEntries;            // Triangle-tile pairs, main pass
+    UINT64 pixelsShaded;
+    UINT32 invalidDraws;
+    double shadowMs;
+    double geometryMs;            // Clear, transform, clip, setup and binning of the main pass
+    double rasterMs;              // Tile rasterization and shading of the main pass
+    double frameMs;
+    double trianglesPerSecond;    // (triangles + shadowTriangles) / frameMs
+
+    // Totals since init
+    UINT64 framesExecuted;
+    UINT64 framesPresented;
+    UINT64 totalTriangles;
+    double totalFrameMs;
+};
+
+// ==================== RSSOFTWARE BACKEND ====================
+// CPU rasterizer for GPU-less machines (image tests, thumbnails, servers).
+// Draws the packet's DrawCommand / PerInstanceData streams the same way the
+// GPU backends do, in two phases per pass:
+//   1. Geometry: instance chunks are transformed, clipped against the near
+//      plane, culled and set up, then binned into 64x64 tiles
+//   2. Raster: tiles are filled in parallel with 4-wide SSE edge functions,
+//      a depth test and a simplified version of the D3D11 PBR shader
+//      (GGX, directional CSM shadows, IBL ambient, ACES)
+// Cascades go through the same pipeline depth-only. Spot and point shadows,
+// texture maps, anisotropy and clear coat are not rendered.
+// executeFrame() is synchronous, the image is ready when it returns.
+class RSSoftware : public RHI
+{
+private:
+    Quark::SlotMap<SoftwareMeshBuffer> m_MeshBuffers;
+    Quark::SlotMap<SoftwareMaterialBuffer> m_MaterialBuffers;
+    Quark::SlotMap<SoftwareTexture> m_Textures;
+
+    // Render targets, rows padded to whole tiles
+    std::vector<UINT32> m_ColorBuffer;  // RGBA8, R in the low byte
+    std::vector<float> m_DepthBuffer;
+    UINT32 m_Width;
+    UINT32 m_Height;
+    UINT32 m_Stride;
+    UINT32 m_TilesX;
+    UINT32 m_TilesY;
+
+    std::vector<float> m_ShadowMaps[DIRECTIONAL_CASCADE_COUNT];
+    bool m_ShadowMapValid[DIRECTIONAL_CASCADE_COUNT];
+    std::vector<float> m_StaticShadowMaps[DIRECTIONAL_CASCADE_COUNT];  // STATIC casters only
+    UINT64 m_ShadowMapVersions[DIRECTIONAL_CASCADE_COUNT];             // Held versions, 0 = none
+    UINT64 m_StaticShadowMapVersions[DIRECTIONAL_CASCADE_COUNT];
+    UINT32 m_ShadowMapSize;
+    UINT32 m_ShadowMapStride;
+    bool m_ShadowsEnabled;
+    bool m_SkyEnabled;
+    bool m_ClusteredLighting;
+
+    // Main pass instances of valid draws, flattened so large instanced draws split across tasks
+    struct DrawInstance
+    {
+        UINT32 command;
+        UINT32 instance;
+    };
+
+    TaskPool m_TaskPool;
+    std::vector<DrawInstance> m_DrawInstances;
+    std::vector<BinTask> m_BinTasks;
+    UINT32 m_BinTaskCount;              // Tasks filled by the last binTriangles()
+    std::vector<UINT64> m_TilePixels;   // Shaded pixels per tile, summed after the raster phase
+
+    SoftwareRHIStats m_Stats;
+    bool m_Initialized;
+    UINT64 m_CompletedFrameFence;
+
+    void resizeTargets(UINT32 width, UINT32 height);
+    void clearTargets(const FramePacket& packet);
+    void renderShadowCascades(const FramePacket& packet);
+    void renderShadowDepth(const FramePacket& packet, const ShadowView& view, UINT32 commandStart, UINT32 commandCount, std::vector<float>& map);
+    void binTriangles(const DrawCommand* commands, UINT32 commandCount,
+                      const PerInstanceData* instances, UINT32 instanceCount,
+                      const Quark::Mat4& viewProjection, const SoftwareRasterTarget& target);
+    void rasterizeTiles(const SoftwareRasterTarget& target, const SoftwareShadeContext* shade);
+
+public:
+    RSSoftware();
+    ~RSSoftware() override;
+
+    RSSoftware(const RSSoftware&) = delete;
+    RSSoftware& operator=(const RSSoftware&) = delete;
+
+    // ==================== RHI INTERFACE ====================
+    void init(qWndh windowHandle) override;
+    void shutdown() override;
+
+    hMesh createMeshBuffer(const MeshData& meshData, bool isDynamic) override;
+    void destroyMeshBuffer(hMesh handle) override;
+    bool updateMeshBuffer(hMesh handle, const MeshData& meshData) override;
+
+    hMaterial createMaterialBuffer(const MaterialData& materialData) override;
+    void destroyMaterialBuffer(hMaterial handle) override;
+    bool updateMaterialBuffer(hMaterial handle, const MaterialData& materialData) override;
+
+    hTexture loadTexture(const char* filename) override;
+    void destroyTexture(hTexture handle) override;
+    bool bindTextureToMaterial(hMaterial material, hTexture texture, UINT32 slot) override;
+
+    void executeFrame(const FramePacket& packet) override;
+    void endFrame() override;
+    UINT64 getCompletedFrameFence() const override;
+    void waitForFrameFence(UINT64 fence) override;
+
+    void onResize(UINT32 width, UINT32 height) override;
+
+    void* getDevice() const override;
+    void* getContext() const override;
+
+    // ==================== SOFTWARE BACKEND ====================
+    // Threads used for binning and tiles (including the caller), ignored while a job system is attached
+    void setThreadCount(UINT32 count) { m_TaskPool.setThreadCount(count); }
+    UINT32 getThreadCount() const { return m_TaskPool.getThreadCount(); }
+    void setJobSystem(JobSystemAPI* jobSystem) { m_TaskPool.setJobSystem(jobSystem); }
+
+    void setShadowsEnabled(bool enabled) { m_ShadowsEnabled = enabled; }
+    bool isShadowsEnabled() const { return m_ShadowsEnabled; }
+    void setShadowMapSize(UINT32 size);
+    UINT32 getShadowMapSize() const { return m_ShadowMapSize; }
+
+    // Off: the background keeps the packet clear color
+    void setSkyEnabled(bool enabled) { m_SkyEnabled = enabled; }
+    bool isSkyEnabled() const { return m_SkyEnabled; }
+
+    // Off: every pixel walks every light, the reference for the packet's light clusters
+    void setClusteredLighting(bool enabled) { m_ClusteredLighting = enabled; }
+    bool isClusteredLighting() const { return m_ClusteredLighting; }
+
+    // Last rendered image, RGBA8 rows of getImageStride() pixels
+    const UINT32* getImage() const { return m_ColorBuffer.data(); }
+    UINT32 getImageStride() const { return m_Stride; }
+    UINT32 getWidth() const { return m_Width; }
+    UINT32 getHeight() const { return m_Height; }
+
+    // Copies the image into tightly packed RGBA8 rows (width * height * 4 bytes)
+    void readPixels(UINT8* outPixels) const;
+    bool writePNG(const char* filename) const;
+
+    const SoftwareRHIStats& getStats() const { return m_Stats; }
+};
+
+// ==================== C API (DLL BOUNDARY) ====================
+extern "C" {
+    RSSOFTWARE_API RHI* createRenderBackend();
+    RSSOFTWARE_API void destroyRenderBackend(RHI* rhi);
+
+    // Lets the engine share its job system with a backend created above
+    RSSOFTWARE_API void setRenderBackendJobSystem(RHI* rhi, JobSystemAPI* jobSystem);
+
+    // Records the backend's zones into a shared profiler (one per module, not per backend)
+    RSSOFTWARE_API void setRenderBackendProfiler(Quark::Profiler* profiler);
+}
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#include "../../headeronly/globaltypes.h"
+#include "../../headeronly/mathematics.h"
+#include "frustum.h"
+
+// ==================== BVH CONSTANTS ====================
+constexpr UINT32 BVH_NULL_NODE = UINT32_MAX;
+constexpr float BVH_FAT_MARGIN = 0.1f;          // Fat AABB margin, relative to the largest extent
+constexpr float BVH_FAT_MARGIN_MIN = 0.05f;     // Fat AABB margin floor (world units)
+constexpr UINT32 BVH_FULL_PLANE_MASK = 0x3F;    // All 6 frustum planes
+
+// ==================== BVH CULL STATS ====================
+struct BVHCullStats
+{
+    UINT32 nodesTested;         // Node boxes tested against at least one plane
+    UINT32 subtreesRejected;    // Nodes outside a plane, skipped with everything below
+    UINT32 subtreesAccepted;    // Inner nodes fully inside, emitted without further tests
+};
+
+// (node, plane mask) entries of a frustum walk. The caller owns it so one tree can be
+// walked from several threads, each with its own stack; reusing one keeps walks allocation free.
+using BVHTraversalStack = std::vector<std::pair<UINT32, UINT32>>;
+
+// ==================== BVH NODE ====================
+struct BVHNode
+{
+    Quark::AABB aabb;       // Fat for dynamic leaves, tight for built trees
+    UINT32 parent;          // Next free node while on the free list
+    UINT32 child1;
+    UINT32 child2;
+    UINT32 userData;
+    int height;             // Leaf = 0, free = -1
+
+    bool isLeaf() const { return child1 == BVH_NULL_NODE; }
+};
+
+// ==================== DYNAMIC AABB TREE ====================
+// Binary AABB tree with one leaf per proxy.
+// - insert/remove/move: incremental updates, move is free while the new bounds stay inside the fat AABB;
+//   the refit walk rotates unbalanced nodes (Box2D style) so the height stays O(log n)
+// - build: top-down median split over a fixed set (used for static geometry)
+class DynamicAABBTree
+{
+private:
+    std::vector<BVHNode> m_Nodes;
+    UINT32 m_Root;
+    UINT32 m_FreeList;
+    UINT32 m_LeafCount;
+
+public:
+    DynamicAABBTree()
+        : m_Root(BVH_NULL_NODE)
+        , m_FreeList(BVH_NULL_NODE)
+        , m_LeafCount(0)
+    {
+    }
+
+    // ==================== INCREMENTAL ====================
+    UINT32 insert(const Quark::AABB& box, UINT32 userData)
+    {
+        UINT32 leaf = allocateNode();
+        m_Nodes[leaf].aabb = fatten(box);
+        m_Nodes[leaf].userData = userData;
+        m_Nodes[leaf].height = 0;
+        insertLeaf(leaf);
+        m_LeafCount++;
+        return leaf;
+    }
+
+    void remove(UINT32 proxyId)
+    {
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        m_LeafCount--;
+    }
+
+    // Returns true if the proxy had to be reinserted
+    bool move(UINT32 proxyId, const Quark::AABB& box)
+    {
+        const Quark::AABB& fat = m_Nodes[proxyId].aabb;
+        if (contains(fat, box))
+        {
+            return false;
+        }
+
+        removeLeaf(proxyId);
+        m_Nodes[proxyId].aabb = fatten(box);
+        insertLeaf(proxyId);
+        return true;
+    }
+
+    void clear()
+    {
+        m_Nodes.clear();
+        m_Root = BVH_NULL_NODE;
+        m_FreeList = BVH_NULL_NODE;
+        m_LeafCount = 0;
+    }
+
+    // ==================== STATIC BUILD ====================
+    // Rebuilds the whole tree from tight bounds, leaf i gets userData i
+    void build(const Quark::AABB* boxes, UINT32 count)
+    {
+        clear();
+        if (count == 0) return;
+
+        m_Nodes.reserve(count * 2);
+
+        std::vector<UINT32> leaves(count);
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            UINT32 leaf = allocateNode();
+            m_Nodes[leaf].aabb = boxes[i];
+            m_Nodes[leaf].userData = i;
+            m_Nodes[leaf].height = 0;
+            leaves[i] = leaf;
+        }
+
+        m_LeafCount = count;
+        m_Root = buildRange(leaves.data(), count);
+        m_Nodes[m_Root].parent = BVH_NULL_NODE;
+    }
+
+    // ==================== QUERIES ====================
+    // Hierarchical frustum walk. Planes a node is fully inside are dropped from the
+    // mask for its subtree, so fully visible subtrees are emitted without further tests.
+    // visitor(userData, fullyInside): fullyInside is false for leaves whose (fat) box
+    // straddles a plane; callers may refine those with a tight test.
+    template<typename Visitor>
+    BVHCullStats cullFrustum(const Frustum& frustum, BVHTraversalStack& stack, Visitor&& visitor) const
+    {
+        BVHCullStats stats = {};
+        if (m_Root == BVH_NULL_NODE) return stats;
+
+        stack.clear();
+        stack.push_back({ m_Root, BVH_FULL_PLANE_MASK });
+
+        while (!stack.empty())
+        {
+            auto [nodeIndex, mask] = stack.back();
+            stack.pop_back();
+
+            const BVHNode& node = m_Nodes[nodeIndex];
+
+            if (mask != 0)
+            {
+                stats.nodesTested++;
+                Quark::Vec3 center = node.aabb.Center();
+                Quark::Vec3 extent = node.aabb.Extents();
+                bool outside = false;
+
+                for (UINT32 p = 0; p < 6; ++p)
+                {
+                    if ((mask & (1u << p)) == 0) continue;
+
+                    const Quark::Plane& plane = frustum.planes[p];
+                    float dist = plane.normal.Dot(center) + plane.distance;
+                    float radius = std::abs(plane.normal.x) * extent.x +
+                                   std::abs(plane.normal.y) * extent.y +
+                                   std::abs(plane.normal.z) * extent.z;
+
+                    if (dist + radius < 0.0f)
+                    {
+                        outside = true;
+                        break;
+                    }
+                    if (dist - radius >= 0.0f)
+                    {
+                        mask &= ~(1u << p);
+                    }
+                }
+
+                if (outside)
+                {
+                    stats.subtreesRejected++;
+                    continue;
+                }
+            }
+
+            if (node.isLeaf())
+            {
+                visitor(node.userData, mask == 0);
+            }
+            else if (mask == 0)
+            {
+                stats.subtreesAccepted++;
+                emitSubtree(nodeIndex, stack, visitor);
+            }
+            else
+            {
+                stack.push_back({ node.child1, mask });
+                stack.push_back({ node.child2, mask });
+            }
+        }
+        return stats;
+    }
+
+    UINT32 getUserData(UINT32 proxyId) const { return m_Nodes[proxyId].userData; }
+    const Quark::AABB& getFatAABB(UINT32 proxyId) const { return m_Nodes[proxyId].aabb; }
+    UINT32 getLeafCount() const { return m_LeafCount; }
+    int getHeight() const { return m_Root == BVH_NULL_NODE ? 0 : m_Nodes[m_Root].height; }
+
+private:
+    // ==================== NODE POOL ====================
+    UINT32 allocateNode()
+    {
+        UINT32 index;
+        if (m_FreeList != BVH_NULL_NODE)
+        {
+            index = m_FreeList;
+            m_FreeList = m_Nodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<UINT32>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+
+        BVHNode& node = m_Nodes[index];
+        node.parent = BVH_NULL_NODE;
+        node.child1 = BVH_NULL_NODE;
+        node.child2 = BVH_NULL_NODE;
+        node.userData = 0;
+        node.height = 0;
+        return index;
+    }
+
+    void freeNode(UINT32 index)
+    {
+        m_Nodes[index].parent = m_FreeList;
+        m_Nodes[index].height = -1;
+        m_FreeList = index;
+    }
+
+    // ==================== HELPERS ====================
+    static Quark::AABB fatten(const Quark::AABB& box)
+    {
+        Quark::Vec3 extent = box.Extents();
+        float largest = (std::max)(extent.x, (std::max)(extent.y, extent.z));
+        float margin = (std::max)(largest * BVH_FAT_MARGIN, BVH_FAT_MARGIN_MIN);
+        Quark::Vec3 m(margin, margin, margin);
+        return Quark::AABB(box.minBounds - m, box.maxBounds + m);
+    }
+
+    static bool contains(const Quark::AABB& outer, const Quark::AABB& inner)
+    {
+        return outer.minBounds.x <= inner.minBounds.x && outer.minBounds.y <= inner.minBounds.y &&
+               outer.minBounds.z <= inner.minBounds.z && outer.maxBounds.x >= inner.maxBounds.x &&
+               outer.maxBounds.y >= inner.maxBounds.y && outer.maxBounds.z >= inner.maxBounds.z;
+    }
+
+    static float surfaceArea(const Quark::AABB& box)
+    {
+        Quark::Vec3 d = box.Size();
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Walks to the root, balancing and refitting every ancestor
+    void refit(UINT32 index)
+    {
+        while (index != BVH_NULL_NODE)
+        {
+            index = balance(index);
+
+            BVHNode& node = m_Nodes[index];
+            const BVHNode& c1 = m_Nodes[node.child1];
+            const BVHNode& c2 = m_Nodes[node.child2];
+            node.aabb = c1.aabb.Merge(c2.aabb);
+            node.height = 1 + (std::max)(c1.height, c2.height);
+            index = node.parent;
+        }
+    }
+
+    // Points a's parent (or the root) at its replacement b, which takes over a's parent
+    void replaceChild(UINT32 a, UINT32 b)
+    {
+        UINT32 parent = m_Nodes[a].parent;
+        m_Nodes[b].parent = parent;
+        if (parent == BVH_NULL_NODE)
+            m_Root = b;
+        else if (m_Nodes[parent].child1 == a)
+            m_Nodes[parent].child1 = b;
+        else
+            m_Nodes[parent].child2 = b;
+    }
+
+    // AVL rotation: if one child of a is more than one level taller than the other, the
+    // taller child takes a's place, and a keeps the shorter grandchild. Returns the node
+    // now at a's position. The children must already be refitted.
+    UINT32 balance(UINT32 a)
+    {
+        BVHNode& nodeA = m_Nodes[a];
+        if (nodeA.isLeaf() || nodeA.height < 2)
+        {
+            return a;
+        }
+
+        const int difference = m_Nodes[nodeA.child2].height - m_Nodes[nodeA.child1].height;
+        if (difference >= -1 && difference <= 1)
+        {
+            return a;
+        }
+
+        // b goes up, c is the child that stays below a
+        const bool rotateChild2 = difference > 1;
+        const UINT32 b = rotateChild2 ? nodeA.child2 : nodeA.child1;
+        const UINT32 c = rotateChild2 ? nodeA.child1 : nodeA.child2;
+        BVHNode& nodeB = m_Nodes[b];
+
+        // b keeps its taller child, the shorter one moves under a
+        const UINT32 keep = m_Nodes[nodeB.child1].height > m_Nodes[nodeB.child2].height ? nodeB.child1 : nodeB.child2;
+        const UINT32 give = keep == nodeB.child1 ? nodeB.child2 : nodeB.child1;
+
+        replaceChild(a, b);
+        nodeB.child1 = a;
+        nodeB.child2 = keep;
+        nodeA.parent = b;
+
+        if (rotateChild2)
+            nodeA.child2 = give;
+        else
+            nodeA.child1 = give;
+        m_Nodes[give].parent = a;
+
+        nodeA.aabb = m_Nodes[c].aabb.Merge(m_Nodes[give].aabb);
+        nodeA.height = 1 + (std::max)(m_Nodes[c].height, m_Nodes[give].height);
+        nodeB.aabb = nodeA.aabb.Merge(m_Nodes[keep].aabb);
+        nodeB.height = 1 + (std::max)(nodeA.height, m_Nodes[keep].height);
+        return b;
+    }
+
+    // Surface area heuristic descent (Box2D style)
+    void insertLeaf(UINT32 leaf)
+    {
+        if (m_Root == BVH_NULL_NODE)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = BVH_NULL_NODE;
+            return;
+        }
+
+        const Quark::AABB leafBox = m_Nodes[leaf].aabb;
+        UINT32 index = m_Root;
+
+        while (!m_Nodes[index].isLeaf())
+        {
+            const BVHNode& node = m_Nodes[index];
+            float area = surfaceArea(node.aabb);
+            float combinedArea = surfaceArea(node.aabb.Merge(leafBox));
+
+            // Cost of making a new parent here, and the inherited cost for going deeper
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto childCost = [&](UINT32 child)
+            {
+                Quark::AABB merged = m_Nodes[child].aabb.Merge(leafBox);
+                if (m_Nodes[child].isLeaf())
+                {
+                    return surfaceArea(merged) + inheritanceCost;
+                }
+                return surfaceArea(merged) - surfaceArea(m_Nodes[child].aabb) + inheritanceCost;
+            };
+
+            float cost1 = childCost(node.child1);
+            float cost2 = childCost(node.child2);
+
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+
+            index = (cost1 < cost2) ? node.child1 : node.child2;
+        }
+
+        UINT32 sibling = index;
+        UINT32 oldParent = m_Nodes[sibling].parent;
+        UINT32 newParent = allocateNode();
+        m_Nodes[newParent].parent = oldParent;
+        m_Nodes[newParent].child1 = sibling;
+        m_Nodes[newParent].child2 = leaf;
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        if (oldParent != BVH_NULL_NODE)
+        {
+            if (m_Nodes[oldParent].child1 == sibling)
+                m_Nodes[oldParent].child1 = newParent;
+            else
+                m_Nodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            m_Root = newParent;
+        }
+
+        refit(newParent);
+    }
+
+    void removeLeaf(UINT32 leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = BVH_NULL_NODE;
+            return;
+        }
+
+        UINT32 parent = m_Nodes[leaf].parent;
+        UINT32 grandParent = m_Nodes[parent].parent;
+        UINT32 sibling = (m_Nodes[parent].child1 == leaf) ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+        if (grandParent != BVH_NULL_NODE)
+        {
+            if (m_Nodes[grandParent].child1 == parent)
+                m_Nodes[grandParent].child1 = sibling;
+            else
+                m_Nodes[grandParent].child2 = sibling;
+
+            m_Nodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refit(grandParent);
+        }
+        else
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].parent = BVH_NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    // Median split on the longest centroid axis
+    UINT32 buildRange(UINT32* leaves, UINT32 count)
+    {
+        if (count == 1)
+        {
+            return leaves[0];
+        }
+
+        Quark::AABB centroidBounds(m_Nodes[leaves[0]].aabb.Center(), m_Nodes[leaves[0]].aabb.Center());
+        for (UINT32 i = 1; i < count; ++i)
+        {
+            centroidBounds.Expand(m_Nodes[leaves[i]].aabb.Center());
+        }
+
+        Quark::Vec3 size = centroidBounds.Size();
+        int axis = (size.x > size.y && size.x > size.z) ? 0 : (size.y > size.z ? 1 : 2);
+
+        auto centerOnAxis = [&](UINT32 node)
+        {
+            Quark::Vec3 c = m_Nodes[node].aabb.Center();
+            return axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+        };
+
+        UINT32 half = count / 2;
+        std::nth_element(leaves, leaves + half, leaves + count,
+            [&](UINT32 a, UINT32 b) { return centerOnAxis(a) < centerOnAxis(b); });
+
+        UINT32 left = buildRange(leaves, half);
+        UINT32 right = buildRange(leaves + half, count - half);
+
+        UINT32 node = allocateNode();
+        m_Nodes[node].child1 = left;
+        m_Nodes[node].child2 = right;
+        m_Nodes[node].aabb = m_Nodes[left].aabb.Merge(m_Nodes[right].aabb);
+        m_Nodes[node].height = 1 + (std::max)(m_Nodes[left].height, m_Nodes[right].height);
+        m_Nodes[left].parent = node;
+        m_Nodes[right].parent = node;
+        return node;
+    }
+
+    template<typename Visitor>
+    void emitSubtree(UINT32 root, BVHTraversalStack& stack, Visitor& visitor) const
+    {
+        // Shares the traversal stack: entries pushed here are consumed before returning
+        size_t base = stack.size();
+        stack.push_back({ root, 0 });
+
+        while (stack.size() > base)
+        {
+            UINT32 index = stack.back().first;
+            stack.pop_back();
+
+            const BVHNode& node = m_Nodes[index];
+            if (node.isLeaf())
+            {
+                visitor(node.userData, true);
+            }
+            else
+            {
+                stack.push_back({ node.child1, 0 });
+                stack.push_back({ node.child2, 0 });
+            }
+        }
+    }
+};
@@ -229,7 +229,7 @@ private:
     void updateView()
     {
         view = Quark::Mat4::LookAt(position, position + forward(), up());
-        invView = view.Inverted();
+        invView = view.InvertedRigid();
     }
 
     void updateProjection()
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cfloat>
 #include <cmath>
+#include <cstring>
 #include "../../headeronly/mathematics.h"
 #include "camera.h"
 #include "lighting.h"
@@ -10,7 +12,12 @@
 // ==================== CSM CONSTANTS ====================
 constexpr float CSM_SPLIT_LAMBDA = 0.5f;   // Lower = more linear = longer close cascades
 constexpr float CSM_SHADOW_FAR = 150.0f;
-constexpr float SHADOW_CASTER_DISTANCE = 500.0f;
+constexpr float SHADOW_CASTER_DISTANCE = 500.0f;  // Pull-back toward the light when the casters have no bounds
+constexpr float CSM_DEPTH_QUANTUM = 8.0f;         // Fitted pull-back moves in steps so casters can move without a new matrix
+constexpr float CSM_SPLIT_SLACK = 1.1f;           // Fitted split range reaches 10% past the receivers...
+constexpr float CSM_SPLIT_SHRINK = 0.7f;          // ...and is refitted once they cover less than 70% of it
+constexpr float CSM_STAGGER_MARGIN = 0.1f;        // Extra radius of cascades kept across frames, room for the camera to move
+constexpr UINT32 CSM_MAX_UPDATE_INTERVAL = 1u << (DIRECTIONAL_CASCADE_COUNT - 1);
 
 // ==================== CASCADE DATA ====================
 struct CascadeData
@@ -27,6 +34,34 @@ struct CSMData
     Quark::Vec4 splitDistances;
 };
 
+// What the culling pass saw this frame, cascades are fitted to it
+struct CSMSceneBounds
+{
+    Quark::AABB casterBounds;   // Union of the shadow casters' world bounds, min > max when there are none
+    float receiverNear;         // View depth range of the visible shadow receivers
+    float receiverFar;
+    bool casterBoundsValid;     // False when a caster has no bounds, SHADOW_CASTER_DISTANCE is used
+    bool receiverRangeValid;    // False when a receiver has no bounds or none is visible, the full range is split
+};
+
+// A cascade matrix kept across frames
+struct CSMCascadeState
+{
+    Quark::Mat4 viewProjMatrix;
+    float depthMin;             // Closest depth along the light the matrix still covers
+    bool casterFitted;          // Pulled back to the caster bounds rather than SHADOW_CASTER_DISTANCE
+    bool valid;
+};
+
+struct CSMState
+{
+    CSMCascadeState cascades[DIRECTIONAL_CASCADE_COUNT];
+    Quark::Vec3 lightDir;
+    float splitNear;            // Range the splits are spread over, 0 until the first update
+    float splitFar;
+    UINT32 updatedMask;         // Bit per cascade refitted by the last updateCSM()
+};
+
 // ==================== CSM CALCULATIONS ====================
 
 inline void calculateCascadeSplits(float nearPlane, float farPlane, float lambda, float outSplits[DIRECTIONAL_CASCADE_COUNT + 1])
@@ -86,7 +121,10 @@ inline Quark::Mat4 computeCascadeMatrix(
     const Quark::Vec3& lightDir,
     const Quark::Vec3 frustumCorners[8],
     UINT32 cascadeIndex,
-    float& outWorldUnitsPerTexel)
+    float& outWorldUnitsPerTexel,
+    float radiusScale = 1.0f,
+    const Quark::AABB* casterBounds = nullptr,
+    float* outDepthMin = nullptr)
 {
     // ===============================
     // 1. Compute frustum center
@@ -123,8 +161,8 @@ inline Quark::Mat4 computeCascadeMatrix(
             maxDist = (std::max)(maxDist, dist);
         }
     }
-    // Radius is half the maximum diagonal
-    float radius = maxDist * 0.5f;
+    // Radius is half the maximum diagonal, scaled up for cascades that must outlive a camera move
+    float radius = maxDist * 0.5f * radiusScale;
     
     // Quantize radius to texel size to prevent sub-texel changes
     float cascadeResolution = static_cast<float>(DIRECTIONAL_SHADOW_ATLAS_SIZE) * 0.5f;
@@ -170,7 +208,7 @@ inline Quark::Mat4 computeCascadeMatrix(
     centerLS.y = std::floor(centerLS.y / outWorldUnitsPerTexel) * outWorldUnitsPerTexel;
 
     Quark::Vec4 snappedCenterWS4 =
-        lightView.Inverted() *
+        lightView.InvertedRigid() *
         Quark::Vec4(centerLS.x, centerLS.y, centerLS.z, 1.0f);
 
     Quark::Vec3 snappedCenter(
@@ -179,7 +217,23 @@ inline Quark::Mat4 computeCascadeMatrix(
         snappedCenterWS4.z
     );
 
-    lightPos = snappedCenter - dir * SHADOW_CASTER_DISTANCE;
+    // Pull back only as far as the casters reach toward the light (never less than the slice
+    // radius), the depth range then spends its precision on geometry that can matter
+    float pullBack = SHADOW_CASTER_DISTANCE;
+    if (casterBounds && casterBounds->minBounds.x > casterBounds->maxBounds.x)
+    {
+        pullBack = (std::min)(std::ceil((radius + 1.0f) / CSM_DEPTH_QUANTUM) * CSM_DEPTH_QUANTUM, SHADOW_CASTER_DISTANCE);
+    }
+    else if (casterBounds)
+    {
+        const Quark::Vec3 extents = casterBounds->Extents();
+        const float casterReach = -(casterBounds->Center() - snappedCenter).Dot(dir) +
+                                  std::fabs(extents.x * dir.x) + std::fabs(extents.y * dir.y) + std::fabs(extents.z * dir.z);
+        pullBack = (std::max)(casterReach, radius) + 1.0f;
+        pullBack = (std::min)(std::ceil(pullBack / CSM_DEPTH_QUANTUM) * CSM_DEPTH_QUANTUM, SHADOW_CASTER_DISTANCE);
+    }
+
+    lightPos = snappedCenter - dir * pullBack;
     lightView = Quark::Mat4::LookAt(lightPos, snappedCenter, up);
 
     // ===============================
@@ -187,10 +241,12 @@ inline Quark::Mat4 computeCascadeMatrix(
     // ===============================
     float halfSize = std::ceil(radius / outWorldUnitsPerTexel) * outWorldUnitsPerTexel;
 
-    // Z bounds adjusted for large shadow caster distance
-    // Near plane starts just in front of light, far extends through entire scene
+    // Near plane starts just in front of light, far extends past the slice
     float nearZ = 0.1f;
-    float farZ = SHADOW_CASTER_DISTANCE + radius * 2.0f;
+    float farZ = pullBack + radius * 2.0f;
+
+    if (outDepthMin)
+        *outDepthMin = lightPos.Dot(dir) + nearZ;
 
     // RH system, -Z forward
     Quark::Mat4 lightProj =
@@ -239,6 +295,121 @@ inline CSMData computeCSM(const Camera& camera, const Quark::Vec3& lightDir)
     return csm;
 }
 
+// Cascade c is refitted every min(2^c, maxInterval) frames
+inline UINT32 getCascadeUpdatePeriod(UINT32 cascadeIndex, UINT32 maxInterval)
+{
+    UINT32 period = 1;
+    while ((period << 1) <= maxInterval && (period << 1) <= (1u << cascadeIndex))
+        period <<= 1;
+    return period;
+}
+
+// Frame within its period a cascade is refitted on. Half a period, plus another half for every
+// cascade before it that got the same clamped period. With four cascades no two of cascades 1-3
+// share a frame for maxInterval >= 4; with 2 they alternate and two of them share every other frame.
+inline UINT32 getCascadeUpdatePhase(UINT32 cascadeIndex, UINT32 period)
+{
+    const UINT32 clampedSteps = cascadeIndex - static_cast<UINT32>(std::countr_zero(period));
+    return (period / 2) * (1 + clampedSteps) % period;
+}
+
+// True when a held cascade still shadows everything it has to this frame
+inline bool isCascadeStillValid(const CSMCascadeState& held, const Quark::Vec3 frustumCorners[8],
+                                const CSMSceneBounds& bounds, const Quark::Vec3& dir)
+{
+    if (!held.valid) return false;
+
+    // Every receiver of the slice must still land inside the ortho box
+    for (int i = 0; i < 8; ++i)
+    {
+        Quark::Vec4 clip = held.viewProjMatrix * Quark::Vec4(frustumCorners[i], 1.0f);
+        if (std::fabs(clip.x) > 1.0f || std::fabs(clip.y) > 1.0f || std::fabs(clip.z) > 1.0f)
+            return false;
+    }
+
+    // And no caster may have moved past its near plane
+    if (!bounds.casterBoundsValid) return !held.casterFitted;
+    if (bounds.casterBounds.minBounds.x > bounds.casterBounds.maxBounds.x) return true;
+
+    const Quark::Vec3 extents = bounds.casterBounds.Extents();
+    const float casterDepthMin = bounds.casterBounds.Center().Dot(dir) -
+                                 (std::fabs(extents.x * dir.x) + std::fabs(extents.y * dir.y) + std::fabs(extents.z * dir.z));
+    return casterDepthMin >= held.depthMin;
+}
+
+// Like computeCSM, but fitted to the scene bounds and with the far cascades refitted every few
+// frames. A cascade left alone keeps its exact matrix, so anything cached for it stays valid;
+// it is refitted early when the camera or the casters move out of what it covers.
+inline CSMData updateCSM(CSMState& state, const Camera& camera, const Quark::Vec3& lightDir,
+                         const CSMSceneBounds& bounds, UINT64 frameIndex, UINT32 maxInterval)
+{
+    CSMData csm = {};
+    const Quark::Vec3 dir = lightDir.Normalized();
+    const float effectiveFar = (std::min)(camera.farPlane, CSM_SHADOW_FAR);
+
+    // 1. Split range from the receivers: taken at once when they leave it, refitted
+    //    only when they shrink well inside it, so the splits do not follow every move
+    float splitNear = camera.nearPlane;
+    float splitFar = effectiveFar;
+    if (bounds.receiverRangeValid)
+    {
+        const float wantNear = std::clamp(bounds.receiverNear, camera.nearPlane, effectiveFar);
+        const float wantFar = std::clamp(bounds.receiverFar, wantNear, effectiveFar);
+        const bool held = state.splitFar > 0.0f;
+
+        splitNear = held && wantNear >= state.splitNear && wantNear * CSM_SPLIT_SHRINK <= state.splitNear
+            ? state.splitNear : wantNear / CSM_SPLIT_SLACK;
+        splitFar = held && wantFar <= state.splitFar && wantFar >= state.splitFar * CSM_SPLIT_SHRINK
+            ? state.splitFar : wantFar * CSM_SPLIT_SLACK;
+
+        splitNear = std::clamp(splitNear, camera.nearPlane, effectiveFar);
+        splitFar = std::clamp(splitFar, (std::min)(splitNear + 1.0f, effectiveFar), effectiveFar);
+    }
+    state.splitNear = splitNear;
+    state.splitFar = splitFar;
+
+    float splits[5];
+    calculateCascadeSplits(splitNear, splitFar, CSM_SPLIT_LAMBDA, splits);
+
+    csm.splitDistances.x = splits[1];
+    csm.splitDistances.y = splits[2];
+    csm.splitDistances.z = splits[3];
+    csm.splitDistances.w = splits[4];
+
+    // 2. Cascades: refit the ones due this frame and the ones that no longer cover their slice
+    const bool lightMoved = memcmp(&state.lightDir, &dir, sizeof(Quark::Vec3)) != 0;
+    state.lightDir = dir;
+    state.updatedMask = 0;
+
+    for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
+    {
+        CSMCascadeState& held = state.cascades[i];
+        const UINT32 period = getCascadeUpdatePeriod(i, maxInterval);
+
+        Quark::Vec3 corners[8];
+        computeFrustumCornersWorldSpace(camera, splits[i], splits[i + 1], corners);
+
+        const bool due = frameIndex % period == getCascadeUpdatePhase(i, period);
+        if (due || lightMoved || !isCascadeStillValid(held, corners, bounds, dir))
+        {
+            float texelSize = 0.0f;
+            held.viewProjMatrix = computeCascadeMatrix(dir, corners, i, texelSize,
+                                                       period > 1 ? 1.0f + CSM_STAGGER_MARGIN : 1.0f,
+                                                       bounds.casterBoundsValid ? &bounds.casterBounds : nullptr,
+                                                       &held.depthMin);
+            held.casterFitted = bounds.casterBoundsValid;
+            held.valid = true;
+            state.updatedMask |= 1u << i;
+        }
+
+        csm.cascades[i].viewProjMatrix = held.viewProjMatrix;
+        csm.cascades[i].splitNear = splits[i];
+        csm.cascades[i].splitFar = splits[i + 1];
+    }
+
+    return csm;
+}
+
 inline Quark::Vec2 getCascadeAtlasOffset(UINT32 cascadeIndex)
 {
     switch (cascadeIndex)
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include "../../headeronly/globaltypes.h"
 #include "../../headeronly/mathematics.h"
+#include "../../headeronly/framearena.h"
 #include "rstypes.h"
 #include "camera.h"
 #include "material.h"
@@ -20,6 +23,126 @@ struct DrawCommand
     UINT32 sortKey;
 };
 
+// ==================== SHADOW VIEW ====================
+enum class ShadowViewType : UINT32
+{
+    CASCADE = 0,     // Directional CSM cascade, slot = cascade index
+    SPOT = 1,        // Spot light, renders into atlasRect
+    POINT_FACE = 2   // Point light cube face, slot = face index, renders into atlasRect
+};
+
+// One shadow map render: the casters that survived culling against this view
+// are the shadow draw commands [commandStart, commandStart + commandCount),
+// STATIC casters first. Views without casters still come through, their tile has to be cleared.
+//
+// The versions name the tile's content (matrix and casters), 0 means uncached. A backend
+// that still holds the same version in that tile from the previous packet can skip the
+// view, one holding the same static version only redraws the dynamic commands over its
+// cached static layer. Both are hints, drawing every view is always correct.
+struct ShadowView
+{
+    Quark::Mat4 viewProjection;
+    ShadowViewType type;
+    UINT32 slot;
+    Quark::Vec4 atlasRect;      // Local views: tile in the local shadow atlas, UV offset (xy) and scale (zw)
+    UINT32 commandStart;
+    UINT32 commandCount;
+    UINT32 staticCommandCount;  // Leading commands that draw the static layer
+    UINT32 _pad0;               // Keeps the versions aligned without hidden bytes (captures hash views raw)
+    UINT64 cacheVersion;
+    UINT64 staticCacheVersion;
+};
+
+// Identifies the texels a view renders into: the cascade, or the local atlas tile
+inline UINT64 getShadowTileKey(ShadowViewType type, UINT32 slot, const Quark::Vec4& atlasRect)
+{
+    if (type == ShadowViewType::CASCADE) return slot;
+
+    const float atlasSize = static_cast<float>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE);
+    const UINT64 x = static_cast<UINT64>(atlasRect.x * atlasSize + 0.5f);
+    const UINT64 y = static_cast<UINT64>(atlasRect.y * atlasSize + 0.5f);
+    const UINT64 size = static_cast<UINT64>(atlasRect.z * atlasSize + 0.5f);
+    return (1ull << 63) | (x << 40) | (y << 20) | size;
+}
+
+// Every view a packet can hold: the cascades plus six faces per shadowed local light
+constexpr UINT32 MAX_SHADOW_VIEWS = DIRECTIONAL_CASCADE_COUNT + MAX_LOCAL_SHADOW_LIGHTS * POINT_SHADOW_FACE_COUNT;
+
+// Per-tile state by getShadowTileKey, linear probing over storage sized once for
+// MAX_SHADOW_VIEWS, so filling it every frame never allocates. Swapping two maps
+// swaps their storage.
+template <typename T>
+class ShadowTileMap
+{
+private:
+    static constexpr UINT32 CAPACITY = 1024;    // Power of two, under 40% full at MAX_SHADOW_VIEWS
+    static constexpr UINT64 EMPTY_KEY = ~0ull;  // No tile key has every bit set
+    static_assert(CAPACITY >= MAX_SHADOW_VIEWS * 2, "ShadowTileMap too small for MAX_SHADOW_VIEWS");
+
+    std::vector<UINT64> m_Keys;
+    std::vector<T> m_Values;
+
+    static UINT32 slotOf(UINT64 key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<UINT32>(key) & (CAPACITY - 1);
+    }
+
+public:
+    ShadowTileMap() : m_Keys(CAPACITY, EMPTY_KEY), m_Values(CAPACITY) {}
+
+    void clear()
+    {
+        std::fill(m_Keys.begin(), m_Keys.end(), EMPTY_KEY);
+    }
+
+    T* find(UINT64 key)
+    {
+        UINT32 slot = slotOf(key);
+        for (UINT32 probe = 0; probe < CAPACITY; ++probe, slot = (slot + 1) & (CAPACITY - 1))
+        {
+            if (m_Keys[slot] == key) return &m_Values[slot];
+            if (m_Keys[slot] == EMPTY_KEY) return nullptr;
+        }
+        return nullptr;
+    }
+
+    const T* find(UINT64 key) const
+    {
+        return const_cast<ShadowTileMap*>(this)->find(key);
+    }
+
+    // Value of the key, value-initialized if it was not there yet; nullptr once the map is full
+    T* insert(UINT64 key, bool* inserted = nullptr)
+    {
+        UINT32 slot = slotOf(key);
+        for (UINT32 probe = 0; probe < CAPACITY; ++probe, slot = (slot + 1) & (CAPACITY - 1))
+        {
+            if (m_Keys[slot] == key)
+            {
+                if (inserted) *inserted = false;
+                return &m_Values[slot];
+            }
+            if (m_Keys[slot] == EMPTY_KEY)
+            {
+                m_Keys[slot] = key;
+                m_Values[slot] = T();
+                if (inserted) *inserted = true;
+                return &m_Values[slot];
+            }
+        }
+        return nullptr;
+    }
+
+    void swap(ShadowTileMap& other)
+    {
+        m_Keys.swap(other.m_Keys);
+        m_Values.swap(other.m_Values);
+    }
+};
+
 // ==================== PER-INSTANCE DATA ====================
 struct PerInstanceData
 {
@@ -28,6 +151,13 @@ struct PerInstanceData
     Quark::Vec4 customData;
 };
 
+// ==================== LIGHT CLUSTERS ====================
+// Lights of one cluster: clusterLightIndices[offset, offset + count)
+struct LightClusterRange
+{
+    UINT32 offset;
+    UINT32 count;
+};
 
 // ==================== FRAME CONSTANTS ====================
 struct FrameConstants
@@ -48,11 +178,33 @@ struct FrameConstants
     UINT32 shadowAtlasSize;       // Directional CSM atlas size
     UINT32 localShadowAtlasSize;  // Local light (spot/point) atlas size
     // 16-byte aligned: deltaTime(4) + 3 UINT32s(12) = 16 bytes
+
+    UINT32 clusterGridX;
+    UINT32 clusterGridY;
+    UINT32 clusterGridZ;
+    UINT32 directionalLightCount; // Directional lights lead the light array and are not clustered
+
+    float clusterDepthScale;      // Slice = log(view depth) * scale + bias
+    float clusterDepthBias;
+    float clusterTileScaleX;      // Tile = pixel * scale
+    float clusterTileScaleY;
 };
 
+// Cluster a pixel center (top-left origin) at a positive view depth falls into,
+// the same mapping as the main pixel shader
+inline UINT32 getLightClusterIndex(const FrameConstants& constants, float pixelX, float pixelY, float viewDepth)
+{
+    UINT32 x = (std::min)(static_cast<UINT32>((std::max)(pixelX * constants.clusterTileScaleX, 0.0f)), constants.clusterGridX - 1);
+    UINT32 y = (std::min)(static_cast<UINT32>((std::max)(pixelY * constants.clusterTileScaleY, 0.0f)), constants.clusterGridY - 1);
+    float slice = std::log((std::max)(viewDepth, 1e-6f)) * constants.clusterDepthScale + constants.clusterDepthBias;
+    UINT32 z = (std::min)(static_cast<UINT32>((std::max)(slice, 0.0f)), constants.clusterGridZ - 1);
+    return (z * constants.clusterGridY + y) * constants.clusterGridX + x;
+}
+
 // ==================== FRAME PACKET ====================
 struct FramePacket
 {
+    UINT64 frameFence;            // Signalled by the backend once it no longer reads this packet
     FrameConstants constants;
     float clearColor[4];
     
@@ -62,6 +214,9 @@ struct FramePacket
     DrawCommand* shadowDrawCommands;
     UINT32 shadowDrawCommandCount;
     
+    ShadowView* shadowViews;
+    UINT32 shadowViewCount;
+    
     PerInstanceData* instanceData;
     UINT32 instanceDataCount;
     
@@ -75,6 +230,12 @@ struct FramePacket
     GPULightData* lights;
     UINT32 lightCount;
     
+    LightClusterRange* lightClusters;     // LIGHT_CLUSTER_COUNT entries, see getLightClusterIndex()
+    UINT32 lightClusterCount;
+    
+    UINT32* clusterLightIndices;          // Point and spot light indices, grouped by cluster
+    UINT32 clusterLightIndexCount;
+    
     UINT32 viewportWidth;
     UINT32 viewportHeight;
     
@@ -89,13 +250,17 @@ private:
     static constexpr UINT32 MAX_INSTANCES = 65536;
     static constexpr UINT32 MAX_MATERIALS = 1024;
     
-    std::vector<DrawCommand> m_DrawCommands;
-    std::vector<PerInstanceData> m_InstanceData;
-    std::vector<DrawCommand> m_ShadowDrawCommands;
-    std::vector<PerInstanceData> m_ShadowInstanceData;
-    std::vector<MaterialData> m_Materials;
-    std::vector<hMaterial> m_MaterialHandles;
-    std::vector<GPULightData> m_Lights;
+    // Packet storage lives in the frame arena given to beginFrame()
+    Quark::ArenaVector<DrawCommand> m_DrawCommands;
+    Quark::ArenaVector<PerInstanceData> m_InstanceData;
+    Quark::ArenaVector<DrawCommand> m_ShadowDrawCommands;
+    Quark::ArenaVector<PerInstanceData> m_ShadowInstanceData;
+    Quark::ArenaVector<ShadowView> m_ShadowViews;
+    Quark::ArenaVector<MaterialData> m_Materials;
+    Quark::ArenaVector<hMaterial> m_MaterialHandles;
+    Quark::ArenaVector<GPULightData> m_Lights;
+    Quark::ArenaVector<LightClusterRange> m_LightClusters;
+    Quark::ArenaVector<UINT32> m_ClusterLightIndices;
     
     UINT32 m_DrawCommandCount;
     UINT32 m_InstanceCount;
@@ -104,13 +269,9 @@ private:
     UINT32 m_MaterialCount;
     UINT32 m_LightCount;
     UINT32 m_DirectionalLightCount;
-    UINT32 m_PointLightCount;
-    UINT32 m_SpotLightCount;
-    
-    UINT32 m_SpotShadowCount;  // Tracks next available spot shadow slot
-    UINT32 m_PointShadowCount; // Tracks next available point shadow slot
     
     FrameConstants m_Constants;
+    UINT64 m_FrameFence;
     float m_ClearColor[4];
     UINT32 m_ViewportWidth;
     UINT32 m_ViewportHeight;
@@ -125,10 +286,7 @@ public:
         , m_MaterialCount(0)
         , m_LightCount(0)
         , m_DirectionalLightCount(0)
-        , m_PointLightCount(0)
-        , m_SpotLightCount(0)
-        , m_SpotShadowCount(0)
-        , m_PointShadowCount(0)
+        , m_FrameFence(0)
         , m_ViewportWidth(0)
         , m_ViewportHeight(0)
     {
@@ -136,9 +294,12 @@ public:
         m_InstanceData.reserve(4096);
         m_ShadowDrawCommands.reserve(1024);
         m_ShadowInstanceData.reserve(4096);
+        m_ShadowViews.reserve(MAX_SHADOW_VIEWS);
         m_Materials.reserve(64);
         m_MaterialHandles.reserve(64);
-        m_Lights.reserve(MAX_LIGHTS);
+        m_Lights.reserve(64);
+        m_LightClusters.reserve(LIGHT_CLUSTER_COUNT);
+        m_ClusterLightIndices.reserve(1024);
         
         m_ClearColor[0] = 0.1f;
         m_ClearColor[1] = 0.1f;
@@ -146,15 +307,35 @@ public:
         m_ClearColor[3] = 1.0f;
     }
     
+    // Moves packet storage to the arena of the frame about to be built. Packets
+    // built earlier keep pointing into their own arena until it is reset.
+    void beginFrame(Quark::FrameArena& arena)
+    {
+        Quark::RebindArenaVector(m_DrawCommands, arena);
+        Quark::RebindArenaVector(m_InstanceData, arena);
+        Quark::RebindArenaVector(m_ShadowDrawCommands, arena);
+        Quark::RebindArenaVector(m_ShadowInstanceData, arena);
+        Quark::RebindArenaVector(m_ShadowViews, arena);
+        Quark::RebindArenaVector(m_Materials, arena);
+        Quark::RebindArenaVector(m_MaterialHandles, arena);
+        Quark::RebindArenaVector(m_Lights, arena);
+        Quark::RebindArenaVector(m_LightClusters, arena);
+        Quark::RebindArenaVector(m_ClusterLightIndices, arena);
+        reset();
+    }
+
     void reset()
     {
         m_DrawCommands.clear();
         m_InstanceData.clear();
         m_ShadowDrawCommands.clear();
         m_ShadowInstanceData.clear();
+        m_ShadowViews.clear();
         m_Materials.clear();
         m_MaterialHandles.clear();
         m_Lights.clear();
+        m_LightClusters.clear();
+        m_ClusterLightIndices.clear();
         m_DrawCommandCount = 0;
         m_InstanceCount = 0;
         m_ShadowDrawCommandCount = 0;
@@ -162,13 +343,10 @@ public:
         m_MaterialCount = 0;
         m_LightCount = 0;
         m_DirectionalLightCount = 0;
-        m_PointLightCount = 0;
-        m_SpotLightCount = 0;
-        m_SpotShadowCount = 0;
-        m_PointShadowCount = 0;
     }
     
     void setFrameConstants(const FrameConstants& constants) { m_Constants = constants; }
+    void setFrameFence(UINT64 fence) { m_FrameFence = fence; }
     void setClearColor(float r, float g, float b, float a)
     {
         m_ClearColor[0] = r;
@@ -203,6 +381,19 @@ public:
         return startIndex;
     }
     
+    // Reserves a range for the caller to fill in place (in parallel), UINT32_MAX when over budget.
+    // Pointers from getInstanceData() are only stable once all ranges are reserved.
+    UINT32 reserveInstances(UINT32 count)
+    {
+        if (m_InstanceCount + count > MAX_INSTANCES) return UINT32_MAX;
+        UINT32 startIndex = m_InstanceCount;
+        m_InstanceData.resize(m_InstanceCount + count);
+        m_InstanceCount += count;
+        return startIndex;
+    }
+    
+    PerInstanceData* getInstanceData() { return m_InstanceData.data(); }
+    
     bool addShadowDrawCommand(const DrawCommand& cmd)
     {
         if (m_ShadowDrawCommandCount >= MAX_DRAW_COMMANDS) return false;
@@ -223,6 +414,59 @@ public:
         return startIndex;
     }
     
+    UINT32 reserveShadowInstances(UINT32 count)
+    {
+        if (m_ShadowInstanceCount + count > MAX_INSTANCES) return UINT32_MAX;
+        UINT32 startIndex = m_ShadowInstanceCount;
+        m_ShadowInstanceData.resize(m_ShadowInstanceCount + count);
+        m_ShadowInstanceCount += count;
+        return startIndex;
+    }
+    
+    PerInstanceData* getShadowInstanceData() { return m_ShadowInstanceData.data(); }
+    
+    // Shadow draw commands added until the next beginShadowView() belong to this view
+    void beginShadowView(ShadowViewType type, UINT32 slot, const Quark::Mat4& viewProjection, const Quark::Vec4& atlasRect,
+                         UINT64 cacheVersion, UINT64 staticCacheVersion)
+    {
+        ShadowView view = {};
+        view.viewProjection = viewProjection;
+        view.type = type;
+        view.slot = slot;
+        view.atlasRect = atlasRect;
+        view.commandStart = m_ShadowDrawCommandCount;
+        view.commandCount = 0;
+        view.staticCommandCount = 0;
+        view.cacheVersion = cacheVersion;
+        view.staticCacheVersion = staticCacheVersion;
+        m_ShadowViews.push_back(view);
+    }
+    
+    // Commands added so far in the current view draw its static layer
+    void endShadowViewStaticLayer()
+    {
+        if (m_ShadowViews.empty()) return;
+        ShadowView& view = m_ShadowViews.back();
+        view.staticCommandCount = m_ShadowDrawCommandCount - view.commandStart;
+    }
+    
+    // The current view's tile must be drawn even if the backend holds its versions
+    void uncacheShadowView()
+    {
+        if (m_ShadowViews.empty()) return;
+        ShadowView& view = m_ShadowViews.back();
+        view.cacheVersion = 0;
+        view.staticCacheVersion = 0;
+    }
+    
+    // Closes the current view, empty views are kept so the backend clears their tile
+    void endShadowView()
+    {
+        if (m_ShadowViews.empty()) return;
+        ShadowView& view = m_ShadowViews.back();
+        view.commandCount = m_ShadowDrawCommandCount - view.commandStart;
+    }
+    
     bool addMaterial(hMaterial handle, const MaterialData& data)
     {
         if (m_MaterialCount >= MAX_MATERIALS) return false;
@@ -240,16 +484,16 @@ public:
         return true;
     }
     
-    bool addDirectionalLight(const DirectionalLight& light, const Camera& camera)
+    // Directional lights go before any point or spot light, shading walks them outside the clusters.
+    // csm: the light's cascades, only read when it casts shadows
+    bool addDirectionalLight(const DirectionalLight& light, const CSMData& csm)
     {
-        if (m_DirectionalLightCount >= MAX_DIRECTIONAL_LIGHTS) return false;
+        if (m_DirectionalLightCount >= MAX_DIRECTIONAL_LIGHTS || m_LightCount != m_DirectionalLightCount) return false;
 
         GPULightData gpu = light.toGPU();
         
-        // Compute CSM matrices if light casts shadows
         if (light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS))
         {
-            CSMData csm = computeCSM(camera, light.direction.Normalized());
             gpu.cascadeSplits = csm.splitDistances;
             for (UINT32 i = 0; i < DIRECTIONAL_CASCADE_COUNT; ++i)
             {
@@ -265,77 +509,71 @@ public:
         return false;
     }
     
-    bool addPointLight(const PointLight& light)
+    // shadowTiles: one atlas tile per cube face, nullptr renders the light without shadows
+    bool addPointLight(const PointLight& light, const ShadowAtlasTile* shadowTiles)
     {
-        if (m_PointLightCount >= MAX_POINT_LIGHTS) return false;
+        if (m_LightCount >= MAX_LIGHTS) return false;
 
         GPULightData gpu = light.toGPU();
+        gpu.shadowIndex = -1;
 
-        // Assign shadow slots if light casts shadows
-        // Point lights need 6 slots for cube map faces
-        // shadowIndex stores the BASE slot index (first of 6 consecutive slots)
-        if ((light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && 
-            m_PointShadowCount < MAX_POINT_SHADOW_LIGHTS)
+        if ((light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && shadowTiles)
         {
-            // Each point light uses 6 slots, stored after spot lights
-            // Spot lights use slots 0-15 (MAX_SPOT_SHADOW_LIGHTS)
-            // Point lights start at slot 16 onwards
-            UINT32 baseSlot = MAX_SPOT_SHADOW_LIGHTS + (m_PointShadowCount * POINT_SHADOW_FACE_COUNT);
-            gpu.shadowIndex = static_cast<int>(baseSlot);
-            
-            // Compute 6 cube face matrices
+            gpu.shadowIndex = 0;
             computePointShadowMatrices(light, gpu.pointShadowMatrices);
-            
-            m_PointShadowCount++;
-        }
-        else
-        {
-            gpu.shadowIndex = -1;
+            for (UINT32 f = 0; f < POINT_SHADOW_FACE_COUNT; ++f)
+            {
+                gpu.shadowRects[f] = getShadowAtlasRect(shadowTiles[f]);
+            }
         }
 
-        if (addLight(gpu))
-        {
-            m_PointLightCount++;
-            return true;
-        }
-        return false;
+        return addLight(gpu);
     }
     
-    bool addSpotLight(const SpotLight& light)
+    // shadowTile: the light's atlas tile, nullptr renders the light without shadows
+    bool addSpotLight(const SpotLight& light, const ShadowAtlasTile* shadowTile)
     {
-        if (m_SpotLightCount >= MAX_SPOT_LIGHTS) return false;
+        if (m_LightCount >= MAX_LIGHTS) return false;
 
         GPULightData gpu = light.toGPU();
+        gpu.shadowIndex = -1;
         
-        // Assign shadow slot if light casts shadows
-        if ((light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && 
-            m_SpotShadowCount < MAX_SPOT_SHADOW_LIGHTS)
+        if ((light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && shadowTile)
         {
-            gpu.shadowIndex = static_cast<int>(m_SpotShadowCount);
+            gpu.shadowIndex = 0;
             gpu.spotShadowMatrix = computeSpotShadowMatrix(light);
-            m_SpotShadowCount++;
-        }
-        else
-        {
-            gpu.shadowIndex = -1;
+            gpu.shadowRects[0] = getShadowAtlasRect(*shadowTile);
         }
         
-        if (addLight(gpu))
-        {
-            m_SpotLightCount++;
-            return true;
-        }
-        return false;
+        return addLight(gpu);
+    }
+    
+    // Cluster ranges (LIGHT_CLUSTER_COUNT) and index list for the caller to fill, after all lights are added
+    LightClusterRange* reserveLightClusters()
+    {
+        m_LightClusters.resize(LIGHT_CLUSTER_COUNT);
+        return m_LightClusters.data();
+    }
+    
+    UINT32* reserveClusterLightIndices(UINT32 count)
+    {
+        m_ClusterLightIndices.resize(count);
+        return m_ClusterLightIndices.data();
     }
     
     FramePacket build()
     {
         FramePacket packet = {};
         
+        packet.frameFence = m_FrameFence;
         packet.constants = m_Constants;
         packet.constants.activeLightCount = m_LightCount;
         packet.constants.shadowAtlasSize = static_cast<UINT32>(DIRECTIONAL_SHADOW_ATLAS_SIZE);
         packet.constants.localShadowAtlasSize = static_cast<UINT32>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE);
+        packet.constants.clusterGridX = LIGHT_CLUSTER_GRID_X;
+        packet.constants.clusterGridY = LIGHT_CLUSTER_GRID_Y;
+        packet.constants.clusterGridZ = LIGHT_CLUSTER_GRID_Z;
+        packet.constants.directionalLightCount = m_DirectionalLightCount;
         
         packet.clearColor[0] = m_ClearColor[0];
         packet.clearColor[1] = m_ClearColor[1];
@@ -348,6 +586,9 @@ public:
         packet.shadowDrawCommands = m_ShadowDrawCommands.data();
         packet.shadowDrawCommandCount = m_ShadowDrawCommandCount;
         
+        packet.shadowViews = m_ShadowViews.data();
+        packet.shadowViewCount = static_cast<UINT32>(m_ShadowViews.size());
+        
         packet.instanceData = m_InstanceData.data();
         packet.instanceDataCount = m_InstanceCount;
         
@@ -361,6 +602,12 @@ public:
         packet.lights = m_Lights.data();
         packet.lightCount = m_LightCount;
         
+        packet.lightClusters = m_LightClusters.data();
+        packet.lightClusterCount = static_cast<UINT32>(m_LightClusters.size());
+        
+        packet.clusterLightIndices = m_ClusterLightIndices.data();
+        packet.clusterLightIndexCount = static_cast<UINT32>(m_ClusterLightIndices.size());
+        
         packet.viewportWidth = m_ViewportWidth;
         packet.viewportHeight = m_ViewportHeight;
         packet.skySettings = m_SkySettings;
@@ -373,4 +620,7 @@ public:
     UINT32 getCurrentInstanceCount() const { return m_InstanceCount; }
     UINT32 getCurrentLightCount() const { return m_LightCount; }
     UINT32 getRemainingLights() const { return MAX_LIGHTS - m_LightCount; }
+    const GPULightData* getLights() const { return m_Lights.data(); }
+    UINT32 getShadowViewCount() const { return static_cast<UINT32>(m_ShadowViews.size()); }
+    UINT32 getCurrentShadowInstanceCount() const { return m_ShadowInstanceCount; }
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cfloat>
+#include "../../headeronly/globaltypes.h"
 #include "../../headeronly/mathematics.h"
 
 // ==================== FRUSTUM ====================
@@ -35,15 +37,24 @@ struct Frustum
         extractAndNormalize(3,
             vp.m[3] - vp.m[1], vp.m[7] - vp.m[5], vp.m[11] - vp.m[9], vp.m[15] - vp.m[13]);
 
-        // Near plane (row2 for z in [0,1] depth range)
+        // Near plane (row3 + row2, projections are built for z in [-1,1])
         extractAndNormalize(4,
-            vp.m[2], vp.m[6], vp.m[10], vp.m[14]);
+            vp.m[3] + vp.m[2], vp.m[7] + vp.m[6], vp.m[11] + vp.m[10], vp.m[15] + vp.m[14]);
 
         // Far plane (row3 - row2)
         extractAndNormalize(5,
             vp.m[3] - vp.m[2], vp.m[7] - vp.m[6], vp.m[11] - vp.m[10], vp.m[15] - vp.m[14]);
     }
 
+    // Turns plane into one every point is in front of.
+    // Used to drop the near plane of directional shadow views so casters
+    // between the light and the cascade volume are kept.
+    void disablePlane(int index)
+    {
+        planes[index].normal = Quark::Vec3::Zero();
+        planes[index].distance = FLT_MAX;
+    }
+
     bool containsPoint(const Quark::Vec3& point) const
     {
         for (int i = 0; i < 6; i++)
@@ -64,6 +75,24 @@ struct Frustum
         return true;
     }
 
+    // Cone from the apex along the unit axis to a base disk at height. It is outside
+    // a plane when the apex and the base point furthest along the normal both are.
+    bool intersectsCone(const Quark::Vec3& apex, const Quark::Vec3& axis, float height, float baseRadius) const
+    {
+        Quark::Vec3 base = apex + axis * height;
+        for (int i = 0; i < 6; i++)
+        {
+            if (planes[i].DistanceToPoint(apex) >= 0) continue;
+
+            Quark::Vec3 toRim = planes[i].normal - axis * planes[i].normal.Dot(axis);
+            float length = toRim.Length();
+            Quark::Vec3 rim = length > Quark::EPSILON ? base + toRim * (baseRadius / length) : base;
+            if (planes[i].DistanceToPoint(rim) < 0)
+                return false;
+        }
+        return true;
+    }
+
     bool intersectsAABB(const Quark::AABB& aabb) const
     {
         for (int i = 0; i < 6; i++)
@@ -79,4 +108,125 @@ struct Frustum
         }
         return true;
     }
+
+    // Batch test of a SoA AABB set against all 6 planes (center/extent form:
+    // a box is outside a plane when n.c + d + |n|.e < 0).
+    // Writes indices of boxes that are inside or intersecting to outIndices
+    // (capacity must be >= boxes.Size()) and returns how many were written.
+    UINT32 cullAABBs(const Quark::AABBSoA& boxes, UINT32* outIndices) const
+    {
+        return cullAABBs(boxes, 0, static_cast<UINT32>(boxes.Size()), outIndices);
+    }
+
+    // Same test over boxes [begin, end). Indices written are absolute, outIndices
+    // needs capacity for end - begin. Ranges starting on a multiple of 8 test each
+    // box exactly as the full-set call does.
+    UINT32 cullAABBs(const Quark::AABBSoA& boxes, UINT32 begin, UINT32 end, UINT32* outIndices) const
+    {
+        const UINT32 count = end;
+        const float* cx = boxes.centerX.data();
+        const float* cy = boxes.centerY.data();
+        const float* cz = boxes.centerZ.data();
+        const float* ex = boxes.extentX.data();
+        const float* ey = boxes.extentY.data();
+        const float* ez = boxes.extentZ.data();
+
+        UINT32 visibleCount = 0;
+        UINT32 i = begin;
+
+#if defined(QUARK_MATH_AVX2)
+        __m256 pnx[6], pny[6], pnz[6], pd[6], pax[6], pay[6], paz[6];
+        for (int p = 0; p < 6; p++)
+        {
+            pnx[p] = _mm256_set1_ps(planes[p].normal.x);
+            pny[p] = _mm256_set1_ps(planes[p].normal.y);
+            pnz[p] = _mm256_set1_ps(planes[p].normal.z);
+            pd[p] = _mm256_set1_ps(planes[p].distance);
+            pax[p] = _mm256_set1_ps(std::abs(planes[p].normal.x));
+            pay[p] = _mm256_set1_ps(std::abs(planes[p].normal.y));
+            paz[p] = _mm256_set1_ps(std::abs(planes[p].normal.z));
+        }
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(cx + i), y = _mm256_loadu_ps(cy + i), z = _mm256_loadu_ps(cz + i);
+            __m256 hx = _mm256_loadu_ps(ex + i), hy = _mm256_loadu_ps(ey + i), hz = _mm256_loadu_ps(ez + i);
+
+            // Accumulate "outside any plane" as a sign mask
+            __m256 outside = _mm256_setzero_ps();
+            for (int p = 0; p < 6; p++)
+            {
+                __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(pnx[p], x), _mm256_mul_ps(pny[p], y)), _mm256_mul_ps(pnz[p], z)), pd[p]);
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(pax[p], hx), _mm256_mul_ps(pay[p], hy)), _mm256_mul_ps(paz[p], hz));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            UINT32 mask = static_cast<UINT32>(~_mm256_movemask_ps(outside)) & 0xFFu;
+            for (UINT32 lane = 0; lane < 8; lane++)
+            {
+                outIndices[visibleCount] = i + lane;
+                visibleCount += (mask >> lane) & 1u;
+            }
+        }
+#elif defined(QUARK_MATH_SSE2)
+        __m128 pnx[6], pny[6], pnz[6], pd[6], pax[6], pay[6], paz[6];
+        for (int p = 0; p < 6; p++)
+        {
+            pnx[p] = _mm_set1_ps(planes[p].normal.x);
+            pny[p] = _mm_set1_ps(planes[p].normal.y);
+            pnz[p] = _mm_set1_ps(planes[p].normal.z);
+            pd[p] = _mm_set1_ps(planes[p].distance);
+            pax[p] = _mm_set1_ps(std::abs(planes[p].normal.x));
+            pay[p] = _mm_set1_ps(std::abs(planes[p].normal.y));
+            paz[p] = _mm_set1_ps(std::abs(planes[p].normal.z));
+        }
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(cx + i), y = _mm_loadu_ps(cy + i), z = _mm_loadu_ps(cz + i);
+            __m128 hx = _mm_loadu_ps(ex + i), hy = _mm_loadu_ps(ey + i), hz = _mm_loadu_ps(ez + i);
+
+            // Accumulate "outside any plane" as a sign mask
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < 6; p++)
+            {
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(pnx[p], x), _mm_mul_ps(pny[p], y)), _mm_mul_ps(pnz[p], z)), pd[p]);
+                __m128 radius = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(pax[p], hx), _mm_mul_ps(pay[p], hy)), _mm_mul_ps(paz[p], hz));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+            }
+
+            UINT32 mask = static_cast<UINT32>(~_mm_movemask_ps(outside)) & 0xFu;
+            for (UINT32 lane = 0; lane < 4; lane++)
+            {
+                outIndices[visibleCount] = i + lane;
+                visibleCount += (mask >> lane) & 1u;
+            }
+        }
+#endif
+
+        // Scalar tail (and full path without SIMD)
+        for (; i < count; i++)
+        {
+            bool inside = true;
+            for (int p = 0; p < 6; p++)
+            {
+                const Quark::Plane& plane = planes[p];
+                float dist = plane.normal.x * cx[i] + plane.normal.y * cy[i] + plane.normal.z * cz[i] + plane.distance;
+                float radius = std::abs(plane.normal.x) * ex[i] + std::abs(plane.normal.y) * ey[i] + std::abs(plane.normal.z) * ez[i];
+                if (dist + radius < 0.0f)
+                {
+                    inside = false;
+                    break;
+                }
+            }
+            outIndices[visibleCount] = i;
+            visibleCount += inside ? 1u : 0u;
+        }
+
+        return visibleCount;
+    }
 };
@@ -0,0 +1,322 @@
+#include "lightclusters.h"
+#include "../../headeronly/profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ==================== CONSTRUCTOR ====================
+LightClusterBuilder::LightClusterBuilder()
+    : m_NearPlane(0.1f)
+    , m_FarPlane(1000.0f)
+    , m_DepthScale(0.0f)
+    , m_DepthBias(0.0f)
+    , m_IndexCount(0)
+    , m_MaxClusterLights(0)
+{
+    m_Slices.resize(LIGHT_CLUSTER_GRID_Z);
+    m_Lights.reserve(256);
+}
+
+// ==================== GRID ====================
+void LightClusterBuilder::setupGrid(const Camera& camera)
+{
+    m_NearPlane = (std::max)(camera.nearPlane, 1e-4f);
+    m_FarPlane = (std::max)(camera.farPlane, m_NearPlane * 1.001f);
+
+    // Slice boundaries near * (far / near)^(k / Z)
+    m_DepthScale = static_cast<float>(LIGHT_CLUSTER_GRID_Z) / std::log(m_FarPlane / m_NearPlane);
+    m_DepthBias = -std::log(m_NearPlane) * m_DepthScale;
+
+    // Two points per tile corner on the near and far planes give the corner's ray
+    for (UINT32 j = 0; j <= LIGHT_CLUSTER_GRID_Y; ++j)
+    {
+        float ndcY = 1.0f - 2.0f * static_cast<float>(j) / LIGHT_CLUSTER_GRID_Y;
+        for (UINT32 i = 0; i <= LIGHT_CLUSTER_GRID_X; ++i)
+        {
+            float ndcX = -1.0f + 2.0f * static_cast<float>(i) / LIGHT_CLUSTER_GRID_X;
+            Quark::Vec4 nearPoint = camera.invProjection * Quark::Vec4(ndcX, ndcY, -1.0f, 1.0f);
+            Quark::Vec4 farPoint = camera.invProjection * Quark::Vec4(ndcX, ndcY, 1.0f, 1.0f);
+            nearPoint = nearPoint * (1.0f / nearPoint.w);
+            farPoint = farPoint * (1.0f / farPoint.w);
+
+            float nearDepth = -nearPoint.z;
+            float farDepth = -farPoint.z;
+            float invSpan = 1.0f / (std::max)(farDepth - nearDepth, 1e-6f);
+
+            CornerRay& ray = m_Corners[j * (LIGHT_CLUSTER_GRID_X + 1) + i];
+            ray.bx = (farPoint.x - nearPoint.x) * invSpan;
+            ray.by = (farPoint.y - nearPoint.y) * invSpan;
+            ray.ax = nearPoint.x - ray.bx * nearDepth;
+            ray.ay = nearPoint.y - ray.by * nearDepth;
+        }
+    }
+}
+
+// ==================== LIGHTS ====================
+bool LightClusterBuilder::setupLight(const GPULightData& light, UINT32 lightIndex, const Camera& camera, ClusterLight& out) const
+{
+    Quark::Vec4 viewPos = camera.view * Quark::Vec4(light.position, 1.0f);
+
+    out.lightIndex = lightIndex;
+    out.apexX = viewPos.x;
+    out.apexY = viewPos.y;
+    out.apexDepth = -viewPos.z;
+    out.range = light.range;
+    out.coneCos = 0.0f;
+    out.coneSin = 1.0f;
+    out.axisX = out.axisY = out.axisDepth = 0.0f;
+
+    // Point lights and spots wider than a hemisphere are bounded by the range sphere
+    out.centerX = out.apexX;
+    out.centerY = out.apexY;
+    out.centerDepth = out.apexDepth;
+    out.radius = light.range;
+
+    if (light.type == static_cast<UINT32>(LightType::SPOT) && light.spotAngles.y > 0.0f)
+    {
+        Quark::Vec3 axis = camera.view.TransformDirection(light.direction).Normalized();
+        out.axisX = axis.x;
+        out.axisY = axis.y;
+        out.axisDepth = -axis.z;
+        out.coneCos = (std::min)(light.spotAngles.y, 1.0f);
+        out.coneSin = std::sqrt(1.0f - out.coneCos * out.coneCos);
+
+        Quark::Sphere bounds = computeConeBoundingSphere(Quark::Vec3(viewPos.x, viewPos.y, viewPos.z), axis, light.range, out.coneCos);
+        out.radius = bounds.radius;
+        out.centerX = bounds.center.x;
+        out.centerY = bounds.center.y;
+        out.centerDepth = -bounds.center.z;
+    }
+
+    float minDepth = (std::max)(out.centerDepth - out.radius, m_NearPlane);
+    float maxDepth = (std::min)(out.centerDepth + out.radius, m_FarPlane);
+    if (minDepth > maxDepth) return false;
+
+    out.minZ = static_cast<UINT32>(std::clamp(std::log(minDepth) * m_DepthScale + m_DepthBias, 0.0f, LIGHT_CLUSTER_GRID_Z - 1.0f));
+    out.maxZ = static_cast<UINT32>(std::clamp(std::log(maxDepth) * m_DepthScale + m_DepthBias, 0.0f, LIGHT_CLUSTER_GRID_Z - 1.0f));
+
+    // Screen bounds of the sphere's box in front of the near plane
+    float ndcMinX = FLT_MAX, ndcMaxX = -FLT_MAX, ndcMinY = FLT_MAX, ndcMaxY = -FLT_MAX;
+    for (UINT32 corner = 0; corner < 8; ++corner)
+    {
+        Quark::Vec4 point((corner & 1) ? out.centerX + out.radius : out.centerX - out.radius,
+                          (corner & 2) ? out.centerY + out.radius : out.centerY - out.radius,
+                          (corner & 4) ? -maxDepth : -minDepth, 1.0f);
+        Quark::Vec4 clip = camera.projection * point;
+        float invW = 1.0f / clip.w;
+        ndcMinX = (std::min)(ndcMinX, clip.x * invW);
+        ndcMaxX = (std::max)(ndcMaxX, clip.x * invW);
+        ndcMinY = (std::min)(ndcMinY, clip.y * invW);
+        ndcMaxY = (std::max)(ndcMaxY, clip.y * invW);
+    }
+    if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) return false;
+
+    // Tile rows run top to bottom like pixel rows
+    auto tile = [](float t, UINT32 count)
+    {
+        return static_cast<UINT32>(std::clamp(t * count, 0.0f, count - 1.0f));
+    };
+    out.minX = tile(ndcMinX * 0.5f + 0.5f, LIGHT_CLUSTER_GRID_X);
+    out.maxX = tile(ndcMaxX * 0.5f + 0.5f, LIGHT_CLUSTER_GRID_X);
+    out.minY = tile(0.5f - ndcMaxY * 0.5f, LIGHT_CLUSTER_GRID_Y);
+    out.maxY = tile(0.5f - ndcMinY * 0.5f, LIGHT_CLUSTER_GRID_Y);
+    return true;
+}
+
+// ==================== SLICE BINNING ====================
+void LightClusterBuilder::binSlice(UINT32 z)
+{
+    ClusterSlice& slice = m_Slices[z];
+    slice.minDepth = std::exp((static_cast<float>(z) - m_DepthBias) / m_DepthScale);
+    slice.maxDepth = std::exp((static_cast<float>(z + 1) - m_DepthBias) / m_DepthScale);
+    if (z == 0) slice.minDepth = m_NearPlane;
+    if (z == LIGHT_CLUSTER_GRID_Z - 1) slice.maxDepth = m_FarPlane;
+
+    const float sliceCenter = (slice.minDepth + slice.maxDepth) * 0.5f;
+    const float sliceHalf = (slice.maxDepth - slice.minDepth) * 0.5f;
+
+    // Cluster boxes from the four corner rays at both slice depths
+    for (UINT32 y = 0; y < LIGHT_CLUSTER_GRID_Y; ++y)
+    {
+        for (UINT32 x = 0; x < LIGHT_CLUSTER_GRID_X; ++x)
+        {
+            float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+            for (UINT32 corner = 0; corner < 4; ++corner)
+            {
+                const CornerRay& ray = m_Corners[(y + (corner >> 1)) * (LIGHT_CLUSTER_GRID_X + 1) + x + (corner & 1)];
+                for (float depth : { slice.minDepth, slice.maxDepth })
+                {
+                    float px = ray.ax + ray.bx * depth;
+                    float py = ray.ay + ray.by * depth;
+                    minX = (std::min)(minX, px);
+                    maxX = (std::max)(maxX, px);
+                    minY = (std::min)(minY, py);
+                    maxY = (std::max)(maxY, py);
+                }
+            }
+
+            UINT32 c = y * LIGHT_CLUSTER_GRID_X + x;
+            slice.minX[c] = minX;
+            slice.maxX[c] = maxX;
+            slice.minY[c] = minY;
+            slice.maxY[c] = maxY;
+            slice.centerX[c] = (minX + maxX) * 0.5f;
+            slice.centerY[c] = (minY + maxY) * 0.5f;
+            float hx = (maxX - minX) * 0.5f, hy = (maxY - minY) * 0.5f;
+            slice.radius[c] = std::sqrt(hx * hx + hy * hy + sliceHalf * sliceHalf);
+        }
+    }
+
+    slice.entries.clear();
+    std::fill(slice.counts, slice.counts + LIGHT_CLUSTER_TILES, 0u);
+
+    for (const ClusterLight& light : m_Lights)
+    {
+        if (z < light.minZ || z > light.maxZ) continue;
+
+        // Depth distance is the same for every cluster of the slice
+        float dz = (std::max)((std::max)(slice.minDepth - light.centerDepth, light.centerDepth - slice.maxDepth), 0.0f);
+        float radiusSq = light.radius * light.radius - dz * dz;
+        if (radiusSq < 0.0f) continue;
+
+        const bool testCone = light.coneCos > 0.0f;
+        const float apexToSlice = sliceCenter - light.apexDepth;
+
+        for (UINT32 y = light.minY; y <= light.maxY; ++y)
+        {
+            const UINT32 row = y * LIGHT_CLUSTER_GRID_X;
+            for (UINT32 x = light.minX & ~3u; x <= light.maxX; x += 4)
+            {
+                const UINT32 c = row + x;
+                UINT32 mask;
+
+#if defined(QUARK_MATH_SSE2)
+                const __m128 zero = _mm_setzero_ps();
+                __m128 cx = _mm_set1_ps(light.centerX), cy = _mm_set1_ps(light.centerY);
+                __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(slice.minX + c), cx), _mm_sub_ps(cx, _mm_load_ps(slice.maxX + c))), zero);
+                __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(slice.minY + c), cy), _mm_sub_ps(cy, _mm_load_ps(slice.maxY + c))), zero);
+                __m128 inside = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_set1_ps(radiusSq));
+
+                if (testCone)
+                {
+                    // Cluster bounding sphere against the cone
+                    __m128 r = _mm_load_ps(slice.radius + c);
+                    __m128 vx = _mm_sub_ps(_mm_load_ps(slice.centerX + c), _mm_set1_ps(light.apexX));
+                    __m128 vy = _mm_sub_ps(_mm_load_ps(slice.centerY + c), _mm_set1_ps(light.apexY));
+                    __m128 vz = _mm_set1_ps(apexToSlice);
+                    __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+                    __m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(light.axisX)),
+                        _mm_mul_ps(vy, _mm_set1_ps(light.axisY))), _mm_mul_ps(vz, _mm_set1_ps(light.axisDepth)));
+                    __m128 across = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lenSq, _mm_mul_ps(along, along)), zero));
+                    __m128 distance = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(light.coneCos), across), _mm_mul_ps(along, _mm_set1_ps(light.coneSin)));
+                    inside = _mm_and_ps(inside, _mm_cmple_ps(distance, r));
+                    inside = _mm_and_ps(inside, _mm_cmple_ps(along, _mm_add_ps(r, _mm_set1_ps(light.range))));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(along, _mm_sub_ps(zero, r)));
+                }
+
+                mask = static_cast<UINT32>(_mm_movemask_ps(inside));
+#else
+                mask = 0;
+                for (UINT32 lane = 0; lane < 4; ++lane)
+                {
+                    const UINT32 k = c + lane;
+                    float dx = (std::max)((std::max)(slice.minX[k] - light.centerX, light.centerX - slice.maxX[k]), 0.0f);
+                    float dy = (std::max)((std::max)(slice.minY[k] - light.centerY, light.centerY - slice.maxY[k]), 0.0f);
+                    bool inside = dx * dx + dy * dy <= radiusSq;
+
+                    if (inside && testCone)
+                    {
+                        float r = slice.radius[k];
+                        float vx = slice.centerX[k] - light.apexX, vy = slice.centerY[k] - light.apexY, vz = apexToSlice;
+                        float along = vx * light.axisX + vy * light.axisY + vz * light.axisDepth;
+                        float across = std::sqrt((std::max)(vx * vx + vy * vy + vz * vz - along * along, 0.0f));
+                        inside = light.coneCos * across - along * light.coneSin <= r && along <= r + light.range && along >= -r;
+                    }
+                    mask |= inside ? (1u << lane) : 0u;
+                }
+#endif
+
+                // Lanes outside the light's tile range
+                for (UINT32 lane = 0; lane < 4; ++lane)
+                {
+                    if (!(mask & (1u << lane)) || x + lane < light.minX || x + lane > light.maxX) continue;
+                    slice.entries.push_back((light.lightIndex << 8) | (c + lane));
+                    slice.counts[c + lane]++;
+                }
+            }
+        }
+    }
+
+    // Counting sort by cluster, entries are already in light order
+    UINT32 offset = 0;
+    for (UINT32 c = 0; c < LIGHT_CLUSTER_TILES; ++c)
+    {
+        slice.offsets[c] = offset;
+        offset += slice.counts[c];
+    }
+
+    slice.indices.resize(slice.entries.size());
+    UINT32 cursor[LIGHT_CLUSTER_TILES];
+    std::copy(slice.offsets, slice.offsets + LIGHT_CLUSTER_TILES, cursor);
+    for (UINT32 entry : slice.entries)
+    {
+        slice.indices[cursor[entry & 0xFF]++] = entry >> 8;
+    }
+}
+
+// ==================== BUILD ====================
+void LightClusterBuilder::build(const Camera& camera, const GPULightData* lights, UINT32 lightCount, TaskPool& pool)
+{
+    QUARK_PROFILE_ZONE("LightClusterBuilder::build");
+
+    setupGrid(camera);
+
+    m_Lights.clear();
+    for (UINT32 i = 0; i < lightCount; ++i)
+    {
+        const GPULightData& light = lights[i];
+        if (light.type == static_cast<UINT32>(LightType::DIRECTIONAL) ||
+            !(light.flags & static_cast<UINT32>(LightFlags::LIGHT_ENABLED)) || light.range <= 0.0f)
+        {
+            continue;
+        }
+
+        ClusterLight clusterLight;
+        if (setupLight(light, i, camera, clusterLight))
+        {
+            m_Lights.push_back(clusterLight);
+        }
+    }
+
+    pool.run(LIGHT_CLUSTER_GRID_Z, [&](UINT32 z)
+    {
+        QUARK_PROFILE_ZONE("LightClusterBuilder::binSlice");
+        binSlice(z);
+    });
+
+    m_IndexCount = 0;
+    m_MaxClusterLights = 0;
+    for (const ClusterSlice& slice : m_Slices)
+    {
+        m_IndexCount += static_cast<UINT32>(slice.indices.size());
+        m_MaxClusterLights = (std::max)(m_MaxClusterLights, *std::max_element(slice.counts, slice.counts + LIGHT_CLUSTER_TILES));
+    }
+}
+
+void LightClusterBuilder::write(LightClusterRange* ranges, UINT32* indices) const
+{
+    UINT32 base = 0;
+    for (UINT32 z = 0; z < LIGHT_CLUSTER_GRID_Z; ++z)
+    {
+        const ClusterSlice& slice = m_Slices[z];
+        LightClusterRange* sliceRanges = ranges + z * LIGHT_CLUSTER_TILES;
+        for (UINT32 c = 0; c < LIGHT_CLUSTER_TILES; ++c)
+        {
+            sliceRanges[c].offset = base + slice.offsets[c];
+            sliceRanges[c].count = slice.counts[c];
+        }
+
+        std::copy(slice.indices.begin(), slice.indices.end(), indices + base);
+        base += static_cast<UINT32>(slice.indices.size());
+    }
+}
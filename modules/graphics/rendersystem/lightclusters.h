@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include "../../headeronly/globaltypes.h"
+#include "../../headeronly/mathematics.h"
+#include "lighting.h"
+#include "camera.h"
+#include "framepacket.h"
+#include "taskpool.h"
+
+// ==================== LIGHT CLUSTER CONSTANTS ====================
+constexpr UINT32 LIGHT_CLUSTER_TILES = LIGHT_CLUSTER_GRID_X * LIGHT_CLUSTER_GRID_Y;    // Clusters per depth slice
+
+static_assert(LIGHT_CLUSTER_GRID_X % 4 == 0, "Cluster rows are tested four clusters at a time");
+static_assert(LIGHT_CLUSTER_TILES <= 256, "Slice entries keep the cluster in 8 bits");
+
+// ==================== LIGHT CLUSTER BUILDER ====================
+// Bins point and spot lights into the froxel grid of a camera: screen tiles
+// times exponential depth slices between the near and far planes.
+// Every light first gets a view space bounding sphere and the tile and slice
+// range it projects to. Each depth slice is then one task on the render
+// system's task pool: it builds its cluster boxes and tests them against the
+// lights in range four clusters at a time (sphere vs box, plus a cone test for
+// spot lights). Lists keep ascending light order, so the result does not
+// depend on the thread count.
+class LightClusterBuilder
+{
+private:
+    // Depth is the positive distance along the view direction (-view z)
+    struct ClusterLight
+    {
+        float centerX, centerY, centerDepth, radius;    // Bounding sphere
+        float apexX, apexY, apexDepth;                  // Spot cone, coneCos <= 0 skips the cone test
+        float axisX, axisY, axisDepth;
+        float coneCos, coneSin, range;
+        UINT32 lightIndex;
+        UINT32 minX, maxX, minY, maxY, minZ, maxZ;      // Inclusive cluster range
+    };
+
+    struct ClusterSlice
+    {
+        // Cluster boxes, LIGHT_CLUSTER_GRID_Y rows of LIGHT_CLUSTER_GRID_X
+        alignas(16) float minX[LIGHT_CLUSTER_TILES];
+        alignas(16) float maxX[LIGHT_CLUSTER_TILES];
+        alignas(16) float minY[LIGHT_CLUSTER_TILES];
+        alignas(16) float maxY[LIGHT_CLUSTER_TILES];
+        alignas(16) float centerX[LIGHT_CLUSTER_TILES];
+        alignas(16) float centerY[LIGHT_CLUSTER_TILES];
+        alignas(16) float radius[LIGHT_CLUSTER_TILES];
+        float minDepth;
+        float maxDepth;
+
+        UINT32 counts[LIGHT_CLUSTER_TILES];
+        UINT32 offsets[LIGHT_CLUSTER_TILES];
+        std::vector<UINT32> entries;    // (light index << 8) | cluster in slice
+        std::vector<UINT32> indices;    // Light indices grouped by cluster
+    };
+
+    // Tile corner rays in view space: x = ax + bx * depth, y = ay + by * depth
+    struct CornerRay
+    {
+        float ax, bx, ay, by;
+    };
+
+    std::vector<ClusterLight> m_Lights;
+    std::vector<ClusterSlice> m_Slices;
+    CornerRay m_Corners[(LIGHT_CLUSTER_GRID_X + 1) * (LIGHT_CLUSTER_GRID_Y + 1)];
+
+    float m_NearPlane;
+    float m_FarPlane;
+    float m_DepthScale;
+    float m_DepthBias;
+    UINT32 m_IndexCount;
+    UINT32 m_MaxClusterLights;
+
+    void setupGrid(const Camera& camera);
+    bool setupLight(const GPULightData& light, UINT32 lightIndex, const Camera& camera, ClusterLight& out) const;
+    void binSlice(UINT32 z);
+
+public:
+    LightClusterBuilder();
+
+    // Bins lights[0, lightCount), directional and disabled lights are skipped
+    void build(const Camera& camera, const GPULightData* lights, UINT32 lightCount, TaskPool& pool);
+
+    // Fills LIGHT_CLUSTER_COUNT ranges and getIndexCount() indices
+    void write(LightClusterRange* ranges, UINT32* indices) const;
+
+    UINT32 getIndexCount() const { return m_IndexCount; }
+    UINT32 getBinnedLightCount() const { return static_cast<UINT32>(m_Lights.size()); }
+    UINT32 getMaxClusterLights() const { return m_MaxClusterLights; }
+
+    // Slice mapping for FrameConstants, tile scales come from the viewport
+    float getDepthScale() const { return m_DepthScale; }
+    float getDepthBias() const { return m_DepthBias; }
+};
@@ -3,21 +3,30 @@
 #include "../../headeronly/mathematics.h"
 
 // LIMITS & CONSTANTS
-constexpr UINT32 MAX_LIGHTS = 64;
+// Point and spot lights share the budget, shading only visits the lights of a pixel's cluster
+constexpr UINT32 MAX_LIGHTS = 4096;             // Lights in one frame packet
+constexpr UINT32 MAX_SCENE_LIGHTS = 65536;      // Lights the render system can hold, culled and ranked down to the budget
+constexpr UINT32 DEFAULT_LIGHT_BUDGET = 1024;   // Visible point and spot lights kept per frame, by importance
 constexpr UINT32 MAX_DIRECTIONAL_LIGHTS = 1;
-constexpr UINT32 MAX_SPOT_LIGHTS = 48;
-constexpr UINT32 MAX_POINT_LIGHTS = 15;
 
-constexpr UINT32 MAX_SPOT_SHADOW_LIGHTS = 16;
-constexpr UINT32 MAX_POINT_SHADOW_LIGHTS = 5;
+constexpr UINT32 MAX_LOCAL_SHADOW_LIGHTS = 64;  // Spot and point lights with shadows per frame, by importance
 
 constexpr UINT32 DIRECTIONAL_CASCADE_COUNT = 4;
 constexpr UINT32 POINT_SHADOW_FACE_COUNT = 6;  // Cube map has 6 faces
 
 constexpr float DIRECTIONAL_SHADOW_ATLAS_SIZE = 4096.0f;
 constexpr float LOCAL_LIGHT_SHADOW_ATLAS_SIZE = 4096.0f;
-constexpr UINT32 LOCAL_SHADOW_GRID_SIZE = 8;  // 8x8 grid = 64 slots
-constexpr UINT32 LOCAL_SHADOW_SLOT_SIZE = 512; // 4096 / 8 = 512px per slot
+
+// Local shadow atlas: quadtree of power-of-two tiles sized by the light's size on screen,
+// one tile per spot light and one per point light cube face
+constexpr UINT32 LOCAL_SHADOW_MAX_TILE_SIZE = 1024;
+constexpr UINT32 LOCAL_SHADOW_MIN_TILE_SIZE = 64;
+
+// Light clusters: screen tiles x exponential depth slices of the camera frustum
+constexpr UINT32 LIGHT_CLUSTER_GRID_X = 16;
+constexpr UINT32 LIGHT_CLUSTER_GRID_Y = 9;
+constexpr UINT32 LIGHT_CLUSTER_GRID_Z = 24;
+constexpr UINT32 LIGHT_CLUSTER_COUNT = LIGHT_CLUSTER_GRID_X * LIGHT_CLUSTER_GRID_Y * LIGHT_CLUSTER_GRID_Z;
 
 // ENUMS
 enum class LightType : UINT32
@@ -97,15 +106,31 @@ struct GPULightData
     UINT32 flags;
 
     Quark::Vec3 attenuation;
-    int shadowIndex;  // Slot index in local shadow atlas (-1 = no shadow)
+    int shadowIndex;  // -1 = no shadow, local lights with shadows have tiles in shadowRects
 
     Quark::Vec4 cascadeSplits;
     Quark::Mat4 cascadeMatrices[DIRECTIONAL_CASCADE_COUNT];
     
     Quark::Mat4 spotShadowMatrix;  // Spot light shadow viewProj matrix
     Quark::Mat4 pointShadowMatrices[POINT_SHADOW_FACE_COUNT];  // Point light cube face matrices
+
+    Quark::Vec4 shadowRects[POINT_SHADOW_FACE_COUNT];  // Local shadow atlas tiles as UV offset (xy) and scale (zw), spot lights use the first
+};
+
+// Square tile of the local shadow atlas, in texels
+struct ShadowAtlasTile
+{
+    UINT32 x;
+    UINT32 y;
+    UINT32 size;
 };
 
+inline Quark::Vec4 getShadowAtlasRect(const ShadowAtlasTile& tile)
+{
+    constexpr float invAtlasSize = 1.0f / LOCAL_LIGHT_SHADOW_ATLAS_SIZE;
+    return Quark::Vec4(tile.x * invAtlasSize, tile.y * invAtlasSize, tile.size * invAtlasSize, tile.size * invAtlasSize);
+}
+
 struct DirectionalLight
 {
     Quark::Vec3 direction = Quark::Vec3(0, -1, 0);
@@ -270,3 +295,55 @@ inline void computePointShadowMatrices(const PointLight& light, Quark::Mat4 outM
         outMatrices[i] = proj * view;
     }
 }
+
+// ==================== LIGHT BOUNDS ====================
+// Smallest sphere around a spot cone given cos(half angle): through the apex and
+// the rim below 45 degrees, around the rim above. Cones wider than a hemisphere
+// are bounded by the range sphere.
+inline Quark::Sphere computeConeBoundingSphere(const Quark::Vec3& apex, const Quark::Vec3& axis, float range, float coneCos)
+{
+    if (coneCos <= 0.0f) return Quark::Sphere(apex, range);
+
+    coneCos = (std::min)(coneCos, 1.0f);
+    float offset = coneCos >= 0.70710678f ? range / (2.0f * coneCos) : range * coneCos;
+    float radius = coneCos >= 0.70710678f ? offset : range * std::sqrt(1.0f - coneCos * coneCos);
+    return Quark::Sphere(apex + axis * offset, radius);
+}
+
+// Cone from the apex to a base disk at range, encloses the lit part of the range sphere
+inline float computeConeBaseRadius(float range, float coneCos)
+{
+    coneCos = (std::min)(coneCos, 1.0f);
+    return range * std::sqrt(1.0f - coneCos * coneCos) / coneCos;
+}
+
+inline Quark::AABB computePointLightAABB(const PointLight& light)
+{
+    Quark::Vec3 extent(light.range, light.range, light.range);
+    return Quark::AABB(light.position - extent, light.position + extent);
+}
+
+// Box around the cone (apex plus base disk), clipped to the range sphere's box
+inline Quark::AABB computeSpotLightAABB(const SpotLight& light)
+{
+    Quark::Vec3 extent(light.range, light.range, light.range);
+    Quark::AABB box(light.position - extent, light.position + extent);
+    if (light.outerCutoff <= 0.0f) return box;
+
+    Quark::Vec3 axis = light.direction.Normalized();
+    Quark::Vec3 base = light.position + axis * light.range;
+    float baseRadius = computeConeBaseRadius(light.range, light.outerCutoff);
+
+    // Half size of the base disk along each world axis
+    Quark::Vec3 disk(baseRadius * std::sqrt((std::max)(0.0f, 1.0f - axis.x * axis.x)),
+                     baseRadius * std::sqrt((std::max)(0.0f, 1.0f - axis.y * axis.y)),
+                     baseRadius * std::sqrt((std::max)(0.0f, 1.0f - axis.z * axis.z)));
+
+    Quark::AABB cone(light.position, light.position);
+    cone.Expand(base - disk);
+    cone.Expand(base + disk);
+
+    return Quark::AABB(
+        Quark::Vec3((std::max)(box.minBounds.x, cone.minBounds.x), (std::max)(box.minBounds.y, cone.minBounds.y), (std::max)(box.minBounds.z, cone.minBounds.z)),
+        Quark::Vec3((std::min)(box.maxBounds.x, cone.maxBounds.x), (std::min)(box.maxBounds.y, cone.maxBounds.y), (std::min)(box.maxBounds.z, cone.maxBounds.z)));
+}
@@ -0,0 +1,355 @@
+#include "occlusion.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ==================== CONSTRUCTOR ====================
+OcclusionCuller::OcclusionCuller()
+    : m_NearW(0.1f)
+    , m_OccluderCount(0)
+{
+    m_Depth.assign(OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT, 0.0f);
+    m_HiZ.assign(OCCLUSION_HIZ_WIDTH * OCCLUSION_HIZ_HEIGHT, 0.0f);
+}
+
+// ==================== FRAME ====================
+void OcclusionCuller::beginFrame(const Quark::Mat4& viewProjection, float nearPlane)
+{
+    m_ViewProjection = viewProjection;
+    m_NearW = (std::max)(nearPlane, 1e-4f);
+    m_OccluderCount = 0;
+    m_Triangles.clear();
+
+    for (auto& bin : m_TileBins)
+    {
+        bin.clear();
+    }
+
+    std::fill(m_Depth.begin(), m_Depth.end(), 0.0f);
+    std::fill(m_HiZ.begin(), m_HiZ.end(), 0.0f);
+}
+
+// ==================== OCCLUDERS ====================
+void OcclusionCuller::addOccluder(const Quark::Vec3* positions, const UINT32* indices, UINT32 indexCount, const Quark::Mat4& world)
+{
+    if (!positions || !indices || indexCount < 3)
+    {
+        return;
+    }
+
+    m_OccluderCount++;
+
+    Quark::Mat4 worldViewProj = m_ViewProjection * world;
+
+    for (UINT32 i = 0; i + 2 < indexCount; i += 3)
+    {
+        if (m_Triangles.size() >= OCCLUSION_MAX_TRIANGLES)
+        {
+            return;
+        }
+
+        Quark::Vec4 clip[3] = {
+            worldViewProj * Quark::Vec4(positions[indices[i + 0]], 1.0f),
+            worldViewProj * Quark::Vec4(positions[indices[i + 1]], 1.0f),
+            worldViewProj * Quark::Vec4(positions[indices[i + 2]], 1.0f)
+        };
+
+        UINT32 behind = (clip[0].w < m_NearW ? 1u : 0u) + (clip[1].w < m_NearW ? 1u : 0u) + (clip[2].w < m_NearW ? 1u : 0u);
+
+        if (behind == 3)
+        {
+            continue;
+        }
+
+        if (behind == 0)
+        {
+            setupTriangle(clip[0], clip[1], clip[2]);
+            continue;
+        }
+
+        // Clip against w = near (Sutherland-Hodgman on one plane, at most 4 vertices)
+        Quark::Vec4 polygon[4];
+        UINT32 polygonCount = 0;
+
+        for (UINT32 e = 0; e < 3; ++e)
+        {
+            const Quark::Vec4& a = clip[e];
+            const Quark::Vec4& b = clip[(e + 1) % 3];
+            bool aInside = a.w >= m_NearW;
+            bool bInside = b.w >= m_NearW;
+
+            if (aInside)
+            {
+                polygon[polygonCount++] = a;
+            }
+
+            if (aInside != bInside)
+            {
+                float t = (m_NearW - a.w) / (b.w - a.w);
+                polygon[polygonCount++] = a + (b - a) * t;
+            }
+        }
+
+        for (UINT32 v = 1; v + 1 < polygonCount; ++v)
+        {
+            setupTriangle(polygon[0], polygon[v], polygon[v + 1]);
+        }
+    }
+}
+
+void OcclusionCuller::setupTriangle(const Quark::Vec4& c0, const Quark::Vec4& c1, const Quark::Vec4& c2)
+{
+    const float halfW = static_cast<float>(OCCLUSION_BUFFER_WIDTH) * 0.5f;
+    const float halfH = static_cast<float>(OCCLUSION_BUFFER_HEIGHT) * 0.5f;
+
+    // Screen space (y down) and 1/w
+    float iw[3] = { 1.0f / c0.w, 1.0f / c1.w, 1.0f / c2.w };
+    float x[3] = { (c0.x * iw[0] + 1.0f) * halfW, (c1.x * iw[1] + 1.0f) * halfW, (c2.x * iw[2] + 1.0f) * halfW };
+    float y[3] = { (1.0f - c0.y * iw[0]) * halfH, (1.0f - c1.y * iw[1]) * halfH, (1.0f - c2.y * iw[2]) * halfH };
+
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::abs(area) < 1e-6f)
+    {
+        return;
+    }
+
+    // Occluders are treated as double sided, normalize the winding
+    if (area < 0.0f)
+    {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(iw[1], iw[2]);
+        area = -area;
+    }
+
+    // Clamp in float first, near-plane vertices can project far outside int range
+    const float maxPixelX = static_cast<float>(OCCLUSION_BUFFER_WIDTH - 1);
+    const float maxPixelY = static_cast<float>(OCCLUSION_BUFFER_HEIGHT - 1);
+
+    ScreenTriangle tri;
+    tri.minX = static_cast<int>(std::clamp(std::floor((std::min)({ x[0], x[1], x[2] })), 0.0f, maxPixelX + 1.0f));
+    tri.minY = static_cast<int>(std::clamp(std::floor((std::min)({ y[0], y[1], y[2] })), 0.0f, maxPixelY + 1.0f));
+    tri.maxX = static_cast<int>(std::clamp(std::ceil((std::max)({ x[0], x[1], x[2] })), -1.0f, maxPixelX));
+    tri.maxY = static_cast<int>(std::clamp(std::ceil((std::max)({ y[0], y[1], y[2] })), -1.0f, maxPixelY));
+
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+    {
+        return;
+    }
+
+    // E(p) = A*px + B*py + C per edge (v0->v1, v1->v2, v2->v0)
+    for (int e = 0; e < 3; ++e)
+    {
+        int a = e;
+        int b = (e + 1) % 3;
+        tri.edgeA[e] = y[a] - y[b];
+        tri.edgeB[e] = x[b] - x[a];
+        tri.edgeC[e] = -(tri.edgeA[e] * x[a] + tri.edgeB[e] * y[a]);
+    }
+
+    float invArea = 1.0f / area;
+    tri.depthA = ((iw[1] - iw[0]) * (y[2] - y[0]) - (iw[2] - iw[0]) * (y[1] - y[0])) * invArea;
+    tri.depthB = ((iw[2] - iw[0]) * (x[1] - x[0]) - (iw[1] - iw[0]) * (x[2] - x[0])) * invArea;
+    tri.depthC = iw[0] - tri.depthA * x[0] - tri.depthB * y[0];
+
+    UINT32 triIndex = static_cast<UINT32>(m_Triangles.size());
+    m_Triangles.push_back(tri);
+
+    // Bin into every tile the bounds touch
+    int tileMinX = tri.minX / static_cast<int>(OCCLUSION_TILE_SIZE);
+    int tileMaxX = tri.maxX / static_cast<int>(OCCLUSION_TILE_SIZE);
+    int tileMinY = tri.minY / static_cast<int>(OCCLUSION_TILE_SIZE);
+    int tileMaxY = tri.maxY / static_cast<int>(OCCLUSION_TILE_SIZE);
+
+    for (int ty = tileMinY; ty <= tileMaxY; ++ty)
+    {
+        for (int tx = tileMinX; tx <= tileMaxX; ++tx)
+        {
+            m_TileBins[ty * OCCLUSION_TILES_X + tx].push_back(triIndex);
+        }
+    }
+}
+
+// ==================== RASTERIZATION ====================
+void OcclusionCuller::rasterize(TaskPool& pool)
+{
+    const UINT32 tileCount = OCCLUSION_TILES_X * OCCLUSION_TILES_Y;
+
+    if (m_Triangles.empty())
+    {
+        return;
+    }
+
+    // Tiles never share pixels or HiZ blocks, so workers need no synchronization
+    pool.run(tileCount, [this](UINT32 tile) { rasterizeTile(tile); });
+}
+
+void OcclusionCuller::rasterizeTile(UINT32 tileIndex)
+{
+    const int tileX0 = static_cast<int>((tileIndex % OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE);
+    const int tileY0 = static_cast<int>((tileIndex / OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE);
+    const int tileX1 = tileX0 + static_cast<int>(OCCLUSION_TILE_SIZE) - 1;
+    const int tileY1 = tileY0 + static_cast<int>(OCCLUSION_TILE_SIZE) - 1;
+
+    for (UINT32 triIndex : m_TileBins[tileIndex])
+    {
+        const ScreenTriangle& tri = m_Triangles[triIndex];
+
+        // Columns start 4-aligned so SIMD rows never cross the tile edge
+        int x0 = (std::max)(tri.minX, tileX0) & ~3;
+        int x1 = (std::min)(tri.maxX, tileX1);
+        int y0 = (std::max)(tri.minY, tileY0);
+        int y1 = (std::min)(tri.maxY, tileY1);
+
+        for (int py = y0; py <= y1; ++py)
+        {
+            float* row = &m_Depth[py * OCCLUSION_BUFFER_WIDTH];
+            float cy = static_cast<float>(py) + 0.5f;
+
+            float rowE0 = tri.edgeB[0] * cy + tri.edgeC[0];
+            float rowE1 = tri.edgeB[1] * cy + tri.edgeC[1];
+            float rowE2 = tri.edgeB[2] * cy + tri.edgeC[2];
+            float rowZ = tri.depthB * cy + tri.depthC;
+
+#if defined(QUARK_MATH_SSE2)
+            const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 a0 = _mm_set1_ps(tri.edgeA[0]), a1 = _mm_set1_ps(tri.edgeA[1]), a2 = _mm_set1_ps(tri.edgeA[2]);
+            const __m128 r0 = _mm_set1_ps(rowE0), r1 = _mm_set1_ps(rowE1), r2 = _mm_set1_ps(rowE2);
+            const __m128 za = _mm_set1_ps(tri.depthA), rz = _mm_set1_ps(rowZ);
+
+            for (int px = x0; px <= x1; px += 4)
+            {
+                __m128 cx = _mm_add_ps(_mm_set1_ps(static_cast<float>(px)), laneOffset);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, cx), r0);
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, cx), r1);
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, cx), r2);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+                if (_mm_movemask_ps(inside) == 0)
+                {
+                    continue;
+                }
+
+                __m128 z = _mm_add_ps(_mm_mul_ps(za, cx), rz);
+                __m128 old = _mm_loadu_ps(row + px);
+                __m128 closer = _mm_max_ps(old, z);
+                _mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, old)));
+            }
+#else
+            for (int px = x0; px <= x1; ++px)
+            {
+                float cx = static_cast<float>(px) + 0.5f;
+                if (tri.edgeA[0] * cx + rowE0 >= 0.0f &&
+                    tri.edgeA[1] * cx + rowE1 >= 0.0f &&
+                    tri.edgeA[2] * cx + rowE2 >= 0.0f)
+                {
+                    float z = tri.depthA * cx + rowZ;
+                    row[px] = (std::max)(row[px], z);
+                }
+            }
+#endif
+        }
+    }
+
+    // HiZ for this tile: farthest (min 1/w) depth per block
+    const UINT32 blocksPerTile = OCCLUSION_TILE_SIZE / OCCLUSION_HIZ_BLOCK;
+    const UINT32 blockX0 = static_cast<UINT32>(tileX0) / OCCLUSION_HIZ_BLOCK;
+    const UINT32 blockY0 = static_cast<UINT32>(tileY0) / OCCLUSION_HIZ_BLOCK;
+
+    for (UINT32 by = 0; by < blocksPerTile; ++by)
+    {
+        for (UINT32 bx = 0; bx < blocksPerTile; ++bx)
+        {
+            UINT32 px0 = (blockX0 + bx) * OCCLUSION_HIZ_BLOCK;
+            UINT32 py0 = (blockY0 + by) * OCCLUSION_HIZ_BLOCK;
+            float farthest = FLT_MAX;
+
+            for (UINT32 y = 0; y < OCCLUSION_HIZ_BLOCK; ++y)
+            {
+                const float* row = &m_Depth[(py0 + y) * OCCLUSION_BUFFER_WIDTH + px0];
+                for (UINT32 x = 0; x < OCCLUSION_HIZ_BLOCK; ++x)
+                {
+                    farthest = (std::min)(farthest, row[x]);
+                }
+            }
+
+            m_HiZ[(blockY0 + by) * OCCLUSION_HIZ_WIDTH + blockX0 + bx] = farthest;
+        }
+    }
+}
+
+// ==================== OCCLUDEE TEST ====================
+bool OcclusionCuller::isVisible(const Quark::AABB& worldBounds) const
+{
+    if (m_Triangles.empty())
+    {
+        return true;
+    }
+
+    const float halfW = static_cast<float>(OCCLUSION_BUFFER_WIDTH) * 0.5f;
+    const float halfH = static_cast<float>(OCCLUSION_BUFFER_HEIGHT) * 0.5f;
+
+    float minX = FLT_MAX, minY = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float nearestDepth = 0.0f;
+
+    for (int c = 0; c < 8; ++c)
+    {
+        Quark::Vec3 corner(
+            (c & 1) ? worldBounds.maxBounds.x : worldBounds.minBounds.x,
+            (c & 2) ? worldBounds.maxBounds.y : worldBounds.minBounds.y,
+            (c & 4) ? worldBounds.maxBounds.z : worldBounds.minBounds.z
+        );
+
+        Quark::Vec4 clip = m_ViewProjection * Quark::Vec4(corner, 1.0f);
+
+        // Crosses the near plane: can't be projected conservatively
+        if (clip.w < m_NearW)
+        {
+            return true;
+        }
+
+        float iw = 1.0f / clip.w;
+        float sx = (clip.x * iw + 1.0f) * halfW;
+        float sy = (1.0f - clip.y * iw) * halfH;
+
+        minX = (std::min)(minX, sx);
+        maxX = (std::max)(maxX, sx);
+        minY = (std::min)(minY, sy);
+        maxY = (std::max)(maxY, sy);
+        nearestDepth = (std::max)(nearestDepth, iw);
+    }
+
+    // One pixel of slack for the pixel center coverage of occluders
+    const float maxPixelX = static_cast<float>(OCCLUSION_BUFFER_WIDTH - 1);
+    const float maxPixelY = static_cast<float>(OCCLUSION_BUFFER_HEIGHT - 1);
+
+    int x0 = static_cast<int>(std::clamp(std::floor(minX) - 1.0f, 0.0f, maxPixelX + 1.0f));
+    int y0 = static_cast<int>(std::clamp(std::floor(minY) - 1.0f, 0.0f, maxPixelY + 1.0f));
+    int x1 = static_cast<int>(std::clamp(std::ceil(maxX) + 1.0f, -1.0f, maxPixelX));
+    int y1 = static_cast<int>(std::clamp(std::ceil(maxY) + 1.0f, -1.0f, maxPixelY));
+
+    if (x0 > x1 || y0 > y1)
+    {
+        return true;
+    }
+
+    UINT32 bx0 = static_cast<UINT32>(x0) / OCCLUSION_HIZ_BLOCK;
+    UINT32 by0 = static_cast<UINT32>(y0) / OCCLUSION_HIZ_BLOCK;
+    UINT32 bx1 = static_cast<UINT32>(x1) / OCCLUSION_HIZ_BLOCK;
+    UINT32 by1 = static_cast<UINT32>(y1) / OCCLUSION_HIZ_BLOCK;
+
+    for (UINT32 by = by0; by <= by1; ++by)
+    {
+        for (UINT32 bx = bx0; bx <= bx1; ++bx)
+        {
+            if (nearestDepth >= m_HiZ[by * OCCLUSION_HIZ_WIDTH + bx])
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
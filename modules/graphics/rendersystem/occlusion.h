@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "../../headeronly/globaltypes.h"
+#include "../../headeronly/mathematics.h"
+#include "taskpool.h"
+
+// ==================== OCCLUSION CONSTANTS ====================
+constexpr UINT32 OCCLUSION_BUFFER_WIDTH = 320;
+constexpr UINT32 OCCLUSION_BUFFER_HEIGHT = 192;
+constexpr UINT32 OCCLUSION_TILE_SIZE = 32;          // Rasterizer work unit (pixels)
+constexpr UINT32 OCCLUSION_HIZ_BLOCK = 8;           // HiZ block size (pixels)
+constexpr UINT32 OCCLUSION_MAX_TRIANGLES = 65536;   // Occluder triangle budget per frame
+
+constexpr UINT32 OCCLUSION_TILES_X = OCCLUSION_BUFFER_WIDTH / OCCLUSION_TILE_SIZE;
+constexpr UINT32 OCCLUSION_TILES_Y = OCCLUSION_BUFFER_HEIGHT / OCCLUSION_TILE_SIZE;
+constexpr UINT32 OCCLUSION_HIZ_WIDTH = OCCLUSION_BUFFER_WIDTH / OCCLUSION_HIZ_BLOCK;
+constexpr UINT32 OCCLUSION_HIZ_HEIGHT = OCCLUSION_BUFFER_HEIGHT / OCCLUSION_HIZ_BLOCK;
+
+// ==================== OCCLUSION CULLER ====================
+// Low resolution CPU depth buffer for occluder meshes.
+// Depth is stored as 1/w (larger = closer, 0 = nothing rendered), which interpolates
+// linearly in screen space. Triangles are binned into tiles and tiles are rasterized
+// in parallel on the render system's task pool; each tile also produces its part of the HiZ (min 1/w = farthest depth
+// per block) that occludee bounds are tested against.
+class OcclusionCuller
+{
+private:
+    struct ScreenTriangle
+    {
+        float edgeA[3], edgeB[3], edgeC[3];  // Edge functions, inside when all >= 0
+        float depthA, depthB, depthC;        // 1/w plane: depth = A*x + B*y + C
+        int minX, minY, maxX, maxY;          // Pixel bounds (inclusive, clamped)
+    };
+
+    Quark::Mat4 m_ViewProjection;
+    float m_NearW;
+
+    std::vector<ScreenTriangle> m_Triangles;
+    std::vector<UINT32> m_TileBins[OCCLUSION_TILES_X * OCCLUSION_TILES_Y];
+    std::vector<float> m_Depth;
+    std::vector<float> m_HiZ;
+
+    UINT32 m_OccluderCount;
+
+    void setupTriangle(const Quark::Vec4& c0, const Quark::Vec4& c1, const Quark::Vec4& c2);
+    void rasterizeTile(UINT32 tileIndex);
+
+public:
+    OcclusionCuller();
+
+    // Clears the buffers for a new view
+    void beginFrame(const Quark::Mat4& viewProjection, float nearPlane);
+
+    // Transforms, clips against the near plane and bins one occluder mesh
+    void addOccluder(const Quark::Vec3* positions, const UINT32* indices, UINT32 indexCount, const Quark::Mat4& world);
+
+    // Rasterizes all binned triangles and builds the HiZ
+    void rasterize(TaskPool& pool);
+
+    // Conservative test of a world AABB against the HiZ
+    bool isVisible(const Quark::AABB& worldBounds) const;
+
+    UINT32 getOccluderCount() const { return m_OccluderCount; }
+    UINT32 getTriangleCount() const { return static_cast<UINT32>(m_Triangles.size()); }
+    const float* getDepthBuffer() const { return m_Depth.data(); }
+};
@@ -12,7 +12,8 @@ enum class RenderObjectFlags : UINT32
     VISIBLE        = 1 << 2,   // Object should be rendered
     CAST_SHADOW    = 1 << 3,   // Object casts shadows
     RECEIVE_SHADOW = 1 << 4,   // Object receives shadows
-    FRUSTUM_CULL   = 1 << 5    // Object participates in frustum culling
+    FRUSTUM_CULL   = 1 << 5,   // Object participates in frustum culling
+    OCCLUDER       = 1 << 6    // Object is rasterized into the CPU occlusion buffer
 };
 
 // Bitwise operators for RenderObjectFlags
@@ -1,6 +1,55 @@
 #pragma once
+#include <vector>
+#include <algorithm>
 #include "../../headeronly/globaltypes.h"
 
+// ==================== RENDER STAGES ====================
+// CPU stages of RenderSystem::renderFrame, timed every frame
+enum class RenderStage : UINT32
+{
+    PROXIES = 0,    // Dirty proxy refresh
+    CULL,           // Cull trees, frustum and occlusion culling
+    SORT,           // Sort keys and radix sort
+    BATCH,          // Draw commands and main pass instance data
+    LIGHTS,         // Light packing, CSM matrices and light clusters
+    SHADOWS,        // Shadow view culling, commands and instance data
+    PACKET,         // Constants, materials and the packet itself
+    EXECUTE,        // Backend executeFrame (queueing only with a render thread)
+    FENCE_WAIT,     // Blocked on a frame fence to reuse an arena
+    COUNT
+};
+
+constexpr UINT32 RENDER_STAGE_COUNT = static_cast<UINT32>(RenderStage::COUNT);
+constexpr UINT32 DEFAULT_STATS_WINDOW = 120;    // Frames in the rolling window
+constexpr UINT32 MAX_STATS_WINDOW = 1024;
+
+inline const char* getRenderStageName(RenderStage stage)
+{
+    switch (stage)
+    {
+    case RenderStage::PROXIES:    return "Proxies";
+    case RenderStage::CULL:       return "Cull";
+    case RenderStage::SORT:       return "Sort";
+    case RenderStage::BATCH:      return "Batch";
+    case RenderStage::LIGHTS:     return "Lights";
+    case RenderStage::SHADOWS:    return "Shadows";
+    case RenderStage::PACKET:     return "Packet";
+    case RenderStage::EXECUTE:    return "Execute";
+    case RenderStage::FENCE_WAIT: return "Fence wait";
+    default:                      return "Unknown";
+    }
+}
+
+// ==================== TIMING SUMMARY ====================
+// Milliseconds over the frames in the rolling window
+struct RenderTimingSummary
+{
+    float min;
+    float avg;
+    float p95;
+    float max;
+};
+
 // ==================== RENDER STATISTICS ====================
 struct RenderStats
 {
@@ -8,8 +57,133 @@ struct RenderStats
     UINT32 trianglesRendered;
     UINT32 objectsRendered;
     UINT32 objectsCulled;
+    UINT32 proxyCount;          // Live render proxies
+    UINT32 proxiesUpdated;      // Proxies reprocessed this frame
+    UINT32 objectsOccluded;     // Passed the frustum test, hidden by occluders
+    UINT32 occluderCount;
+    UINT32 occluderTriangles;   // Triangles rasterized into the occlusion buffer
     UINT32 shadowMapDrawCalls;
-    float frameTime;
-    float cpuTime;
-    float gpuTime;
+    UINT32 shadowViews;         // Cascades, spot tiles and point faces, empty ones included
+    UINT32 shadowViewsCached;   // Views the backend can keep from the previous frame
+    UINT32 shadowViewsStaticCached; // Views that only redraw dynamic casters over a cached static layer
+    UINT32 shadowInstances;     // Caster instances summed over all shadow views
+    UINT32 framesInFlight;      // Packets submitted but not yet released by the backend
+    UINT32 fenceWaits;          // Times the builder blocked on a frame fence to reuse an arena
+
+    // Culling and batching work, main view unless noted
+    UINT32 aabbsTested;         // BVH nodes plus boxes through the SIMD kernel
+    UINT32 cullEarlyOuts;       // Subtrees rejected or accepted whole, their leaves never tested
+    UINT32 shadowAABBsTested;   // Caster boxes tested against shadow views
+    UINT32 batchesMerged;       // Instances that joined an existing draw, main and shadow passes
+    UINT32 instancesWritten;    // PerInstanceData entries written, main and shadow passes
+
+    // Light culling
+    UINT32 lightsVisible;       // Enabled point and spot lights intersecting the camera frustum
+    UINT32 lightsCulled;        // Point and spot lights outside the frustum or disabled
+    UINT32 lightsOverBudget;    // Visible lights dropped as least important
+
+    // Clustered lighting
+    UINT32 lightsClustered;     // Point and spot lights in range of the camera's clusters
+    UINT32 clusterLightRefs;    // Entries in the per-cluster light lists
+    UINT32 maxClusterLights;    // Longest per-cluster light list
+
+    // Local shadow atlas
+    UINT32 localShadowLights;   // Spot and point lights given shadow tiles
+    UINT32 shadowTilesAllocated;    // Tiles handed out this frame, 0 while every light keeps its tiles
+    float shadowAtlasUsage;     // Fraction of the local atlas covered by tiles, retained ones included
+
+    // Cascaded shadows
+    UINT32 cascadesUpdated;     // Cascades refitted this frame, the others kept their matrix and contents
+
+    float frameTime;            // Wall time since the previous renderFrame
+    float cpuTime;              // renderFrame on the calling thread
+    float gpuTime;              // Reported by the backend, 0 while none measures it
+    float stageTime[RENDER_STAGE_COUNT];    // Indexed by RenderStage
+
+    // Rolling window over the last windowFrames frames, this one included
+    UINT32 windowFrames;
+    RenderTimingSummary frameTimeWindow;
+    RenderTimingSummary cpuTimeWindow;
+    RenderTimingSummary stageTimeWindow[RENDER_STAGE_COUNT];
+};
+
+// ==================== RENDER STATS WINDOW ====================
+// Ring of per-frame timings, summarized into a RenderStats after every frame
+class RenderStatsWindow
+{
+private:
+    static constexpr UINT32 SERIES_COUNT = RENDER_STAGE_COUNT + 2;   // Stages, frame, cpu
+    static constexpr UINT32 FRAME_SERIES = RENDER_STAGE_COUNT;
+    static constexpr UINT32 CPU_SERIES = RENDER_STAGE_COUNT + 1;
+
+    std::vector<float> m_Samples;       // SERIES_COUNT rows of m_Capacity samples
+    std::vector<float> m_Scratch;       // Percentile selection
+    UINT32 m_Capacity;
+    UINT32 m_Count;
+    UINT32 m_Next;
+
+    RenderTimingSummary summarize(UINT32 series)
+    {
+        const float* samples = m_Samples.data() + static_cast<size_t>(series) * m_Capacity;
+
+        RenderTimingSummary summary = { samples[0], 0.0f, 0.0f, samples[0] };
+        float sum = 0.0f;
+        for (UINT32 i = 0; i < m_Count; ++i)
+        {
+            summary.min = (std::min)(summary.min, samples[i]);
+            summary.max = (std::max)(summary.max, samples[i]);
+            sum += samples[i];
+        }
+        summary.avg = sum / static_cast<float>(m_Count);
+
+        // Nearest rank
+        UINT32 rank = (m_Count * 95 + 99) / 100;
+        m_Scratch.assign(samples, samples + m_Count);
+        std::nth_element(m_Scratch.begin(), m_Scratch.begin() + (rank - 1), m_Scratch.end());
+        summary.p95 = m_Scratch[rank - 1];
+        return summary;
+    }
+
+public:
+    RenderStatsWindow()
+        : m_Capacity(0)
+        , m_Count(0)
+        , m_Next(0)
+    {
+        resize(DEFAULT_STATS_WINDOW);
+    }
+
+    // Drops the collected samples
+    void resize(UINT32 frames)
+    {
+        m_Capacity = (std::max)(1u, (std::min)(frames, MAX_STATS_WINDOW));
+        m_Samples.assign(static_cast<size_t>(SERIES_COUNT) * m_Capacity, 0.0f);
+        m_Scratch.reserve(m_Capacity);
+        m_Count = 0;
+        m_Next = 0;
+    }
+
+    UINT32 getCapacity() const { return m_Capacity; }
+
+    // Adds the frame's timings and writes the window summaries back into stats
+    void addFrame(RenderStats& stats)
+    {
+        for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+        {
+            m_Samples[static_cast<size_t>(s) * m_Capacity + m_Next] = stats.stageTime[s];
+        }
+        m_Samples[static_cast<size_t>(FRAME_SERIES) * m_Capacity + m_Next] = stats.frameTime;
+        m_Samples[static_cast<size_t>(CPU_SERIES) * m_Capacity + m_Next] = stats.cpuTime;
+
+        m_Next = (m_Next + 1) % m_Capacity;
+        m_Count = (std::min)(m_Count + 1, m_Capacity);
+
+        stats.windowFrames = m_Count;
+        for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+        {
+            stats.stageTimeWindow[s] = summarize(s);
+        }
+        stats.frameTimeWindow = summarize(FRAME_SERIES);
+        stats.cpuTimeWindow = summarize(CPU_SERIES);
+    }
 };
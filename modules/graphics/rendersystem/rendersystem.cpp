@@ -1,6 +1,8 @@
 #include "rendersystem.h"
+#include "../../headeronly/profiler.h"
 #include <iostream>
 #include <cstring>
+#include <bit>
 
 // ==================== CONSTRUCTOR ====================
 RenderSystem::RenderSystem()
@@ -11,11 +13,20 @@ RenderSystem::RenderSystem()
     , m_pActiveCamera(nullptr)
     , m_DeltaTime(0.016f)
     , m_Time(0.0f)
-    , m_NextMeshHandle(1)
-    , m_NextMaterialHandle(1)
-    , m_NextTextureHandle(1)
-    , m_NextLightHandle(1)
     , m_AmbientLight(0.1f, 0.1f, 0.1f, 1.0f)
+    , m_FrameIndex(0)
+    , m_FrameArenaIndex(0)
+    , m_FramesInFlight(DEFAULT_FRAMES_IN_FLIGHT)
+    , m_SubmittedFrameFence(0)
+    , m_StaticProxiesChanged(false)
+    , m_ShadowCacheVersion(0)
+    , m_ShadowCacheEnabled(true)
+    , m_OcclusionEnabled(true)
+    , m_LightBudget(DEFAULT_LIGHT_BUDGET)
+    , m_CSMSceneBounds()
+    , m_CSMState()
+    , m_CascadeUpdateInterval(1)
+    , m_HasLastFrame(false)
 {
     m_ClearColor[0] = 0.1f;
     m_ClearColor[1] = 0.1f;
@@ -23,6 +34,10 @@ RenderSystem::RenderSystem()
     m_ClearColor[3] = 1.0f;
     
     memset(&m_Stats, 0, sizeof(RenderStats));
+    memset(m_FrameArenaFences, 0, sizeof(m_FrameArenaFences));
+    
+    // Bind transient containers before the first submit
+    rotateFrameArena();
     
     std::cout << "[RenderSystem] Created.\n";
 }
@@ -54,25 +69,49 @@ void RenderSystem::shutdown()
 {
     std::cout << "[RenderSystem] Shutting down...\n";
 
-    for (auto& pair : m_Meshes)
+    // Packets still queued in the backend reference the resources released below
+    if (m_pRhi)
+    {
+        m_pRhi->waitForFrameFence(m_SubmittedFrameFence);
+    }
+
+    for (auto& mesh : m_Meshes)
     {
-        if (m_pRhi) m_pRhi->destroyMeshBuffer(pair.second.gpuHandle);
+        if (m_pRhi) m_pRhi->destroyMeshBuffer(mesh.gpuHandle);
     }
     m_Meshes.clear();
 
-    for (auto& pair : m_Materials)
+    for (auto& material : m_Materials)
     {
-        if (m_pRhi) m_pRhi->destroyMaterialBuffer(pair.second.gpuHandle);
+        if (m_pRhi) m_pRhi->destroyMaterialBuffer(material.gpuHandle);
     }
     m_Materials.clear();
 
-    for (auto& pair : m_Textures)
+    for (hTexture gpuHandle : m_Textures)
     {
-        if (m_pRhi) m_pRhi->destroyTexture(pair.second);
+        if (m_pRhi) m_pRhi->destroyTexture(gpuHandle);
     }
     m_Textures.clear();
 
     m_Lights.clear();
+    m_LightTree.clear();
+    m_VisibleLights.clear();
+    m_ShadowAtlas.clear();
+    m_ShadowTiles.clear();
+    m_CSMState = {};
+
+    m_Proxies.clear();
+    m_DirtyProxies.clear();
+    m_ProxyTree.clear();
+    m_StaticProxyTree.clear();
+    m_StaticProxies.clear();
+    m_StaticProxyBounds.clear();
+    m_StaticProxiesChanged = false;
+
+    m_StaticTree.clear();
+    m_DynamicTree.clear();
+    m_StaticBounds.clear();
+    m_DynamicProxies.clear();
 
     if (m_pRhi)
     {
@@ -99,7 +138,13 @@ void RenderSystem::renderFrame()
         return;
     }
 
+    QUARK_PROFILE_ZONE("RenderSystem::renderFrame");
+
+    const auto frameStart = std::chrono::steady_clock::now();
+    auto stageStart = frameStart;
+
     m_Time += m_DeltaTime;
+    m_FrameIndex++;
     
     m_pActiveCamera->update();
     
@@ -107,247 +152,1190 @@ void RenderSystem::renderFrame()
     m_Stats.objectsRendered = 0;
     m_Stats.objectsCulled = 0;
 
+    // ==================== PROXIES ====================
+    updateProxies();
+    endStage(RenderStage::PROXIES, stageStart);
+
     // ==================== CULLING ====================
     frustumCull();
+    endStage(RenderStage::CULL, stageStart);
 
     // ==================== SORTING ====================
     sortObjects();
+    endStage(RenderStage::SORT, stageStart);
 
     // ==================== BATCHING & BUILD ====================
     buildBatches();
+    endStage(RenderStage::BATCH, stageStart);
     
     // ==================== BUILD FRAME PACKET ====================
+    // Splits its own time into LIGHTS, SHADOWS and PACKET
+    m_FrameArenaFences[m_FrameArenaIndex] = ++m_SubmittedFrameFence;
+    m_PacketBuilder.setFrameFence(m_SubmittedFrameFence);
     FramePacket packet = buildFramePacket();
+    stageStart = std::chrono::steady_clock::now();
 
     // ==================== EXECUTE ====================
-    m_pRhi->executeFrame(packet);
+    {
+        QUARK_PROFILE_ZONE("RHI::executeFrame");
+        m_pRhi->executeFrame(packet);
+    }
+    endStage(RenderStage::EXECUTE, stageStart);
 
     // ==================== CLEANUP ====================
-    m_SubmittedObjects.clear();
-    m_VisibleObjects.clear();
-    m_ShadowCasters.clear();
-    m_PacketBuilder.reset();
+    rotateFrameArena();
+
+    // ==================== STATS ====================
+    const auto frameEnd = std::chrono::steady_clock::now();
+    m_Stats.cpuTime = std::chrono::duration<float, std::milli>(frameEnd - frameStart).count();
+    m_Stats.frameTime = m_HasLastFrame
+        ? std::chrono::duration<float, std::milli>(frameStart - m_LastFrameStart).count()
+        : m_Stats.cpuTime;
+    m_LastFrameStart = frameStart;
+    m_HasLastFrame = true;
+    m_StatsWindow.addFrame(m_Stats);
+
+    QUARK_PROFILE_COUNTER("Draw calls", m_Stats.drawCalls);
+    QUARK_PROFILE_COUNTER("Objects rendered", m_Stats.objectsRendered);
+    QUARK_PROFILE_COUNTER("Instances written", m_Stats.instancesWritten);
+}
 
+void RenderSystem::endStage(RenderStage stage, std::chrono::steady_clock::time_point& stageStart)
+{
+    const auto now = std::chrono::steady_clock::now();
+    m_Stats.stageTime[static_cast<UINT32>(stage)] += std::chrono::duration<float, std::milli>(now - stageStart).count();
+    stageStart = now;
 }
 
 void RenderSystem::endFrame()
 {
+    QUARK_PROFILE_ZONE("RenderSystem::endFrame");
+
     if (m_pRhi)
     {
         m_pRhi->endFrame();
     }
 }
 
+// ==================== FRAME MEMORY ====================
+void RenderSystem::rotateFrameArena()
+{
+    // The next arena in the ring last held the packet from m_FramesInFlight frames
+    // ago, it can only be reset once the backend has released that packet
+    m_FrameArenaIndex = (m_FrameArenaIndex + 1) % m_FramesInFlight;
+    if (m_pRhi)
+    {
+        UINT64 fence = m_FrameArenaFences[m_FrameArenaIndex];
+        if (m_pRhi->getCompletedFrameFence() < fence)
+        {
+            QUARK_PROFILE_ZONE("RenderSystem::waitForFrameFence");
+            auto waitStart = std::chrono::steady_clock::now();
+            m_pRhi->waitForFrameFence(fence);
+            endStage(RenderStage::FENCE_WAIT, waitStart);
+            m_Stats.fenceWaits++;
+        }
+        m_Stats.framesInFlight = static_cast<UINT32>(m_SubmittedFrameFence - m_pRhi->getCompletedFrameFence());
+    }
+
+    Quark::FrameArena& arena = m_FrameArenas[m_FrameArenaIndex];
+    arena.reset();
+
+    Quark::RebindArenaVector(m_SubmittedObjects, arena);
+    Quark::RebindArenaVector(m_VisibleObjects, arena);
+    Quark::RebindArenaVector(m_ShadowCasters, arena);
+    Quark::RebindArenaVector(m_SortEntries, arena);
+    Quark::RebindArenaVector(m_SortScratch, arena);
+    Quark::RebindArenaVector(m_SortedObjects, arena);
+    Quark::RebindArenaVector(m_StaticOrder, arena);
+    Quark::RebindArenaVector(m_DynamicOrder, arena);
+    Quark::RebindArenaVector(m_CullCandidates, arena);
+    Quark::RebindArenaVector(m_CullIndices, arena);
+    Quark::RebindArenaVector(m_CullVisible, arena);
+    Quark::RebindArenaVector(m_ShadowBoundedCasters, arena);
+    Quark::RebindArenaVector(m_ShadowUnboundedCasters, arena);
+    Quark::RebindArenaVector(m_ShadowLocalCasters, arena);
+    Quark::RebindArenaVector(m_ShadowIndices, arena);
+    Quark::RebindArenaVector(m_ShadowViewCasters, arena);
+    Quark::RebindArenaVector(m_ShadowInstanceCasters, arena);
+    Quark::RebindArenaVector(m_ShadowCasterHashes, arena);
+    Quark::RebindArenaVector(m_ObjectClass, arena);
+    Quark::RebindArenaVector(m_InstanceTargets, arena);
+
+    m_PacketBuilder.beginFrame(arena);
+}
+
+// ==================== PROXIES ====================
+void RenderSystem::updateProxies()
+{
+    QUARK_PROFILE_ZONE("RenderSystem::updateProxies");
+
+    for (hRenderProxy handle : m_DirtyProxies)
+    {
+        // Destroyed proxies leave stale handles behind, get() filters them out
+        RenderProxy* proxy = m_Proxies.get(handle);
+        if (!proxy || !proxy->dirty)
+        {
+            continue;
+        }
+
+        refreshProxy(*proxy);
+        m_Stats.proxiesUpdated++;
+    }
+    m_DirtyProxies.clear();
+
+    m_Stats.proxyCount = static_cast<UINT32>(m_Proxies.size());
+}
+
+void RenderSystem::refreshProxy(RenderProxy& proxy)
+{
+    SubmittedObject& obj = proxy.object;
+
+    obj.matrixType = obj.worldMatrix.Classify();
+    proxy.normalMatrix = obj.worldMatrix.NormalMatrix(obj.matrixType);
+
+    const MeshResource* mesh = m_Meshes.get(obj.mesh);
+    obj.worldBounds = Quark::TransformAABB(obj.worldMatrix, mesh ? mesh->localBounds : Quark::AABB());
+
+    const MaterialResource* material = m_Materials.get(obj.material);
+    obj.transparent = material &&
+        (static_cast<MaterialFlags>(material->data.flags) & MaterialFlags::ALPHA_BLEND) != MaterialFlags::NONE;
+
+    UINT32 materialId = obj.material & Quark::SlotMap<MaterialResource>::INDEX_MASK;
+    UINT32 meshId = obj.mesh & Quark::SlotMap<MeshResource>::INDEX_MASK;
+    proxy.sortKeyBase = packSortKeyBase(0, obj.transparent, materialId, meshId);
+
+    // Static proxies go into a tree built in one pass, any change to the set rebuilds it
+    bool culled = (obj.flags & RenderObjectFlags::FRUSTUM_CULL) != RenderObjectFlags::NONE;
+    bool isStatic = (obj.flags & RenderObjectFlags::STATIC) != RenderObjectFlags::NONE;
+    if (proxy.staticCulled || (culled && isStatic))
+    {
+        m_StaticProxiesChanged = true;
+    }
+    proxy.staticCulled = culled && isStatic;
+
+    bool inTree = culled && !isStatic;
+    if (inTree && proxy.treeNode == BVH_NULL_NODE)
+    {
+        proxy.treeNode = m_ProxyTree.insert(obj.worldBounds, obj.proxy);
+    }
+    else if (inTree)
+    {
+        m_ProxyTree.move(proxy.treeNode, obj.worldBounds);
+    }
+    else if (proxy.treeNode != BVH_NULL_NODE)
+    {
+        m_ProxyTree.remove(proxy.treeNode);
+        proxy.treeNode = BVH_NULL_NODE;
+    }
+
+    proxy.dirty = false;
+}
+
+void RenderSystem::markProxyDirty(hRenderProxy handle, RenderProxy& proxy)
+{
+    if (proxy.dirty) return;
+
+    proxy.dirty = true;
+    m_DirtyProxies.push_back(handle);
+}
+
 // ==================== CULLING ====================
 void RenderSystem::frustumCull()
 {
-    m_VisibleObjects.clear();
-    m_ShadowCasters.clear();
-    m_VisibleObjects.reserve(m_SubmittedObjects.size());
-    m_ShadowCasters.reserve(m_SubmittedObjects.size());
+    QUARK_PROFILE_ZONE("RenderSystem::frustumCull");
+
+    const UINT32 objectCount = getObjectCount();
+    const UINT32 immediateCount = static_cast<UINT32>(m_SubmittedObjects.size());
+
+    const Frustum& frustum = m_pActiveCamera->frustum;
+
+    updateCullTrees();
+
+    // Hierarchical walk: fully inside leaves are accepted directly,
+    // leaves straddling a plane are collected for the SIMD kernel
+    m_CullVisible.assign(objectCount, 0);
+    m_CullBounds.Clear();
+    m_CullCandidates.clear();
+
+    auto collect = [this](UINT32 submittedIndex, bool fullyInside)
+    {
+        if (fullyInside)
+        {
+            m_CullVisible[submittedIndex] = 1;
+            return;
+        }
+        m_CullBounds.Add(getObject(submittedIndex).worldBounds);
+        m_CullCandidates.push_back(submittedIndex);
+    };
+
+    const BVHCullStats treeStats[] =
+    {
+        m_StaticTree.cullFrustum(frustum, m_CullStack, [&](UINT32 ordinal, bool fullyInside) { collect(m_StaticOrder[ordinal], fullyInside); }),
+        m_DynamicTree.cullFrustum(frustum, m_CullStack, [&](UINT32 ordinal, bool fullyInside) { collect(m_DynamicOrder[ordinal], fullyInside); }),
+        m_ProxyTree.cullFrustum(frustum, m_CullStack, [&](hRenderProxy handle, bool fullyInside) { collect(immediateCount + m_Proxies.indexOf(handle), fullyInside); }),
+        m_StaticProxyTree.cullFrustum(frustum, m_CullStack, [&](UINT32 leaf, bool fullyInside) { collect(immediateCount + m_Proxies.indexOf(m_StaticProxies[leaf]), fullyInside); })
+    };
+    for (const BVHCullStats& treeStat : treeStats)
+    {
+        m_Stats.aabbsTested += treeStat.nodesTested;
+        m_Stats.cullEarlyOuts += treeStat.subtreesRejected + treeStat.subtreesAccepted;
+    }
+    m_Stats.aabbsTested += static_cast<UINT32>(m_CullCandidates.size());
+
+    m_CullIndices.resize(m_CullCandidates.size());
+
+    // SIMD kernel over the straddling leaves, chunks start on 8-box boundaries so every
+    // box goes through the same lanes as a single-range call
+    UINT32 chunkSize = 0;
+    UINT32 chunkCount = m_TaskPool.chunkCount(static_cast<UINT32>(m_CullCandidates.size()), CULL_CHUNK_SIZE, 8, chunkSize);
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, static_cast<UINT32>(m_CullCandidates.size()));
+        UINT32* indices = m_CullIndices.data() + begin;
+        UINT32 inFrustumCount = frustum.cullAABBs(m_CullBounds, begin, end, indices);
+        for (UINT32 i = 0; i < inFrustumCount; ++i)
+        {
+            m_CullVisible[m_CullCandidates[indices[i]]] = 1;
+        }
+    });
+
+    // Occluders are rasterized after the frustum pass, only visible ones can hide anything
+    bool useOcclusion = m_OcclusionEnabled && renderOccluders();
+
+    // Classify per chunk, then scatter into pre-sized ranges in chunk order so the
+    // queues come out exactly as a serial walk would build them
+    chunkCount = m_TaskPool.chunkCount(objectCount, CULL_CHUNK_SIZE, 1, chunkSize);
+    m_ObjectClass.resize(objectCount);
+    m_StageChunks.resize(chunkCount);
+
+    // Caster bounds and receiver depths come along for fitting the cascades
+    const Quark::Vec3 cameraPosition = m_pActiveCamera->position;
+    const Quark::Vec3 cameraForward = m_pActiveCamera->forward();
+
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        StageChunk& counts = m_StageChunks[chunk];
+        counts = {};
+        counts.casterBounds = Quark::AABB(Quark::Vec3(FLT_MAX, FLT_MAX, FLT_MAX), Quark::Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+        counts.receiverNear = FLT_MAX;
+        counts.receiverFar = -FLT_MAX;
+
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, objectCount);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            const SubmittedObject& obj = getObject(i);
+            UINT8 objectClass = 0;
+
+            bool shouldCull = (obj.flags & RenderObjectFlags::FRUSTUM_CULL) != RenderObjectFlags::NONE;
+
+            if ((obj.flags & RenderObjectFlags::CAST_SHADOW) != RenderObjectFlags::NONE)
+            {
+                objectClass |= OBJECT_CLASS_CASTER;
+                counts.casterCount++;
+                if (shouldCull)
+                    counts.casterBounds = counts.casterBounds.Merge(obj.worldBounds);
+                else
+                    counts.unboundedCaster = true;
+            }
+
+            if ((obj.flags & RenderObjectFlags::VISIBLE) == RenderObjectFlags::NONE)
+            {
+                // Not drawn in the main pass
+            }
+            else if (shouldCull && !m_CullVisible[i])
+            {
+                counts.culledCount++;
+            }
+            else if (shouldCull && useOcclusion &&
+                     (obj.flags & RenderObjectFlags::OCCLUDER) == RenderObjectFlags::NONE &&
+                     !m_Occlusion.isVisible(obj.worldBounds))
+            {
+                counts.occludedCount++;
+            }
+            else
+            {
+                objectClass |= OBJECT_CLASS_VISIBLE;
+                counts.visibleCount++;
+
+                if ((obj.flags & RenderObjectFlags::RECEIVE_SHADOW) == RenderObjectFlags::NONE)
+                {
+                    // Nothing to fit
+                }
+                else if (shouldCull)
+                {
+                    const Quark::Vec3 extents = obj.worldBounds.Extents();
+                    const float depth = (obj.worldBounds.Center() - cameraPosition).Dot(cameraForward);
+                    const float reach = std::fabs(extents.x * cameraForward.x) + std::fabs(extents.y * cameraForward.y) +
+                                        std::fabs(extents.z * cameraForward.z);
+                    counts.receiverNear = (std::min)(counts.receiverNear, depth - reach);
+                    counts.receiverFar = (std::max)(counts.receiverFar, depth + reach);
+                }
+                else
+                {
+                    counts.unboundedReceiver = true;
+                }
+            }
+
+            m_ObjectClass[i] = objectClass;
+        }
+    });
+
+    UINT32 visibleCount = 0;
+    UINT32 casterCount = 0;
+    CSMSceneBounds& sceneBounds = m_CSMSceneBounds;
+    sceneBounds.casterBounds = Quark::AABB(Quark::Vec3(FLT_MAX, FLT_MAX, FLT_MAX), Quark::Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+    sceneBounds.receiverNear = FLT_MAX;
+    sceneBounds.receiverFar = -FLT_MAX;
+    sceneBounds.casterBoundsValid = true;
+    sceneBounds.receiverRangeValid = true;
+    for (StageChunk& counts : m_StageChunks)
+    {
+        sceneBounds.casterBounds = sceneBounds.casterBounds.Merge(counts.casterBounds);
+        sceneBounds.receiverNear = (std::min)(sceneBounds.receiverNear, counts.receiverNear);
+        sceneBounds.receiverFar = (std::max)(sceneBounds.receiverFar, counts.receiverFar);
+        sceneBounds.casterBoundsValid &= !counts.unboundedCaster;
+        sceneBounds.receiverRangeValid &= !counts.unboundedReceiver;
+
+        counts.visibleStart = visibleCount;
+        counts.casterStart = casterCount;
+        visibleCount += counts.visibleCount;
+        casterCount += counts.casterCount;
+        m_Stats.objectsCulled += counts.culledCount;
+        m_Stats.objectsOccluded += counts.occludedCount;
+    }
+    m_Stats.objectsRendered += visibleCount;
+
+    m_VisibleObjects.resize(visibleCount);
+    m_ShadowCasters.resize(casterCount);
+
+    sceneBounds.receiverRangeValid &= sceneBounds.receiverNear <= sceneBounds.receiverFar;
+
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        const StageChunk& counts = m_StageChunks[chunk];
+        SubmittedObject* visible = m_VisibleObjects.data() + counts.visibleStart;
+        SubmittedObject* casters = m_ShadowCasters.data() + counts.casterStart;
+
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, objectCount);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            UINT8 objectClass = m_ObjectClass[i];
+            if (objectClass == 0) continue;
+
+            const SubmittedObject& obj = getObject(i);
+            if (objectClass & OBJECT_CLASS_CASTER)
+            {
+                *casters++ = obj;
+            }
+            if (objectClass & OBJECT_CLASS_VISIBLE)
+            {
+                *visible = obj;
+                visible->sortDistance = (obj.worldBounds.Center() - cameraPosition).LengthSq();
+                visible++;
+            }
+        }
+    });
+}
+
+void RenderSystem::updateCullTrees()
+{
+    m_StaticOrder.clear();
+    m_DynamicOrder.clear();
 
-    for (auto& obj : m_SubmittedObjects)
+    for (UINT32 i = 0; i < static_cast<UINT32>(m_SubmittedObjects.size()); ++i)
     {
-        if (obj.flags == RenderObjectFlags::NONE)
+        const auto& obj = m_SubmittedObjects[i];
+        if ((obj.flags & RenderObjectFlags::FRUSTUM_CULL) == RenderObjectFlags::NONE)
         {
             continue;
         }
-        
-        if ((obj.flags & RenderObjectFlags::CAST_SHADOW) != RenderObjectFlags::NONE)
+
+        if ((obj.flags & RenderObjectFlags::STATIC) != RenderObjectFlags::NONE)
+            m_StaticOrder.push_back(i);
+        else
+            m_DynamicOrder.push_back(i);
+    }
+
+    // ==================== STATIC ====================
+    // Rebuild only when the static bounds differ from the ones the tree was built from
+    bool staticChanged = m_StaticOrder.size() != m_StaticBounds.size();
+    for (size_t k = 0; !staticChanged && k < m_StaticOrder.size(); ++k)
+    {
+        const Quark::AABB& a = m_SubmittedObjects[m_StaticOrder[k]].worldBounds;
+        const Quark::AABB& b = m_StaticBounds[k];
+        staticChanged = a.minBounds.x != b.minBounds.x || a.minBounds.y != b.minBounds.y || a.minBounds.z != b.minBounds.z ||
+                        a.maxBounds.x != b.maxBounds.x || a.maxBounds.y != b.maxBounds.y || a.maxBounds.z != b.maxBounds.z;
+    }
+
+    if (staticChanged)
+    {
+        m_StaticBounds.resize(m_StaticOrder.size());
+        for (size_t k = 0; k < m_StaticOrder.size(); ++k)
         {
-            m_ShadowCasters.push_back(obj);
+            m_StaticBounds[k] = m_SubmittedObjects[m_StaticOrder[k]].worldBounds;
         }
-        
-        if ((obj.flags & RenderObjectFlags::VISIBLE) == RenderObjectFlags::NONE)
+        m_StaticTree.build(m_StaticBounds.data(), static_cast<UINT32>(m_StaticBounds.size()));
+    }
+
+    // ==================== STATIC PROXIES ====================
+    // Rebuilt from the proxies flagged by refreshProxy/destroyRenderProxy, untouched otherwise
+    if (m_StaticProxiesChanged)
+    {
+        m_StaticProxies.clear();
+        m_StaticProxyBounds.clear();
+        for (size_t i = 0; i < m_Proxies.size(); ++i)
+        {
+            const RenderProxy& proxy = m_Proxies.data()[i];
+            if (!proxy.staticCulled) continue;
+
+            m_StaticProxies.push_back(m_Proxies.handleAt(i));
+            m_StaticProxyBounds.push_back(proxy.object.worldBounds);
+        }
+        m_StaticProxyTree.build(m_StaticProxyBounds.data(), static_cast<UINT32>(m_StaticProxyBounds.size()));
+        m_StaticProxiesChanged = false;
+    }
+
+    // ==================== DYNAMIC ====================
+    // Proxies follow submission order; move() is a no-op while bounds stay inside the fat AABB
+    const size_t dynamicCount = m_DynamicOrder.size();
+
+    while (m_DynamicProxies.size() > dynamicCount)
+    {
+        m_DynamicTree.remove(m_DynamicProxies.back());
+        m_DynamicProxies.pop_back();
+    }
+
+    for (size_t k = 0; k < dynamicCount; ++k)
+    {
+        const Quark::AABB& bounds = m_SubmittedObjects[m_DynamicOrder[k]].worldBounds;
+        if (k < m_DynamicProxies.size())
+        {
+            m_DynamicTree.move(m_DynamicProxies[k], bounds);
+        }
+        else
+        {
+            m_DynamicProxies.push_back(m_DynamicTree.insert(bounds, static_cast<UINT32>(k)));
+        }
+    }
+}
+
+bool RenderSystem::renderOccluders()
+{
+    m_Occlusion.beginFrame(m_pActiveCamera->viewProjection, m_pActiveCamera->nearPlane);
+
+    const UINT32 objectCount = getObjectCount();
+    for (UINT32 i = 0; i < objectCount; ++i)
+    {
+        const SubmittedObject& obj = getObject(i);
+        if ((obj.flags & RenderObjectFlags::OCCLUDER) == RenderObjectFlags::NONE ||
+            (obj.flags & RenderObjectFlags::VISIBLE) == RenderObjectFlags::NONE)
         {
             continue;
         }
-        
+
         bool shouldCull = (obj.flags & RenderObjectFlags::FRUSTUM_CULL) != RenderObjectFlags::NONE;
-        
-        if (shouldCull && !m_pActiveCamera->isVisible(obj.worldBounds))
+        if (shouldCull && !m_CullVisible[i])
         {
-            m_Stats.objectsCulled++;
             continue;
         }
-        
-        Quark::Vec3 objCenter = obj.worldBounds.Center();
-        obj.sortDistance = (objCenter - m_pActiveCamera->position).LengthSq();
-        
-        m_VisibleObjects.push_back(obj);
-        m_Stats.objectsRendered++;
-    }
+
+        const MeshResource* mesh = m_Meshes.get(obj.mesh);
+        if (!mesh || mesh->cpuIndices.empty())
+        {
+            continue;
+        }
+
+        m_Occlusion.addOccluder(mesh->cpuPositions.data(), mesh->cpuIndices.data(),
+                                static_cast<UINT32>(mesh->cpuIndices.size()), obj.worldMatrix);
+    }
+
+    m_Stats.occluderCount = m_Occlusion.getOccluderCount();
+    m_Stats.occluderTriangles = m_Occlusion.getTriangleCount();
+
+    if (m_Stats.occluderTriangles == 0)
+    {
+        return false;
+    }
+
+    m_Occlusion.rasterize(m_TaskPool);
+    return true;
+}
+
+// ==================== SORTING ====================
+void RenderSystem::sortObjects()
+{
+    QUARK_PROFILE_ZONE("RenderSystem::sortObjects");
+
+    const UINT32 count = static_cast<UINT32>(m_VisibleObjects.size());
+    if (count < 2) return;
+
+    UINT32 chunkSize = 0;
+    UINT32 chunkCount = m_TaskPool.chunkCount(count, SORT_CHUNK_SIZE, 1, chunkSize);
+
+    // Keys are built once per object, the sort itself never touches resources
+    m_SortEntries.resize(count);
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, count);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            auto& obj = m_VisibleObjects[i];
+            const RenderProxy* proxy = obj.proxy ? m_Proxies.get(obj.proxy) : nullptr;
+            if (proxy)
+            {
+                // Transparency and everything but depth were resolved when the proxy was refreshed
+                obj.sortKey = applySortDepth(proxy->sortKeyBase, obj.transparent, obj.sortDistance);
+            }
+            else
+            {
+                const MaterialResource* material = m_Materials.get(obj.material);
+                obj.transparent = material &&
+                    (static_cast<MaterialFlags>(material->data.flags) & MaterialFlags::ALPHA_BLEND) != MaterialFlags::NONE;
+                obj.sortKey = calculateSortKey(obj);
+            }
+            m_SortEntries[i] = { obj.sortKey, i };
+        }
+    });
+
+    sortEntries(chunkCount, chunkSize);
+
+    m_SortedObjects.resize(count);
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, count);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            m_SortedObjects[i] = m_VisibleObjects[m_SortEntries[i].index];
+        }
+    });
+    m_VisibleObjects.swap(m_SortedObjects);
+}
+
+void RenderSystem::sortEntries(UINT32 chunkCount, UINT32 chunkSize)
+{
+    if (chunkCount < 2)
+    {
+        radixSortEntries(m_SortEntries, m_SortScratch);
+        return;
+    }
+
+    // Same stable LSD radix sort as radixSortEntries: per chunk histograms give every
+    // chunk its own output offsets, chunks scatter in parallel and keep their order
+    const UINT32 count = static_cast<UINT32>(m_SortEntries.size());
+    m_SortHistograms.resize(static_cast<size_t>(chunkCount) * 256);
+    m_SortKeyMasks.resize(static_cast<size_t>(chunkCount) * 2);
+
+    // Bits that differ between any two keys, passes over constant bytes are skipped
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT64 keyAnd = ~0ull;
+        UINT64 keyOr = 0;
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, count);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            keyAnd &= m_SortEntries[i].key;
+            keyOr |= m_SortEntries[i].key;
+        }
+        m_SortKeyMasks[chunk * 2] = keyAnd;
+        m_SortKeyMasks[chunk * 2 + 1] = keyOr;
+    });
+
+    UINT64 keyAnd = ~0ull;
+    UINT64 keyOr = 0;
+    for (UINT32 chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        keyAnd &= m_SortKeyMasks[chunk * 2];
+        keyOr |= m_SortKeyMasks[chunk * 2 + 1];
+    }
+    const UINT64 varyingBits = keyAnd ^ keyOr;
+
+    m_SortScratch.resize(count);
+    SortEntry* src = m_SortEntries.data();
+    SortEntry* dst = m_SortScratch.data();
+
+    for (UINT32 pass = 0; pass < 8; ++pass)
+    {
+        const UINT32 shift = pass * 8;
+        if (((varyingBits >> shift) & 0xFF) == 0) continue;
+
+        m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+        {
+            UINT32* histogram = m_SortHistograms.data() + chunk * 256;
+            memset(histogram, 0, 256 * sizeof(UINT32));
+
+            UINT32 begin = chunk * chunkSize;
+            UINT32 end = (std::min)(begin + chunkSize, count);
+            for (UINT32 i = begin; i < end; ++i)
+            {
+                histogram[(src[i].key >> shift) & 0xFF]++;
+            }
+        });
+
+        // Bucket-major, chunk-minor prefix sum
+        UINT32 offset = 0;
+        for (UINT32 b = 0; b < 256; ++b)
+        {
+            for (UINT32 chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                UINT32& slot = m_SortHistograms[chunk * 256 + b];
+                UINT32 c = slot;
+                slot = offset;
+                offset += c;
+            }
+        }
+
+        m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+        {
+            UINT32* histogram = m_SortHistograms.data() + chunk * 256;
+
+            UINT32 begin = chunk * chunkSize;
+            UINT32 end = (std::min)(begin + chunkSize, count);
+            for (UINT32 i = begin; i < end; ++i)
+            {
+                dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+            }
+        });
+
+        SortEntry* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != m_SortEntries.data())
+    {
+        m_SortEntries.swap(m_SortScratch);
+    }
+}
+
+// ==================== BATCHING ====================
+void RenderSystem::buildBatches()
+{
+    QUARK_PROFILE_ZONE("RenderSystem::buildBatches");
+
+    const UINT32 count = static_cast<UINT32>(m_VisibleObjects.size());
+    if (count == 0) return;
+
+    // Serial pass over the sorted queue: one draw per mesh/material run, each run
+    // reserves its instance range and every object records its slot in it
+    m_InstanceTargets.resize(count);
+
+    UINT32 runStart = 0;
+    while (runStart < count)
+    {
+        const hMesh runMesh = m_VisibleObjects[runStart].mesh;
+        const hMaterial runMaterial = m_VisibleObjects[runStart].material;
+
+        UINT32 runEnd = runStart + 1;
+        while (runEnd < count && m_VisibleObjects[runEnd].mesh == runMesh && m_VisibleObjects[runEnd].material == runMaterial)
+        {
+            ++runEnd;
+        }
+        const UINT32 runLength = runEnd - runStart;
+
+        const MeshResource* mesh = m_Meshes.get(runMesh);
+        const MaterialResource* material = m_Materials.get(runMaterial);
+
+        if (mesh)
+        {
+            m_Stats.trianglesRendered += (mesh->data.indexCount / 3) * runLength;
+        }
+
+        UINT32 instanceStart = (mesh && material) ? m_PacketBuilder.reserveInstances(runLength) : UINT32_MAX;
+        if (instanceStart != UINT32_MAX)
+        {
+            DrawCommand cmd = {};
+            cmd.mesh = mesh->gpuHandle;
+            cmd.material = material->gpuHandle;
+            cmd.instanceStart = instanceStart;
+            cmd.instanceCount = runLength;
+            cmd.sortKey = 0;
+
+            m_PacketBuilder.addDrawCommand(cmd);
+            m_Stats.drawCalls++;
+            m_Stats.batchesMerged += runLength - 1;
+            m_Stats.instancesWritten += runLength;
+        }
+
+        for (UINT32 i = runStart; i < runEnd; ++i)
+        {
+            m_InstanceTargets[i] = instanceStart == UINT32_MAX ? UINT32_MAX : instanceStart + (i - runStart);
+        }
+
+        runStart = runEnd;
+    }
+
+    // Instance data (and the normal matrix inverses) written in place, in parallel
+    PerInstanceData* instances = m_PacketBuilder.getInstanceData();
+
+    UINT32 chunkSize = 0;
+    UINT32 chunkCount = m_TaskPool.chunkCount(count, INSTANCE_CHUNK_SIZE, 1, chunkSize);
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, count);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            if (m_InstanceTargets[i] == UINT32_MAX) continue;
+
+            const SubmittedObject& obj = m_VisibleObjects[i];
+            PerInstanceData& instance = instances[m_InstanceTargets[i]];
+
+            const RenderProxy* proxy = obj.proxy ? m_Proxies.get(obj.proxy) : nullptr;
+            instance.worldMatrix = obj.worldMatrix;
+            instance.worldInvTranspose = proxy ? proxy->normalMatrix : obj.worldMatrix.NormalMatrix(obj.matrixType);
+            instance.customData = Quark::Vec4(static_cast<float>(static_cast<UINT32>(obj.flags)), 0, 0, 0);
+        }
+    });
+}
+
+// ==================== SHADOW VIEWS ====================
+static bool isStaticCaster(const SubmittedObject& obj)
+{
+    return (obj.flags & RenderObjectFlags::STATIC) != RenderObjectFlags::NONE;
+}
+
+// Everything the caster's depth depends on, views sum these so the order does not matter
+static UINT64 hashShadowCaster(const SubmittedObject& obj, UINT32 meshRevision)
+{
+    UINT32 words[16];
+    memcpy(words, obj.worldMatrix.m, sizeof(words));
+
+    UINT64 hash = 0xcbf29ce484222325ull ^ (static_cast<UINT64>(obj.mesh) << 32 | meshRevision);
+    for (UINT32 word : words)
+    {
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+
+    // FNV alone mixes the high bits poorly, sums of it would collide
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void RenderSystem::buildShadowViews()
+{
+    QUARK_PROFILE_ZONE("RenderSystem::buildShadowViews");
+
+    // Views are built even without casters, their tiles still have to be cleared
+    const UINT32 casterCount = static_cast<UINT32>(m_ShadowCasters.size());
+
+    // Sorted once so the casters surviving any view come out static first, then grouped by mesh/material
+    std::sort(m_ShadowCasters.begin(), m_ShadowCasters.end(),
+        [](const SubmittedObject& a, const SubmittedObject& b)
+        {
+            if (isStaticCaster(a) != isStaticCaster(b)) return isStaticCaster(a);
+            if (a.mesh != b.mesh) return a.mesh < b.mesh;
+            return a.material < b.material;
+        });
+
+    // Casters without FRUSTUM_CULL have no trusted bounds and go into every view
+    m_ShadowBounds.Clear();
+    m_ShadowBoundedCasters.clear();
+    m_ShadowUnboundedCasters.clear();
+    m_ShadowCasterHashes.resize(m_ShadowCacheEnabled ? casterCount : 0);
+    for (UINT32 i = 0; i < casterCount; ++i)
+    {
+        const auto& obj = m_ShadowCasters[i];
+        if (m_ShadowCacheEnabled)
+        {
+            const MeshResource* mesh = m_Meshes.get(obj.mesh);
+            m_ShadowCasterHashes[i] = hashShadowCaster(obj, mesh ? mesh->revision : 0);
+        }
+        if ((obj.flags & RenderObjectFlags::FRUSTUM_CULL) != RenderObjectFlags::NONE)
+        {
+            m_ShadowBounds.Add(obj.worldBounds);
+            m_ShadowBoundedCasters.push_back(i);
+        }
+        else
+        {
+            m_ShadowUnboundedCasters.push_back(i);
+        }
+    }
+
+    const GPULightData* lights = m_PacketBuilder.getLights();
+    const UINT32 lightCount = m_PacketBuilder.getCurrentLightCount();
+    const UINT32 boundedCount = static_cast<UINT32>(m_ShadowBounds.Size());
+
+    // ==================== VIEW JOBS ====================
+    // Point lights narrow the caster set to their range box first. Every point light
+    // appends its subset to the shared local SoA, its faces cull that range only.
+    m_ShadowViewJobs.clear();
+    m_ShadowLocalBounds.Clear();
+    m_ShadowLocalCasters.clear();
+
+    auto addJob = [&](ShadowViewType type, UINT32 slot, const Quark::Vec4& atlasRect, const Quark::Mat4& viewProjection,
+                      const Quark::AABBSoA* bounds, UINT32 boundsBegin, UINT32 boundsEnd, const UINT32* casters)
+    {
+        ShadowViewJob job = {};
+        job.type = type;
+        job.slot = slot;
+        job.atlasRect = atlasRect;
+        job.viewProjection = viewProjection;
+        job.frustum.extractFromViewProjection(viewProjection);
+        job.bounds = bounds;
+        job.boundsBegin = boundsBegin;
+        job.boundsEnd = boundsEnd;
+        job.casters = casters;
+        m_ShadowViewJobs.push_back(job);
+        return &m_ShadowViewJobs.back();
+    };
+
+    for (UINT32 l = 0; l < lightCount; ++l)
+    {
+        const GPULightData& light = lights[l];
+        if (!(light.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) || light.shadowIndex < 0)
+        {
+            continue;
+        }
+
+        switch (static_cast<LightType>(light.type))
+        {
+        case LightType::DIRECTIONAL:
+            for (UINT32 c = 0; c < DIRECTIONAL_CASCADE_COUNT; ++c)
+            {
+                // Ortho volume extruded toward the light: anything between the
+                // light and the cascade can still throw a shadow into it
+                ShadowViewJob* job = addJob(ShadowViewType::CASCADE, c, Quark::Vec4(0.0f), light.cascadeMatrices[c],
+                                            &m_ShadowBounds, 0, boundedCount, nullptr);
+                job->frustum.disablePlane(4);
+            }
+            break;
+
+        case LightType::SPOT:
+            addJob(ShadowViewType::SPOT, 0, light.shadowRects[0], light.spotShadowMatrix,
+                   &m_ShadowBounds, 0, boundedCount, nullptr);
+            break;
+
+        case LightType::POINT:
+            {
+                const UINT32 localBegin = static_cast<UINT32>(m_ShadowLocalBounds.Size());
+                for (UINT32 k = 0; k < boundedCount; ++k)
+                {
+                    if (std::abs(m_ShadowBounds.centerX[k] - light.position.x) <= m_ShadowBounds.extentX[k] + light.range &&
+                        std::abs(m_ShadowBounds.centerY[k] - light.position.y) <= m_ShadowBounds.extentY[k] + light.range &&
+                        std::abs(m_ShadowBounds.centerZ[k] - light.position.z) <= m_ShadowBounds.extentZ[k] + light.range)
+                    {
+                        m_ShadowLocalBounds.Add(m_ShadowBounds.Get(k));
+                        m_ShadowLocalCasters.push_back(m_ShadowBoundedCasters[k]);
+                    }
+                }
+                const UINT32 localEnd = static_cast<UINT32>(m_ShadowLocalBounds.Size());
+
+                for (UINT32 f = 0; f < POINT_SHADOW_FACE_COUNT; ++f)
+                {
+                    addJob(ShadowViewType::POINT_FACE, f, light.shadowRects[f], light.pointShadowMatrices[f],
+                           &m_ShadowLocalBounds, localBegin, localEnd, nullptr);
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Caster lists are final now, so the pointers can be filled in and output ranges laid out
+    const UINT32 unboundedCount = static_cast<UINT32>(m_ShadowUnboundedCasters.size());
+    UINT32 outputSize = 0;
+    for (ShadowViewJob& job : m_ShadowViewJobs)
+    {
+        job.casters = job.bounds == &m_ShadowBounds ? m_ShadowBoundedCasters.data() : m_ShadowLocalCasters.data();
+        job.outputStart = outputSize;
+        outputSize += (job.boundsEnd - job.boundsBegin) + unboundedCount;
+    }
+    m_ShadowIndices.resize(outputSize);
+    m_ShadowViewCasters.resize(outputSize);
+    for (const ShadowViewJob& job : m_ShadowViewJobs)
+    {
+        m_Stats.shadowAABBsTested += job.boundsEnd - job.boundsBegin;
+    }
+
+    // ==================== CULL ====================
+    // One task per view, each writes only its own output range
+    m_TaskPool.run(static_cast<UINT32>(m_ShadowViewJobs.size()), [&](UINT32 v)
+    {
+        ShadowViewJob& job = m_ShadowViewJobs[v];
+        UINT32* indices = m_ShadowIndices.data() + job.outputStart;
+        UINT32* casters = m_ShadowViewCasters.data() + job.outputStart;
+
+        UINT32 survivorCount = job.frustum.cullAABBs(*job.bounds, job.boundsBegin, job.boundsEnd, indices);
+        for (UINT32 i = 0; i < survivorCount; ++i)
+        {
+            casters[i] = job.casters[indices[i]];
+        }
+        if (unboundedCount > 0)
+        {
+            memcpy(casters + survivorCount, m_ShadowUnboundedCasters.data(), unboundedCount * sizeof(UINT32));
+            survivorCount += unboundedCount;
+            std::sort(casters, casters + survivorCount);
+        }
+        job.survivorCount = survivorCount;
+
+        job.staticHash = 0;
+        job.dynamicHash = 0;
+        if (m_ShadowCacheEnabled)
+        {
+            for (UINT32 i = 0; i < survivorCount; ++i)
+            {
+                UINT64& hash = isStaticCaster(m_ShadowCasters[casters[i]]) ? job.staticHash : job.dynamicHash;
+                hash += m_ShadowCasterHashes[casters[i]];
+            }
+        }
+    });
+
+    updateShadowCache();
+
+    // ==================== EMIT ====================
+    // Views, commands and instance ranges in light order, instance data afterwards in parallel
+    m_ShadowInstanceCasters.clear();
+    for (const ShadowViewJob& job : m_ShadowViewJobs)
+    {
+        emitShadowView(job);
+    }
+
+    PerInstanceData* instances = m_PacketBuilder.getShadowInstanceData();
+    const UINT32 instanceCount = static_cast<UINT32>(m_ShadowInstanceCasters.size());
+
+    UINT32 chunkSize = 0;
+    UINT32 chunkCount = m_TaskPool.chunkCount(instanceCount, INSTANCE_CHUNK_SIZE, 1, chunkSize);
+    m_TaskPool.run(chunkCount, [&](UINT32 chunk)
+    {
+        UINT32 begin = chunk * chunkSize;
+        UINT32 end = (std::min)(begin + chunkSize, instanceCount);
+        for (UINT32 i = begin; i < end; ++i)
+        {
+            const SubmittedObject& obj = m_ShadowCasters[m_ShadowInstanceCasters[i]];
+            // Shadow pass only transforms positions, normal matrix stays identity
+            instances[i].worldMatrix = obj.worldMatrix;
+            instances[i].customData = Quark::Vec4(static_cast<float>(static_cast<UINT32>(obj.flags)), 0, 0, 0);
+        }
+    });
+
+    m_Stats.shadowViews = m_PacketBuilder.getShadowViewCount();
 }
 
-// ==================== SORTING ====================
-void RenderSystem::sortObjects()
+// ==================== SHADOW CACHE ====================
+// A view keeps last frame's version when its tile was drawn with the same matrix and
+// casters, and its static version when only dynamic casters changed. A cascade that was
+// not refitted this frame holds its matrix, so it is cached the same way as any other view.
+void RenderSystem::updateShadowCache()
 {
-    auto isTransparent = [this](hMaterial matHandle) -> bool
-    {
-        auto it = m_Materials.find(matHandle);
-        if (it == m_Materials.end()) return false;
-        return (static_cast<MaterialFlags>(it->second.data.flags) & MaterialFlags::ALPHA_BLEND) != MaterialFlags::NONE;
-    };
+    m_NextShadowTiles.clear();
 
-    for (auto& obj : m_VisibleObjects)
+    // Tiles two views draw into in the same frame are never cached
+    for (ShadowViewJob& job : m_ShadowViewJobs)
     {
-        obj.sortKey = calculateSortKey(obj.material, obj.sortDistance);
+        job.tileKey = getShadowTileKey(job.type, job.slot, job.atlasRect);
+        bool inserted = false;
+        if (ShadowTileContent* content = m_NextShadowTiles.insert(job.tileKey, &inserted))
+            content->version = inserted ? 1 : 0;
     }
 
-    std::sort(m_VisibleObjects.begin(), m_VisibleObjects.end(),
-        [&isTransparent](const SubmittedObject& a, const SubmittedObject& b)
+    for (ShadowViewJob& job : m_ShadowViewJobs)
+    {
+        ShadowTileContent* next = m_NextShadowTiles.find(job.tileKey);
+        if (!m_ShadowCacheEnabled || !next || next->version == 0)
         {
-            bool aTransparent = isTransparent(a.material);
-            bool bTransparent = isTransparent(b.material);
-            
-            if (aTransparent != bTransparent)
-                return !aTransparent;
-            
-            if (aTransparent)
-            {
-                return a.sortDistance > b.sortDistance;
-            }
-            else
-            {
-                if (a.material != b.material)
-                    return a.material < b.material;
-                
-                if (a.mesh != b.mesh)
-                    return a.mesh < b.mesh;
-                
-                if (a.material != b.material)
-                    return a.material < b.material;
-                
-                if (a.mesh != b.mesh)
-                    return a.mesh < b.mesh;
-                
-                return a.sortDistance < b.sortDistance;
-            }
-        });
+            job.cacheVersion = 0;
+            job.staticCacheVersion = 0;
+            continue;
+        }
+        ShadowTileContent& content = *next;
+
+        const ShadowTileContent* previous = m_ShadowTiles.find(job.tileKey);
+        const bool sameMatrix = previous && previous->version != 0 &&
+                                memcmp(&previous->viewProjection, &job.viewProjection, sizeof(Quark::Mat4)) == 0;
+        const bool sameStatic = sameMatrix && previous->staticHash == job.staticHash;
+        const bool sameView = sameStatic && previous->dynamicHash == job.dynamicHash;
+
+        job.staticCacheVersion = sameStatic ? previous->staticVersion : ++m_ShadowCacheVersion;
+        job.cacheVersion = sameView ? previous->version : ++m_ShadowCacheVersion;
+
+        content.viewProjection = job.viewProjection;
+        content.staticHash = job.staticHash;
+        content.dynamicHash = job.dynamicHash;
+        content.version = job.cacheVersion;
+        content.staticVersion = job.staticCacheVersion;
+
+        if (sameView)
+            m_Stats.shadowViewsCached++;
+        else if (sameStatic)
+            m_Stats.shadowViewsStaticCached++;
+    }
+
+    m_ShadowTiles.swap(m_NextShadowTiles);
 }
 
-// ==================== BATCHING ====================
-void RenderSystem::buildBatches()
+void RenderSystem::emitShadowView(const ShadowViewJob& job)
 {
-    if (m_VisibleObjects.empty()) return;
+    const UINT32* casters = m_ShadowViewCasters.data() + job.outputStart;
 
-    hMesh currentMesh = 0;
-    hMaterial currentMaterial = 0;
-    std::vector<PerInstanceData> currentInstances;
-    
-    auto flushBatch = [&]()
+    m_PacketBuilder.beginShadowView(job.type, job.slot, job.viewProjection, job.atlasRect, job.cacheVersion, job.staticCacheVersion);
+
+    // Static casters come first, runs never cross into the dynamic layer
+    bool inStaticLayer = true;
+    bool complete = true;
+    UINT32 runStart = 0;
+    while (runStart < job.survivorCount)
     {
-        if (currentInstances.empty()) return;
-        
-        auto meshIt = m_Meshes.find(currentMesh);
-        auto matIt = m_Materials.find(currentMaterial);
-        
-        if (meshIt == m_Meshes.end() || matIt == m_Materials.end())
+        const SubmittedObject& first = m_ShadowCasters[casters[runStart]];
+        const bool isStatic = isStaticCaster(first);
+        if (inStaticLayer && !isStatic)
         {
-            currentInstances.clear();
-            return;
+            m_PacketBuilder.endShadowViewStaticLayer();
+            inStaticLayer = false;
         }
-        
-        UINT32 instanceStart = m_PacketBuilder.addInstances(
-            currentInstances.data(), 
-            static_cast<UINT32>(currentInstances.size())
-        );
-        
+
+        UINT32 runEnd = runStart + 1;
+        while (runEnd < job.survivorCount &&
+               m_ShadowCasters[casters[runEnd]].mesh == first.mesh &&
+               m_ShadowCasters[casters[runEnd]].material == first.material &&
+               isStaticCaster(m_ShadowCasters[casters[runEnd]]) == isStatic)
+        {
+            ++runEnd;
+        }
+        const UINT32 runLength = runEnd - runStart;
+
+        UINT32 instanceStart = first.mesh != 0 ? m_PacketBuilder.reserveShadowInstances(runLength) : UINT32_MAX;
         if (instanceStart != UINT32_MAX)
         {
+            m_ShadowInstanceCasters.insert(m_ShadowInstanceCasters.end(), casters + runStart, casters + runEnd);
+
+            const MeshResource* mesh = m_Meshes.get(first.mesh);
+            const MaterialResource* material = m_Materials.get(first.material);
+
             DrawCommand cmd = {};
-            cmd.mesh = meshIt->second.gpuHandle;
-            cmd.material = matIt->second.gpuHandle;
+            cmd.mesh = mesh ? mesh->gpuHandle : 0;
+            cmd.material = material ? material->gpuHandle : 0;
             cmd.instanceStart = instanceStart;
-            cmd.instanceCount = static_cast<UINT32>(currentInstances.size());
+            cmd.instanceCount = runLength;
             cmd.sortKey = 0;
-            
-            m_PacketBuilder.addDrawCommand(cmd);
-            m_Stats.drawCalls++;
-        }
-        
-        currentInstances.clear();
-    };
 
-    for (const auto& obj : m_VisibleObjects)
-    {
-        if (obj.mesh != currentMesh || obj.material != currentMaterial)
-        {
-            flushBatch();
-            currentMesh = obj.mesh;
-            currentMaterial = obj.material;
+            if (m_PacketBuilder.addShadowDrawCommand(cmd))
+            {
+                m_Stats.shadowMapDrawCalls++;
+                m_Stats.shadowInstances += cmd.instanceCount;
+                m_Stats.batchesMerged += cmd.instanceCount - 1;
+            }
+            else
+            {
+                complete = false;
+            }
+            m_Stats.instancesWritten += runLength;
         }
-        
-        PerInstanceData instance = {};
-        instance.worldMatrix = obj.worldMatrix;
-        instance.worldInvTranspose = obj.worldMatrix.Inverted();
-        instance.customData = Quark::Vec4(static_cast<float>(static_cast<UINT32>(obj.flags)), 0, 0, 0);
-        
-        currentInstances.push_back(instance);
-        
-        auto meshIt = m_Meshes.find(obj.mesh);
-        if (meshIt != m_Meshes.end())
+        else if (first.mesh != 0)
         {
-            m_Stats.trianglesRendered += meshIt->second.data.indexCount / 3;
+            complete = false;
         }
+
+        runStart = runEnd;
     }
-    
-    flushBatch();
-    
-    hMesh shadowCurrentMesh = 0;
-    hMaterial shadowCurrentMaterial = 0;
-    std::vector<PerInstanceData> shadowCurrentInstances;
-    shadowCurrentInstances.reserve(64);
-    
-    auto flushShadowBatch = [&]()
+
+    if (inStaticLayer)
     {
-        if (shadowCurrentInstances.empty() || shadowCurrentMesh == 0) return;
-        
-        UINT32 instanceStart = m_PacketBuilder.addShadowInstances(shadowCurrentInstances.data(), 
-                                                                   static_cast<UINT32>(shadowCurrentInstances.size()));
-        if (instanceStart != UINT32_MAX)
-        {
-            DrawCommand cmd = {};
-            
-            auto meshIt = m_Meshes.find(shadowCurrentMesh);
-            auto matIt = m_Materials.find(shadowCurrentMaterial);
-            
-            cmd.mesh = (meshIt != m_Meshes.end()) ? meshIt->second.gpuHandle : 0;
-            cmd.material = (matIt != m_Materials.end()) ? matIt->second.gpuHandle : 0;
-            cmd.instanceStart = instanceStart;
-            cmd.instanceCount = static_cast<UINT32>(shadowCurrentInstances.size());
-            cmd.sortKey = 0;
-            
-            m_PacketBuilder.addShadowDrawCommand(cmd);
-        }
-        
-        shadowCurrentInstances.clear();
+        m_PacketBuilder.endShadowViewStaticLayer();
+    }
+    // Casters dropped at the packet limits are still in the view's hashes
+    if (!complete)
+    {
+        m_PacketBuilder.uncacheShadowView();
+    }
+    m_PacketBuilder.endShadowView();
+}
+
+// ==================== LIGHT CULLING ====================
+static Quark::Sphere getLightSphere(const LightResource& light)
+{
+    if (light.type == LightType::SPOT)
+        return computeConeBoundingSphere(light.spot.position, light.spot.direction.Normalized(), light.spot.range, light.spot.outerCutoff);
+    return Quark::Sphere(light.point.position, light.point.range);
+}
+
+// Tight test for tree leaves straddling a plane: bounding sphere, then the spot cone
+static bool lightIntersectsFrustum(const LightResource& light, const Quark::Sphere& sphere, const Frustum& frustum)
+{
+    if (!frustum.intersectsSphere(sphere)) return false;
+    if (light.type != LightType::SPOT || light.spot.outerCutoff <= 0.0f) return true;
+
+    return frustum.intersectsCone(light.spot.position, light.spot.direction.Normalized(), light.spot.range,
+                                  computeConeBaseRadius(light.spot.range, light.spot.outerCutoff));
+}
+
+// Importance is screen coverage (squared fraction of the screen height the bounding
+// sphere spans) times brightness, over distance. Lights around the camera are measured
+// as if it sat on the sphere, which covers the whole screen.
+static VisibleLight rankLight(hLight handle, const Quark::Sphere& sphere, const Quark::Color& color, float intensity, const Camera& camera)
+{
+    float distance = camera.position.Distance(sphere.center);
+    float halfHeight = camera.projectionType == ProjectionType::Orthographic
+        ? camera.orthoHeight * 0.5f
+        : (std::max)(distance, sphere.radius) * std::tan(camera.fov * 0.5f);
+
+    VisibleLight visible = {};
+    visible.handle = handle;
+    visible.screenSize = sphere.radius / halfHeight;
+
+    float coverage = (std::min)(visible.screenSize * visible.screenSize, 1.0f);
+    float brightness = intensity * (std::max)(color.r, (std::max)(color.g, color.b));
+    visible.importance = coverage * brightness / (std::max)(distance, camera.nearPlane);
+    return visible;
+}
+
+void RenderSystem::cullLights()
+{
+    QUARK_PROFILE_ZONE("RenderSystem::cullLights");
+
+    m_VisibleLights.clear();
+    const Frustum& frustum = m_pActiveCamera->frustum;
+
+    m_LightTree.cullFrustum(frustum, m_CullStack, [&](hLight handle, bool fullyInside)
+    {
+        const LightResource* light = m_Lights.get(handle);
+        const bool isSpot = light->type == LightType::SPOT;
+        const UINT32 flags = isSpot ? light->spot.flags : light->point.flags;
+        if (!light->isActive || !(flags & static_cast<UINT32>(LightFlags::LIGHT_ENABLED))) return;
+
+        Quark::Sphere sphere = getLightSphere(*light);
+        if (!fullyInside && !lightIntersectsFrustum(*light, sphere, frustum)) return;
+
+        m_VisibleLights.push_back(isSpot
+            ? rankLight(handle, sphere, light->spot.color, light->spot.intensity, *m_pActiveCamera)
+            : rankLight(handle, sphere, light->point.color, light->point.intensity, *m_pActiveCamera));
+    });
+
+    // Handles break ties so the order does not depend on the tree layout
+    auto moreImportant = [](const VisibleLight& a, const VisibleLight& b)
+    {
+        return a.importance != b.importance ? a.importance > b.importance : a.handle < b.handle;
     };
 
-    for (const auto& obj : m_ShadowCasters)
+    const UINT32 visibleCount = static_cast<UINT32>(m_VisibleLights.size());
+    if (visibleCount > m_LightBudget)
     {
-        if (obj.mesh != shadowCurrentMesh || obj.material != shadowCurrentMaterial)
-        {
-            flushShadowBatch();
-            shadowCurrentMesh = obj.mesh;
-            shadowCurrentMaterial = obj.material;
-        }
-        
-        PerInstanceData instance = {};
-        instance.worldMatrix = obj.worldMatrix;
-        instance.worldInvTranspose = obj.worldMatrix.Inverted();
-        instance.customData = Quark::Vec4(static_cast<float>(static_cast<UINT32>(obj.flags)), 0, 0, 0);
-        
-        shadowCurrentInstances.push_back(instance);
+        std::nth_element(m_VisibleLights.begin(), m_VisibleLights.begin() + m_LightBudget, m_VisibleLights.end(), moreImportant);
+        m_VisibleLights.resize(m_LightBudget);
     }
-    
-    flushShadowBatch();
-}
+    std::sort(m_VisibleLights.begin(), m_VisibleLights.end(), moreImportant);
 
+    m_Stats.lightsVisible = visibleCount;
+    m_Stats.lightsCulled = m_LightTree.getLeafCount() - visibleCount;
+    m_Stats.lightsOverBudget = visibleCount - static_cast<UINT32>(m_VisibleLights.size());
+}
 
 // ==================== BUILD FRAME PACKET ====================
 FramePacket RenderSystem::buildFramePacket()
 {
+    QUARK_PROFILE_ZONE("RenderSystem::buildFramePacket");
+
+    auto stageStart = std::chrono::steady_clock::now();
+
     FrameConstants constants = {};
     constants.view = m_pActiveCamera->view;
     constants.projection = m_pActiveCamera->projection;
@@ -358,68 +1346,160 @@ FramePacket RenderSystem::buildFramePacket()
     constants.time = m_Time;
     constants.ambientLight = m_AmbientLight;
     constants.deltaTime = m_DeltaTime;
+    constants.clusterTileScaleX = m_ViewportWidth > 0 ? static_cast<float>(LIGHT_CLUSTER_GRID_X) / m_ViewportWidth : 0.0f;
+    constants.clusterTileScaleY = m_ViewportHeight > 0 ? static_cast<float>(LIGHT_CLUSTER_GRID_Y) / m_ViewportHeight : 0.0f;
     
-    m_PacketBuilder.setFrameConstants(constants);
     m_PacketBuilder.setClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]);
     m_PacketBuilder.setViewport(m_ViewportWidth, m_ViewportHeight);
     
-    std::unordered_map<hMaterial, bool> usedMaterials;
+    // Each material is added once, tagged with the frame it was last added in
     for (const auto& obj : m_VisibleObjects)
     {
-        if (usedMaterials.find(obj.material) == usedMaterials.end())
+        MaterialResource* material = m_Materials.get(obj.material);
+        if (material && material->lastUsedFrame != m_FrameIndex)
         {
-            auto it = m_Materials.find(obj.material);
-            if (it != m_Materials.end())
-            {
-                m_PacketBuilder.addMaterial(it->first, it->second.data);
-                usedMaterials[obj.material] = true;
-            }
+            m_PacketBuilder.addMaterial(obj.material, material->data);
+            material->lastUsedFrame = m_FrameIndex;
         }
     }
     
+    endStage(RenderStage::PACKET, stageStart);
+
     // Sync SkySettings with active directional light
     SkySettings skyForFrame = m_SkySettings;
     
-    for (const auto& pair : m_Lights)
+    // Directional lights lead the packet's light array, the first shadowed one owns the cascades
+    bool cascadesFitted = false;
+    for (const auto& light : m_Lights)
     {
-        if (!pair.second.isActive) continue;
+        if (!light.isActive || light.type != LightType::DIRECTIONAL) continue;
+        
+        // Sync sun direction and intensity from directional light
+        skyForFrame.sunDirection = light.directional.direction.Normalized();
+        skyForFrame.sunIntensity = light.directional.intensity;
         
-        switch (pair.second.type)
+        CSMData csm = {};
+        if ((light.directional.flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && !cascadesFitted &&
+            m_PacketBuilder.getCurrentLightCount() < MAX_DIRECTIONAL_LIGHTS)
         {
-        case LightType::DIRECTIONAL:
-            {
-                // Sync sun direction and intensity from directional light
-                skyForFrame.sunDirection = pair.second.directional.direction.Normalized();
-                skyForFrame.sunIntensity = pair.second.directional.intensity;
-                
-                // Add light to packet
-                m_PacketBuilder.addDirectionalLight(pair.second.directional, *m_pActiveCamera);
-            }
-            break;
-        case LightType::POINT:
-            m_PacketBuilder.addPointLight(pair.second.point);
-            break;
-        case LightType::SPOT:
-            m_PacketBuilder.addSpotLight(pair.second.spot);
-            break;
+            csm = updateCSM(m_CSMState, *m_pActiveCamera, light.directional.direction, m_CSMSceneBounds,
+                            m_FrameIndex, m_CascadeUpdateInterval);
+            cascadesFitted = true;
+            m_Stats.cascadesUpdated = static_cast<UINT32>(std::popcount(m_CSMState.updatedMask));
+        }
+        m_PacketBuilder.addDirectionalLight(light.directional, csm);
+    }
+    if (!cascadesFitted)
+        m_CSMState = {};
+    
+    // Point and spot lights go in by importance, the most important casters get shadow tiles first
+    cullLights();
+
+    // Shadow tiles follow the light's height on screen (a cube face sees about half of it),
+    // scaled down together when the shadow casters would not fit the atlas
+    auto getWantedShadowSize = [this](const VisibleLight& visible, bool isPoint)
+    {
+        const float size = visible.screenSize * static_cast<float>(m_ViewportHeight) * (isPoint ? 0.5f : 1.0f);
+        return std::clamp(size, static_cast<float>(LOCAL_SHADOW_MIN_TILE_SIZE), static_cast<float>(LOCAL_SHADOW_MAX_TILE_SIZE));
+    };
+
+    double wantedTexels = 0.0;
+    UINT32 shadowLightCount = 0;
+    for (const VisibleLight& visible : m_VisibleLights)
+    {
+        if (shadowLightCount == MAX_LOCAL_SHADOW_LIGHTS) break;
+
+        const LightResource* light = m_Lights.get(visible.handle);
+        const bool isPoint = light->type == LightType::POINT;
+        const UINT32 flags = isPoint ? light->point.flags : light->spot.flags;
+        if (!(flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS))) continue;
+
+        const double size = getWantedShadowSize(visible, isPoint);
+        wantedTexels += size * size * (isPoint ? POINT_SHADOW_FACE_COUNT : 1);
+        shadowLightCount++;
+    }
+
+    const double budgetTexels = static_cast<double>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE) * LOCAL_LIGHT_SHADOW_ATLAS_SIZE * SHADOW_ATLAS_BUDGET_FILL;
+    const float shadowSizeScale = wantedTexels > budgetTexels ? static_cast<float>(std::sqrt(budgetTexels / wantedTexels)) : 1.0f;
+
+    m_ShadowAtlas.beginFrame(m_FrameIndex);
+    shadowLightCount = 0;
+    for (const VisibleLight& visible : m_VisibleLights)
+    {
+        const LightResource* light = m_Lights.get(visible.handle);
+        const bool isPoint = light->type == LightType::POINT;
+        const UINT32 flags = isPoint ? light->point.flags : light->spot.flags;
+
+        const ShadowAtlasTile* shadowTiles = nullptr;
+        if ((flags & static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS)) && shadowLightCount < MAX_LOCAL_SHADOW_LIGHTS)
+        {
+            const float wantedSize = getWantedShadowSize(visible, isPoint) * shadowSizeScale;
+            shadowTiles = m_ShadowAtlas.request(visible.handle, isPoint ? POINT_SHADOW_FACE_COUNT : 1, wantedSize);
+            shadowLightCount += shadowTiles ? 1 : 0;
         }
+
+        if (isPoint)
+            m_PacketBuilder.addPointLight(light->point, shadowTiles);
+        else
+            m_PacketBuilder.addSpotLight(light->spot, shadowTiles);
     }
+    m_ShadowAtlas.endFrame();
+
+    m_Stats.localShadowLights = shadowLightCount;
+    m_Stats.shadowTilesAllocated = m_ShadowAtlas.getTilesAllocated();
+    m_Stats.shadowAtlasUsage = m_ShadowAtlas.getUsage();
+    
+    // Bin point and spot lights into the camera's clusters
+    m_LightClusters.build(*m_pActiveCamera, m_PacketBuilder.getLights(), m_PacketBuilder.getCurrentLightCount(), m_TaskPool);
+    m_LightClusters.write(m_PacketBuilder.reserveLightClusters(),
+                          m_PacketBuilder.reserveClusterLightIndices(m_LightClusters.getIndexCount()));
+    
+    constants.clusterDepthScale = m_LightClusters.getDepthScale();
+    constants.clusterDepthBias = m_LightClusters.getDepthBias();
+    m_PacketBuilder.setFrameConstants(constants);
+    
+    m_Stats.lightsClustered = m_LightClusters.getBinnedLightCount();
+    m_Stats.clusterLightRefs = m_LightClusters.getIndexCount();
+    m_Stats.maxClusterLights = m_LightClusters.getMaxClusterLights();
+    
+    endStage(RenderStage::LIGHTS, stageStart);
+
+    // Shadow views need the light matrices the builder just computed
+    buildShadowViews();
+    endStage(RenderStage::SHADOWS, stageStart);
     
     // Set sky settings with synced sun data
     m_PacketBuilder.setSkySettings(skyForFrame);
     
-    return m_PacketBuilder.build();
+    FramePacket packet = m_PacketBuilder.build();
+    endStage(RenderStage::PACKET, stageStart);
+    return packet;
 }
 
 // ==================== UTILITY ====================
-UINT32 RenderSystem::calculateSortKey(hMaterial material, float distance)
+UINT64 RenderSystem::calculateSortKey(const SubmittedObject& obj)
 {
-    UINT32 matKey = (material & 0xFFFF) << 16;
-    UINT32 distKey = static_cast<UINT32>(distance * 10.0f) & 0xFFFF;
-    return matKey | distKey;
+    // Slot indices are unique among live resources, the generation bits are dropped
+    UINT32 materialId = obj.material & Quark::SlotMap<MaterialResource>::INDEX_MASK;
+    UINT32 meshId = obj.mesh & Quark::SlotMap<MeshResource>::INDEX_MASK;
+    return packSortKey(0, obj.transparent, materialId, meshId, obj.sortDistance);
 }
 
 // ==================== MESH MANAGEMENT ====================
+static void copyOcclusionGeometry(MeshResource& resource, const MeshData& meshData)
+{
+    resource.cpuPositions.resize(meshData.vertexCount);
+    for (UINT32 i = 0; i < meshData.vertexCount; ++i)
+    {
+        resource.cpuPositions[i] = meshData.vertices[i].position;
+    }
+
+    if (meshData.indices && meshData.indexCount > 0)
+        resource.cpuIndices.assign(meshData.indices, meshData.indices + meshData.indexCount);
+    else
+        resource.cpuIndices.clear();
+}
+
 hMesh RenderSystem::createMesh(const MeshData& meshData, bool isDynamic)
 {
     if (!m_pRhi)
@@ -441,23 +1521,28 @@ hMesh RenderSystem::createMesh(const MeshData& meshData, bool isDynamic)
         return 0;
     }
     
-    hMesh localHandle = m_NextMeshHandle++;
-    
     MeshResource resource = {};
     resource.data = meshData;
     resource.gpuHandle = gpuHandle;
     resource.isDynamic = isDynamic;
     resource.localBounds = meshData.boundingBox;
+    copyOcclusionGeometry(resource, meshData);
     
-    m_Meshes[localHandle] = resource;
+    hMesh localHandle = m_Meshes.insert(std::move(resource));
+    if (localHandle == 0)
+    {
+        std::cerr << "[RenderSystem] ERROR: Mesh storage is full.\n";
+        m_pRhi->destroyMeshBuffer(gpuHandle);
+        return 0;
+    }
     
     return localHandle;
 }
 
 void RenderSystem::destroyMesh(hMesh handle)
 {
-    auto it = m_Meshes.find(handle);
-    if (it == m_Meshes.end())
+    const MeshResource* mesh = m_Meshes.get(handle);
+    if (!mesh)
     {
         std::cerr << "[RenderSystem] WARNING: Mesh handle not found.\n";
         return;
@@ -465,31 +1550,40 @@ void RenderSystem::destroyMesh(hMesh handle)
     
     if (m_pRhi)
     {
-        m_pRhi->destroyMeshBuffer(it->second.gpuHandle);
+        m_pRhi->destroyMeshBuffer(mesh->gpuHandle);
     }
     
-    m_Meshes.erase(it);
+    m_Meshes.remove(handle);
 }
 
 bool RenderSystem::updateMesh(hMesh handle, const MeshData& meshData)
 {
-    auto it = m_Meshes.find(handle);
-    if (it == m_Meshes.end())
+    MeshResource* mesh = m_Meshes.get(handle);
+    if (!mesh)
     {
         std::cerr << "[RenderSystem] ERROR: Mesh handle not found.\n";
         return false;
     }
     
-    if (!it->second.isDynamic)
+    if (!mesh->isDynamic)
     {
         std::cerr << "[RenderSystem] ERROR: Cannot update static mesh.\n";
         return false;
     }
     
-    if (m_pRhi && m_pRhi->updateMeshBuffer(it->second.gpuHandle, meshData))
+    if (m_pRhi && m_pRhi->updateMeshBuffer(mesh->gpuHandle, meshData))
     {
-        it->second.data = meshData;
-        it->second.localBounds = meshData.boundingBox;
+        mesh->data = meshData;
+        mesh->revision++;
+        mesh->localBounds = meshData.boundingBox;
+        copyOcclusionGeometry(*mesh, meshData);
+
+        // Proxy world bounds derive from the mesh bounds
+        for (size_t i = 0; i < m_Proxies.size(); ++i)
+        {
+            RenderProxy& proxy = m_Proxies.data()[i];
+            if (proxy.object.mesh == handle) markProxyDirty(m_Proxies.handleAt(i), proxy);
+        }
         return true;
     }
     
@@ -512,21 +1606,26 @@ hMaterial RenderSystem::createMaterial(const MaterialData& materialData)
         return 0;
     }
     
-    hMaterial localHandle = m_NextMaterialHandle++;
-    
     MaterialResource resource = {};
     resource.data = materialData;
     resource.gpuHandle = gpuHandle;
+    resource.lastUsedFrame = UINT32_MAX;
     
-    m_Materials[localHandle] = resource;
+    hMaterial localHandle = m_Materials.insert(resource);
+    if (localHandle == 0)
+    {
+        std::cerr << "[RenderSystem] ERROR: Material storage is full.\n";
+        m_pRhi->destroyMaterialBuffer(gpuHandle);
+        return 0;
+    }
     
     return localHandle;
 }
 
 void RenderSystem::destroyMaterial(hMaterial handle)
 {
-    auto it = m_Materials.find(handle);
-    if (it == m_Materials.end())
+    const MaterialResource* material = m_Materials.get(handle);
+    if (!material)
     {
         std::cerr << "[RenderSystem] WARNING: Material handle not found.\n";
         return;
@@ -534,24 +1633,31 @@ void RenderSystem::destroyMaterial(hMaterial handle)
     
     if (m_pRhi)
     {
-        m_pRhi->destroyMaterialBuffer(it->second.gpuHandle);
+        m_pRhi->destroyMaterialBuffer(material->gpuHandle);
     }
     
-    m_Materials.erase(it);
+    m_Materials.remove(handle);
 }
 
 bool RenderSystem::updateMaterial(hMaterial handle, const MaterialData& materialData)
 {
-    auto it = m_Materials.find(handle);
-    if (it == m_Materials.end())
+    MaterialResource* material = m_Materials.get(handle);
+    if (!material)
     {
         std::cerr << "[RenderSystem] ERROR: Material handle not found.\n";
         return false;
     }
     
-    if (m_pRhi && m_pRhi->updateMaterialBuffer(it->second.gpuHandle, materialData))
+    if (m_pRhi && m_pRhi->updateMaterialBuffer(material->gpuHandle, materialData))
     {
-        it->second.data = materialData;
+        material->data = materialData;
+
+        // Blend flags feed the cached proxy sort keys
+        for (size_t i = 0; i < m_Proxies.size(); ++i)
+        {
+            RenderProxy& proxy = m_Proxies.data()[i];
+            if (proxy.object.material == handle) markProxyDirty(m_Proxies.handleAt(i), proxy);
+        }
         return true;
     }
     
@@ -574,16 +1680,21 @@ hTexture RenderSystem::loadTexture(const char* filename)
         return 0;
     }
     
-    hTexture localHandle = m_NextTextureHandle++;
-    m_Textures[localHandle] = gpuHandle;
+    hTexture localHandle = m_Textures.insert(gpuHandle);
+    if (localHandle == 0)
+    {
+        std::cerr << "[RenderSystem] ERROR: Texture storage is full.\n";
+        m_pRhi->destroyTexture(gpuHandle);
+        return 0;
+    }
     
     return localHandle;
 }
 
 void RenderSystem::destroyTexture(hTexture handle)
 {
-    auto it = m_Textures.find(handle);
-    if (it == m_Textures.end())
+    const hTexture* gpuHandle = m_Textures.get(handle);
+    if (!gpuHandle)
     {
         std::cerr << "[RenderSystem] WARNING: Texture handle not found.\n";
         return;
@@ -591,23 +1702,23 @@ void RenderSystem::destroyTexture(hTexture handle)
     
     if (m_pRhi)
     {
-        m_pRhi->destroyTexture(it->second);
+        m_pRhi->destroyTexture(*gpuHandle);
     }
     
-    m_Textures.erase(it);
+    m_Textures.remove(handle);
 }
 
 bool RenderSystem::setMaterialTexture(hMaterial material, hTexture texture, UINT32 slot)
 {
-    auto matIt = m_Materials.find(material);
-    if (matIt == m_Materials.end())
+    const MaterialResource* materialResource = m_Materials.get(material);
+    if (!materialResource)
     {
         std::cerr << "[RenderSystem] ERROR: Material handle not found.\n";
         return false;
     }
     
-    auto texIt = m_Textures.find(texture);
-    if (texIt == m_Textures.end())
+    const hTexture* gpuTexture = m_Textures.get(texture);
+    if (!gpuTexture)
     {
         std::cerr << "[RenderSystem] ERROR: Texture handle not found.\n";
         return false;
@@ -615,7 +1726,7 @@ bool RenderSystem::setMaterialTexture(hMaterial material, hTexture texture, UINT
     
     if (m_pRhi)
     {
-        return m_pRhi->bindTextureToMaterial(matIt->second.gpuHandle, texIt->second, slot);
+        return m_pRhi->bindTextureToMaterial(materialResource->gpuHandle, *gpuTexture, slot);
     }
     
     return false;
@@ -628,14 +1739,93 @@ void RenderSystem::submit(const RenderObject& obj)
     submitted.mesh = obj.mesh;
     submitted.material = obj.material;
     submitted.worldMatrix = obj.worldMatrix;
+    submitted.matrixType = obj.worldMatrix.Classify();
     submitted.worldBounds = obj.worldAABB;
     submitted.flags = obj.flags;
     submitted.sortDistance = 0.0f;
     submitted.sortKey = 0;
+    submitted.transparent = false;
+    submitted.proxy = 0;
     
     m_SubmittedObjects.push_back(submitted);
 }
 
+// ==================== RENDER PROXIES ====================
+hRenderProxy RenderSystem::createRenderProxy(const RenderObject& obj)
+{
+    RenderProxy proxy = {};
+    proxy.object.mesh = obj.mesh;
+    proxy.object.material = obj.material;
+    proxy.object.worldMatrix = obj.worldMatrix;
+    proxy.object.flags = obj.flags;
+    proxy.treeNode = BVH_NULL_NODE;
+    proxy.staticCulled = false;
+    proxy.dirty = false;
+
+    hRenderProxy handle = m_Proxies.insert(proxy);
+    if (handle == 0)
+    {
+        std::cerr << "[RenderSystem] ERROR: Render proxy storage is full.\n";
+        return 0;
+    }
+
+    RenderProxy* stored = m_Proxies.get(handle);
+    stored->object.proxy = handle;
+    markProxyDirty(handle, *stored);
+
+    return handle;
+}
+
+void RenderSystem::updateProxyTransform(hRenderProxy handle, const Quark::Mat4& worldMatrix)
+{
+    RenderProxy* proxy = m_Proxies.get(handle);
+    if (!proxy)
+    {
+        std::cerr << "[RenderSystem] WARNING: Render proxy handle not found.\n";
+        return;
+    }
+
+    proxy->object.worldMatrix = worldMatrix;
+    markProxyDirty(handle, *proxy);
+}
+
+void RenderSystem::updateRenderProxy(hRenderProxy handle, const RenderObject& obj)
+{
+    RenderProxy* proxy = m_Proxies.get(handle);
+    if (!proxy)
+    {
+        std::cerr << "[RenderSystem] WARNING: Render proxy handle not found.\n";
+        return;
+    }
+
+    proxy->object.mesh = obj.mesh;
+    proxy->object.material = obj.material;
+    proxy->object.worldMatrix = obj.worldMatrix;
+    proxy->object.flags = obj.flags;
+    markProxyDirty(handle, *proxy);
+}
+
+void RenderSystem::destroyRenderProxy(hRenderProxy handle)
+{
+    const RenderProxy* proxy = m_Proxies.get(handle);
+    if (!proxy)
+    {
+        std::cerr << "[RenderSystem] WARNING: Render proxy handle not found.\n";
+        return;
+    }
+
+    if (proxy->treeNode != BVH_NULL_NODE)
+    {
+        m_ProxyTree.remove(proxy->treeNode);
+    }
+    if (proxy->staticCulled)
+    {
+        m_StaticProxiesChanged = true;
+    }
+
+    m_Proxies.remove(handle);
+}
+
 // ==================== CAMERA ====================
 void RenderSystem::setActiveCamera(Camera* camera)
 {
@@ -671,13 +1861,81 @@ const SkySettings& RenderSystem::getSkySettings() const
     return m_SkySettings;
 }
 
+void RenderSystem::setOcclusionCulling(bool enabled)
+{
+    m_OcclusionEnabled = enabled;
+}
+
+bool RenderSystem::getOcclusionCulling() const
+{
+    return m_OcclusionEnabled;
+}
+
+void RenderSystem::setWorkerThreadCount(UINT32 count)
+{
+    m_TaskPool.setThreadCount(count);
+}
+
+UINT32 RenderSystem::getWorkerThreadCount() const
+{
+    return m_TaskPool.getThreadCount();
+}
+
+void RenderSystem::setJobSystem(JobSystemAPI* jobSystem)
+{
+    m_TaskPool.setJobSystem(jobSystem);
+}
+
+void RenderSystem::setFramesInFlight(UINT32 count)
+{
+    // Arenas left out of a smaller ring keep their fence and are checked again if it grows
+    m_FramesInFlight = std::clamp<UINT32>(count, 1, MAX_FRAMES_IN_FLIGHT);
+}
+
+UINT32 RenderSystem::getFramesInFlight() const
+{
+    return m_FramesInFlight;
+}
+
+void RenderSystem::setLightBudget(UINT32 count)
+{
+    // Directional lights share the packet's light array
+    m_LightBudget = (std::min)(count, MAX_LIGHTS - MAX_DIRECTIONAL_LIGHTS);
+}
+
+UINT32 RenderSystem::getLightBudget() const
+{
+    return m_LightBudget;
+}
+
+void RenderSystem::setShadowCaching(bool enabled)
+{
+    m_ShadowCacheEnabled = enabled;
+    m_ShadowTiles.clear();
+}
+
+bool RenderSystem::getShadowCaching() const
+{
+    return m_ShadowCacheEnabled;
+}
+
+void RenderSystem::setCascadeUpdateInterval(UINT32 frames)
+{
+    m_CascadeUpdateInterval = std::clamp(frames, 1u, CSM_MAX_UPDATE_INTERVAL);
+}
+
+UINT32 RenderSystem::getCascadeUpdateInterval() const
+{
+    return m_CascadeUpdateInterval;
+}
+
 // ==================== LIGHTING ====================
 hLight RenderSystem::createDirectionalLight(const DirectionalLight& data)
 {
     UINT32 count = 0;
-    for (const auto& pair : m_Lights)
+    for (const auto& light : m_Lights)
     {
-        if (pair.second.type == LightType::DIRECTIONAL) count++;
+        if (light.type == LightType::DIRECTIONAL) count++;
     }
 
     if (count >= MAX_DIRECTIONAL_LIGHTS)
@@ -686,97 +1944,94 @@ hLight RenderSystem::createDirectionalLight(const DirectionalLight& data)
         return 0;
     }
 
-    hLight handle = m_NextLightHandle++;
-    
     LightResource resource = {};
     resource.type = LightType::DIRECTIONAL;
     resource.directional = data;
     resource.isActive = true;
     
-    m_Lights[handle] = resource;
-    return handle;
+    return m_Lights.insert(resource);
 }
 
 hLight RenderSystem::createPointLight(const PointLight& data)
 {
-    UINT32 count = 0;
-    for (const auto& pair : m_Lights)
+    if (m_Lights.size() >= MAX_SCENE_LIGHTS)
     {
-        if (pair.second.type == LightType::POINT) count++;
-    }
-
-    if (count >= MAX_POINT_LIGHTS)
-    {
-        std::cerr << "[RenderSystem] ERROR: Cannot create Point Light. Limit reached (" << MAX_POINT_LIGHTS << ").\n";
+        std::cerr << "[RenderSystem] ERROR: Cannot create Point Light. Limit reached (" << MAX_SCENE_LIGHTS << ").\n";
         return 0;
     }
 
-    hLight handle = m_NextLightHandle++;
-    
     LightResource resource = {};
     resource.type = LightType::POINT;
     resource.point = data;
     resource.isActive = true;
     
-    m_Lights[handle] = resource;
+    hLight handle = m_Lights.insert(resource);
+    if (handle != 0)
+    {
+        m_Lights.get(handle)->treeNode = m_LightTree.insert(computePointLightAABB(data), handle);
+    }
     return handle;
 }
 
 hLight RenderSystem::createSpotLight(const SpotLight& data)
 {
-    UINT32 count = 0;
-    for (const auto& pair : m_Lights)
-    {
-        if (pair.second.type == LightType::SPOT) count++;
-    }
-
-    if (count >= MAX_SPOT_LIGHTS)
+    if (m_Lights.size() >= MAX_SCENE_LIGHTS)
     {
-        std::cerr << "[RenderSystem] ERROR: Cannot create Spot Light. Limit reached (" << MAX_SPOT_LIGHTS << ").\n";
+        std::cerr << "[RenderSystem] ERROR: Cannot create Spot Light. Limit reached (" << MAX_SCENE_LIGHTS << ").\n";
         return 0;
     }
 
-    hLight handle = m_NextLightHandle++;
-    
     LightResource resource = {};
     resource.type = LightType::SPOT;
     resource.spot = data;
     resource.isActive = true;
     
-    m_Lights[handle] = resource;
+    hLight handle = m_Lights.insert(resource);
+    if (handle != 0)
+    {
+        m_Lights.get(handle)->treeNode = m_LightTree.insert(computeSpotLightAABB(data), handle);
+    }
     return handle;
 }
 
 void RenderSystem::updateLight(hLight handle, const DirectionalLight& data)
 {
-    auto it = m_Lights.find(handle);
-    if (it != m_Lights.end() && it->second.type == LightType::DIRECTIONAL)
+    LightResource* light = m_Lights.get(handle);
+    if (light && light->type == LightType::DIRECTIONAL)
     {
-        it->second.directional = data;
+        light->directional = data;
     }
 }
 
 void RenderSystem::updateLight(hLight handle, const PointLight& data)
 {
-    auto it = m_Lights.find(handle);
-    if (it != m_Lights.end() && it->second.type == LightType::POINT)
+    LightResource* light = m_Lights.get(handle);
+    if (light && light->type == LightType::POINT)
     {
-        it->second.point = data;
+        light->point = data;
+        m_LightTree.move(light->treeNode, computePointLightAABB(data));
     }
 }
 
 void RenderSystem::updateLight(hLight handle, const SpotLight& data)
 {
-    auto it = m_Lights.find(handle);
-    if (it != m_Lights.end() && it->second.type == LightType::SPOT)
+    LightResource* light = m_Lights.get(handle);
+    if (light && light->type == LightType::SPOT)
     {
-        it->second.spot = data;
+        light->spot = data;
+        m_LightTree.move(light->treeNode, computeSpotLightAABB(data));
     }
 }
 
 void RenderSystem::destroyLight(hLight handle)
 {
-    m_Lights.erase(handle);
+    const LightResource* light = m_Lights.get(handle);
+    if (light && light->treeNode != BVH_NULL_NODE)
+    {
+        m_LightTree.remove(light->treeNode);
+        m_ShadowAtlas.release(handle);
+    }
+    m_Lights.remove(handle);
 }
 
 // ==================== STATISTICS ====================
@@ -785,6 +2040,21 @@ const RenderStats& RenderSystem::getStats() const
     return m_Stats;
 }
 
+void RenderSystem::setStatsWindow(UINT32 frames)
+{
+    m_StatsWindow.resize(frames);
+}
+
+UINT32 RenderSystem::getStatsWindow() const
+{
+    return m_StatsWindow.getCapacity();
+}
+
+void RenderSystem::setProfiler(Quark::Profiler* profiler)
+{
+    Quark::setModuleProfiler(profiler, "rendersystem");
+}
+
 // ==================== TIMING ====================
 void RenderSystem::setDeltaTime(float dt)
 {
@@ -11,11 +11,13 @@
 #endif
 
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
+#include <chrono>
 
 #include "../../headeronly/globaltypes.h"
 #include "../../headeronly/mathematics.h"
+#include "../../headeronly/slotmap.h"
+#include "../../headeronly/framearena.h"
 #include "rendersystemapi.h"
 #include "rhi.h"
 #include "rstypes.h"
@@ -26,6 +28,12 @@
 #include "renderstats.h"
 #include "camera.h"
 #include "framepacket.h"
+#include "bvh.h"
+#include "occlusion.h"
+#include "lightclusters.h"
+#include "shadowatlas.h"
+#include "taskpool.h"
+#include "sortkey.h"
 
 // ==================== INTERNAL RESOURCE STRUCTURES ====================
 // Mesh resource - CPU data + GPU handle
@@ -34,7 +42,12 @@ struct MeshResource
     MeshData data;
     hMesh gpuHandle;
     bool isDynamic;
+    UINT32 revision;            // Bumped by updateMesh, cached shadow views compare it
     Quark::AABB localBounds;
+
+    // CPU copy for occlusion rasterization (MeshData pointers are caller owned)
+    std::vector<Quark::Vec3> cpuPositions;
+    std::vector<UINT32> cpuIndices;
 };
 
 // Material resource - CPU data + GPU handle
@@ -42,6 +55,7 @@ struct MaterialResource
 {
     MaterialData data;
     hMaterial gpuHandle;
+    UINT32 lastUsedFrame;   // Frame index the material was last added to the packet
 };
 
 struct LightResource
@@ -54,8 +68,9 @@ struct LightResource
         SpotLight spot;
     };
     bool isActive;
+    UINT32 treeNode;        // Leaf in m_LightTree, BVH_NULL_NODE for directional lights
     
-    LightResource() : type(LightType::DIRECTIONAL), isActive(false) 
+    LightResource() : type(LightType::DIRECTIONAL), isActive(false), treeNode(BVH_NULL_NODE)
     {
         memset(&directional, 0, sizeof(DirectionalLight));
     }
@@ -68,13 +83,99 @@ struct SubmittedObject
     hMesh mesh;
     hMaterial material;
     Quark::Mat4 worldMatrix;
+    Quark::MatrixType matrixType;   // Classified at submit, selects the normal matrix path
     Quark::AABB worldBounds;
     RenderObjectFlags flags;
-    float sortDistance;
-    UINT32 sortKey;
+    float sortDistance;             // Squared distance to the camera
+    UINT64 sortKey;                 // Packed key, see sortkey.h
+    bool transparent;               // Resolved from the material before sorting
+    hRenderProxy proxy;             // Owning proxy, 0 for immediate submissions
+};
+
+// ==================== RENDER PROXY ====================
+// Retained object: derived data is cached and only rebuilt when the proxy is dirty
+struct RenderProxy
+{
+    SubmittedObject object;         // Bounds, matrix type and transparency kept current
+    Quark::Mat4 normalMatrix;       // Cached inverse-transpose of the world matrix
+    UINT64 sortKeyBase;             // Sort key without depth
+    UINT32 treeNode;                // Leaf in m_ProxyTree for culled dynamic proxies, BVH_NULL_NODE otherwise
+    bool staticCulled;              // Culled static proxy, in m_StaticProxyTree after the next rebuild
+    bool dirty;
+};
+
+// ==================== PARALLEL STAGES ====================
+// Minimum items per task, smaller inputs stay on the calling thread
+constexpr UINT32 CULL_CHUNK_SIZE = 2048;
+constexpr UINT32 SORT_CHUNK_SIZE = 8192;
+constexpr UINT32 INSTANCE_CHUNK_SIZE = 1024;
+
+// Per object result of the classify pass
+constexpr UINT8 OBJECT_CLASS_VISIBLE = 1 << 0;
+constexpr UINT8 OBJECT_CLASS_CASTER = 1 << 1;
+
+// Counts of one classify chunk and where its output starts
+struct StageChunk
+{
+    UINT32 visibleCount;
+    UINT32 casterCount;
+    UINT32 culledCount;
+    UINT32 occludedCount;
+    UINT32 visibleStart;
+    UINT32 casterStart;
+    Quark::AABB casterBounds;   // Casters with FRUSTUM_CULL
+    float receiverNear;         // View depth range of the visible receivers with FRUSTUM_CULL
+    float receiverFar;
+    bool unboundedCaster;
+    bool unboundedReceiver;
+};
+
+// One shadow view: culled in parallel, emitted in order
+struct ShadowViewJob
+{
+    ShadowViewType type;
+    UINT32 slot;
+    Quark::Vec4 atlasRect;          // Local views only, see ShadowView
+    Quark::Mat4 viewProjection;
+    Frustum frustum;
+    const Quark::AABBSoA* bounds;   // Culls [boundsBegin, boundsEnd) of this set
+    UINT32 boundsBegin;
+    UINT32 boundsEnd;
+    const UINT32* casters;          // Caster index per bounds entry
+    UINT32 outputStart;             // Range in m_ShadowIndices / m_ShadowViewCasters
+    UINT32 survivorCount;
+    UINT64 staticHash;              // Sums of the surviving casters' fingerprints
+    UINT64 dynamicHash;
+    UINT64 tileKey;                 // See getShadowTileKey
+    UINT64 cacheVersion;            // See ShadowView
+    UINT64 staticCacheVersion;
+};
+
+// What a shadow tile was last drawn with, a view drawing the same keeps the versions
+struct ShadowTileContent
+{
+    Quark::Mat4 viewProjection;
+    UINT64 staticHash;
+    UINT64 dynamicHash;
+    UINT64 version;                 // 0 while two views of a frame share the tile
+    UINT64 staticVersion;
+};
+
+// Point or spot light that survived the frustum test, ranked for the light budget
+struct VisibleLight
+{
+    hLight handle;
+    float importance;       // Screen coverage x intensity / distance
+    float screenSize;       // Bounding sphere diameter over the screen height, above 1 up close
 };
 
 // ==================== RENDER SYSTEM ====================
+// Frame arenas form a ring of m_FramesInFlight entries. Each one holds a packet
+// until the backend signals its fence, so the next frames can be simulated and
+// built while earlier packets are still being consumed.
+constexpr UINT32 MAX_FRAMES_IN_FLIGHT = 3;
+constexpr UINT32 DEFAULT_FRAMES_IN_FLIGHT = 2;
+
 class RenderSystem : public RenderSystemAPI
 {
 private:
@@ -98,20 +199,106 @@ private:
     Quark::Color m_AmbientLight;
     
     // ==================== RESOURCE STORAGE ====================
-    std::unordered_map<hMesh, MeshResource> m_Meshes;
-    std::unordered_map<hMaterial, MaterialResource> m_Materials;
-    std::unordered_map<hTexture, hTexture> m_Textures;
-    std::unordered_map<hLight, LightResource> m_Lights;
+    // Handles returned to callers are slot map handles (index + generation)
+    Quark::SlotMap<MeshResource> m_Meshes;
+    Quark::SlotMap<MaterialResource> m_Materials;
+    Quark::SlotMap<hTexture> m_Textures;        // Local handle -> RHI texture handle
+    Quark::SlotMap<LightResource> m_Lights;
+    
+    UINT32 m_FrameIndex;
     
-    hMesh m_NextMeshHandle;
-    hMaterial m_NextMaterialHandle;
-    hTexture m_NextTextureHandle;
-    hLight m_NextLightHandle;
+    // ==================== FRAME MEMORY ====================
+    // Every ArenaVector below is transient and rebound to the next arena after each frame
+    Quark::FrameArena m_FrameArenas[MAX_FRAMES_IN_FLIGHT];
+    UINT64 m_FrameArenaFences[MAX_FRAMES_IN_FLIGHT];    // Fence of the last packet built in each arena
+    UINT32 m_FrameArenaIndex;
+    UINT32 m_FramesInFlight;
+    UINT64 m_SubmittedFrameFence;
     
     // ==================== RENDER QUEUE ====================
-    std::vector<SubmittedObject> m_SubmittedObjects;
-    std::vector<SubmittedObject> m_VisibleObjects;
-    std::vector<SubmittedObject> m_ShadowCasters;
+    // Cull indices cover immediate submissions first, then proxies in dense order
+    Quark::ArenaVector<SubmittedObject> m_SubmittedObjects;
+    Quark::ArenaVector<SubmittedObject> m_VisibleObjects;
+    Quark::ArenaVector<SubmittedObject> m_ShadowCasters;
+
+    // ==================== RENDER PROXIES ====================
+    Quark::SlotMap<RenderProxy> m_Proxies;
+    std::vector<hRenderProxy> m_DirtyProxies;
+    DynamicAABBTree m_ProxyTree;                // Dynamic proxies, leaf user data is the proxy handle
+    DynamicAABBTree m_StaticProxyTree;          // Static proxies, rebuilt only when the static set changes
+    std::vector<hRenderProxy> m_StaticProxies;  // Static proxy tree leaf -> proxy handle
+    std::vector<Quark::AABB> m_StaticProxyBounds;   // Bounds the static proxy tree was built from
+    bool m_StaticProxiesChanged;
+
+    // ==================== SORTING ====================
+    Quark::ArenaVector<SortEntry> m_SortEntries;
+    Quark::ArenaVector<SortEntry> m_SortScratch;
+    Quark::ArenaVector<SubmittedObject> m_SortedObjects;  // Permutation target, swapped with m_VisibleObjects
+    std::vector<UINT32> m_SortHistograms;               // 256 buckets per sort chunk
+    std::vector<UINT64> m_SortKeyMasks;                 // AND / OR of the keys per sort chunk
+
+    // ==================== CULLING ====================
+    // Static objects: tree rebuilt only when the static bounds set changes.
+    // Dynamic objects: one proxy per submission ordinal, moved incrementally.
+    DynamicAABBTree m_StaticTree;
+    DynamicAABBTree m_DynamicTree;
+    std::vector<Quark::AABB> m_StaticBounds;    // Bounds the static tree was built from
+    Quark::ArenaVector<UINT32> m_StaticOrder;   // Static ordinal -> submitted index
+    Quark::ArenaVector<UINT32> m_DynamicOrder;  // Dynamic ordinal -> submitted index
+    std::vector<UINT32> m_DynamicProxies;       // Dynamic ordinal -> tree proxy
+    BVHTraversalStack m_CullStack;              // Shared by the tree walks, all run on the calling thread
+
+    Quark::AABBSoA m_CullBounds;                // Leaves straddling a plane, tested by the SIMD kernel
+    Quark::ArenaVector<UINT32> m_CullCandidates;    // Submitted index per m_CullBounds entry
+    Quark::ArenaVector<UINT32> m_CullIndices;       // Compact visible index list from the kernel
+    Quark::ArenaVector<UINT8> m_CullVisible;        // Per submitted object visibility
+    Quark::ArenaVector<UINT8> m_ObjectClass;        // OBJECT_CLASS_* per submitted object
+    std::vector<StageChunk> m_StageChunks;
+
+    // ==================== SHADOW CULLING ====================
+    Quark::AABBSoA m_ShadowBounds;                  // Bounds of casters with FRUSTUM_CULL
+    Quark::ArenaVector<UINT32> m_ShadowBoundedCasters;      // Caster index per m_ShadowBounds entry
+    Quark::ArenaVector<UINT32> m_ShadowUnboundedCasters;    // Casters drawn into every view
+    Quark::AABBSoA m_ShadowLocalBounds;                     // Subsets in range of each point light, back to back
+    Quark::ArenaVector<UINT32> m_ShadowLocalCasters;        // Caster index per m_ShadowLocalBounds entry
+    std::vector<ShadowViewJob> m_ShadowViewJobs;
+    Quark::ArenaVector<UINT32> m_ShadowIndices;             // Kernel output, one range per view
+    Quark::ArenaVector<UINT32> m_ShadowViewCasters;         // Sorted surviving casters, one range per view
+    Quark::ArenaVector<UINT32> m_ShadowInstanceCasters;     // Caster index per shadow instance
+    Quark::ArenaVector<UINT64> m_ShadowCasterHashes;        // Fingerprint per caster, mesh and world matrix
+
+    // ==================== SHADOW CACHE ====================
+    // Tiles of the previous frame by getShadowTileKey, only tiles drawn every frame stay cached
+    ShadowTileMap<ShadowTileContent> m_ShadowTiles;
+    ShadowTileMap<ShadowTileContent> m_NextShadowTiles;
+    UINT64 m_ShadowCacheVersion;    // Last version handed out
+    bool m_ShadowCacheEnabled;
+
+    // ==================== BATCHING ====================
+    Quark::ArenaVector<UINT32> m_InstanceTargets;           // Instance slot per visible object, UINT32_MAX if dropped
+
+    // ==================== THREADING ====================
+    TaskPool m_TaskPool;
+
+    // ==================== OCCLUSION ====================
+    OcclusionCuller m_Occlusion;
+    bool m_OcclusionEnabled;
+
+    // ==================== LIGHT CULLING ====================
+    DynamicAABBTree m_LightTree;                // Point and spot lights, leaf user data is the light handle
+    std::vector<VisibleLight> m_VisibleLights;  // Highest importance first, cut to m_LightBudget
+    UINT32 m_LightBudget;
+
+    // ==================== LIGHT CLUSTERS ====================
+    LightClusterBuilder m_LightClusters;
+
+    // ==================== LOCAL SHADOW ATLAS ====================
+    ShadowAtlas m_ShadowAtlas;                  // Tiles of the shadowed spot and point lights, kept across frames
+
+    // ==================== CASCADES ====================
+    CSMSceneBounds m_CSMSceneBounds;            // Gathered by frustumCull()
+    CSMState m_CSMState;                        // Cascades of the shadowed directional light, kept across frames
+    UINT32 m_CascadeUpdateInterval;
 
     // ==================== SKY ====================
     SkySettings m_SkySettings;
@@ -121,15 +308,41 @@ private:
     
     // ==================== STATS ====================
     RenderStats m_Stats;
+    RenderStatsWindow m_StatsWindow;
+    std::chrono::steady_clock::time_point m_LastFrameStart;
+    bool m_HasLastFrame;
     
 private:
     // ==================== INTERNAL METHODS ====================
+    void rotateFrameArena();
+    void endStage(RenderStage stage, std::chrono::steady_clock::time_point& stageStart);
+    void updateProxies();
+    void refreshProxy(RenderProxy& proxy);
+    void markProxyDirty(hRenderProxy handle, RenderProxy& proxy);
     void frustumCull();
+    void updateCullTrees();
+    bool renderOccluders();
     void sortObjects();
+    void sortEntries(UINT32 chunkCount, UINT32 chunkSize);
     void buildBatches();
+    void buildShadowViews();
+    void updateShadowCache();
+    void emitShadowView(const ShadowViewJob& job);
+    void cullLights();
     FramePacket buildFramePacket();
     
-    UINT32 calculateSortKey(hMaterial material, float distance);
+    UINT64 calculateSortKey(const SubmittedObject& obj);
+
+    UINT32 getObjectCount() const
+    {
+        return static_cast<UINT32>(m_SubmittedObjects.size() + m_Proxies.size());
+    }
+
+    const SubmittedObject& getObject(UINT32 index) const
+    {
+        UINT32 immediateCount = static_cast<UINT32>(m_SubmittedObjects.size());
+        return index < immediateCount ? m_SubmittedObjects[index] : m_Proxies.data()[index - immediateCount].object;
+    }
     
 public:
     RenderSystem();
@@ -159,6 +372,12 @@ public:
     // ==================== OBJECT SUBMISSION ====================
     void submit(const RenderObject& obj) override;
 
+    // ==================== RENDER PROXIES ====================
+    hRenderProxy createRenderProxy(const RenderObject& obj) override;
+    void updateProxyTransform(hRenderProxy proxy, const Quark::Mat4& worldMatrix) override;
+    void updateRenderProxy(hRenderProxy proxy, const RenderObject& obj) override;
+    void destroyRenderProxy(hRenderProxy proxy) override;
+
     // ==================== CAMERA ====================
     void setActiveCamera(Camera* camera) override;
     Camera* getActiveCamera() const override;
@@ -168,6 +387,19 @@ public:
     void setAmbientLight(const Quark::Color& color) override;
     void setSkySettings(const SkySettings& settings) override;
     const SkySettings& getSkySettings() const override;
+    void setOcclusionCulling(bool enabled) override;
+    bool getOcclusionCulling() const override;
+    void setWorkerThreadCount(UINT32 count) override;
+    UINT32 getWorkerThreadCount() const override;
+    void setJobSystem(JobSystemAPI* jobSystem) override;
+    void setFramesInFlight(UINT32 count) override;
+    UINT32 getFramesInFlight() const override;
+    void setLightBudget(UINT32 count) override;
+    UINT32 getLightBudget() const override;
+    void setShadowCaching(bool enabled) override;
+    bool getShadowCaching() const override;
+    void setCascadeUpdateInterval(UINT32 frames) override;
+    UINT32 getCascadeUpdateInterval() const override;
 
     // ==================== LIGHTING ====================
     hLight createDirectionalLight(const DirectionalLight& data) override;
@@ -180,6 +412,9 @@ public:
 
     // ==================== STATISTICS ====================
     const RenderStats& getStats() const override;
+    void setStatsWindow(UINT32 frames) override;
+    UINT32 getStatsWindow() const override;
+    void setProfiler(Quark::Profiler* profiler) override;
 
     // ==================== TIMING ====================
     void setDeltaTime(float dt) override;
@@ -12,6 +12,9 @@
 #include "../../headeronly/globaltypes.h"
 #include "../../headeronly/mathematics.h"
 
+class JobSystemAPI;
+namespace Quark { class Profiler; }
+
 // ==================== RENDER SYSTEM API ====================
 class RenderSystemAPI
 {
@@ -40,8 +43,17 @@ public:
     virtual bool setMaterialTexture(hMaterial material, hTexture texture, UINT32 slot) = 0;
 
     // ==================== OBJECT SUBMISSION ====================
+    // Immediate mode: valid for the next renderFrame only (transient objects)
     virtual void submit(const RenderObject& obj) = 0;
 
+    // ==================== RENDER PROXIES ====================
+    // Retained mode: the object persists until destroyed and is only reprocessed when changed.
+    // World bounds come from the mesh bounds, RenderObject::worldAABB is ignored.
+    virtual hRenderProxy createRenderProxy(const RenderObject& obj) = 0;
+    virtual void updateProxyTransform(hRenderProxy proxy, const Quark::Mat4& worldMatrix) = 0;
+    virtual void updateRenderProxy(hRenderProxy proxy, const RenderObject& obj) = 0;
+    virtual void destroyRenderProxy(hRenderProxy proxy) = 0;
+
     // ==================== CAMERA ====================
     virtual void setActiveCamera(Camera* camera) = 0;
     virtual Camera* getActiveCamera() const = 0;
@@ -51,6 +63,25 @@ public:
     virtual void setAmbientLight(const Quark::Color& color) = 0;
     virtual void setSkySettings(const SkySettings& settings) = 0;
     virtual const SkySettings& getSkySettings() const = 0;
+    virtual void setOcclusionCulling(bool enabled) = 0;
+    virtual bool getOcclusionCulling() const = 0;
+    // Threads used by the cull/sort/batch stages (including the calling thread), 1 = serial
+    virtual void setWorkerThreadCount(UINT32 count) = 0;
+    virtual UINT32 getWorkerThreadCount() const = 0;
+    // Runs the parallel stages on a shared job system instead of the internal threads, nullptr detaches
+    virtual void setJobSystem(JobSystemAPI* jobSystem) = 0;
+    // Packets that may exist at once (being built + queued in the backend), 1 = fully synchronous
+    virtual void setFramesInFlight(UINT32 count) = 0;
+    virtual UINT32 getFramesInFlight() const = 0;
+    // Visible point and spot lights packed per frame, the most important ones are kept (up to MAX_LIGHTS)
+    virtual void setLightBudget(UINT32 count) = 0;
+    virtual UINT32 getLightBudget() const = 0;
+    // Lets the backend keep shadow tiles whose light and casters did not change since the last frame
+    virtual void setShadowCaching(bool enabled) = 0;
+    virtual bool getShadowCaching() const = 0;
+    // Far cascades are refitted every few frames, up to this many. Defaults to 1, every cascade every frame
+    virtual void setCascadeUpdateInterval(UINT32 frames) = 0;
+    virtual UINT32 getCascadeUpdateInterval() const = 0;
 
     // ==================== LIGHTING ====================
     virtual hLight createDirectionalLight(const DirectionalLight& data) = 0;
@@ -62,7 +93,13 @@ public:
     virtual void destroyLight(hLight handle) = 0;
     
     // ==================== STATISTICS ====================
+    // Last frame, plus min/avg/p95/max of the timings over the rolling window
     virtual const RenderStats& getStats() const = 0;
+    // Frames in the rolling window (clamped to MAX_STATS_WINDOW), resets it
+    virtual void setStatsWindow(UINT32 frames) = 0;
+    virtual UINT32 getStatsWindow() const = 0;
+    // Records the render system's zones and counters into a shared profiler, nullptr detaches
+    virtual void setProfiler(Quark::Profiler* profiler) = 0;
 
     // ==================== TIMING ====================
     virtual void setDeltaTime(float dt) = 0;
@@ -35,6 +35,15 @@ public:
     virtual void executeFrame(const FramePacket& packet) = 0;
     virtual void endFrame() = 0;
 
+    // ==================== FRAME FENCES ====================
+    // Each packet carries a frameFence, one higher than the previous packet's.
+    // A backend may keep reading a packet after executeFrame() returns (e.g. from
+    // its own thread); the caller keeps the packet memory alive until
+    // getCompletedFrameFence() reaches that fence. Resource calls must take effect
+    // in call order relative to executeFrame().
+    virtual UINT64 getCompletedFrameFence() const = 0;
+    virtual void waitForFrameFence(UINT64 fence) = 0;
+
     // ==================== WINDOW EVENTS ====================
     virtual void onResize(UINT32 width, UINT32 height) = 0;
 
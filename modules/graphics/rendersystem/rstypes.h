@@ -12,4 +12,5 @@ struct NativeRenderTarget
 using hMesh = UINT32;
 using hMaterial = UINT32;
 using hTexture = UINT32;
-using hLight = UINT32;
\ No newline at end of file
+using hLight = UINT32;
+using hRenderProxy = UINT32;
\ No newline at end of file
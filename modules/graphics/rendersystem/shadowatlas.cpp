@@ -0,0 +1,264 @@
+#include "shadowatlas.h"
+#include <algorithm>
+
+// ==================== CONSTRUCTOR ====================
+ShadowAtlas::ShadowAtlas()
+    : m_FrameIndex(0)
+    , m_TilesAllocated(0)
+    , m_UsedTexels(0)
+{
+    for (UINT32 level = 0; level < SHADOW_ATLAS_LEVEL_COUNT; ++level)
+    {
+        m_Nodes[level].resize(static_cast<size_t>(1) << (2 * level));
+    }
+    clear();
+}
+
+void ShadowAtlas::clear()
+{
+    for (UINT32 level = 0; level < SHADOW_ATLAS_LEVEL_COUNT; ++level)
+    {
+        std::fill(m_Nodes[level].begin(), m_Nodes[level].end(), static_cast<UINT8>(NODE_COVERED));
+        m_FreeCount[level] = 0;
+    }
+    m_Nodes[0][0] = NODE_FREE;
+    m_FreeCount[0] = 1;
+
+    m_Allocations.clear();
+    m_TilesAllocated = 0;
+    m_UsedTexels = 0;
+}
+
+// ==================== TILES ====================
+// Deepest level whose tiles are at least the wanted size, within the tile size limits
+UINT32 ShadowAtlas::getLevel(float wantedSize)
+{
+    UINT32 level = 0;
+    while (getTileSize(level) > LOCAL_SHADOW_MAX_TILE_SIZE)
+    {
+        level++;
+    }
+    while (level + 1 < SHADOW_ATLAS_LEVEL_COUNT && static_cast<float>(getTileSize(level + 1)) >= wantedSize)
+    {
+        level++;
+    }
+    return level;
+}
+
+// Node index is a Morton code: even bits are the column, odd bits the row
+ShadowAtlasTile ShadowAtlas::getTile(UINT32 level, UINT32 node)
+{
+    UINT32 column = 0;
+    UINT32 row = 0;
+    for (UINT32 bit = 0; bit < level; ++bit)
+    {
+        column |= ((node >> (2 * bit)) & 1u) << bit;
+        row |= ((node >> (2 * bit + 1)) & 1u) << bit;
+    }
+
+    const UINT32 size = getTileSize(level);
+    return { column * size, row * size, size };
+}
+
+// ==================== QUADTREE ====================
+bool ShadowAtlas::allocateNode(UINT32 level, UINT32& outNode)
+{
+    // Best fit: the deepest level with a free node, split down to the wanted level
+    for (UINT32 l = level + 1; l-- > 0;)
+    {
+        if (m_FreeCount[l] == 0) continue;
+
+        UINT32 node = static_cast<UINT32>(std::find(m_Nodes[l].begin(), m_Nodes[l].end(), static_cast<UINT8>(NODE_FREE)) - m_Nodes[l].begin());
+        while (l < level)
+        {
+            m_Nodes[l][node] = NODE_SPLIT;
+            m_FreeCount[l]--;
+
+            l++;
+            node *= 4;
+            for (UINT32 child = 0; child < 4; ++child)
+            {
+                m_Nodes[l][node + child] = NODE_FREE;
+            }
+            m_FreeCount[l] += 4;
+        }
+
+        m_Nodes[level][node] = NODE_USED;
+        m_FreeCount[level]--;
+        outNode = node;
+        return true;
+    }
+    return false;
+}
+
+void ShadowAtlas::freeNode(UINT32 level, UINT32 node)
+{
+    m_Nodes[level][node] = NODE_FREE;
+    m_FreeCount[level]++;
+
+    // Four free siblings merge back into their parent
+    while (level > 0)
+    {
+        const UINT32 first = node & ~3u;
+        for (UINT32 child = 0; child < 4; ++child)
+        {
+            if (m_Nodes[level][first + child] != NODE_FREE) return;
+        }
+        for (UINT32 child = 0; child < 4; ++child)
+        {
+            m_Nodes[level][first + child] = NODE_COVERED;
+        }
+        m_FreeCount[level] -= 4;
+
+        level--;
+        node >>= 2;
+        m_Nodes[level][node] = NODE_FREE;
+        m_FreeCount[level]++;
+    }
+}
+
+bool ShadowAtlas::allocateTiles(UINT32 level, UINT32 tileCount, Allocation& allocation)
+{
+    for (UINT32 t = 0; t < tileCount; ++t)
+    {
+        if (!allocateNode(level, allocation.nodes[t]))
+        {
+            while (t-- > 0)
+            {
+                freeNode(level, allocation.nodes[t]);
+            }
+            return false;
+        }
+        allocation.tiles[t] = getTile(level, allocation.nodes[t]);
+    }
+
+    const UINT64 size = getTileSize(level);
+    allocation.level = level;
+    allocation.tileCount = tileCount;
+    m_UsedTexels += size * size * tileCount;
+    m_TilesAllocated += tileCount;
+    return true;
+}
+
+void ShadowAtlas::freeAllocation(UINT32 index)
+{
+    const Allocation& allocation = m_Allocations[index];
+    const UINT64 size = getTileSize(allocation.level);
+    for (UINT32 t = 0; t < allocation.tileCount; ++t)
+    {
+        freeNode(allocation.level, allocation.nodes[t]);
+    }
+    m_UsedTexels -= size * size * allocation.tileCount;
+
+    m_Allocations[index] = m_Allocations.back();
+    m_Allocations.pop_back();
+}
+
+// Only allocations not requested yet this frame can go, the ones already handed out are in use
+bool ShadowAtlas::evictLeastRecentlyUsed()
+{
+    UINT32 victim = UINT32_MAX;
+    for (UINT32 i = 0; i < static_cast<UINT32>(m_Allocations.size()); ++i)
+    {
+        const Allocation& allocation = m_Allocations[i];
+        if (allocation.lastUsedFrame == m_FrameIndex) continue;
+        if (victim == UINT32_MAX || allocation.lastUsedFrame < m_Allocations[victim].lastUsedFrame)
+        {
+            victim = i;
+        }
+    }
+
+    if (victim == UINT32_MAX) return false;
+    freeAllocation(victim);
+    return true;
+}
+
+// ==================== FRAME ====================
+void ShadowAtlas::beginFrame(UINT32 frameIndex)
+{
+    m_FrameIndex = frameIndex;
+    m_TilesAllocated = 0;
+}
+
+const ShadowAtlasTile* ShadowAtlas::request(hLight light, UINT32 tileCount, float wantedSize)
+{
+    if (tileCount == 0 || tileCount > POINT_SHADOW_FACE_COUNT) return nullptr;
+
+    for (UINT32 i = 0; i < static_cast<UINT32>(m_Allocations.size()); ++i)
+    {
+        Allocation& allocation = m_Allocations[i];
+        if (allocation.light != light) continue;
+
+        // Inside the hysteresis band the light keeps its tiles
+        const float size = static_cast<float>(getTileSize(allocation.level));
+        const float clampedSize = std::clamp(wantedSize, static_cast<float>(LOCAL_SHADOW_MIN_TILE_SIZE), static_cast<float>(LOCAL_SHADOW_MAX_TILE_SIZE));
+        if (allocation.tileCount == tileCount && clampedSize >= size * SHADOW_TILE_SHRINK_RATIO)
+        {
+            allocation.lastUsedFrame = m_FrameIndex;
+            if (clampedSize <= size * SHADOW_TILE_GROW_RATIO) return allocation.tiles;
+
+            // Growing only takes free space, a light that had to settle for a smaller tile keeps it
+            Allocation grown = allocation;
+            for (UINT32 level = getLevel(wantedSize); level < allocation.level; ++level)
+            {
+                if (allocateTiles(level, tileCount, grown))
+                {
+                    freeAllocation(i);
+                    m_Allocations.push_back(grown);
+                    return m_Allocations.back().tiles;
+                }
+            }
+            return allocation.tiles;
+        }
+
+        freeAllocation(i);
+        break;
+    }
+
+    Allocation allocation = {};
+    allocation.light = light;
+    allocation.lastUsedFrame = m_FrameIndex;
+
+    // Stale allocations are evicted before settling for a smaller tile
+    for (UINT32 level = getLevel(wantedSize); level < SHADOW_ATLAS_LEVEL_COUNT; ++level)
+    {
+        do
+        {
+            if (allocateTiles(level, tileCount, allocation))
+            {
+                m_Allocations.push_back(allocation);
+                return m_Allocations.back().tiles;
+            }
+        } while (evictLeastRecentlyUsed());
+    }
+    return nullptr;
+}
+
+void ShadowAtlas::endFrame()
+{
+    for (UINT32 i = static_cast<UINT32>(m_Allocations.size()); i-- > 0;)
+    {
+        if (m_FrameIndex - m_Allocations[i].lastUsedFrame >= SHADOW_TILE_RETAIN_FRAMES)
+        {
+            freeAllocation(i);
+        }
+    }
+}
+
+void ShadowAtlas::release(hLight light)
+{
+    for (UINT32 i = 0; i < static_cast<UINT32>(m_Allocations.size()); ++i)
+    {
+        if (m_Allocations[i].light == light)
+        {
+            freeAllocation(i);
+            return;
+        }
+    }
+}
+
+float ShadowAtlas::getUsage() const
+{
+    const double atlasTexels = static_cast<double>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE) * LOCAL_LIGHT_SHADOW_ATLAS_SIZE;
+    return static_cast<float>(m_UsedTexels / atlasTexels);
+}
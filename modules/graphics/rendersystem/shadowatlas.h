@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "../../headeronly/globaltypes.h"
+#include "lighting.h"
+#include "rstypes.h"
+
+// ==================== SHADOW ATLAS CONSTANTS ====================
+constexpr UINT32 SHADOW_ATLAS_LEVEL_COUNT = 7;          // 4096 down to 64 texel tiles
+constexpr float SHADOW_TILE_GROW_RATIO = 1.5f;          // A tile doubles once the wanted size passes 1.5x its size
+constexpr float SHADOW_TILE_SHRINK_RATIO = 0.35f;       // and halves below 0.35x, so lights near a power of two keep their tile
+constexpr UINT32 SHADOW_TILE_RETAIN_FRAMES = 60;        // Frames an unused allocation survives, lights coming back on screen reuse it
+constexpr float SHADOW_ATLAS_BUDGET_FILL = 0.5f;        // Share of the atlas wanted sizes are scaled to, rounding up to tile sizes about doubles it
+
+static_assert(static_cast<UINT32>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE) >> (SHADOW_ATLAS_LEVEL_COUNT - 1) == LOCAL_SHADOW_MIN_TILE_SIZE,
+              "The deepest quadtree level holds the smallest tiles");
+static_assert(LOCAL_SHADOW_MAX_TILE_SIZE <= static_cast<UINT32>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE), "Tiles must fit the atlas");
+
+// ==================== SHADOW ATLAS ====================
+// Quadtree allocator for the local (spot and point) shadow atlas.
+// Level 0 is the whole atlas, every level splits its nodes into four. A tile
+// request takes the first free node of the deepest level that has one and
+// splits it down to the wanted size; freed siblings merge back into their parent.
+// Allocations belong to a light handle and are kept from frame to frame while
+// the wanted size stays within the grow/shrink ratios, so a light keeps its
+// texels (and the backend its viewport) instead of moving every frame.
+// Requests come in importance order. When the atlas is full, allocations not
+// requested yet this frame are evicted least recently used first, then smaller
+// tiles are tried.
+class ShadowAtlas
+{
+private:
+    enum NodeState : UINT8
+    {
+        NODE_COVERED = 0,   // Part of a free or used ancestor
+        NODE_FREE,
+        NODE_SPLIT,
+        NODE_USED
+    };
+
+    struct Allocation
+    {
+        hLight light;
+        UINT32 level;
+        UINT32 tileCount;
+        UINT32 nodes[POINT_SHADOW_FACE_COUNT];
+        ShadowAtlasTile tiles[POINT_SHADOW_FACE_COUNT];
+        UINT32 lastUsedFrame;
+    };
+
+    // Nodes of a level in Morton order, the children of node i are 4i .. 4i + 3 one level down
+    std::vector<UINT8> m_Nodes[SHADOW_ATLAS_LEVEL_COUNT];
+    UINT32 m_FreeCount[SHADOW_ATLAS_LEVEL_COUNT];
+
+    std::vector<Allocation> m_Allocations;
+    UINT32 m_FrameIndex;
+    UINT32 m_TilesAllocated;
+    UINT64 m_UsedTexels;
+
+    static UINT32 getTileSize(UINT32 level) { return static_cast<UINT32>(LOCAL_LIGHT_SHADOW_ATLAS_SIZE) >> level; }
+    static UINT32 getLevel(float wantedSize);
+    static ShadowAtlasTile getTile(UINT32 level, UINT32 node);
+
+    bool allocateNode(UINT32 level, UINT32& outNode);
+    void freeNode(UINT32 level, UINT32 node);
+    bool allocateTiles(UINT32 level, UINT32 tileCount, Allocation& allocation);
+    void freeAllocation(UINT32 index);
+    bool evictLeastRecentlyUsed();
+
+public:
+    ShadowAtlas();
+
+    void clear();
+
+    // Starts a frame of requests, frameIndex has to advance every frame
+    void beginFrame(UINT32 frameIndex);
+
+    // tileCount square tiles (1 for spot lights, 6 for point lights) of about wantedSize texels.
+    // Returns nullptr when there is no room, the tiles pointer is valid until the next request.
+    const ShadowAtlasTile* request(hLight light, UINT32 tileCount, float wantedSize);
+
+    // Drops allocations not requested for SHADOW_TILE_RETAIN_FRAMES frames
+    void endFrame();
+
+    // Frees the light's tiles right away, for destroyed lights
+    void release(hLight light);
+
+    UINT32 getAllocationCount() const { return static_cast<UINT32>(m_Allocations.size()); }
+    UINT32 getTilesAllocated() const { return m_TilesAllocated; }   // New tiles handed out this frame
+    float getUsage() const;                                         // Fraction of the atlas covered by tiles
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+#include <cstring>
+
+#include "../../headeronly/globaltypes.h"
+
+// ==================== SORT KEY LAYOUT ====================
+// 64-bit render queue key, compared as an unsigned integer (MSB first):
+//
+//   opaque:      [layer:4][0][material:20][mesh:20][depth:19]
+//   transparent: [layer:4][1][~depth:19][material:20][mesh:20]
+//
+// Opaque objects group by material then mesh (front to back inside a batch),
+// transparent objects sort back to front. Material and mesh are slot indices,
+// depth is the top 19 bits of the positive float sort distance, which keeps
+// its ordering without any range clamp.
+constexpr UINT32 SORT_KEY_LAYER_BITS = 4;
+constexpr UINT32 SORT_KEY_ID_BITS = 20;
+constexpr UINT32 SORT_KEY_DEPTH_BITS = 19;
+
+constexpr UINT64 SORT_KEY_ID_MASK = (1ull << SORT_KEY_ID_BITS) - 1;
+constexpr UINT64 SORT_KEY_DEPTH_MASK = (1ull << SORT_KEY_DEPTH_BITS) - 1;
+constexpr UINT64 SORT_KEY_LAYER_MASK = (1ull << SORT_KEY_LAYER_BITS) - 1;
+constexpr UINT32 SORT_KEY_TRANSPARENT_SHIFT = 63 - SORT_KEY_LAYER_BITS;
+
+inline UINT64 quantizeSortDepth(float distance)
+{
+    if (!(distance > 0.0f)) return 0;
+
+    UINT32 bits;
+    memcpy(&bits, &distance, sizeof(bits));
+    return (bits >> (31 - SORT_KEY_DEPTH_BITS)) & SORT_KEY_DEPTH_MASK;
+}
+
+// Everything but depth, can be cached while material, mesh and layer stay the same
+inline UINT64 packSortKeyBase(UINT32 layer, bool transparent, UINT32 materialId, UINT32 meshId)
+{
+    UINT64 key = (static_cast<UINT64>(layer) & SORT_KEY_LAYER_MASK) << (SORT_KEY_TRANSPARENT_SHIFT + 1);
+    UINT64 material = materialId & SORT_KEY_ID_MASK;
+    UINT64 mesh = meshId & SORT_KEY_ID_MASK;
+
+    if (transparent)
+    {
+        key |= 1ull << SORT_KEY_TRANSPARENT_SHIFT;
+        key |= material << SORT_KEY_ID_BITS;
+        key |= mesh;
+    }
+    else
+    {
+        key |= material << (SORT_KEY_ID_BITS + SORT_KEY_DEPTH_BITS);
+        key |= mesh << SORT_KEY_DEPTH_BITS;
+    }
+    return key;
+}
+
+inline UINT64 applySortDepth(UINT64 baseKey, bool transparent, float distance)
+{
+    UINT64 depth = quantizeSortDepth(distance);
+    if (transparent)
+        return baseKey | ((~depth & SORT_KEY_DEPTH_MASK) << (2 * SORT_KEY_ID_BITS));
+    return baseKey | depth;
+}
+
+inline UINT64 packSortKey(UINT32 layer, bool transparent, UINT32 materialId, UINT32 meshId, float distance)
+{
+    return applySortDepth(packSortKeyBase(layer, transparent, materialId, meshId), transparent, distance);
+}
+
+// ==================== RADIX SORT ====================
+struct SortEntry
+{
+    UINT64 key;
+    UINT32 index;
+};
+
+// Stable LSD radix sort on the 64-bit key, 8 bits per pass.
+// All 8 histograms are built in one read; passes whose byte is the same for
+// every key are skipped (layer and most high material bits usually are).
+// scratch is resized as needed and may be reused across calls.
+template <typename EntryVector>
+inline void radixSortEntries(EntryVector& entries, EntryVector& scratch)
+{
+    const size_t count = entries.size();
+    if (count < 2) return;
+
+    UINT32 histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        UINT64 key = entries[i].key;
+        for (UINT32 pass = 0; pass < 8; ++pass)
+        {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(count);
+    SortEntry* src = entries.data();
+    SortEntry* dst = scratch.data();
+
+    for (UINT32 pass = 0; pass < 8; ++pass)
+    {
+        UINT32* histogram = histograms[pass];
+        const UINT32 shift = pass * 8;
+
+        if (histogram[(src[0].key >> shift) & 0xFF] == count) continue;
+
+        UINT32 offset = 0;
+        for (UINT32 b = 0; b < 256; ++b)
+        {
+            UINT32 c = histogram[b];
+            histogram[b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        SortEntry* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != entries.data())
+    {
+        entries.swap(scratch);
+    }
+}
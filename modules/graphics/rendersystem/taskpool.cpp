@@ -0,0 +1,177 @@
+#include "taskpool.h"
+#include "../../headeronly/profiler.h"
+#include <algorithm>
+
+// ==================== CONSTRUCTOR ====================
+TaskPool::TaskPool()
+    : m_TaskFunction(nullptr)
+    , m_TaskContext(nullptr)
+    , m_TaskCount(0)
+    , m_Generation(0)
+    , m_BusyWorkers(0)
+    , m_Quit(false)
+    , m_NextTask(0)
+    , m_pJobSystem(nullptr)
+    , m_OwnThreadCount(1)
+{
+    UINT32 hw = std::thread::hardware_concurrency();
+    setThreadCount(hw > 0 ? hw : 1);
+}
+
+TaskPool::~TaskPool()
+{
+    stopWorkers();
+}
+
+// ==================== THREADS ====================
+void TaskPool::setThreadCount(UINT32 count)
+{
+    m_OwnThreadCount = std::clamp<UINT32>(count, 1, TASK_POOL_MAX_THREADS);
+    if (m_pJobSystem) return;
+    if (m_OwnThreadCount == m_Workers.size() + 1) return;
+
+    stopWorkers();
+    startWorkers(m_OwnThreadCount);
+}
+
+UINT32 TaskPool::getThreadCount() const
+{
+    if (m_pJobSystem) return m_pJobSystem->getThreadCount();
+    return static_cast<UINT32>(m_Workers.size()) + 1;
+}
+
+void TaskPool::setJobSystem(JobSystemAPI* jobSystem)
+{
+    if (jobSystem == m_pJobSystem) return;
+
+    m_pJobSystem = jobSystem;
+    stopWorkers();
+    if (!m_pJobSystem)
+    {
+        startWorkers(m_OwnThreadCount);
+    }
+}
+
+void TaskPool::startWorkers(UINT32 count)
+{
+    m_Quit = false;
+    m_Workers.reserve(count - 1);
+    for (UINT32 i = 1; i < count; ++i)
+    {
+        // Workers start from the current generation so an early dispatch is never missed
+        m_Workers.emplace_back(&TaskPool::workerLoop, this, m_Generation);
+    }
+}
+
+void TaskPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for (auto& worker : m_Workers)
+    {
+        worker.join();
+    }
+    m_Workers.clear();
+}
+
+void TaskPool::workerLoop(UINT64 seenGeneration)
+{
+    QUARK_PROFILE_THREAD("Task Worker");
+
+    for (;;)
+    {
+        void (*function)(void*, UINT32);
+        void* context;
+        UINT32 taskCount;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeCondition.wait(lock, [&] { return m_Quit || m_Generation != seenGeneration; });
+            if (m_Quit) return;
+
+            seenGeneration = m_Generation;
+            function = m_TaskFunction;
+            context = m_TaskContext;
+            taskCount = m_TaskCount;
+        }
+
+        {
+            QUARK_PROFILE_ZONE("TaskPool::executeTasks");
+            executeTasks(function, context, taskCount);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (--m_BusyWorkers == 0)
+            {
+                m_DoneCondition.notify_one();
+            }
+        }
+    }
+}
+
+// ==================== DISPATCH ====================
+void TaskPool::executeTasks(void (*function)(void*, UINT32), void* context, UINT32 taskCount)
+{
+    for (UINT32 task = m_NextTask.fetch_add(1); task < taskCount; task = m_NextTask.fetch_add(1))
+    {
+        function(context, task);
+    }
+}
+
+void TaskPool::dispatch(UINT32 taskCount, void (*function)(void*, UINT32), void* context)
+{
+    if (taskCount == 0) return;
+
+    QUARK_PROFILE_ZONE("TaskPool::dispatch");
+
+    if (m_pJobSystem && taskCount > 1)
+    {
+        m_pJobSystem->parallelFor(taskCount, 1, [function, context](UINT32 begin, UINT32 end)
+        {
+            for (UINT32 task = begin; task < end; ++task)
+            {
+                function(context, task);
+            }
+        });
+        return;
+    }
+
+    if (m_Workers.empty() || taskCount == 1)
+    {
+        for (UINT32 task = 0; task < taskCount; ++task)
+        {
+            function(context, task);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_TaskFunction = function;
+        m_TaskContext = context;
+        m_TaskCount = taskCount;
+        m_NextTask.store(0);
+        m_BusyWorkers = static_cast<UINT32>(m_Workers.size());
+        m_Generation++;
+    }
+    m_WakeCondition.notify_all();
+
+    // The caller works too instead of just waiting
+    executeTasks(function, context, taskCount);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCondition.wait(lock, [&] { return m_BusyWorkers == 0; });
+}
+
+UINT32 TaskPool::chunkCount(UINT32 count, UINT32 minChunk, UINT32 alignment, UINT32& chunkSize) const
+{
+    // A few chunks per thread evens out uneven per-item cost
+    UINT32 target = getThreadCount() * 4;
+    chunkSize = (std::max)(minChunk, (count + target - 1) / target);
+    chunkSize = (chunkSize + alignment - 1) / alignment * alignment;
+    return count == 0 ? 0 : (count + chunkSize - 1) / chunkSize;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+
+#include "../../headeronly/globaltypes.h"
+#include "../../core/engine/jobsystem/jobsystemapi.h"
+
+// ==================== TASK POOL CONSTANTS ====================
+constexpr UINT32 TASK_POOL_MAX_THREADS = 64;
+
+// ==================== TASK POOL ====================
+// Persistent worker threads for the parallel frame stages.
+// run() hands out task indices [0, taskCount) to the workers and the calling
+// thread, and returns once every task has finished. Tasks are plain indices so
+// callers decide the chunking and keep their outputs in per-task slots, which
+// keeps results independent of the thread count and of scheduling order.
+// When a shared JobSystemAPI is attached, tasks run on its workers instead and
+// the pool's own threads are stopped.
+class TaskPool
+{
+private:
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_DoneCondition;
+
+    // Current dispatch, published under m_Mutex
+    void (*m_TaskFunction)(void* context, UINT32 task);
+    void* m_TaskContext;
+    UINT32 m_TaskCount;
+    UINT64 m_Generation;
+    UINT32 m_BusyWorkers;
+    bool m_Quit;
+
+    std::atomic<UINT32> m_NextTask;
+
+    JobSystemAPI* m_pJobSystem;
+    UINT32 m_OwnThreadCount;    // Restored when the job system is detached
+
+    void workerLoop(UINT64 seenGeneration);
+    void executeTasks(void (*function)(void*, UINT32), void* context, UINT32 taskCount);
+    void dispatch(UINT32 taskCount, void (*function)(void*, UINT32), void* context);
+    void stopWorkers();
+
+    template <typename Fn>
+    static void invokeTask(void* context, UINT32 task)
+    {
+        (*static_cast<Fn*>(context))(task);
+    }
+
+    void startWorkers(UINT32 count);
+
+public:
+    TaskPool();
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Total thread count including the caller of run(), 1 runs everything inline.
+    // Applies to the pool's own threads, remembered while a job system is attached.
+    void setThreadCount(UINT32 count);
+    UINT32 getThreadCount() const;
+
+    // Runs tasks on a shared job system, nullptr goes back to the pool's own threads
+    void setJobSystem(JobSystemAPI* jobSystem);
+    JobSystemAPI* getJobSystem() const { return m_pJobSystem; }
+
+    // Calls fn(task) for every task index, blocks until all are done. Not reentrant.
+    template <typename Fn>
+    void run(UINT32 taskCount, Fn&& fn)
+    {
+        using Function = std::remove_reference_t<Fn>;
+        dispatch(taskCount, &invokeTask<Function>, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    // Splits [0, count) into chunks of at least minChunk items (a multiple of
+    // alignment), enough to give every thread a few. Returns the chunk count.
+    UINT32 chunkCount(UINT32 count, UINT32 minChunk, UINT32 alignment, UINT32& chunkSize) const;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include "globaltypes.h"
+
+namespace Quark
+{
+    // ==================== FRAME ARENA ====================
+    // Linear (bump) allocator for data that lives for one frame.
+    //
+    // Allocation moves an offset inside one contiguous block, frees are no-ops
+    // and reset() rewinds the offset. When a frame asks for more than the block
+    // holds, extra blocks are taken from the heap for the rest of that frame and
+    // the next reset() replaces everything with a single block big enough for the
+    // peak. Once the working set stops growing, frames do no heap allocation and
+    // reset() is O(1).
+    class FrameArena
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 1u << 20;
+        static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    private:
+        UINT8* m_Base;
+        size_t m_Capacity;
+        size_t m_Offset;
+
+        std::vector<void*> m_Overflow;  // Blocks taken this frame after the main block ran out
+        size_t m_OverflowBytes;
+
+        static void* allocateBlock(size_t size)
+        {
+            return ::operator new(size, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+
+        static void freeBlock(void* block)
+        {
+            ::operator delete(block, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+
+        void releaseOverflow()
+        {
+            for (void* block : m_Overflow)
+            {
+                freeBlock(block);
+            }
+            m_Overflow.clear();
+            m_OverflowBytes = 0;
+        }
+
+    public:
+        explicit FrameArena(size_t capacity = DEFAULT_CAPACITY)
+            : m_Base(nullptr)
+            , m_Capacity(capacity)
+            , m_Offset(0)
+            , m_OverflowBytes(0)
+        {
+            if (m_Capacity > 0)
+            {
+                m_Base = static_cast<UINT8*>(allocateBlock(m_Capacity));
+            }
+        }
+
+        ~FrameArena()
+        {
+            releaseOverflow();
+            if (m_Base) freeBlock(m_Base);
+        }
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // alignment must be a power of two no larger than BLOCK_ALIGNMENT
+        void* allocate(size_t size, size_t alignment)
+        {
+            size_t aligned = (m_Offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + size <= m_Capacity)
+            {
+                m_Offset = aligned + size;
+                return m_Base + aligned;
+            }
+
+            // Out of space: serve from a dedicated block, folded into the main block on reset
+            void* block = allocateBlock(size > 0 ? size : 1);
+            m_Overflow.push_back(block);
+            m_OverflowBytes += size + alignment;
+            return block;
+        }
+
+        void reset()
+        {
+            if (!m_Overflow.empty())
+            {
+                size_t peak = m_Offset + m_OverflowBytes;
+                releaseOverflow();
+
+                if (m_Base) freeBlock(m_Base);
+                m_Capacity = peak + peak / 2;
+                m_Base = static_cast<UINT8*>(allocateBlock(m_Capacity));
+            }
+            m_Offset = 0;
+        }
+
+        size_t getUsed() const { return m_Offset + m_OverflowBytes; }
+        size_t getCapacity() const { return m_Capacity; }
+        bool hasOverflowed() const { return !m_Overflow.empty(); }
+    };
+
+    // ==================== ARENA ALLOCATOR ====================
+    // STL allocator over a FrameArena. A default constructed allocator (no arena)
+    // falls back to the heap so containers can exist before they are bound.
+    template <typename T>
+    struct ArenaAllocator
+    {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        FrameArena* arena;
+
+        ArenaAllocator() noexcept : arena(nullptr) {}
+        explicit ArenaAllocator(FrameArena* arena) noexcept : arena(arena) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+        T* allocate(size_t count)
+        {
+            if (!arena) return static_cast<T*>(::operator new(count * sizeof(T)));
+            return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_t)
+        {
+            if (!arena) ::operator delete(ptr);
+        }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+    };
+
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    // Drops the vector's storage (without touching the arena it came from) and
+    // rebinds it to a new arena, reserving the capacity it had reached so a
+    // steady frame never regrows it
+    template <typename T>
+    void RebindArenaVector(ArenaVector<T>& vec, FrameArena& arena)
+    {
+        size_t capacity = vec.capacity();
+        vec = ArenaVector<T>(ArenaAllocator<T>(&arena));
+        vec.reserve(capacity);
+    }
+}
@@ -3,6 +3,30 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <vector>
+
+// SIMD backend selection (compile time)
+// SSE2 is the x64 baseline, AVX2 is used when the compiler targets it.
+// Define QUARK_MATH_NO_SIMD to force the scalar fallback.
+#if !defined(QUARK_MATH_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define QUARK_MATH_SSE2 1
+    #endif
+    #if defined(QUARK_MATH_SSE2) && defined(__AVX2__)
+        #define QUARK_MATH_AVX2 1
+    #endif
+#endif
+
+#if defined(QUARK_MATH_AVX2)
+#include <immintrin.h>
+#elif defined(QUARK_MATH_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(QUARK_MATH_SSE2)
+// Lane swizzle helper, lanes listed in x, y, z, w order
+#define QUARK_MM_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE((w), (z), (y), (x)))
+#endif
 
 namespace Quark {
 
@@ -41,6 +65,14 @@ namespace Quark {
         return radians * RAD2DEG;
     }
 
+    // Matrix classification, used to pick the cheapest correct inverse path
+    enum class MatrixType {
+        GENERAL,        // Projective or unknown
+        AFFINE,         // Last row is (0, 0, 0, 1)
+        UNIFORM_SCALE,  // Affine, orthogonal basis with equal axis lengths
+        RIGID           // Affine, orthonormal basis (rotation + translation)
+    };
+
     // Vec2 - 2D Vector
     struct Vec2 {
         float x, y;
@@ -235,6 +267,64 @@ namespace Quark {
         const float& operator[](int i) const { return m[i]; }
 
         Mat4 operator*(const Mat4& mat) const {
+#if defined(QUARK_MATH_AVX2)
+            // Two result columns per iteration, lhs columns duplicated in both 128-bit halves
+            __m128 c0 = _mm_loadu_ps(&m[0]);
+            __m128 c1 = _mm_loadu_ps(&m[4]);
+            __m128 c2 = _mm_loadu_ps(&m[8]);
+            __m128 c3 = _mm_loadu_ps(&m[12]);
+            __m256 a0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+            __m256 a1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+            __m256 a2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+            __m256 a3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+
+            Mat4 result;
+            for (int i = 0; i < 16; i += 8) {
+                __m256 b = _mm256_loadu_ps(&mat.m[i]);
+                __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(b, b, 0x00));
+                r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(b, b, 0x55)));
+                r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(b, b, 0xAA)));
+                r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(b, b, 0xFF)));
+                _mm256_storeu_ps(&result.m[i], r);
+            }
+            return result;
+#elif defined(QUARK_MATH_SSE2)
+            __m128 a0 = _mm_loadu_ps(&m[0]);
+            __m128 a1 = _mm_loadu_ps(&m[4]);
+            __m128 a2 = _mm_loadu_ps(&m[8]);
+            __m128 a3 = _mm_loadu_ps(&m[12]);
+
+            Mat4 result;
+            for (int i = 0; i < 16; i += 4) {
+                __m128 b = _mm_loadu_ps(&mat.m[i]);
+                __m128 r = _mm_mul_ps(a0, QUARK_MM_SWIZZLE(b, 0, 0, 0, 0));
+                r = _mm_add_ps(r, _mm_mul_ps(a1, QUARK_MM_SWIZZLE(b, 1, 1, 1, 1)));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, QUARK_MM_SWIZZLE(b, 2, 2, 2, 2)));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, QUARK_MM_SWIZZLE(b, 3, 3, 3, 3)));
+                _mm_storeu_ps(&result.m[i], r);
+            }
+            return result;
+#else
+            return MultiplyScalar(mat);
+#endif
+        }
+
+        Vec4 operator*(const Vec4& v) const {
+#if defined(QUARK_MATH_SSE2)
+            __m128 r = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(v.x));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(v.y)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(v.z)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(v.w)));
+            Vec4 result;
+            _mm_storeu_ps(&result.x, r);
+            return result;
+#else
+            return TransformScalar(v);
+#endif
+        }
+
+        // Scalar reference implementations (SIMD paths must match these)
+        Mat4 MultiplyScalar(const Mat4& mat) const {
             Mat4 result;
             for (int i = 0; i < 4; i++) {
                 for (int j = 0; j < 4; j++) {
@@ -247,7 +337,7 @@ namespace Quark {
             return result;
         }
 
-        Vec4 operator*(const Vec4& v) const {
+        Vec4 TransformScalar(const Vec4& v) const {
             return Vec4(
                 m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
                 m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
@@ -271,11 +361,23 @@ namespace Quark {
 
         Mat4 Transposed() const {
             Mat4 result;
+#if defined(QUARK_MATH_SSE2)
+            __m128 c0 = _mm_loadu_ps(&m[0]);
+            __m128 c1 = _mm_loadu_ps(&m[4]);
+            __m128 c2 = _mm_loadu_ps(&m[8]);
+            __m128 c3 = _mm_loadu_ps(&m[12]);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&result.m[0], c0);
+            _mm_storeu_ps(&result.m[4], c1);
+            _mm_storeu_ps(&result.m[8], c2);
+            _mm_storeu_ps(&result.m[12], c3);
+#else
             for (int i = 0; i < 4; i++) {
                 for (int j = 0; j < 4; j++) {
                     result.m[i * 4 + j] = m[j * 4 + i];
                 }
             }
+#endif
             return result;
         }
 
@@ -302,6 +404,73 @@ namespace Quark {
         }
 
         Mat4 Inverted() const {
+#if defined(QUARK_MATH_SSE2)
+            // Same cofactor expansion as InvertedScalar, four result elements per lane group.
+            // Every lane evaluates its terms in the scalar order, so results are bit-identical.
+            __m128 a = _mm_loadu_ps(&m[0]);
+            __m128 b = _mm_loadu_ps(&m[4]);
+            __m128 c = _mm_loadu_ps(&m[8]);
+            __m128 d = _mm_loadu_ps(&m[12]);
+
+            // 2x2 sub-determinants: lo0 = (b00..b03), lo1 = (b04, b05), hi0 = (b06..b09), hi1 = (b10, b11)
+            __m128 lo0 = _mm_sub_ps(
+                _mm_mul_ps(QUARK_MM_SWIZZLE(a, 0, 0, 0, 1), QUARK_MM_SWIZZLE(b, 1, 2, 3, 2)),
+                _mm_mul_ps(QUARK_MM_SWIZZLE(a, 1, 2, 3, 2), QUARK_MM_SWIZZLE(b, 0, 0, 0, 1)));
+            __m128 lo1 = _mm_sub_ps(
+                _mm_mul_ps(QUARK_MM_SWIZZLE(a, 1, 2, 1, 2), QUARK_MM_SWIZZLE(b, 3, 3, 3, 3)),
+                _mm_mul_ps(QUARK_MM_SWIZZLE(a, 3, 3, 3, 3), QUARK_MM_SWIZZLE(b, 1, 2, 1, 2)));
+            __m128 hi0 = _mm_sub_ps(
+                _mm_mul_ps(QUARK_MM_SWIZZLE(c, 0, 0, 0, 1), QUARK_MM_SWIZZLE(d, 1, 2, 3, 2)),
+                _mm_mul_ps(QUARK_MM_SWIZZLE(c, 1, 2, 3, 2), QUARK_MM_SWIZZLE(d, 0, 0, 0, 1)));
+            __m128 hi1 = _mm_sub_ps(
+                _mm_mul_ps(QUARK_MM_SWIZZLE(c, 1, 2, 1, 2), QUARK_MM_SWIZZLE(d, 3, 3, 3, 3)),
+                _mm_mul_ps(QUARK_MM_SWIZZLE(c, 3, 3, 3, 3), QUARK_MM_SWIZZLE(d, 1, 2, 1, 2)));
+
+            float lo[8], hi[8];
+            _mm_storeu_ps(&lo[0], lo0);
+            _mm_storeu_ps(&lo[4], lo1);
+            _mm_storeu_ps(&hi[0], hi0);
+            _mm_storeu_ps(&hi[4], hi1);
+
+            float det = lo[0] * hi[5] - lo[1] * hi[4] + lo[2] * hi[3] + lo[3] * hi[2] - lo[4] * hi[1] + lo[5] * hi[0];
+
+            if (std::abs(det) < EPSILON) {
+                return Mat4::Identity();
+            }
+
+            // (b_hi, b_hi, b_lo, b_lo) pairs, e.g. v11 = (b11, b11, b05, b05)
+            __m128 v11 = _mm_shuffle_ps(hi1, lo1, _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 v10 = _mm_shuffle_ps(hi1, lo1, _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 v09 = _mm_shuffle_ps(hi0, lo0, _MM_SHUFFLE(3, 3, 3, 3));
+            __m128 v08 = _mm_shuffle_ps(hi0, lo0, _MM_SHUFFLE(2, 2, 2, 2));
+            __m128 v07 = _mm_shuffle_ps(hi0, lo0, _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 v06 = _mm_shuffle_ps(hi0, lo0, _MM_SHUFFLE(0, 0, 0, 0));
+
+            // Rows of (b, a, d, c): ux = (a10, a00, a30, a20) etc.
+            __m128 ux = b, uy = a, uz = d, uw = c;
+            _MM_TRANSPOSE4_PS(ux, uy, uz, uw);
+
+            const __m128 signEven = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+            const __m128 signOdd = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+            __m128 invDet = _mm_set1_ps(1.0f / det);
+
+            __m128 r0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(uy, v11), _mm_mul_ps(uz, v10)), _mm_mul_ps(uw, v09));
+            __m128 r1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ux, v11), _mm_mul_ps(uz, v08)), _mm_mul_ps(uw, v07));
+            __m128 r2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ux, v10), _mm_mul_ps(uy, v08)), _mm_mul_ps(uw, v06));
+            __m128 r3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ux, v09), _mm_mul_ps(uy, v07)), _mm_mul_ps(uz, v06));
+
+            Mat4 result;
+            _mm_storeu_ps(&result.m[0], _mm_mul_ps(_mm_xor_ps(r0, signEven), invDet));
+            _mm_storeu_ps(&result.m[4], _mm_mul_ps(_mm_xor_ps(r1, signOdd), invDet));
+            _mm_storeu_ps(&result.m[8], _mm_mul_ps(_mm_xor_ps(r2, signEven), invDet));
+            _mm_storeu_ps(&result.m[12], _mm_mul_ps(_mm_xor_ps(r3, signOdd), invDet));
+            return result;
+#else
+            return InvertedScalar();
+#endif
+        }
+
+        Mat4 InvertedScalar() const {
             float a00 = m[0], a01 = m[1], a02 = m[2], a03 = m[3];
             float a10 = m[4], a11 = m[5], a12 = m[6], a13 = m[7];
             float a20 = m[8], a21 = m[9], a22 = m[10], a23 = m[11];
@@ -353,6 +522,145 @@ namespace Quark {
             *this = Inverted();
         }
 
+        MatrixType Classify() const {
+            if (m[3] != 0.0f || m[7] != 0.0f || m[11] != 0.0f || m[15] != 1.0f) {
+                return MatrixType::GENERAL;
+            }
+
+            float len0 = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+            float len1 = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+            float len2 = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+            float dot01 = m[0] * m[4] + m[1] * m[5] + m[2] * m[6];
+            float dot02 = m[0] * m[8] + m[1] * m[9] + m[2] * m[10];
+            float dot12 = m[4] * m[8] + m[5] * m[9] + m[6] * m[10];
+
+            // Degenerate basis (det below EPSILON, e.g. a zero scale): AFFINE guards it the way Inverted() does
+            if (len0 * len0 * len0 < EPSILON * EPSILON) {
+                return MatrixType::AFFINE;
+            }
+
+            // Tolerances are relative to the squared axis length
+            float tolerance = 1e-4f * len0;
+            if (std::abs(dot01) > tolerance || std::abs(dot02) > tolerance || std::abs(dot12) > tolerance ||
+                std::abs(len1 - len0) > tolerance || std::abs(len2 - len0) > tolerance) {
+                return MatrixType::AFFINE;
+            }
+
+            return (std::abs(len0 - 1.0f) <= 1e-4f) ? MatrixType::RIGID : MatrixType::UNIFORM_SCALE;
+        }
+
+        // Inverse for matrices whose last row is (0, 0, 0, 1)
+        Mat4 InvertedAffine() const {
+            // Columns of the upper 3x3
+            Vec3 c0(m[0], m[1], m[2]);
+            Vec3 c1(m[4], m[5], m[6]);
+            Vec3 c2(m[8], m[9], m[10]);
+
+            // Rows of the inverse are the cross products divided by the determinant
+            Vec3 r0 = c1.Cross(c2);
+            Vec3 r1 = c2.Cross(c0);
+            Vec3 r2 = c0.Cross(c1);
+
+            float det = c0.Dot(r0);
+            if (std::abs(det) < EPSILON) {
+                return Mat4::Identity();
+            }
+
+            float invDet = 1.0f / det;
+            r0 *= invDet;
+            r1 *= invDet;
+            r2 *= invDet;
+
+            Vec3 t(m[12], m[13], m[14]);
+
+            Mat4 result;
+            result.m[0] = r0.x; result.m[4] = r0.y; result.m[8] = r0.z;
+            result.m[1] = r1.x; result.m[5] = r1.y; result.m[9] = r1.z;
+            result.m[2] = r2.x; result.m[6] = r2.y; result.m[10] = r2.z;
+            result.m[12] = -r0.Dot(t);
+            result.m[13] = -r1.Dot(t);
+            result.m[14] = -r2.Dot(t);
+            return result;
+        }
+
+        // Inverse of a rotation + translation (+ uniform scale) matrix, transpose based
+        Mat4 InvertedRigid() const {
+            float invScaleSq = 1.0f / (m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+
+            Mat4 result;
+            result.m[0] = m[0] * invScaleSq; result.m[4] = m[1] * invScaleSq; result.m[8] = m[2] * invScaleSq;
+            result.m[1] = m[4] * invScaleSq; result.m[5] = m[5] * invScaleSq; result.m[9] = m[6] * invScaleSq;
+            result.m[2] = m[8] * invScaleSq; result.m[6] = m[9] * invScaleSq; result.m[10] = m[10] * invScaleSq;
+
+            result.m[12] = -(result.m[0] * m[12] + result.m[4] * m[13] + result.m[8] * m[14]);
+            result.m[13] = -(result.m[1] * m[12] + result.m[5] * m[13] + result.m[9] * m[14]);
+            result.m[14] = -(result.m[2] * m[12] + result.m[6] * m[13] + result.m[10] * m[14]);
+            return result;
+        }
+
+        Mat4 Inverted(MatrixType type) const {
+            switch (type) {
+                case MatrixType::RIGID:
+                case MatrixType::UNIFORM_SCALE: return InvertedRigid();
+                case MatrixType::AFFINE: return InvertedAffine();
+                default: return Inverted();
+            }
+        }
+
+        // Normal matrix: inverse-transpose of the upper 3x3, rest is identity.
+        // Columns are the cofactor cross products, no full inverse needed.
+        Mat4 NormalMatrix() const {
+            Vec3 c0(m[0], m[1], m[2]);
+            Vec3 c1(m[4], m[5], m[6]);
+            Vec3 c2(m[8], m[9], m[10]);
+
+            Vec3 n0 = c1.Cross(c2);
+            Vec3 n1 = c2.Cross(c0);
+            Vec3 n2 = c0.Cross(c1);
+
+            float det = c0.Dot(n0);
+            if (std::abs(det) < EPSILON) {
+                return Mat4::Identity();
+            }
+
+            float invDet = 1.0f / det;
+
+            Mat4 result;
+            result.m[0] = n0.x * invDet; result.m[1] = n0.y * invDet; result.m[2] = n0.z * invDet;
+            result.m[4] = n1.x * invDet; result.m[5] = n1.y * invDet; result.m[6] = n1.z * invDet;
+            result.m[8] = n2.x * invDet; result.m[9] = n2.y * invDet; result.m[10] = n2.z * invDet;
+            return result;
+        }
+
+        Mat4 NormalMatrix(MatrixType type) const {
+            Mat4 result;
+            switch (type) {
+                case MatrixType::RIGID:
+                    // Orthonormal basis, inverse-transpose is the basis itself
+                    result.m[0] = m[0]; result.m[1] = m[1]; result.m[2] = m[2];
+                    result.m[4] = m[4]; result.m[5] = m[5]; result.m[6] = m[6];
+                    result.m[8] = m[8]; result.m[9] = m[9]; result.m[10] = m[10];
+                    return result;
+                case MatrixType::UNIFORM_SCALE: {
+                    // (s * R)^-T = R / s = basis / s^2
+                    float invScaleSq = 1.0f / (m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+                    result.m[0] = m[0] * invScaleSq; result.m[1] = m[1] * invScaleSq; result.m[2] = m[2] * invScaleSq;
+                    result.m[4] = m[4] * invScaleSq; result.m[5] = m[5] * invScaleSq; result.m[6] = m[6] * invScaleSq;
+                    result.m[8] = m[8] * invScaleSq; result.m[9] = m[9] * invScaleSq; result.m[10] = m[10] * invScaleSq;
+                    return result;
+                }
+                case MatrixType::AFFINE:
+                    return NormalMatrix();
+                default:
+                    // Projective: the upper 3x3 of the full inverse, transposed
+                    result = Inverted().Transposed();
+                    result.m[3] = result.m[7] = result.m[11] = 0.0f;
+                    result.m[12] = result.m[13] = result.m[14] = 0.0f;
+                    result.m[15] = 1.0f;
+                    return result;
+            }
+        }
+
         static Mat4 Identity() { return Mat4(); }
 
         static Mat4 Translation(const Vec3& v) {
@@ -903,4 +1211,244 @@ namespace Quark {
         return Vec3(Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z));
     }
 
+    // ==================== BATCH (SoA) ====================
+
+    // AABB set in structure-of-arrays form (center / half-extent per axis)
+    struct AABBSoA {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> extentX, extentY, extentZ;
+
+        size_t Size() const { return centerX.size(); }
+
+        void Clear() {
+            centerX.clear(); centerY.clear(); centerZ.clear();
+            extentX.clear(); extentY.clear(); extentZ.clear();
+        }
+
+        void Reserve(size_t count) {
+            centerX.reserve(count); centerY.reserve(count); centerZ.reserve(count);
+            extentX.reserve(count); extentY.reserve(count); extentZ.reserve(count);
+        }
+
+        void Resize(size_t count) {
+            centerX.resize(count); centerY.resize(count); centerZ.resize(count);
+            extentX.resize(count); extentY.resize(count); extentZ.resize(count);
+        }
+
+        void Add(const AABB& box) {
+            Vec3 c = box.Center();
+            Vec3 e = box.Extents();
+            centerX.push_back(c.x); centerY.push_back(c.y); centerZ.push_back(c.z);
+            extentX.push_back(e.x); extentY.push_back(e.y); extentZ.push_back(e.z);
+        }
+
+        void Set(size_t i, const AABB& box) {
+            Vec3 c = box.Center();
+            Vec3 e = box.Extents();
+            centerX[i] = c.x; centerY[i] = c.y; centerZ[i] = c.z;
+            extentX[i] = e.x; extentY[i] = e.y; extentZ[i] = e.z;
+        }
+
+        AABB Get(size_t i) const {
+            Vec3 c(centerX[i], centerY[i], centerZ[i]);
+            Vec3 e(extentX[i], extentY[i], extentZ[i]);
+            return AABB(c - e, c + e);
+        }
+    };
+
+    // Transform N points given as separate x/y/z arrays (w = 1). Output may alias input.
+    inline void TransformPoints(const Mat4& mat, const float* xs, const float* ys, const float* zs,
+                                float* outX, float* outY, float* outZ, size_t count) {
+        size_t i = 0;
+#if defined(QUARK_MATH_SSE2)
+        const __m128 m0 = _mm_set1_ps(mat.m[0]), m1 = _mm_set1_ps(mat.m[1]), m2 = _mm_set1_ps(mat.m[2]);
+        const __m128 m4 = _mm_set1_ps(mat.m[4]), m5 = _mm_set1_ps(mat.m[5]), m6 = _mm_set1_ps(mat.m[6]);
+        const __m128 m8 = _mm_set1_ps(mat.m[8]), m9 = _mm_set1_ps(mat.m[9]), m10 = _mm_set1_ps(mat.m[10]);
+        const __m128 m12 = _mm_set1_ps(mat.m[12]), m13 = _mm_set1_ps(mat.m[13]), m14 = _mm_set1_ps(mat.m[14]);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(xs + i);
+            __m128 y = _mm_loadu_ps(ys + i);
+            __m128 z = _mm_loadu_ps(zs + i);
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)), m12);
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)), m13);
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)), m14);
+            _mm_storeu_ps(outX + i, rx);
+            _mm_storeu_ps(outY + i, ry);
+            _mm_storeu_ps(outZ + i, rz);
+        }
+#endif
+        for (; i < count; i++) {
+            float x = xs[i], y = ys[i], z = zs[i];
+            outX[i] = mat.m[0] * x + mat.m[4] * y + mat.m[8] * z + mat.m[12];
+            outY[i] = mat.m[1] * x + mat.m[5] * y + mat.m[9] * z + mat.m[13];
+            outZ[i] = mat.m[2] * x + mat.m[6] * y + mat.m[10] * z + mat.m[14];
+        }
+    }
+
+    // Transform N points (w = 1), affine part only. Output may alias input.
+    inline void TransformPoints(const Mat4& mat, const Vec3* points, Vec3* outPoints, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            Vec3 p = points[i];
+            outPoints[i] = Vec3(
+                mat.m[0] * p.x + mat.m[4] * p.y + mat.m[8] * p.z + mat.m[12],
+                mat.m[1] * p.x + mat.m[5] * p.y + mat.m[9] * p.z + mat.m[13],
+                mat.m[2] * p.x + mat.m[6] * p.y + mat.m[10] * p.z + mat.m[14]
+            );
+        }
+    }
+
+    // Arvo's method: world center = M * c, world extent = |M3x3| * e
+    inline AABB TransformAABB(const Mat4& mat, const AABB& box) {
+#if defined(QUARK_MATH_SSE2)
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 c0 = _mm_loadu_ps(&mat.m[0]);
+        __m128 c1 = _mm_loadu_ps(&mat.m[4]);
+        __m128 c2 = _mm_loadu_ps(&mat.m[8]);
+        __m128 c3 = _mm_loadu_ps(&mat.m[12]);
+
+        __m128 bmin = _mm_setr_ps(box.minBounds.x, box.minBounds.y, box.minBounds.z, 0.0f);
+        __m128 bmax = _mm_setr_ps(box.maxBounds.x, box.maxBounds.y, box.maxBounds.z, 0.0f);
+        __m128 half = _mm_set1_ps(0.5f);
+        __m128 c = _mm_mul_ps(_mm_add_ps(bmin, bmax), half);
+        __m128 e = _mm_mul_ps(_mm_sub_ps(bmax, bmin), half);
+
+        __m128 wc = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(c0, QUARK_MM_SWIZZLE(c, 0, 0, 0, 0)),
+            _mm_mul_ps(c1, QUARK_MM_SWIZZLE(c, 1, 1, 1, 1))),
+            _mm_mul_ps(c2, QUARK_MM_SWIZZLE(c, 2, 2, 2, 2))), c3);
+        __m128 we = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_and_ps(c0, absMask), QUARK_MM_SWIZZLE(e, 0, 0, 0, 0)),
+            _mm_mul_ps(_mm_and_ps(c1, absMask), QUARK_MM_SWIZZLE(e, 1, 1, 1, 1))),
+            _mm_mul_ps(_mm_and_ps(c2, absMask), QUARK_MM_SWIZZLE(e, 2, 2, 2, 2)));
+
+        float lo[4], hi[4];
+        _mm_storeu_ps(lo, _mm_sub_ps(wc, we));
+        _mm_storeu_ps(hi, _mm_add_ps(wc, we));
+        return AABB(Vec3(lo[0], lo[1], lo[2]), Vec3(hi[0], hi[1], hi[2]));
+#else
+        Vec3 c = box.Center();
+        Vec3 e = box.Extents();
+        Vec3 wc(
+            mat.m[0] * c.x + mat.m[4] * c.y + mat.m[8] * c.z + mat.m[12],
+            mat.m[1] * c.x + mat.m[5] * c.y + mat.m[9] * c.z + mat.m[13],
+            mat.m[2] * c.x + mat.m[6] * c.y + mat.m[10] * c.z + mat.m[14]
+        );
+        Vec3 we(
+            std::abs(mat.m[0]) * e.x + std::abs(mat.m[4]) * e.y + std::abs(mat.m[8]) * e.z,
+            std::abs(mat.m[1]) * e.x + std::abs(mat.m[5]) * e.y + std::abs(mat.m[9]) * e.z,
+            std::abs(mat.m[2]) * e.x + std::abs(mat.m[6]) * e.y + std::abs(mat.m[10]) * e.z
+        );
+        return AABB(wc - we, wc + we);
+#endif
+    }
+
+    // Transform N AABBs by one matrix. Output may alias input.
+    inline void TransformAABBs(const Mat4& mat, const AABB* boxes, AABB* outBoxes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            outBoxes[i] = TransformAABB(mat, boxes[i]);
+        }
+    }
+
+    // Transform N AABBs, each by its own matrix. Output may alias input.
+    inline void TransformAABBs(const Mat4* matrices, const AABB* boxes, AABB* outBoxes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            outBoxes[i] = TransformAABB(matrices[i], boxes[i]);
+        }
+    }
+
+    // Transform a SoA AABB set by one matrix, four boxes per iteration. Output may alias input.
+    inline void TransformAABBs(const Mat4& mat, const AABBSoA& boxes, AABBSoA& outBoxes) {
+        size_t count = boxes.Size();
+        if (&outBoxes != &boxes) {
+            outBoxes.Resize(count);
+        }
+
+        const float* cx = boxes.centerX.data(); const float* cy = boxes.centerY.data(); const float* cz = boxes.centerZ.data();
+        const float* ex = boxes.extentX.data(); const float* ey = boxes.extentY.data(); const float* ez = boxes.extentZ.data();
+        float* ocx = outBoxes.centerX.data(); float* ocy = outBoxes.centerY.data(); float* ocz = outBoxes.centerZ.data();
+        float* oex = outBoxes.extentX.data(); float* oey = outBoxes.extentY.data(); float* oez = outBoxes.extentZ.data();
+
+        // Centers are plain points
+        TransformPoints(mat, cx, cy, cz, ocx, ocy, ocz, count);
+
+        float a0 = std::abs(mat.m[0]), a1 = std::abs(mat.m[1]), a2 = std::abs(mat.m[2]);
+        float a4 = std::abs(mat.m[4]), a5 = std::abs(mat.m[5]), a6 = std::abs(mat.m[6]);
+        float a8 = std::abs(mat.m[8]), a9 = std::abs(mat.m[9]), a10 = std::abs(mat.m[10]);
+
+        size_t i = 0;
+#if defined(QUARK_MATH_SSE2)
+        const __m128 m0 = _mm_set1_ps(a0), m1 = _mm_set1_ps(a1), m2 = _mm_set1_ps(a2);
+        const __m128 m4 = _mm_set1_ps(a4), m5 = _mm_set1_ps(a5), m6 = _mm_set1_ps(a6);
+        const __m128 m8 = _mm_set1_ps(a8), m9 = _mm_set1_ps(a9), m10 = _mm_set1_ps(a10);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(ex + i);
+            __m128 y = _mm_loadu_ps(ey + i);
+            __m128 z = _mm_loadu_ps(ez + i);
+            _mm_storeu_ps(oex + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)));
+            _mm_storeu_ps(oey + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)));
+            _mm_storeu_ps(oez + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)));
+        }
+#endif
+        for (; i < count; i++) {
+            float x = ex[i], y = ey[i], z = ez[i];
+            oex[i] = a0 * x + a4 * y + a8 * z;
+            oey[i] = a1 * x + a5 * y + a9 * z;
+            oez[i] = a2 * x + a6 * y + a10 * z;
+        }
+    }
+
+    // Union of N AABBs. Returns a zero box for count == 0.
+    inline AABB MergeAABBs(const AABB* boxes, size_t count) {
+        if (count == 0) return AABB();
+
+#if defined(QUARK_MATH_SSE2)
+        __m128 lo = _mm_setr_ps(boxes[0].minBounds.x, boxes[0].minBounds.y, boxes[0].minBounds.z, 0.0f);
+        __m128 hi = _mm_setr_ps(boxes[0].maxBounds.x, boxes[0].maxBounds.y, boxes[0].maxBounds.z, 0.0f);
+        for (size_t i = 1; i < count; i++) {
+            lo = _mm_min_ps(lo, _mm_setr_ps(boxes[i].minBounds.x, boxes[i].minBounds.y, boxes[i].minBounds.z, 0.0f));
+            hi = _mm_max_ps(hi, _mm_setr_ps(boxes[i].maxBounds.x, boxes[i].maxBounds.y, boxes[i].maxBounds.z, 0.0f));
+        }
+        float l[4], h[4];
+        _mm_storeu_ps(l, lo);
+        _mm_storeu_ps(h, hi);
+        return AABB(Vec3(l[0], l[1], l[2]), Vec3(h[0], h[1], h[2]));
+#else
+        AABB result = boxes[0];
+        for (size_t i = 1; i < count; i++) {
+            result = result.Merge(boxes[i]);
+        }
+        return result;
+#endif
+    }
+
+    // Bounds of N points read with a byte stride (e.g. Vertex::position). Returns a zero box for count == 0.
+    inline AABB ComputeAABB(const Vec3* points, size_t count, size_t stride = sizeof(Vec3)) {
+        if (count == 0) return AABB();
+
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(points);
+#if defined(QUARK_MATH_SSE2)
+        const Vec3& p0 = *points;
+        __m128 lo = _mm_setr_ps(p0.x, p0.y, p0.z, 0.0f);
+        __m128 hi = lo;
+        for (size_t i = 1; i < count; i++) {
+            const Vec3& p = *reinterpret_cast<const Vec3*>(base + i * stride);
+            __m128 v = _mm_setr_ps(p.x, p.y, p.z, 0.0f);
+            lo = _mm_min_ps(lo, v);
+            hi = _mm_max_ps(hi, v);
+        }
+        float l[4], h[4];
+        _mm_storeu_ps(l, lo);
+        _mm_storeu_ps(h, hi);
+        return AABB(Vec3(l[0], l[1], l[2]), Vec3(h[0], h[1], h[2]));
+#else
+        AABB result(*points, *points);
+        for (size_t i = 1; i < count; i++) {
+            result.Expand(*reinterpret_cast<const Vec3*>(base + i * stride));
+        }
+        return result;
+#endif
+    }
+
 }
\ No newline at end of file
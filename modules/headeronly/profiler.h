@@ -0,0 +1,407 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define QUARK_PROFILER_RDTSC 1
+#endif
+
+#include "globaltypes.h"
+
+// ==================== PROFILER SWITCH ====================
+// QUARK_PROFILER_ENABLED (set by the QUARK_ENABLE_PROFILER CMake option) turns
+// the QUARK_PROFILE_* macros on. Without it they expand to nothing and the
+// Profiler class is only there so APIs that pass one around still compile.
+#ifndef QUARK_PROFILER_ENABLED
+#define QUARK_PROFILER_ENABLED 0
+#endif
+
+// Keeps the module binding below private to each shared object, like a DLL on Windows
+#if defined(__GNUC__) && !defined(_WIN32)
+#define QUARK_PROFILER_MODULE_LOCAL __attribute__((visibility("hidden")))
+#else
+#define QUARK_PROFILER_MODULE_LOCAL
+#endif
+
+namespace Quark
+{
+    constexpr UINT32 PROFILER_DEFAULT_THREAD_EVENTS = 1u << 15;   // Per thread and module, 32 bytes each
+
+    enum class ProfileEventType : UINT32
+    {
+        ZONE,       // start..end
+        COUNTER,    // value at start
+        FRAME       // Frame marker at start
+    };
+
+    struct ProfileEvent
+    {
+        const char* name;       // Must outlive the profiler (string literals)
+        UINT64 start;
+        union
+        {
+            UINT64 end;
+            double value;
+        };
+        ProfileEventType type;
+        UINT32 _pad;
+    };
+
+    // Ring of the most recent events of one thread in one module. Only the
+    // owning thread writes; the exporter reads up to `written` once recording stopped.
+    struct ProfileThreadBuffer
+    {
+        std::unique_ptr<ProfileEvent[]> events;
+        UINT32 mask;
+        UINT32 threadIndex;
+        const char* module;
+        alignas(64) std::atomic<UINT64> written{ 0 };
+    };
+
+    // ==================== PROFILER ====================
+    // Collects zones, counters and frame markers from every thread into one
+    // timeline and writes it as Chrome trace JSON (chrome://tracing, Perfetto).
+    //
+    // One instance is shared by all modules: its owner hands the pointer to each
+    // module, which installs it with setModuleProfiler(). Recording only happens
+    // between beginCapture() and endCapture(); outside of that a zone is a load
+    // and a branch. Timestamps are raw TSC ticks, converted to microseconds at
+    // export from the wall time the capture took.
+    class Profiler
+    {
+    private:
+        struct ThreadInfo
+        {
+            std::thread::id id;
+            std::string name;
+        };
+
+        UINT32 m_ThreadEvents;
+        UINT64 m_Serial;
+        std::atomic<bool> m_Capturing;
+
+        UINT64 m_CaptureStartTicks;
+        UINT64 m_CaptureEndTicks;
+        std::chrono::steady_clock::time_point m_CaptureStartTime;
+        std::chrono::steady_clock::time_point m_CaptureEndTime;
+
+        mutable std::mutex m_Mutex;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> m_Buffers;
+        std::vector<ThreadInfo> m_Threads;   // Index = trace tid
+
+        static UINT64 nextSerial()
+        {
+            static std::atomic<UINT64> serial{ 0 };
+            return ++serial;
+        }
+
+        UINT32 findThread(const char* name)
+        {
+            const std::thread::id id = std::this_thread::get_id();
+            for (UINT32 i = 0; i < m_Threads.size(); ++i)
+            {
+                if (m_Threads[i].id == id)
+                {
+                    if (name && m_Threads[i].name.empty()) m_Threads[i].name = name;
+                    return i;
+                }
+            }
+            m_Threads.push_back({ id, name ? name : "" });
+            return static_cast<UINT32>(m_Threads.size() - 1);
+        }
+
+        static void writeString(FILE* file, const char* text)
+        {
+            fputc('"', file);
+            for (const char* c = text; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\') fputc('\\', file);
+                if (static_cast<unsigned char>(*c) >= 0x20) fputc(*c, file);
+            }
+            fputc('"', file);
+        }
+
+    public:
+        // threadEvents is rounded up to a power of two
+        explicit Profiler(UINT32 threadEvents = PROFILER_DEFAULT_THREAD_EVENTS)
+            : m_ThreadEvents(1)
+            , m_Serial(nextSerial())
+            , m_Capturing(false)
+            , m_CaptureStartTicks(0)
+            , m_CaptureEndTicks(0)
+        {
+            while (m_ThreadEvents < threadEvents) m_ThreadEvents <<= 1;
+        }
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        static UINT64 now()
+        {
+#ifdef QUARK_PROFILER_RDTSC
+            return __rdtsc();
+#else
+            return static_cast<UINT64>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        // ==================== CAPTURE ====================
+        // Events from before beginCapture() are dropped at export, so buffers are never cleared
+        void beginCapture()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_CaptureStartTime = std::chrono::steady_clock::now();
+            m_CaptureStartTicks = now();
+            m_Capturing.store(true, std::memory_order_release);
+        }
+
+        void endCapture()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Capturing.load(std::memory_order_relaxed)) return;
+            m_Capturing.store(false, std::memory_order_release);
+            m_CaptureEndTicks = now();
+            m_CaptureEndTime = std::chrono::steady_clock::now();
+        }
+
+        bool isCapturing() const { return m_Capturing.load(std::memory_order_relaxed); }
+        UINT64 getSerial() const { return m_Serial; }
+
+        // ==================== THREADS ====================
+        // Called once per thread and module, from the thread itself
+        ProfileThreadBuffer* registerThread(const char* module, const char* threadName)
+        {
+            auto buffer = std::make_unique<ProfileThreadBuffer>();
+            buffer->events.reset(new ProfileEvent[m_ThreadEvents]);
+            buffer->mask = m_ThreadEvents - 1;
+            buffer->module = module;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            buffer->threadIndex = findThread(threadName);
+            m_Buffers.push_back(std::move(buffer));
+            return m_Buffers.back().get();
+        }
+
+        void setThreadName(const char* name)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Threads[findThread(nullptr)].name = name;
+        }
+
+        // ==================== EXPORT ====================
+        // Writes the last capture. Call after endCapture(): zones still open on
+        // other threads are not included, and each buffer keeps only its most
+        // recent PROFILER_DEFAULT_THREAD_EVENTS events.
+        bool writeChromeTrace(const char* filename) const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (m_CaptureStartTicks == 0 || m_Capturing.load(std::memory_order_relaxed))
+            {
+                std::cerr << "[Profiler] ERROR: No finished capture to write.\n";
+                return false;
+            }
+
+            FILE* file = fopen(filename, "wb");
+            if (!file)
+            {
+                std::cerr << "[Profiler] ERROR: Cannot open " << filename << ".\n";
+                return false;
+            }
+
+            const double wallMicroseconds = std::chrono::duration<double, std::micro>(m_CaptureEndTime - m_CaptureStartTime).count();
+            const UINT64 ticks = m_CaptureEndTicks - m_CaptureStartTicks;
+            const double microsecondsPerTick = ticks > 0 ? wallMicroseconds / static_cast<double>(ticks) : 0.0;
+
+            fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+            fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Quark Engine\"}}");
+
+            for (UINT32 i = 0; i < m_Threads.size(); ++i)
+            {
+                if (m_Threads[i].name.empty()) continue;
+                fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i);
+                writeString(file, m_Threads[i].name.c_str());
+                fprintf(file, "}}");
+            }
+
+            for (const auto& buffer : m_Buffers)
+            {
+                const UINT64 written = buffer->written.load(std::memory_order_acquire);
+                const UINT64 first = written > buffer->mask + 1ull ? written - (buffer->mask + 1ull) : 0;
+
+                for (UINT64 index = first; index < written; ++index)
+                {
+                    const ProfileEvent& event = buffer->events[index & buffer->mask];
+                    if (event.start < m_CaptureStartTicks || event.start > m_CaptureEndTicks) continue;
+                    if (event.type == ProfileEventType::ZONE && event.end > m_CaptureEndTicks) continue;
+
+                    const double ts = static_cast<double>(event.start - m_CaptureStartTicks) * microsecondsPerTick;
+
+                    fprintf(file, ",\n{\"name\":");
+                    writeString(file, event.name);
+                    fprintf(file, ",\"cat\":");
+                    writeString(file, buffer->module);
+
+                    switch (event.type)
+                    {
+                    case ProfileEventType::ZONE:
+                        fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                            ts, static_cast<double>(event.end - event.start) * microsecondsPerTick);
+                        break;
+                    case ProfileEventType::COUNTER:
+                        fprintf(file, ",\"ph\":\"C\",\"ts\":%.3f,\"args\":{\"value\":%.17g}", ts, event.value);
+                        break;
+                    case ProfileEventType::FRAME:
+                        fprintf(file, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f", ts);
+                        break;
+                    }
+                    fprintf(file, ",\"pid\":1,\"tid\":%u}", buffer->threadIndex);
+                }
+            }
+
+            fprintf(file, "\n]}\n");
+            const bool succeeded = ferror(file) == 0;
+            fclose(file);
+
+            if (!succeeded) std::cerr << "[Profiler] ERROR: Failed writing " << filename << ".\n";
+            return succeeded;
+        }
+    };
+
+    // ==================== MODULE BINDING ====================
+    // Every module (DLL) has its own copy of these, so each one installs the
+    // shared profiler itself; `module` becomes the event category.
+    struct ProfilerModule
+    {
+        Profiler* profiler = nullptr;
+        const char* name = "unknown";
+    };
+
+    struct ProfilerThreadCache
+    {
+        UINT64 serial = 0;
+        ProfileThreadBuffer* buffer = nullptr;
+        const char* threadName = nullptr;
+    };
+
+    QUARK_PROFILER_MODULE_LOCAL inline ProfilerModule g_ProfilerModule;
+    QUARK_PROFILER_MODULE_LOCAL inline thread_local ProfilerThreadCache t_ProfilerThread;
+
+    inline void setModuleProfiler(Profiler* profiler, const char* module)
+    {
+        g_ProfilerModule.profiler = profiler;
+        g_ProfilerModule.name = module;
+    }
+
+    inline Profiler* getModuleProfiler() { return g_ProfilerModule.profiler; }
+
+    // The module's profiler while it is recording
+    inline Profiler* activeProfiler()
+    {
+        Profiler* profiler = g_ProfilerModule.profiler;
+        return profiler && profiler->isCapturing() ? profiler : nullptr;
+    }
+
+    inline void profileRecord(Profiler* profiler, ProfileEventType type, const char* name, UINT64 start, UINT64 end)
+    {
+        ProfilerThreadCache& cache = t_ProfilerThread;
+        if (cache.serial != profiler->getSerial())
+        {
+            cache.buffer = profiler->registerThread(g_ProfilerModule.name, cache.threadName);
+            cache.serial = profiler->getSerial();
+        }
+
+        ProfileThreadBuffer* buffer = cache.buffer;
+        const UINT64 index = buffer->written.load(std::memory_order_relaxed);
+        ProfileEvent& event = buffer->events[index & buffer->mask];
+        event.name = name;
+        event.start = start;
+        event.end = end;
+        event.type = type;
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    inline void profileCounter(const char* name, double value)
+    {
+        if (Profiler* profiler = activeProfiler())
+        {
+            UINT64 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            profileRecord(profiler, ProfileEventType::COUNTER, name, Profiler::now(), bits);
+        }
+    }
+
+    inline void profileFrame(const char* name)
+    {
+        if (Profiler* profiler = activeProfiler())
+        {
+            const UINT64 now = Profiler::now();
+            profileRecord(profiler, ProfileEventType::FRAME, name, now, now);
+        }
+    }
+
+    // Also works before the profiler is installed, the name is applied when the thread registers
+    inline void profileThreadName(const char* name)
+    {
+        t_ProfilerThread.threadName = name;
+        if (Profiler* profiler = g_ProfilerModule.profiler) profiler->setThreadName(name);
+    }
+
+    // ==================== ZONE ====================
+    // Records [construction, destruction) as one event when it closes
+    class ProfileZone
+    {
+    private:
+        Profiler* m_pProfiler;
+        const char* m_Name;
+        UINT64 m_Start;
+
+    public:
+        explicit ProfileZone(const char* name)
+            : m_pProfiler(activeProfiler())
+            , m_Name(name)
+            , m_Start(m_pProfiler ? Profiler::now() : 0)
+        {
+        }
+
+        ~ProfileZone()
+        {
+            if (m_pProfiler) profileRecord(m_pProfiler, ProfileEventType::ZONE, m_Name, m_Start, Profiler::now());
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+    };
+}
+
+// ==================== MACROS ====================
+// Names must be string literals (or otherwise outlive the profiler).
+#if QUARK_PROFILER_ENABLED
+#define QUARK_PROFILE_CONCAT_INNER(a, b) a##b
+#define QUARK_PROFILE_CONCAT(a, b) QUARK_PROFILE_CONCAT_INNER(a, b)
+#define QUARK_PROFILE_ZONE(name) ::Quark::ProfileZone QUARK_PROFILE_CONCAT(quarkProfileZone_, __LINE__)(name)
+#define QUARK_PROFILE_FUNCTION() QUARK_PROFILE_ZONE(__func__)
+#define QUARK_PROFILE_COUNTER(name, value) ::Quark::profileCounter(name, static_cast<double>(value))
+#define QUARK_PROFILE_FRAME(name) ::Quark::profileFrame(name)
+#define QUARK_PROFILE_THREAD(name) ::Quark::profileThreadName(name)
+#else
+#define QUARK_PROFILE_ZONE(name) ((void)0)
+#define QUARK_PROFILE_FUNCTION() ((void)0)
+#define QUARK_PROFILE_COUNTER(name, value) ((void)0)
+#define QUARK_PROFILE_FRAME(name) ((void)0)
+#define QUARK_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include "globaltypes.h"
+
+namespace Quark
+{
+    // ==================== SLOT MAP ====================
+    // Dense generational storage behind 32-bit resource handles.
+    //
+    // Handle layout: [generation:12][index:20]
+    //   index      - slot in the sparse table, which points into the dense array
+    //   generation - bumped every time a slot is freed, a stale handle no longer matches
+    // Generations start at 1 so a valid handle is never 0 (0 stays the null handle).
+    //
+    // Values live contiguously and are iterated without gaps. Removal swaps the last
+    // value into the hole, so pointers returned by get() stay valid until the next
+    // insert or remove; lookups themselves never move anything.
+    template <typename T>
+    class SlotMap
+    {
+    public:
+        static constexpr UINT32 INDEX_BITS = 20;
+        static constexpr UINT32 GENERATION_BITS = 12;
+        static constexpr UINT32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+        static constexpr UINT32 GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+        static constexpr UINT32 MAX_SLOTS = 1u << INDEX_BITS;
+        static constexpr UINT32 INVALID_HANDLE = 0;
+
+    private:
+        static constexpr UINT32 FREE_SLOT = 0xFFFFFFFFu;
+
+        struct Slot
+        {
+            UINT32 denseIndex;   // FREE_SLOT while unused
+            UINT32 generation;
+            UINT32 nextFree;     // Free list link while unused
+        };
+
+        std::vector<Slot> m_Slots;
+        std::vector<T> m_Values;
+        std::vector<UINT32> m_DenseToSlot;
+        UINT32 m_FreeHead = FREE_SLOT;
+
+        static UINT32 makeHandle(UINT32 index, UINT32 generation) { return (generation << INDEX_BITS) | index; }
+
+        const Slot* findSlot(UINT32 handle) const
+        {
+            UINT32 index = handle & INDEX_MASK;
+            if (index >= m_Slots.size()) return nullptr;
+
+            const Slot& slot = m_Slots[index];
+            if (slot.denseIndex == FREE_SLOT || slot.generation != (handle >> INDEX_BITS)) return nullptr;
+            return &slot;
+        }
+
+        UINT32 allocateSlot()
+        {
+            if (m_FreeHead != FREE_SLOT)
+            {
+                UINT32 index = m_FreeHead;
+                m_FreeHead = m_Slots[index].nextFree;
+                return index;
+            }
+
+            if (m_Slots.size() >= MAX_SLOTS) return FREE_SLOT;
+
+            m_Slots.push_back({ FREE_SLOT, 1, FREE_SLOT });
+            return static_cast<UINT32>(m_Slots.size() - 1);
+        }
+
+        void releaseSlot(UINT32 index)
+        {
+            // Generation 0 is skipped on wrap so handles never collapse to the null handle
+            Slot& slot = m_Slots[index];
+            slot.generation = (slot.generation + 1) & GENERATION_MASK;
+            if (slot.generation == 0) slot.generation = 1;
+            slot.denseIndex = FREE_SLOT;
+            slot.nextFree = m_FreeHead;
+            m_FreeHead = index;
+        }
+
+    public:
+        template <typename... Args>
+        UINT32 emplace(Args&&... args)
+        {
+            UINT32 index = allocateSlot();
+            if (index == FREE_SLOT) return INVALID_HANDLE;
+
+            Slot& slot = m_Slots[index];
+            slot.denseIndex = static_cast<UINT32>(m_Values.size());
+            slot.nextFree = FREE_SLOT;
+
+            m_Values.emplace_back(std::forward<Args>(args)...);
+            m_DenseToSlot.push_back(index);
+
+            return makeHandle(index, slot.generation);
+        }
+
+        UINT32 insert(const T& value) { return emplace(value); }
+        UINT32 insert(T&& value) { return emplace(std::move(value)); }
+
+        bool remove(UINT32 handle)
+        {
+            if (!findSlot(handle)) return false;
+
+            UINT32 index = handle & INDEX_MASK;
+            UINT32 dense = m_Slots[index].denseIndex;
+            UINT32 last = static_cast<UINT32>(m_Values.size() - 1);
+
+            if (dense != last)
+            {
+                m_Values[dense] = std::move(m_Values[last]);
+                m_DenseToSlot[dense] = m_DenseToSlot[last];
+                m_Slots[m_DenseToSlot[dense]].denseIndex = dense;
+            }
+            m_Values.pop_back();
+            m_DenseToSlot.pop_back();
+
+            releaseSlot(index);
+            return true;
+        }
+
+        T* get(UINT32 handle)
+        {
+            const Slot* slot = findSlot(handle);
+            return slot ? &m_Values[slot->denseIndex] : nullptr;
+        }
+
+        const T* get(UINT32 handle) const
+        {
+            const Slot* slot = findSlot(handle);
+            return slot ? &m_Values[slot->denseIndex] : nullptr;
+        }
+
+        bool contains(UINT32 handle) const { return findSlot(handle) != nullptr; }
+
+        // Dense position of a live handle, INVALID_INDEX when stale
+        static constexpr UINT32 INVALID_INDEX = FREE_SLOT;
+        UINT32 indexOf(UINT32 handle) const
+        {
+            const Slot* slot = findSlot(handle);
+            return slot ? slot->denseIndex : INVALID_INDEX;
+        }
+
+        void clear()
+        {
+            // Keep the slots so handles issued before the clear stay stale
+            for (UINT32 index : m_DenseToSlot)
+            {
+                releaseSlot(index);
+            }
+            m_Values.clear();
+            m_DenseToSlot.clear();
+        }
+
+        void reserve(size_t count)
+        {
+            m_Slots.reserve(count);
+            m_Values.reserve(count);
+            m_DenseToSlot.reserve(count);
+        }
+
+        size_t size() const { return m_Values.size(); }
+        bool empty() const { return m_Values.empty(); }
+
+        // Handle of the value at a dense position
+        UINT32 handleAt(size_t denseIndex) const
+        {
+            UINT32 index = m_DenseToSlot[denseIndex];
+            return makeHandle(index, m_Slots[index].generation);
+        }
+
+        // Dense iteration over live values
+        T* data() { return m_Values.data(); }
+        const T* data() const { return m_Values.data(); }
+        typename std::vector<T>::iterator begin() { return m_Values.begin(); }
+        typename std::vector<T>::iterator end() { return m_Values.end(); }
+        typename std::vector<T>::const_iterator begin() const { return m_Values.begin(); }
+        typename std::vector<T>::const_iterator end() const { return m_Values.end(); }
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "globaltypes.h"
+
+namespace Quark
+{
+    // ==================== SPSC QUEUE ====================
+    // Bounded single-producer / single-consumer ring buffer.
+    //
+    // The producer owns m_Tail and the consumer owns m_Head; each side only
+    // reads the other's index, so no locks are needed. Items are constructed
+    // in place by the producer and read in place by the consumer: front()
+    // stays valid until pop(). Capacity must be a power of two.
+    //
+    // waitForSpace() / waitForItem() block on the other side's index (C++20
+    // atomic wait), which is how callers implement back-pressure.
+    template <typename T, UINT32 Capacity>
+    class SPSCQueue
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+    private:
+        static constexpr UINT32 INDEX_MASK = Capacity - 1;
+
+        alignas(64) std::atomic<UINT32> m_Head{ 0 };   // Next slot to read, written by the consumer
+        alignas(64) std::atomic<UINT32> m_Tail{ 0 };   // Next slot to write, written by the producer
+        alignas(64) T m_Items[Capacity];
+
+    public:
+        SPSCQueue() = default;
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        // ==================== PRODUCER ====================
+        bool full() const
+        {
+            return m_Tail.load(std::memory_order_relaxed) - m_Head.load(std::memory_order_acquire) == Capacity;
+        }
+
+        // Slot for the next item, only valid while !full(). Publish it with push().
+        T& back() { return m_Items[m_Tail.load(std::memory_order_relaxed) & INDEX_MASK]; }
+
+        void push()
+        {
+            m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            m_Tail.notify_one();
+        }
+
+        bool tryPush(const T& item)
+        {
+            if (full()) return false;
+            back() = item;
+            push();
+            return true;
+        }
+
+        void waitForSpace() const
+        {
+            UINT32 tail = m_Tail.load(std::memory_order_relaxed);
+            UINT32 head = m_Head.load(std::memory_order_acquire);
+            while (tail - head == Capacity)
+            {
+                m_Head.wait(head, std::memory_order_acquire);
+                head = m_Head.load(std::memory_order_acquire);
+            }
+        }
+
+        // ==================== CONSUMER ====================
+        bool empty() const
+        {
+            return m_Head.load(std::memory_order_relaxed) == m_Tail.load(std::memory_order_acquire);
+        }
+
+        // Oldest item, only valid while !empty(). Release its slot with pop().
+        T& front() { return m_Items[m_Head.load(std::memory_order_relaxed) & INDEX_MASK]; }
+
+        void pop()
+        {
+            m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            m_Head.notify_one();
+        }
+
+        void waitForItem() const
+        {
+            UINT32 head = m_Head.load(std::memory_order_relaxed);
+            UINT32 tail = m_Tail.load(std::memory_order_acquire);
+            while (head == tail)
+            {
+                m_Tail.wait(tail, std::memory_order_acquire);
+                tail = m_Tail.load(std::memory_order_acquire);
+            }
+        }
+
+        // Approximate when called from a third thread
+        UINT32 size() const { return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire); }
+        static constexpr UINT32 capacity() { return Capacity; }
+    };
+}
@@ -0,0 +1,138 @@
+// test_bvh_tree - DynamicAABBTree height and frustum walk
+//
+// Boxes inserted in sorted order along a line must not degenerate the tree into a list:
+// the rotations in the refit walk keep its height logarithmic. Random inserts, moves and
+// removes follow, and after each step the tree's frustum walk must return exactly the
+// leaves whose fat box passes the plane test, each once.
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "../graphics/rendersystem/bvh.h"
+#include "../graphics/rendersystem/camera.h"
+
+static UINT32 s_Random = 1;
+
+static float randomFloat(float low, float high)
+{
+    s_Random = s_Random * 1664525u + 1013904223u;
+    return low + (high - low) * static_cast<float>((s_Random >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static Quark::AABB randomBox()
+{
+    const Quark::Vec3 center(randomFloat(-40.0f, 40.0f), randomFloat(-20.0f, 20.0f), randomFloat(-20.0f, 60.0f));
+    const Quark::Vec3 extents(randomFloat(0.0f, 3.0f), randomFloat(0.0f, 3.0f), randomFloat(0.0f, 3.0f));
+    return Quark::AABB(center - extents, center + extents);
+}
+
+// AVL-balanced trees stay under 1.44 log2(n + 2); leave some room for the SAH descent
+static bool checkHeight(const char* stage, const DynamicAABBTree& tree)
+{
+    const int limit = static_cast<int>(2.0 * std::log2(static_cast<double>(tree.getLeafCount()) + 2.0)) + 1;
+    if (tree.getHeight() > limit)
+    {
+        std::cerr << "[test_bvh_tree] ERROR: " << stage << ", height " << tree.getHeight() << " for "
+                  << tree.getLeafCount() << " leaves, limit " << limit << ".\n";
+        return false;
+    }
+    return true;
+}
+
+static bool referenceInside(const Frustum& frustum, const Quark::AABB& box)
+{
+    const Quark::Vec3 center = box.Center();
+    const Quark::Vec3 extent = box.Extents();
+    for (int p = 0; p < 6; p++)
+    {
+        const Quark::Plane& plane = frustum.planes[p];
+        float dist = plane.normal.Dot(center) + plane.distance;
+        float radius = std::abs(plane.normal.x) * extent.x + std::abs(plane.normal.y) * extent.y + std::abs(plane.normal.z) * extent.z;
+        if (dist + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+static bool checkCull(const char* stage, const DynamicAABBTree& tree, const Frustum& frustum, const std::vector<UINT32>& proxies, BVHTraversalStack& stack)
+{
+    std::vector<UINT32> visits(proxies.size(), 0);
+    tree.cullFrustum(frustum, stack, [&](UINT32 userData, bool) { visits[userData]++; });
+
+    UINT32 leaves = 0;
+    for (UINT32 i = 0; i < proxies.size(); ++i)
+    {
+        if (proxies[i] == BVH_NULL_NODE)
+        {
+            if (visits[i] != 0)
+            {
+                std::cerr << "[test_bvh_tree] ERROR: " << stage << ", removed box " << i << " returned by the walk.\n";
+                return false;
+            }
+            continue;
+        }
+
+        leaves++;
+        const UINT32 expected = referenceInside(frustum, tree.getFatAABB(proxies[i])) ? 1 : 0;
+        if (visits[i] != expected)
+        {
+            std::cerr << "[test_bvh_tree] ERROR: " << stage << ", box " << i << " returned " << visits[i]
+                      << " times, expected " << expected << ".\n";
+            return false;
+        }
+    }
+    if (leaves != tree.getLeafCount())
+    {
+        std::cerr << "[test_bvh_tree] ERROR: " << stage << ", " << tree.getLeafCount() << " leaves, expected " << leaves << ".\n";
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    // 1. Sorted inserts: unit boxes along a line, the case that turns an unbalanced tree into a list
+    constexpr UINT32 LINE_COUNT = 20000;
+    DynamicAABBTree line;
+    for (UINT32 i = 0; i < LINE_COUNT; ++i)
+    {
+        const Quark::Vec3 min(static_cast<float>(i) * 2.0f, 0.0f, 0.0f);
+        line.insert(Quark::AABB(min, min + Quark::Vec3(1.0f, 1.0f, 1.0f)), i);
+    }
+    if (!checkHeight("sorted inserts", line)) return 1;
+
+    // 2. Random inserts, moves and removes against the reference plane test
+    Camera camera;
+    camera.setPosition(Quark::Vec3(0.0f, 2.0f, -10.0f));
+    camera.setPerspective(Quark::Radians(60.0f), 16.0f / 9.0f, 0.1f, 50.0f);
+    camera.setEulerAngles(Quark::Vec3(0.1f, 0.3f, 0.0f));
+    camera.update();
+
+    constexpr UINT32 BOX_COUNT = 4096;
+    DynamicAABBTree tree;
+    BVHTraversalStack stack;
+    std::vector<UINT32> proxies(BOX_COUNT);
+    for (UINT32 i = 0; i < BOX_COUNT; ++i)
+    {
+        proxies[i] = tree.insert(randomBox(), i);
+    }
+    if (!checkHeight("random inserts", tree) || !checkCull("random inserts", tree, camera.frustum, proxies, stack)) return 1;
+
+    for (UINT32 i = 0; i < BOX_COUNT; i += 2)
+    {
+        tree.move(proxies[i], randomBox());
+    }
+    if (!checkHeight("moves", tree) || !checkCull("moves", tree, camera.frustum, proxies, stack)) return 1;
+
+    for (UINT32 i = 0; i < BOX_COUNT; i += 3)
+    {
+        tree.remove(proxies[i]);
+        proxies[i] = BVH_NULL_NODE;
+    }
+    if (!checkHeight("removes", tree) || !checkCull("removes", tree, camera.frustum, proxies, stack)) return 1;
+
+    std::cout << "[test_bvh_tree] Height " << line.getHeight() << " for " << LINE_COUNT << " sorted inserts, "
+              << tree.getHeight() << " for " << tree.getLeafCount() << " random leaves, walks match the plane test.\n";
+    return 0;
+}
@@ -0,0 +1,130 @@
+// test_frame_allocations - steady-state frames must not touch the heap
+//
+// Replaces the global operator new/delete with counting versions, renders the
+// synthetic bench scene on rsnull until every arena and pool has grown to its
+// working size, then counts the allocations of the following frames. Moving
+// proxies, immediate submits, shadow views and the shadow cache all run in
+// those frames. Any allocation fails the test.
+
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#include "../tools/renderscene.h"
+#include "../graphics/rendersystem/rendersystem.h"
+#include "../graphics/rendersystem/backends/null/rsnull.h"
+
+// ==================== COUNTING ALLOCATOR ====================
+static std::atomic<bool> s_Counting(false);
+static std::atomic<UINT64> s_Allocations(0);
+
+static void* countedAlloc(size_t size, size_t alignment)
+{
+    if (s_Counting.load(std::memory_order_relaxed))
+        s_Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (size == 0) size = 1;
+    void* memory = nullptr;
+    if (alignment > alignof(std::max_align_t))
+    {
+#ifdef _WIN32
+        memory = _aligned_malloc(size, alignment);
+#else
+        if (posix_memalign(&memory, alignment, size) != 0) memory = nullptr;
+#endif
+    }
+    else
+    {
+        memory = malloc(size);
+    }
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+static void countedFree(void* memory, size_t alignment)
+{
+#ifdef _WIN32
+    if (alignment > alignof(std::max_align_t)) { _aligned_free(memory); return; }
+#endif
+    (void)alignment;
+    free(memory);
+}
+
+void* operator new(size_t size) { return countedAlloc(size, 0); }
+void* operator new[](size_t size) { return countedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAlloc(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAlloc(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size, 0); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size, 0); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* memory) noexcept { countedFree(memory, 0); }
+void operator delete[](void* memory) noexcept { countedFree(memory, 0); }
+void operator delete(void* memory, size_t) noexcept { countedFree(memory, 0); }
+void operator delete[](void* memory, size_t) noexcept { countedFree(memory, 0); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { countedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { countedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept { countedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, size_t, std::align_val_t alignment) noexcept { countedFree(memory, static_cast<size_t>(alignment)); }
+
+// ==================== TEST ====================
+static constexpr UINT32 WARMUP_FRAMES = 30;
+static constexpr UINT32 COUNTED_FRAMES = 60;
+
+static bool runFrames(UINT32 threads)
+{
+    RSNull backend;
+
+    // rsnull never touches the window, any non-null handle will do
+    RenderSystem renderSystem;
+    renderSystem.init(&backend, reinterpret_cast<qWndh>(1));
+    renderSystem.onResize(1280, 720);
+    renderSystem.setWorkerThreadCount(threads);
+
+    RenderBenchScene scene;
+    buildRenderBenchScene(renderSystem, scene, 5000);
+
+    UINT32 frame = 0;
+    for (; frame < WARMUP_FRAMES; ++frame)
+    {
+        animateRenderBenchScene(renderSystem, scene, frame);
+        renderSystem.renderFrame();
+        renderSystem.endFrame();
+    }
+
+    s_Allocations = 0;
+    s_Counting = true;
+    for (; frame < WARMUP_FRAMES + COUNTED_FRAMES; ++frame)
+    {
+        animateRenderBenchScene(renderSystem, scene, frame);
+        renderSystem.renderFrame();
+        renderSystem.endFrame();
+    }
+    s_Counting = false;
+
+    renderSystem.shutdown();
+
+    const UINT64 allocations = s_Allocations;
+    std::cout << "[test_frame_allocations] " << threads << " threads: " << allocations << " allocations in "
+              << COUNTED_FRAMES << " steady-state frames\n";
+    return allocations == 0;
+}
+
+int main()
+{
+    bool passed = runFrames(1);
+    passed = runFrames(4) && passed;
+
+    if (!passed)
+    {
+        std::cerr << "[test_frame_allocations] ERROR: steady-state frames allocated heap memory.\n";
+        return 1;
+    }
+    return 0;
+}
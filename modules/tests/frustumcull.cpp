@@ -0,0 +1,107 @@
+// test_frustum_cull - Frustum::cullAABBs against the scalar plane test
+//
+// Random boxes, many of them straddling a plane, are culled by the SIMD kernel and by
+// a per-box scalar loop using the same center/extent test. Every count from 0 to 40 and
+// ranges starting on and off a multiple of 8 are checked, which runs the 8-wide (AVX2)
+// and 4-wide (SSE2) loops with every possible scalar tail. Built once per math level;
+// the AVX2 build skips itself on CPUs without AVX2.
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "../graphics/rendersystem/frustum.h"
+#include "../graphics/rendersystem/camera.h"
+
+static UINT32 s_Random = 1;
+
+static float randomFloat(float low, float high)
+{
+    s_Random = s_Random * 1664525u + 1013904223u;
+    return low + (high - low) * static_cast<float>((s_Random >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static bool referenceInside(const Frustum& frustum, const Quark::AABBSoA& boxes, UINT32 i)
+{
+    for (int p = 0; p < 6; p++)
+    {
+        const Quark::Plane& plane = frustum.planes[p];
+        float dist = plane.normal.x * boxes.centerX[i] + plane.normal.y * boxes.centerY[i] + plane.normal.z * boxes.centerZ[i] + plane.distance;
+        float radius = std::abs(plane.normal.x) * boxes.extentX[i] + std::abs(plane.normal.y) * boxes.extentY[i] + std::abs(plane.normal.z) * boxes.extentZ[i];
+        if (dist + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+static bool checkRange(const Frustum& frustum, const Quark::AABBSoA& boxes, UINT32 begin, UINT32 end)
+{
+    std::vector<UINT32> indices(end - begin + 1);
+    const UINT32 count = frustum.cullAABBs(boxes, begin, end, indices.data());
+
+    UINT32 expected = 0;
+    for (UINT32 i = begin; i < end; ++i)
+    {
+        if (!referenceInside(frustum, boxes, i)) continue;
+        if (expected >= count || indices[expected] != i)
+        {
+            std::cerr << "[test_frustum_cull] ERROR: range [" << begin << ", " << end << "), box " << i << " missing or out of order.\n";
+            return false;
+        }
+        expected++;
+    }
+    if (count != expected)
+    {
+        std::cerr << "[test_frustum_cull] ERROR: range [" << begin << ", " << end << ") returned " << count
+                  << " boxes, expected " << expected << ".\n";
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+#if defined(QUARK_MATH_AVX2) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        std::cout << "[test_frustum_cull] AVX2 not supported by this CPU, skipped.\n";
+        return 0;
+    }
+#endif
+
+    Camera camera;
+    camera.setPosition(Quark::Vec3(0.0f, 2.0f, -10.0f));
+    camera.setPerspective(Quark::Radians(60.0f), 16.0f / 9.0f, 0.1f, 50.0f);
+    camera.setEulerAngles(Quark::Vec3(0.1f, 0.3f, 0.0f));
+    camera.update();
+
+    // Boxes spread around the frustum, small enough that many straddle a plane
+    Quark::AABBSoA boxes;
+    for (UINT32 i = 0; i < 4096; ++i)
+    {
+        const Quark::Vec3 center(randomFloat(-40.0f, 40.0f), randomFloat(-20.0f, 20.0f), randomFloat(-20.0f, 60.0f));
+        const Quark::Vec3 extents(randomFloat(0.0f, 3.0f), randomFloat(0.0f, 3.0f), randomFloat(0.0f, 3.0f));
+        boxes.Add(Quark::AABB(center - extents, center + extents));
+    }
+
+    Frustum shadowFrustum = camera.frustum;
+    shadowFrustum.disablePlane(4);
+
+    bool passed = true;
+    for (const Frustum* frustum : { &camera.frustum, &shadowFrustum })
+    {
+        for (UINT32 count = 0; count <= 40 && passed; ++count)
+        {
+            passed = checkRange(*frustum, boxes, 0, count);
+        }
+        for (UINT32 begin = 0; begin < 24 && passed; ++begin)
+        {
+            passed = checkRange(*frustum, boxes, begin, begin + 37) && checkRange(*frustum, boxes, begin * 64, begin * 64 + 171);
+        }
+        passed = passed && checkRange(*frustum, boxes, 0, static_cast<UINT32>(boxes.Size()));
+    }
+
+    if (!passed) return 1;
+    std::cout << "[test_frustum_cull] cullAABBs matches the scalar test.\n";
+    return 0;
+}
@@ -0,0 +1,155 @@
+// test_mat4_simd - SIMD Mat4 paths against their scalar references
+//
+// Random general matrices and random TRS compositions go through operator* (matrix and
+// vector), Inverted and Transposed, and each result is compared with MultiplyScalar,
+// TransformScalar, InvertedScalar and a plain index swap. The SIMD paths evaluate every
+// element in the scalar order, so the results must be identical, not just close. The
+// build pins -ffp-contract=off: a scalar reference contracted into FMAs would round
+// differently. Built for SSE2 and AVX2; the AVX2 build skips itself on CPUs without AVX2.
+// Zero and near-zero scales are checked first: Classify must send them to a guarded path.
+
+#include <iostream>
+#include <cmath>
+
+#include "../headeronly/globaltypes.h"
+#include "../headeronly/mathematics.h"
+
+static UINT32 s_Random = 1;
+
+static float randomFloat(float low, float high)
+{
+    s_Random = s_Random * 1664525u + 1013904223u;
+    return low + (high - low) * static_cast<float>((s_Random >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static Quark::Mat4 randomMatrix(UINT32 index)
+{
+    Quark::Mat4 matrix;
+    if (index % 2 == 0)
+    {
+        // Every element random, magnitudes from 1e-3 to 1e3
+        for (int i = 0; i < 16; ++i)
+        {
+            matrix.m[i] = randomFloat(-1.0f, 1.0f) * std::pow(10.0f, randomFloat(-3.0f, 3.0f));
+        }
+        return matrix;
+    }
+
+    const Quark::Vec3 translation(randomFloat(-500.0f, 500.0f), randomFloat(-500.0f, 500.0f), randomFloat(-500.0f, 500.0f));
+    const Quark::Vec3 angles(randomFloat(-3.0f, 3.0f), randomFloat(-3.0f, 3.0f), randomFloat(-3.0f, 3.0f));
+    const Quark::Vec3 scale(randomFloat(0.01f, 10.0f), randomFloat(0.01f, 10.0f), randomFloat(0.01f, 10.0f));
+    return Quark::Mat4::Translation(translation) * Quark::Mat4::RotationX(angles.x) * Quark::Mat4::RotationY(angles.y) *
+           Quark::Mat4::RotationZ(angles.z) * Quark::Mat4::Scaling(scale);
+}
+
+// Equal as values: +0 and -0 match, two NaNs match
+static bool sameFloat(float a, float b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+static bool sameMatrix(const char* operation, UINT32 index, const Quark::Mat4& simd, const Quark::Mat4& scalar)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        if (!sameFloat(simd.m[i], scalar.m[i]))
+        {
+            std::cerr << "[test_mat4_simd] ERROR: " << operation << ", matrix " << index << ", element " << i << ": "
+                      << simd.m[i] << " (SIMD) vs " << scalar.m[i] << " (scalar).\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Degenerate bases have to classify as AFFINE or GENERAL and invert to identity like Inverted(),
+// the rigid/uniform scale paths would divide by the zero axis length
+static bool checkDegenerate()
+{
+    const Quark::Mat4 rotation = Quark::Mat4::RotationY(0.7f) * Quark::Mat4::RotationX(-0.3f);
+    const Quark::Mat4 matrices[] =
+    {
+        Quark::Mat4::Scaling(Quark::Vec3(0.0f, 0.0f, 0.0f)),
+        Quark::Mat4::Translation(Quark::Vec3(3.0f, -2.0f, 5.0f)) * rotation * Quark::Mat4::Scaling(Quark::Vec3(0.0f, 0.0f, 0.0f)),
+        Quark::Mat4::Translation(Quark::Vec3(3.0f, -2.0f, 5.0f)) * rotation * Quark::Mat4::Scaling(Quark::Vec3(1e-4f, 1e-4f, 1e-4f)),
+    };
+
+    for (UINT32 index = 0; index < sizeof(matrices) / sizeof(matrices[0]); ++index)
+    {
+        const Quark::Mat4& matrix = matrices[index];
+        const Quark::MatrixType type = matrix.Classify();
+        if (type == Quark::MatrixType::RIGID || type == Quark::MatrixType::UNIFORM_SCALE)
+        {
+            std::cerr << "[test_mat4_simd] ERROR: degenerate matrix " << index << " classified as rigid or uniform scale.\n";
+            return false;
+        }
+
+        const Quark::Mat4 inverse = matrix.Inverted(type);
+        const Quark::Mat4 normal = matrix.NormalMatrix(type);
+        for (int i = 0; i < 16; ++i)
+        {
+            if (!std::isfinite(inverse.m[i]) || !std::isfinite(normal.m[i]))
+            {
+                std::cerr << "[test_mat4_simd] ERROR: degenerate matrix " << index << ", element " << i << " is not finite.\n";
+                return false;
+            }
+        }
+        if (!sameMatrix("Inverted(Classify())", index, inverse, Quark::Mat4::Identity()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    if (!checkDegenerate()) return 1;
+
+#if !defined(QUARK_MATH_SSE2)
+    std::cout << "[test_mat4_simd] Built without SIMD, nothing to compare.\n";
+    return 0;
+#else
+#if defined(QUARK_MATH_AVX2) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        std::cout << "[test_mat4_simd] AVX2 not supported by this CPU, skipped.\n";
+        return 0;
+    }
+#endif
+
+    constexpr UINT32 MATRIX_COUNT = 20000;
+    bool passed = true;
+    for (UINT32 index = 0; index < MATRIX_COUNT && passed; ++index)
+    {
+        const Quark::Mat4 a = randomMatrix(index);
+        const Quark::Mat4 b = randomMatrix(index + 1);
+
+        Quark::Mat4 transposed;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                transposed.m[i * 4 + j] = a.m[j * 4 + i];
+            }
+        }
+
+        passed = sameMatrix("operator*", index, a * b, a.MultiplyScalar(b)) &&
+                 sameMatrix("Inverted", index, a.Inverted(), a.InvertedScalar()) &&
+                 sameMatrix("Transposed", index, a.Transposed(), transposed);
+
+        const Quark::Vec4 v(randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f), randomFloat(-100.0f, 100.0f), randomFloat(-2.0f, 2.0f));
+        const Quark::Vec4 simd = a * v;
+        const Quark::Vec4 scalar = a.TransformScalar(v);
+        if (passed && !(sameFloat(simd.x, scalar.x) && sameFloat(simd.y, scalar.y) && sameFloat(simd.z, scalar.z) && sameFloat(simd.w, scalar.w)))
+        {
+            std::cerr << "[test_mat4_simd] ERROR: operator*(Vec4), matrix " << index << " differs from TransformScalar.\n";
+            passed = false;
+        }
+    }
+
+    if (!passed) return 1;
+    std::cout << "[test_mat4_simd] " << MATRIX_COUNT << " matrices identical to the scalar reference.\n";
+    return 0;
+#endif
+}
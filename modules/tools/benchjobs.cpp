@@ -0,0 +1,243 @@
+// bench_jobsystem - JobSystem microbenchmarks
+//
+//   bench_jobsystem [--iterations N] [--threads a,b,c]
+//
+// Runs three cases once per thread count (1, 2, 4, 8 and 16 by default):
+//   spawn    cost of run() + wait() for a single one-element job, and per job for a batch of them
+//   fanout   parallelFor over a large array with a little work per element (fan-out, fan-in)
+//   nested   parallelFor whose slices each run and wait on their own parallelFor
+// Every case checks its result, a wrong sum or a lost slice fails the run.
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "../core/engine/jobsystem/jobsystem.h"
+
+constexpr UINT32 SPAWN_BATCH = 256;
+constexpr UINT32 FANOUT_COUNT = 1u << 20;
+constexpr UINT32 FANOUT_MIN_CHUNK = 1024;
+constexpr UINT32 NESTED_OUTER = 64;
+constexpr UINT32 NESTED_INNER = 4096;
+constexpr UINT32 NESTED_MIN_CHUNK = 64;
+
+struct BenchJobsResult
+{
+    UINT32 threads;
+    double spawnSingle;     // us per run() + wait()
+    double spawnBatch;      // us per job, SPAWN_BATCH jobs on one counter
+    double fanout;          // ms per parallelFor
+    double nested;          // ms per outer parallelFor
+    bool valid;
+};
+
+static double elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: bench_jobsystem [--iterations N] [--threads a,b,c]\n";
+}
+
+// ==================== CASES ====================
+static void countRange(void* context, UINT32 begin, UINT32 end)
+{
+    static_cast<std::atomic<UINT32>*>(context)->fetch_add(end - begin, std::memory_order_relaxed);
+}
+
+static bool benchSpawn(JobSystem& jobs, UINT32 iterations, BenchJobsResult& result)
+{
+    std::atomic<UINT32> executed(0);
+
+    JobDecl job = {};
+    job.function = &countRange;
+    job.context = &executed;
+    job.count = 1;
+    job.minChunk = 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (UINT32 i = 0; i < iterations; ++i)
+    {
+        JobCounter counter;
+        jobs.run(job, &counter);
+        jobs.wait(&counter);
+    }
+    result.spawnSingle = elapsedMs(start) * 1000.0 / iterations;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (UINT32 i = 0; i < iterations; ++i)
+    {
+        JobCounter counter;
+        for (UINT32 j = 0; j < SPAWN_BATCH; ++j)
+        {
+            jobs.run(job, &counter);
+        }
+        jobs.wait(&counter);
+    }
+    result.spawnBatch = elapsedMs(start) * 1000.0 / (static_cast<double>(iterations) * SPAWN_BATCH);
+
+    return executed == iterations + iterations * SPAWN_BATCH;
+}
+
+static bool benchFanout(JobSystem& jobs, UINT32 iterations, const std::vector<float>& values, double expected, BenchJobsResult& result)
+{
+    std::vector<double> partial(values.size() / FANOUT_MIN_CHUNK + 1);
+    bool valid = true;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (UINT32 i = 0; i < iterations; ++i)
+    {
+        std::fill(partial.begin(), partial.end(), 0.0);
+
+        // Slices never straddle a chunk boundary, so each chunk sums into its own slot
+        jobs.parallelFor(static_cast<UINT32>(values.size() / FANOUT_MIN_CHUNK), 1, [&](UINT32 begin, UINT32 end)
+        {
+            for (UINT32 chunk = begin; chunk < end; ++chunk)
+            {
+                double sum = 0.0;
+                const float* chunkValues = values.data() + static_cast<size_t>(chunk) * FANOUT_MIN_CHUNK;
+                for (UINT32 e = 0; e < FANOUT_MIN_CHUNK; ++e)
+                {
+                    sum += std::sqrt(chunkValues[e]);
+                }
+                partial[chunk] = sum;
+            }
+        });
+
+        double total = 0.0;
+        for (double sum : partial) total += sum;
+        valid = valid && total == expected;
+    }
+    result.fanout = elapsedMs(start) / iterations;
+    return valid;
+}
+
+static bool benchNested(JobSystem& jobs, UINT32 iterations, BenchJobsResult& result)
+{
+    std::vector<std::atomic<UINT32>> innerCounts(NESTED_OUTER);
+    bool valid = true;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (UINT32 i = 0; i < iterations; ++i)
+    {
+        for (std::atomic<UINT32>& count : innerCounts) count = 0;
+
+        jobs.parallelFor(NESTED_OUTER, 1, [&](UINT32 begin, UINT32 end)
+        {
+            for (UINT32 outer = begin; outer < end; ++outer)
+            {
+                std::atomic<UINT32>& count = innerCounts[outer];
+                jobs.parallelFor(NESTED_INNER, NESTED_MIN_CHUNK, [&](UINT32 innerBegin, UINT32 innerEnd)
+                {
+                    count.fetch_add(innerEnd - innerBegin, std::memory_order_relaxed);
+                });
+            }
+        });
+
+        for (const std::atomic<UINT32>& count : innerCounts)
+        {
+            valid = valid && count == NESTED_INNER;
+        }
+    }
+    result.nested = elapsedMs(start) / iterations;
+    return valid;
+}
+
+static BenchJobsResult runBenchJobs(UINT32 threads, UINT32 iterations, const std::vector<float>& values, double expected)
+{
+    BenchJobsResult result = {};
+    result.threads = threads;
+
+    JobSystem jobs(threads);
+
+    // Let the workers start and park before timing
+    benchSpawn(jobs, 16, result);
+
+    result.valid = benchSpawn(jobs, iterations * 10, result);
+    result.valid = benchFanout(jobs, iterations, values, expected, result) && result.valid;
+    result.valid = benchNested(jobs, iterations, result) && result.valid;
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    UINT32 iterations = 100;
+    std::vector<UINT32> threadCounts = { 1, 2, 4, 8, 16 };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = static_cast<UINT32>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCounts.clear();
+            for (char* token = strtok(argv[++i], ","); token; token = strtok(nullptr, ","))
+            {
+                threadCounts.push_back(static_cast<UINT32>(std::max(1, atoi(token))));
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    if (threadCounts.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Same chunked summation order as benchFanout, the totals must match exactly
+    std::vector<float> values(FANOUT_COUNT);
+    for (UINT32 i = 0; i < FANOUT_COUNT; ++i)
+    {
+        values[i] = static_cast<float>(i % 1000);
+    }
+    double expected = 0.0;
+    for (UINT32 chunk = 0; chunk < FANOUT_COUNT / FANOUT_MIN_CHUNK; ++chunk)
+    {
+        double sum = 0.0;
+        for (UINT32 e = 0; e < FANOUT_MIN_CHUNK; ++e)
+        {
+            sum += std::sqrt(values[static_cast<size_t>(chunk) * FANOUT_MIN_CHUNK + e]);
+        }
+        expected += sum;
+    }
+
+    std::vector<BenchJobsResult> results;
+    for (UINT32 threads : threadCounts)
+    {
+        results.push_back(runBenchJobs(threads, iterations, values, expected));
+    }
+
+    // ==================== REPORT ====================
+    std::cout << "\nbench_jobsystem: " << iterations << " iterations\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "spawn us" << std::setw(14) << "batch us/job"
+              << std::setw(12) << "fanout ms" << std::setw(9) << "speedup" << std::setw(12) << "nested ms" << std::setw(9) << "speedup" << '\n';
+
+    std::cout << std::fixed;
+    bool valid = true;
+    for (const BenchJobsResult& result : results)
+    {
+        std::cout << std::setprecision(3) << std::setw(8) << result.threads << std::setw(14) << result.spawnSingle
+                  << std::setw(14) << result.spawnBatch << std::setw(12) << result.fanout
+                  << std::setw(8) << std::setprecision(2) << results[0].fanout / result.fanout << "x"
+                  << std::setw(12) << std::setprecision(3) << result.nested
+                  << std::setw(8) << std::setprecision(2) << results[0].nested / result.nested << "x" << '\n';
+
+        if (!result.valid)
+        {
+            std::cerr << "[bench_jobsystem] ERROR: " << result.threads << " threads produced wrong results.\n";
+            valid = false;
+        }
+    }
+    return valid ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+// bench_render - RenderSystem scaling benchmark on the null backend
+//
+//   bench_render [--objects N] [--frames N] [--warmup N] [--threads a,b,c]
+//
+// Builds the same synthetic scene once per thread count (1, 2, 4, 8 and 16 by default),
+// renders it headless and reports the average per-stage times. Packet checksums of every
+// frame are compared against the first run: the stages must come out identical whatever
+// the thread count, a mismatch fails the run.
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+
+#include "renderscene.h"
+#include "../graphics/rendersystem/rendersystem.h"
+#include "../graphics/rendersystem/backends/null/rsnull.h"
+
+struct BenchRenderResult
+{
+    UINT32 threads;
+    double stageTime[RENDER_STAGE_COUNT];
+    double cpuTime;
+    std::vector<UINT64> checksums;
+};
+
+static void printUsage()
+{
+    std::cout << "Usage: bench_render [--objects N] [--frames N] [--warmup N] [--threads a,b,c]\n";
+}
+
+static BenchRenderResult runBenchRender(UINT32 threads, UINT32 objectCount, UINT32 warmupFrames, UINT32 frames)
+{
+    BenchRenderResult result = {};
+    result.threads = threads;
+
+    RSNull backend;
+    backend.setChecksumEnabled(true);
+
+    // rsnull never touches the window, any non-null handle will do
+    RenderSystem renderSystem;
+    renderSystem.init(&backend, reinterpret_cast<qWndh>(1));
+    renderSystem.onResize(1920, 1080);
+    renderSystem.setWorkerThreadCount(threads);
+
+    RenderBenchScene scene;
+    buildRenderBenchScene(renderSystem, scene, objectCount);
+
+    for (UINT32 frame = 0; frame < warmupFrames + frames; ++frame)
+    {
+        animateRenderBenchScene(renderSystem, scene, frame);
+        renderSystem.renderFrame();
+        renderSystem.endFrame();
+
+        result.checksums.push_back(backend.getStats().checksum);
+        if (frame < warmupFrames) continue;
+
+        const RenderStats& stats = renderSystem.getStats();
+        for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+        {
+            result.stageTime[s] += stats.stageTime[s];
+        }
+        result.cpuTime += stats.cpuTime;
+    }
+
+    for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+    {
+        result.stageTime[s] /= frames;
+    }
+    result.cpuTime /= frames;
+
+    renderSystem.shutdown();
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    UINT32 objectCount = 50000;
+    UINT32 frames = 60;
+    UINT32 warmupFrames = 10;
+    std::vector<UINT32> threadCounts = { 1, 2, 4, 8, 16 };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc)
+            objectCount = static_cast<UINT32>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = static_cast<UINT32>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            warmupFrames = static_cast<UINT32>(std::max(0, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCounts.clear();
+            for (char* token = strtok(argv[++i], ","); token; token = strtok(nullptr, ","))
+            {
+                threadCounts.push_back(static_cast<UINT32>(std::max(1, atoi(token))));
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    if (threadCounts.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<BenchRenderResult> results;
+    for (UINT32 threads : threadCounts)
+    {
+        results.push_back(runBenchRender(threads, objectCount, warmupFrames, frames));
+    }
+
+    // ==================== REPORT ====================
+    std::cout << "\nbench_render: " << objectCount << " objects, " << frames << " frames (" << warmupFrames << " warmup), ms per frame\n";
+    std::cout << std::setw(8) << "threads";
+    for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+    {
+        std::cout << std::setw(11) << getRenderStageName(static_cast<RenderStage>(s));
+    }
+    std::cout << std::setw(10) << "cpu" << std::setw(9) << "speedup" << '\n';
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const BenchRenderResult& result : results)
+    {
+        std::cout << std::setw(8) << result.threads;
+        for (UINT32 s = 0; s < RENDER_STAGE_COUNT; ++s)
+        {
+            std::cout << std::setw(11) << result.stageTime[s];
+        }
+        std::cout << std::setw(10) << result.cpuTime << std::setw(8) << std::setprecision(2)
+                  << results[0].cpuTime / result.cpuTime << "x" << std::setprecision(3) << '\n';
+    }
+
+    // ==================== DETERMINISM ====================
+    bool identical = true;
+    for (const BenchRenderResult& result : results)
+    {
+        for (size_t frame = 0; frame < result.checksums.size(); ++frame)
+        {
+            if (result.checksums[frame] != results[0].checksums[frame])
+            {
+                std::cerr << "[bench_render] ERROR: " << result.threads << " threads, frame " << frame
+                          << " packet checksum differs from " << results[0].threads << " threads.\n";
+                identical = false;
+                break;
+            }
+        }
+    }
+    if (!identical) return 1;
+
+    std::cout << "Packet checksums identical across thread counts (" << results[0].checksums.size() << " frames each).\n";
+    return 0;
+}
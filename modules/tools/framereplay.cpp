@@ -0,0 +1,175 @@
+// framereplay - plays a frame capture into a render backend module and reports frame timing
+//
+//   framereplay <capture> <backend module> [--runs N] [--csv file] [--trace file]
+//
+// The backend is initialized without a window, so use a headless backend
+// (rsnull, rssoftware). GPU backends are replayed in-engine instead.
+// --trace records every run, including the backend's zones, as Chrome trace JSON.
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "../core/engine/framecapture/framecapture.h"
+#include "../headeronly/profiler.h"
+
+typedef RHI* (*t_fnCreateRenderBackend)();
+typedef void (*t_fnDestroyRenderBackend)(RHI*);
+typedef void (*t_fnSetRenderBackendProfiler)(Quark::Profiler*);
+
+#ifdef _WIN32
+using QMODULE = HMODULE;
+static QMODULE openModule(const char* path) { return LoadLibraryA(path); }
+static void* moduleSymbol(QMODULE module, const char* name) { return reinterpret_cast<void*>(GetProcAddress(module, name)); }
+static void closeModule(QMODULE module) { FreeLibrary(module); }
+#else
+using QMODULE = void*;
+static QMODULE openModule(const char* path) { return dlopen(path, RTLD_NOW | RTLD_LOCAL); }
+static void* moduleSymbol(QMODULE module, const char* name) { return dlsym(module, name); }
+static void closeModule(QMODULE module) { dlclose(module); }
+#endif
+
+static void printUsage()
+{
+    std::cout << "Usage: framereplay <capture> <backend module> [--runs N] [--csv file] [--trace file]\n";
+}
+
+static bool writeCSV(const char* filename, const std::vector<ReplayFrameTiming>& timings)
+{
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+
+    file << "frame,frameMs,executeMs,endFrameMs,drawCalls,instances\n";
+    for (size_t i = 0; i < timings.size(); ++i)
+    {
+        const ReplayFrameTiming& timing = timings[i];
+        file << i << ',' << timing.frameTime << ',' << timing.executeTime << ',' << timing.endFrameTime << ','
+             << timing.drawCalls << ',' << timing.instances << '\n';
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const char* capturePath = argv[1];
+    const char* modulePath = argv[2];
+    const char* csvPath = nullptr;
+    const char* tracePath = nullptr;
+    UINT32 runs = 1;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+            runs = static_cast<UINT32>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csvPath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Quark::Profiler profiler;
+    Quark::setModuleProfiler(&profiler, "framereplay");
+    QUARK_PROFILE_THREAD("Main Thread");
+
+    FrameReplayer replayer;
+    if (!replayer.load(capturePath))
+        return 1;
+
+    QMODULE module = openModule(modulePath);
+    if (!module)
+    {
+        std::cerr << "[FrameReplay] ERROR: Cannot load " << modulePath << ".\n";
+        return 1;
+    }
+
+    t_fnCreateRenderBackend fnCreateRenderBackend =
+        reinterpret_cast<t_fnCreateRenderBackend>(moduleSymbol(module, "createRenderBackend"));
+    t_fnDestroyRenderBackend fnDestroyRenderBackend =
+        reinterpret_cast<t_fnDestroyRenderBackend>(moduleSymbol(module, "destroyRenderBackend"));
+
+    if (!fnCreateRenderBackend || !fnDestroyRenderBackend)
+    {
+        std::cerr << "[FrameReplay] ERROR: " << modulePath << " is not a render backend.\n";
+        closeModule(module);
+        return 1;
+    }
+
+    RHI* rhi = fnCreateRenderBackend();
+    if (!rhi)
+    {
+        std::cerr << "[FrameReplay] ERROR: Backend creation failed.\n";
+        closeModule(module);
+        return 1;
+    }
+
+    // Optional export, without it the trace only has the replayer's zones
+    t_fnSetRenderBackendProfiler fnSetRenderBackendProfiler =
+        reinterpret_cast<t_fnSetRenderBackendProfiler>(moduleSymbol(module, "setRenderBackendProfiler"));
+    if (fnSetRenderBackendProfiler)
+        fnSetRenderBackendProfiler(&profiler);
+
+    rhi->init(nullptr);
+    if (replayer.getWidth() > 0 && replayer.getHeight() > 0)
+        rhi->onResize(replayer.getWidth(), replayer.getHeight());
+
+    std::cout << "Replaying " << replayer.getFrameCount() << " frames (" << replayer.getWidth() << "x"
+              << replayer.getHeight() << ") on " << modulePath << "\n";
+
+    if (tracePath)
+        profiler.beginCapture();
+
+    bool succeeded = true;
+    for (UINT32 run = 0; run < runs && succeeded; ++run)
+    {
+        succeeded = replayer.replay(rhi);
+        if (!succeeded) break;
+
+        ReplayStats stats = replayer.getStats();
+        std::cout << "Run " << run + 1 << ": " << stats.frames << " frames in " << stats.totalTime << " ms"
+                  << " | frame min " << stats.minFrameTime << " avg " << stats.avgFrameTime
+                  << " p95 " << stats.p95FrameTime << " max " << stats.maxFrameTime
+                  << " ms (frame " << stats.slowestFrame << ")\n";
+    }
+
+    if (tracePath)
+    {
+        profiler.endCapture();
+        if (succeeded && !profiler.writeChromeTrace(tracePath))
+            succeeded = false;
+    }
+
+    // Per-frame timing of the last run
+    if (succeeded && csvPath && !writeCSV(csvPath, replayer.getFrameTimings()))
+    {
+        std::cerr << "[FrameReplay] ERROR: Cannot write " << csvPath << ".\n";
+        succeeded = false;
+    }
+
+    rhi->shutdown();
+    fnDestroyRenderBackend(rhi);
+    if (fnSetRenderBackendProfiler)
+        fnSetRenderBackendProfiler(nullptr);
+    closeModule(module);
+
+    return succeeded ? 0 : 1;
+}
@@ -68,10 +68,6 @@ LoadedMesh ModelLoader::ProcessMesh(void* meshPtr, void* scenePtr)
     result.vertices.reserve(mesh->mNumVertices);
     result.indices.reserve(mesh->mNumFaces * 3);
     
-    // Bounds
-    Quark::Vec3 minBounds(FLT_MAX, FLT_MAX, FLT_MAX);
-    Quark::Vec3 maxBounds(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-    
     // Process vertices
     for (unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
@@ -82,14 +78,6 @@ LoadedMesh ModelLoader::ProcessMesh(void* meshPtr, void* scenePtr)
         vertex.position.y = mesh->mVertices[i].y;
         vertex.position.z = mesh->mVertices[i].z;
         
-        // Update bounds
-        minBounds.x = (std::min)(minBounds.x, vertex.position.x);
-        minBounds.y = (std::min)(minBounds.y, vertex.position.y);
-        minBounds.z = (std::min)(minBounds.z, vertex.position.z);
-        maxBounds.x = (std::max)(maxBounds.x, vertex.position.x);
-        maxBounds.y = (std::max)(maxBounds.y, vertex.position.y);
-        maxBounds.z = (std::max)(maxBounds.z, vertex.position.z);
-        
         // Normal
         if (mesh->HasNormals())
         {
@@ -135,8 +123,12 @@ LoadedMesh ModelLoader::ProcessMesh(void* meshPtr, void* scenePtr)
     result.data.vertexCount = static_cast<UINT32>(result.vertices.size());
     result.data.indices = result.indices.data();
     result.data.indexCount = static_cast<UINT32>(result.indices.size());
-    result.data.boundingBox.minBounds = minBounds;
-    result.data.boundingBox.maxBounds = maxBounds;
+    
+    // Bounds (batched over the vertex positions)
+    if (!result.vertices.empty())
+    {
+        result.data.boundingBox = Quark::ComputeAABB(&result.vertices[0].position, result.vertices.size(), sizeof(Vertex));
+    }
 
     
     return result;
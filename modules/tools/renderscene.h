@@ -0,0 +1,216 @@
+// renderscene - synthetic scene shared by the render benchmarks and tests
+//
+// A grid of cubes on a ground plane with a shadowed sun, shadowed spot lights and
+// unshadowed point lights. Every 16th cube is a moving proxy and a few cubes are
+// submitted immediate-mode each frame, so the proxy, submit and shadow cache paths
+// all run. Everything comes from a fixed seed, two scenes built with the same
+// arguments render identical packets.
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "../graphics/rendersystem/rendersystemapi.h"
+
+// ==================== SCENE DATA ====================
+struct RenderBenchScene
+{
+    Camera camera;
+    hMesh cubeMesh = 0;
+    hMesh planeMesh = 0;
+    std::vector<hMaterial> materials;
+    std::vector<hRenderProxy> movingProxies;
+    std::vector<RenderObject> movingObjects;    // Proxy state, moved by animateRenderBenchScene
+    std::vector<RenderObject> immediateObjects; // Submitted every frame
+};
+
+// Small LCG, the scene must not depend on the C library's rand()
+inline UINT32 nextRenderBenchRandom(UINT32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+inline float randomRenderBenchFloat(UINT32& state)
+{
+    return static_cast<float>(nextRenderBenchRandom(state) & 0xFFFF) / 65535.0f;
+}
+
+inline MeshData getRenderBenchCube()
+{
+    static Vertex vertices[24];
+    static UINT32 indices[36];
+    static bool built = false;
+    if (!built)
+    {
+        // One quad per face: normal n, in-plane axes u and v
+        const Quark::Vec3 normals[6] = { {0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}, {1, 0, 0}, {-1, 0, 0} };
+        for (UINT32 f = 0; f < 6; ++f)
+        {
+            const Quark::Vec3 n = normals[f];
+            const Quark::Vec3 u = std::fabs(n.y) > 0.5f ? Quark::Vec3(1, 0, 0) : Quark::Vec3(0, 1, 0).Cross(n);
+            const Quark::Vec3 v = n.Cross(u);
+            const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+            for (UINT32 c = 0; c < 4; ++c)
+            {
+                Vertex& vertex = vertices[f * 4 + c];
+                vertex.position = n + u * corners[c][0] + v * corners[c][1];
+                vertex.normal = n;
+                vertex.texCoord = Quark::Vec2(corners[c][0] * 0.5f + 0.5f, corners[c][1] * 0.5f + 0.5f);
+                vertex.tangent = u;
+                vertex.bitangent = v;
+            }
+            const UINT32 quad[6] = { 0, 1, 2, 0, 2, 3 };
+            for (UINT32 i = 0; i < 6; ++i)
+            {
+                indices[f * 6 + i] = f * 4 + quad[i];
+            }
+        }
+        built = true;
+    }
+
+    MeshData mesh;
+    mesh.vertices = vertices;
+    mesh.vertexCount = 24;
+    mesh.indices = indices;
+    mesh.indexCount = 36;
+    mesh.boundingBox = Quark::AABB(Quark::Vec3(-1, -1, -1), Quark::Vec3(1, 1, 1));
+    return mesh;
+}
+
+inline MeshData getRenderBenchPlane()
+{
+    static Vertex vertices[4] =
+    {
+        { Quark::Vec3(-1, 0, -1), Quark::Vec3(0, 1, 0), Quark::Vec2(0, 1), Quark::Vec3(1, 0, 0), Quark::Vec3(0, 0, 1) },
+        { Quark::Vec3( 1, 0, -1), Quark::Vec3(0, 1, 0), Quark::Vec2(1, 1), Quark::Vec3(1, 0, 0), Quark::Vec3(0, 0, 1) },
+        { Quark::Vec3( 1, 0,  1), Quark::Vec3(0, 1, 0), Quark::Vec2(1, 0), Quark::Vec3(1, 0, 0), Quark::Vec3(0, 0, 1) },
+        { Quark::Vec3(-1, 0,  1), Quark::Vec3(0, 1, 0), Quark::Vec2(0, 0), Quark::Vec3(1, 0, 0), Quark::Vec3(0, 0, 1) }
+    };
+    static UINT32 indices[6] = { 0, 2, 1, 0, 3, 2 };
+
+    MeshData mesh;
+    mesh.vertices = vertices;
+    mesh.vertexCount = 4;
+    mesh.indices = indices;
+    mesh.indexCount = 6;
+    mesh.boundingBox = Quark::AABB(Quark::Vec3(-1, 0, -1), Quark::Vec3(1, 0, 1));
+    return mesh;
+}
+
+// ==================== BUILD ====================
+// objectCount cubes on a square grid, about one light per 200 cubes
+inline void buildRenderBenchScene(RenderSystemAPI& renderSystem, RenderBenchScene& scene, UINT32 objectCount, UINT32 seed = 1)
+{
+    UINT32 random = seed;
+
+    scene.cubeMesh = renderSystem.createMesh(getRenderBenchCube());
+    scene.planeMesh = renderSystem.createMesh(getRenderBenchPlane());
+    for (UINT32 i = 0; i < 8; ++i)
+    {
+        MaterialData material = {};
+        material.albedo = Quark::Color(randomRenderBenchFloat(random), randomRenderBenchFloat(random), randomRenderBenchFloat(random), 1.0f);
+        material.roughness = 0.2f + 0.6f * randomRenderBenchFloat(random);
+        scene.materials.push_back(renderSystem.createMaterial(material));
+    }
+
+    const UINT32 side = (std::max)(1u, static_cast<UINT32>(std::sqrt(static_cast<float>(objectCount))));
+    const float spacing = 3.0f;
+    const float halfExtent = side * spacing * 0.5f;
+
+    RenderObject ground = {};
+    ground.mesh = scene.planeMesh;
+    ground.material = scene.materials[0];
+    ground.worldMatrix = Quark::Mat4::Scaling(Quark::Vec3(halfExtent, 1.0f, halfExtent));
+    ground.flags = RenderObjectFlags::VISIBLE | RenderObjectFlags::FRUSTUM_CULL | RenderObjectFlags::RECEIVE_SHADOW |
+                   RenderObjectFlags::STATIC;
+    renderSystem.createRenderProxy(ground);
+
+    for (UINT32 i = 0; i < objectCount; ++i)
+    {
+        const float x = (i % side) * spacing - halfExtent;
+        const float z = (i / side) * spacing - halfExtent;
+        const float height = 0.5f + 2.0f * randomRenderBenchFloat(random);
+
+        RenderObject object = {};
+        object.mesh = scene.cubeMesh;
+        object.material = scene.materials[nextRenderBenchRandom(random) % scene.materials.size()];
+        object.worldMatrix = Quark::Mat4::Translation(Quark::Vec3(x, height, z)) *
+                             Quark::Mat4::Scaling(Quark::Vec3(0.5f, height, 0.5f));
+
+        if (i % 64 == 63)
+        {
+            // Immediate objects carry their own bounds
+            object.worldAABB = Quark::AABB(Quark::Vec3(x - 0.5f, 0.0f, z - 0.5f), Quark::Vec3(x + 0.5f, height * 2.0f, z + 0.5f));
+            scene.immediateObjects.push_back(object);
+            continue;
+        }
+
+        if (i % 16 == 0)
+        {
+            object.flags |= RenderObjectFlags::DYNAMIC;
+            scene.movingProxies.push_back(renderSystem.createRenderProxy(object));
+            scene.movingObjects.push_back(object);
+            continue;
+        }
+
+        object.flags |= RenderObjectFlags::STATIC;
+        if (i % 97 == 0)
+            object.flags |= RenderObjectFlags::OCCLUDER;
+        renderSystem.createRenderProxy(object);
+    }
+
+    DirectionalLight sun = {};
+    sun.direction = Quark::Vec3(0.4f, -0.8f, 0.3f).Normalized();
+    sun.intensity = 2.0f;
+    renderSystem.createDirectionalLight(sun);
+
+    const UINT32 lightCount = objectCount / 200 + 1;
+    for (UINT32 i = 0; i < lightCount; ++i)
+    {
+        const Quark::Vec3 position((randomRenderBenchFloat(random) - 0.5f) * halfExtent * 2.0f, 3.0f,
+                                   (randomRenderBenchFloat(random) - 0.5f) * halfExtent * 2.0f);
+        const Quark::Color color(randomRenderBenchFloat(random), randomRenderBenchFloat(random), randomRenderBenchFloat(random), 1.0f);
+        if (i % 4 == 0)
+        {
+            SpotLight spot = {};
+            spot.position = position;
+            spot.direction = Quark::Vec3(0.2f, -1.0f, 0.1f).Normalized();
+            spot.color = color;
+            spot.range = 12.0f;
+            spot.flags |= static_cast<UINT32>(LightFlags::LIGHT_CAST_SHADOWS);
+            renderSystem.createSpotLight(spot);
+        }
+        else
+        {
+            PointLight point = {};
+            point.position = position;
+            point.color = color;
+            point.range = 6.0f;
+            renderSystem.createPointLight(point);
+        }
+    }
+
+    scene.camera.setPosition(Quark::Vec3(0.0f, 12.0f, -halfExtent * 0.5f));
+    scene.camera.setPerspective(Quark::Radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    scene.camera.setEulerAngles(Quark::Vec3(0.4f, 0.0f, 0.0f));
+    scene.camera.update();
+    renderSystem.setActiveCamera(&scene.camera);
+    renderSystem.setDeltaTime(1.0f / 60.0f);
+}
+
+// ==================== ANIMATE ====================
+// Moves the dynamic proxies and submits the immediate objects, a pure function of the frame number
+inline void animateRenderBenchScene(RenderSystemAPI& renderSystem, RenderBenchScene& scene, UINT32 frame)
+{
+    const float offset = std::sin(static_cast<float>(frame) * 0.1f) * 0.5f;
+    for (size_t i = 0; i < scene.movingProxies.size(); ++i)
+    {
+        const Quark::Mat4 world = Quark::Mat4::Translation(Quark::Vec3(0.0f, offset, 0.0f)) * scene.movingObjects[i].worldMatrix;
+        renderSystem.updateProxyTransform(scene.movingProxies[i], world);
+    }
+    for (const RenderObject& object : scene.immediateObjects)
+    {
+        renderSystem.submit(object);
+    }
+}